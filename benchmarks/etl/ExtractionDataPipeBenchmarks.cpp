@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/ETLHelpers.hpp"
+#include "etl/impl/ExtractionDataPipe.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr auto TOTAL_LEDGERS = 100'000u;
+constexpr auto START_SEQUENCE = 1u;
+
+// The extraction pipe as it was before it moved to ring buffers: one mutex/cv queue per extractor
+class ThreadSafeQueuePipe {
+    using QueueType = etl::ThreadSafeQueue<std::optional<uint32_t>>;
+
+    uint32_t stride_;
+    std::vector<std::unique_ptr<QueueType>> queues_;
+
+public:
+    explicit ThreadSafeQueuePipe(uint32_t stride) : stride_{stride}
+    {
+        auto const maxQueueSize = etl::impl::ExtractionDataPipe<uint32_t>::TOTAL_MAX_IN_QUEUE / stride;
+        for (auto i = 0u; i < stride_; ++i)
+            queues_.push_back(std::make_unique<QueueType>(maxQueueSize));
+    }
+
+    void
+    push(uint32_t sequence, std::optional<uint32_t>&& data)
+    {
+        queues_[(sequence - START_SEQUENCE) % stride_]->push(std::move(data));
+    }
+
+    std::optional<uint32_t>
+    popNext(uint32_t sequence)
+    {
+        return queues_[(sequence - START_SEQUENCE) % stride_]->pop();
+    }
+};
+
+/**
+ * @brief Runs one producer thread per extractor and a single consumer that pops in sequence order, like the ETL does.
+ */
+template <typename PipeType>
+void
+handOff(PipeType& pipe, uint32_t stride)
+{
+    std::vector<std::thread> extractors;
+    extractors.reserve(stride);
+    for (auto i = 0u; i < stride; ++i) {
+        extractors.emplace_back([&pipe, i, stride] {
+            for (auto seq = START_SEQUENCE + i; seq < START_SEQUENCE + TOTAL_LEDGERS; seq += stride)
+                pipe.push(seq, std::make_optional(seq));
+        });
+    }
+
+    for (auto seq = START_SEQUENCE; seq < START_SEQUENCE + TOTAL_LEDGERS; ++seq)
+        benchmark::DoNotOptimize(pipe.popNext(seq));
+
+    for (auto& t : extractors)
+        t.join();
+}
+
+}  // namespace
+
+static void
+benchmarkThreadSafeQueuePipe(benchmark::State& state)
+{
+    auto const stride = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        ThreadSafeQueuePipe pipe{stride};
+        handOff(pipe, stride);
+    }
+    state.SetItemsProcessed(state.iterations() * TOTAL_LEDGERS);
+}
+
+static void
+benchmarkExtractionDataPipe(benchmark::State& state)
+{
+    PrometheusService::init();
+
+    auto const stride = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        etl::impl::ExtractionDataPipe<uint32_t> pipe{stride, START_SEQUENCE};
+        handOff(pipe, stride);
+    }
+    state.SetItemsProcessed(state.iterations() * TOTAL_LEDGERS);
+}
+
+// Handoff of TOTAL_LEDGERS sequences from `stride` extractor threads to a single consumer; compare items per second
+BENCHMARK(benchmarkThreadSafeQueuePipe)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK(benchmarkExtractionDataPipe)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/LedgerCache.hpp"
+#include "data/Types.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <benchmark/benchmark.h>
+#include <google/protobuf/arena.h>
+#include <org/xrpl/rpc/v1/get_ledger_data.pb.h>
+#include <xrpl/basics/base_uint.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr auto OBJECTS_PER_PAGE = 2048u;
+constexpr auto OBJECT_SIZE = 200u;
+constexpr auto ARENA_START_BLOCK_SIZE = 64u * 1024u;
+constexpr auto ARENA_MAX_BLOCK_SIZE = 1024u * 1024u;
+
+using ResponseType = org::xrpl::rpc::v1::GetLedgerDataResponse;
+
+// only allocations made by the benchmarking thread while counting is on are recorded
+thread_local bool countAllocations = false;    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+thread_local std::size_t allocationCount = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+std::string
+randomBytes(std::mt19937_64& engine, std::size_t size)
+{
+    std::string bytes(size, '\0');
+    for (auto& byte : bytes)
+        byte = static_cast<char>(engine());
+    return bytes;
+}
+
+std::string
+makeSerializedPage()
+{
+    std::mt19937_64 engine{0};  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+    ResponseType response;
+    response.set_is_unlimited(true);
+    response.set_marker(randomBytes(engine, ripple::uint256::size()));
+
+    for (auto i = 0u; i < OBJECTS_PER_PAGE; ++i) {
+        auto* object = response.mutable_ledger_objects()->add_objects();
+        object->set_key(randomBytes(engine, ripple::uint256::size()));
+        object->set_data(randomBytes(engine, OBJECT_SIZE));
+    }
+
+    return response.SerializeAsString();
+}
+
+/**
+ * @brief Consumes a page the way the initial ledger load does: the cache gets a copy of each object and the key and
+ * blob are moved to the backend.
+ */
+template <bool MoveIntoCache>
+void
+consume(ResponseType& response, data::LedgerCache& cache, uint32_t seq)
+{
+    std::vector<data::LedgerObject> cacheUpdates;
+    std::vector<std::string> written;
+    cacheUpdates.reserve(OBJECTS_PER_PAGE);
+    written.reserve(2 * OBJECTS_PER_PAGE);
+
+    for (auto& obj : *response.mutable_ledger_objects()->mutable_objects()) {
+        auto const key = ripple::uint256::fromVoidChecked(obj.key());
+        cacheUpdates.push_back({*key, {obj.data().begin(), obj.data().end()}});
+        written.push_back(std::move(*obj.mutable_key()));
+        written.push_back(std::move(*obj.mutable_data()));
+    }
+
+    if constexpr (MoveIntoCache) {
+        cache.update(std::move(cacheUpdates), seq);
+    } else {
+        cache.update(cacheUpdates, seq);
+    }
+
+    benchmark::DoNotOptimize(written.data());
+}
+
+template <bool MoveIntoCache, typename ParseType>
+void
+runPages(benchmark::State& state, ParseType&& parse)
+{
+    PrometheusService::init();
+    data::LedgerCache cache;
+    auto const serialized = makeSerializedPage();
+    uint32_t seq = 1;
+
+    allocationCount = 0;
+    countAllocations = true;
+    for ([[maybe_unused]] auto _ : state) {
+        auto* response = parse(serialized);
+        if (response == nullptr) {
+            state.SkipWithError("Failed to parse page");
+            break;
+        }
+
+        consume<MoveIntoCache>(*response, cache, seq++);
+    }
+    countAllocations = false;
+
+    state.counters["allocations_per_page"] =
+        benchmark::Counter(static_cast<double>(allocationCount), benchmark::Counter::kAvgIterations);
+    state.counters["objects_per_second"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * OBJECTS_PER_PAGE), benchmark::Counter::kIsRate
+    );
+}
+
+}  // namespace
+
+// Counts allocations of the thread running a benchmark; everything else goes straight to malloc as usual. This file is
+// built into clio_allocation_benchmark, so the replacement does not affect the other benchmarks.
+void*
+operator new(std::size_t size)
+{
+    if (countAllocations)
+        ++allocationCount;
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr)  // NOLINT(cppcoreguidelines-no-malloc)
+        return ptr;
+
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);  // NOLINT(cppcoreguidelines-no-malloc)
+}
+
+// Every page is parsed into a heap allocated response and copied into the cache, as before the arena was used
+static void
+benchmarkLedgerDataPageOnHeap(benchmark::State& state)
+{
+    ResponseType response;
+    runPages<false>(state, [&response](std::string const& serialized) {
+        response = ResponseType{};
+        return response.ParseFromString(serialized) ? &response : nullptr;
+    });
+}
+
+// Every page is parsed into a response on an arena that is reset per page and its objects are moved into the cache
+static void
+benchmarkLedgerDataPageOnArena(benchmark::State& state)
+{
+    google::protobuf::ArenaOptions options;
+    options.start_block_size = ARENA_START_BLOCK_SIZE;
+    options.max_block_size = ARENA_MAX_BLOCK_SIZE;
+    google::protobuf::Arena arena{options};
+
+    runPages<true>(state, [&arena](std::string const& serialized) {
+        arena.Reset();
+        auto* response = google::protobuf::Arena::CreateMessage<ResponseType>(&arena);
+        return response->ParseFromString(serialized) ? response : nullptr;
+    });
+}
+
+BENCHMARK(benchmarkLedgerDataPageOnHeap);
+BENCHMARK(benchmarkLedgerDataPageOnArena);
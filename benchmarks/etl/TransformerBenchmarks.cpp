@@ -0,0 +1,460 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/BackendInterface.hpp"
+#include "data/DBHelpers.hpp"
+#include "data/Types.hpp"
+#include "etl/SystemState.hpp"
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/ExtractionDataPipe.hpp"
+#include "etl/impl/LedgerFetcher.hpp"
+#include "etl/impl/LedgerLoader.hpp"
+#include "etl/impl/LedgerRecording.hpp"
+#include "etl/impl/Transformer.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <benchmark/benchmark.h>
+#include <boost/asio/spawn.hpp>
+#include <boost/json/object.hpp>
+#include <boost/log/core/core.hpp>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/protocol/AccountID.h>
+#include <xrpl/protocol/LedgerHeader.h>
+#include <xrpl/protocol/Serializer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr auto SYNTHETIC_LEDGERS = 1'000u;
+constexpr auto SYNTHETIC_OBJECTS_PER_LEDGER = 500u;
+constexpr auto SYNTHETIC_OBJECT_SIZE = 200u;
+constexpr auto SYNTHETIC_START_SEQUENCE = 1'000u;
+
+// set to a file written with `etl_recording_file` to benchmark real ledgers instead of synthetic ones
+constexpr auto RECORDING_ENV = "CLIO_BENCHMARK_LEDGER_RECORDING";
+
+using GetLedgerResponseType = etl::impl::LedgerReplay::GetLedgerResponseType;
+using FetcherType = etl::impl::LedgerFetcher<etl::impl::LedgerReplay>;
+using LoaderType = etl::impl::LedgerLoader<etl::impl::LedgerReplay, FetcherType>;
+using DataPipeType = etl::impl::ExtractionDataPipe<GetLedgerResponseType>;
+
+/**
+ * @brief A backend that drops all writes, so only the ETL side of the write path is measured.
+ *
+ * The ledger cache is a real in-memory cache as it is updated by the Transformer for every ledger.
+ */
+class NullBackend : public data::BackendInterface {
+    std::atomic_size_t writes_ = 0;
+
+public:
+    std::optional<ripple::LedgerHeader>
+    fetchLedgerBySequence(std::uint32_t, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::optional<ripple::LedgerHeader>
+    fetchLedgerByHash(ripple::uint256 const&, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::optional<std::uint32_t>
+    fetchLatestLedgerSequence(boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::vector<data::LedgerCloseTime>
+    fetchLedgerCloseTimes(std::uint32_t, std::uint32_t, boost::asio::yield_context) const override
+    {
+        return {};
+    }
+
+    std::vector<ripple::uint256>
+    fetchAccountRoots(std::uint32_t, std::uint32_t, std::uint32_t, boost::asio::yield_context) const override
+    {
+        return {};
+    }
+
+    std::optional<data::TransactionAndMetadata>
+    fetchTransaction(ripple::uint256 const&, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::vector<data::TransactionAndMetadata>
+    fetchTransactions(std::vector<ripple::uint256> const&, boost::asio::yield_context) const override
+    {
+        return {};
+    }
+
+    data::TransactionsAndCursor
+    fetchAccountTransactions(
+        ripple::AccountID const&,
+        std::uint32_t,
+        bool,
+        std::optional<data::TransactionsCursor> const&,
+        boost::asio::yield_context
+    ) const override
+    {
+        return {};
+    }
+
+    std::optional<data::TransactionAndMetadata>
+    fetchTransactionByIndex(std::uint32_t, std::uint32_t, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::vector<data::TransactionAndMetadata>
+    fetchAllTransactionsInLedger(std::uint32_t, boost::asio::yield_context) const override
+    {
+        return {};
+    }
+
+    std::vector<ripple::uint256>
+    fetchAllTransactionHashesInLedger(std::uint32_t, boost::asio::yield_context) const override
+    {
+        return {};
+    }
+
+    std::optional<data::NFT>
+    fetchNFT(ripple::uint256 const&, std::uint32_t, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    data::TransactionsAndCursor
+    fetchNFTTransactions(
+        ripple::uint256 const&,
+        std::uint32_t,
+        bool,
+        std::optional<data::TransactionsCursor> const&,
+        boost::asio::yield_context
+    ) const override
+    {
+        return {};
+    }
+
+    data::NFTsAndCursor
+    fetchNFTsByIssuer(
+        ripple::AccountID const&,
+        std::optional<std::uint32_t> const&,
+        std::uint32_t,
+        std::uint32_t,
+        std::optional<ripple::uint256> const&,
+        boost::asio::yield_context
+    ) const override
+    {
+        return {};
+    }
+
+    std::optional<data::Blob>
+    doFetchLedgerObject(ripple::uint256 const&, std::uint32_t, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::optional<std::uint32_t>
+    doFetchLedgerObjectSeq(ripple::uint256 const&, std::uint32_t, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::vector<data::Blob>
+    doFetchLedgerObjects(std::vector<ripple::uint256> const& keys, std::uint32_t, boost::asio::yield_context)
+        const override
+    {
+        return std::vector<data::Blob>(keys.size());
+    }
+
+    std::vector<data::LedgerObject>
+    fetchLedgerDiff(std::uint32_t, boost::asio::yield_context) const override
+    {
+        return {};
+    }
+
+    std::optional<ripple::uint256>
+    doFetchSuccessorKey(ripple::uint256, std::uint32_t, boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    std::optional<data::LedgerRange>
+    hardFetchLedgerRange(boost::asio::yield_context) const override
+    {
+        return std::nullopt;
+    }
+
+    void
+    writeLedger(ripple::LedgerHeader const&, std::string&&) override
+    {
+        ++writes_;
+    }
+
+    void
+    writeTransaction(std::string&&, std::uint32_t, std::uint32_t, std::uint32_t, std::string&&, std::string&&)
+        override
+    {
+        ++writes_;
+    }
+
+    void
+    writeNFTs(std::vector<NFTsData> const& data) override
+    {
+        writes_ += data.size();
+    }
+
+    void
+    writeAccountTransactions(std::vector<AccountTransactionsData> data) override
+    {
+        writes_ += data.size();
+    }
+
+    void
+    writeNFTTransactions(std::vector<NFTTransactionsData> const& data) override
+    {
+        writes_ += data.size();
+    }
+
+    void
+    writeLedgerStateObject(std::string&&, std::uint32_t, std::string&&) override
+    {
+        ++writes_;
+    }
+
+    void
+    writeSuccessor(std::string&&, std::uint32_t, std::string&&) override
+    {
+        ++writes_;
+    }
+
+    bool
+    advanceMinSequence(std::uint32_t, std::uint32_t) override
+    {
+        return true;
+    }
+
+    bool
+    tryAcquireWriterLease(std::string const&, std::chrono::milliseconds) override
+    {
+        return true;
+    }
+
+    void
+    releaseWriterLease(std::string const&) override
+    {
+    }
+
+    void
+    deleteLedgerHistory(LedgerHistoryData const&, std::uint32_t, boost::asio::yield_context) override
+    {
+    }
+
+    void
+    startWrites() const override
+    {
+    }
+
+    void
+    waitForWritesToFinish() override
+    {
+    }
+
+    bool
+    isTooBusy() const override
+    {
+        return false;
+    }
+
+    boost::json::object
+    stats() const override
+    {
+        return {{"writes", writes_.load()}};
+    }
+
+private:
+    void
+    doWriteLedgerObject(std::string&&, std::uint32_t, std::string&&) override
+    {
+        ++writes_;
+    }
+
+    bool
+    doFinishWrites() override
+    {
+        return true;
+    }
+};
+
+struct NullPublisher {
+    void
+    publish(etl::impl::CommittedLedger ledger)
+    {
+        benchmark::DoNotOptimize(ledger);
+    }
+
+    static bool
+    broadcastsLedgers()
+    {
+        return false;
+    }
+};
+
+struct NullAmendmentBlockHandler {
+    void
+    onAmendmentBlock()
+    {
+    }
+};
+
+std::string
+randomBytes(std::mt19937_64& engine, std::size_t size)
+{
+    std::string bytes(size, '\0');
+    for (auto& byte : bytes)
+        byte = static_cast<char>(engine());
+    return bytes;
+}
+
+/**
+ * @brief Ledgers with random ledger objects and their neighbors, but without transactions.
+ *
+ * Transactions have to be valid to be processed, so only recordings exercise the transaction path.
+ */
+std::vector<GetLedgerResponseType>
+makeSyntheticLedgers()
+{
+    std::mt19937_64 engine{0};  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+    std::vector<GetLedgerResponseType> ledgers(SYNTHETIC_LEDGERS);
+
+    for (auto i = 0u; i < SYNTHETIC_LEDGERS; ++i) {
+        ripple::LedgerHeader header;
+        header.seq = SYNTHETIC_START_SEQUENCE + i;
+        header.hash = ripple::uint256{header.seq};
+
+        ripple::Serializer serializer;
+        ripple::addRaw(header, serializer, /* includeHash = */ true);
+
+        auto& ledger = ledgers[i];
+        ledger.set_ledger_header(serializer.peekData().data(), serializer.peekData().size());
+        ledger.set_validated(true);
+        ledger.set_object_neighbors_included(true);
+
+        for (auto j = 0u; j < SYNTHETIC_OBJECTS_PER_LEDGER; ++j) {
+            auto* object = ledger.mutable_ledger_objects()->add_objects();
+            object->set_key(randomBytes(engine, ripple::uint256::size()));
+            object->set_data(randomBytes(engine, SYNTHETIC_OBJECT_SIZE));
+            object->set_mod_type(
+                j % 2 == 0 ? etl::impl::LedgerReplay::RawLedgerObjectType::CREATED
+                           : etl::impl::LedgerReplay::RawLedgerObjectType::MODIFIED
+            );
+            object->set_predecessor(randomBytes(engine, ripple::uint256::size()));
+            object->set_successor(randomBytes(engine, ripple::uint256::size()));
+        }
+    }
+
+    return ledgers;
+}
+
+std::shared_ptr<etl::impl::LedgerReplay>
+loadLedgers()
+{
+    if (auto const* path = std::getenv(RECORDING_ENV); path != nullptr)  // NOLINT(concurrency-mt-unsafe)
+        return std::make_shared<etl::impl::LedgerReplay>(path);
+
+    return std::make_shared<etl::impl::LedgerReplay>(makeSyntheticLedgers());
+}
+
+}  // namespace
+
+/**
+ * @brief Replays the ledgers through an extractor thread and the Transformer into a backend that drops all writes.
+ *
+ * The extractor copies every ledger out of the replay like it would receive it from rippled; it runs concurrently so
+ * the Transformer is the bottleneck.
+ */
+static void
+benchmarkTransformer(benchmark::State& state)
+{
+    PrometheusService::init();
+    boost::log::core::get()->set_logging_enabled(false);
+
+    auto const replay = loadLedgers();
+    if (replay->size() == 0) {
+        state.SkipWithError("No ledgers to replay");
+        return;
+    }
+
+    // a missing ledger ends the replay, just like a shutdown ends the extraction
+    auto const firstSequence = *replay->firstSequence();
+    auto endSequence = firstSequence;
+    std::size_t objectsPerRun = 0;
+    for (auto ledger = replay->fetchLedger(endSequence, true, true); ledger;
+         ledger = replay->fetchLedger(++endSequence, true, true)) {
+        objectsPerRun += ledger->ledger_objects().objects_size();
+    }
+    auto const ledgersPerRun = endSequence - firstSequence;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto backend = std::make_shared<NullBackend>();
+        etl::SystemState systemState;
+        FetcherType fetcher{backend, replay};
+        LoaderType loader{backend, replay, fetcher, systemState};
+        DataPipeType pipe{1, firstSequence};
+        NullPublisher publisher;
+        NullAmendmentBlockHandler amendmentBlockHandler;
+        state.ResumeTiming();
+
+        std::thread extractor{[&] {
+            for (auto seq = firstSequence; seq < endSequence; ++seq)
+                pipe.push(seq, fetcher.fetchDataAndDiff(seq));
+            pipe.finish(endSequence);
+        }};
+
+        etl::impl::Transformer<DataPipeType, LoaderType, NullPublisher, NullAmendmentBlockHandler> transformer{
+            pipe, backend, loader, publisher, amendmentBlockHandler, firstSequence, systemState
+        };
+        transformer.waitTillFinished();
+        extractor.join();
+    }
+
+    state.counters["ledgers_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * ledgersPerRun), benchmark::Counter::kIsRate);
+    state.counters["objects_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * objectsPerRun), benchmark::Counter::kIsRate);
+}
+
+// Set CLIO_BENCHMARK_LEDGER_RECORDING to replay a recording instead of synthetic ledgers
+BENCHMARK(benchmarkTransformer)->Unit(benchmark::kMillisecond)->UseRealTime();
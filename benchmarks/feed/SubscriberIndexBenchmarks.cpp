@@ -0,0 +1,177 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "feed/Types.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
+#include "util/Taggable.hpp"
+#include "util/config/Config.hpp"
+#include "web/interface/ConnectionBase.hpp"
+
+#include <benchmark/benchmark.h>
+#include <boost/beast/http/status.hpp>
+#include <xrpl/protocol/AccountID.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr auto NUM_SUBSCRIBERS = 100'000u;
+constexpr auto NUM_ACCOUNTS = 10'000u;
+constexpr auto ACCOUNTS_PER_SUBSCRIBER = 2u;
+constexpr auto ACCOUNTS_PER_TRANSACTION = 8u;
+
+using namespace feed::impl;
+
+class NullSubscriber : public web::ConnectionBase {
+    std::size_t& sent_;
+
+public:
+    NullSubscriber(util::TagDecoratorFactory const& tagFactory, std::size_t& sent)
+        : web::ConnectionBase(tagFactory, ""), sent_(sent)
+    {
+    }
+
+    void
+    send(std::shared_ptr<std::string> msg) override
+    {
+        sent_ += msg->size();
+    }
+
+    void
+    // NOLINTNEXTLINE(cppcoreguidelines-rvalue-reference-param-not-moved)
+    send(std::string&&, boost::beast::http::status) override
+    {
+    }
+};
+
+struct Subscribers {
+    util::TagDecoratorFactory tagFactory{util::Config{}};
+    std::size_t sent = 0;
+    std::vector<feed::SubscriberSharedPtr> all;
+
+    Subscribers()
+    {
+        all.reserve(NUM_SUBSCRIBERS);
+        for (auto i = 0u; i < NUM_SUBSCRIBERS; ++i)
+            all.push_back(std::make_shared<NullSubscriber>(tagFactory, sent));
+    }
+};
+
+ripple::AccountID
+account(std::uint64_t index)
+{
+    return ripple::AccountID{index};
+}
+
+}  // namespace
+
+// Every message of a stream goes to all of its subscribers
+static void
+benchmarkStreamFanOut(benchmark::State& state)
+{
+    Subscribers subscribers;
+    SubscriberIds ids;
+    SubscriberSet set{ids};
+    for (auto const& subscriber : subscribers.all)
+        set.add(subscriber);
+
+    auto const msg = std::make_shared<std::string>(256, 'x');
+    for ([[maybe_unused]] auto _ : state) {
+        set.forEach([&msg](SubscriberId, feed::SubscriberSharedPtr const& subscriber) { subscriber->send(msg); });
+    }
+
+    benchmark::DoNotOptimize(subscribers.sent);
+    state.counters["sends_per_second"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_SUBSCRIBERS), benchmark::Counter::kIsRate
+    );
+}
+
+// A transaction goes once to each subscriber of any of the accounts it affects, like the account stream does
+static void
+benchmarkAccountFanOut(benchmark::State& state)
+{
+    Subscribers subscribers;
+    SubscriberIds ids;
+    SubscriberMap<ripple::AccountID> map{ids};
+    std::mt19937_64 engine{0};  // NOLINT(cert-msc32-c,cert-msc51-cpp)
+    std::uniform_int_distribution<std::uint64_t> accounts{1, NUM_ACCOUNTS};
+
+    for (auto const& subscriber : subscribers.all) {
+        for (auto i = 0u; i < ACCOUNTS_PER_SUBSCRIBER; ++i)
+            map.add(account(accounts(engine)), subscriber);
+    }
+
+    std::vector<std::vector<ripple::AccountID>> transactions(1024);
+    for (auto& affected : transactions) {
+        for (auto i = 0u; i < ACCOUNTS_PER_TRANSACTION; ++i)
+            affected.push_back(account(accounts(engine)));
+    }
+
+    NotifiedSet notified;
+    auto const msg = std::make_shared<std::string>(256, 'x');
+    std::size_t next = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        notified.clear();
+        for (auto const& affected : transactions[next++ % transactions.size()]) {
+            map.forEach(affected, [&](SubscriberId id, feed::SubscriberSharedPtr const& subscriber) {
+                if (notified.insert(id))
+                    subscriber->send(msg);
+            });
+        }
+    }
+
+    benchmark::DoNotOptimize(subscribers.sent);
+    state.counters["transactions_per_second"] =
+        benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+
+// Subscribers keep coming and going while the stream is published, so every publish takes a new snapshot
+static void
+benchmarkStreamFanOutWithChurn(benchmark::State& state)
+{
+    Subscribers subscribers;
+    SubscriberIds ids;
+    SubscriberSet set{ids};
+    for (auto const& subscriber : subscribers.all)
+        set.add(subscriber);
+
+    auto const msg = std::make_shared<std::string>(256, 'x');
+    std::size_t next = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        auto const& leaving = subscribers.all[next++ % subscribers.all.size()];
+        set.remove(leaving.get());
+        set.add(leaving);
+        set.forEach([&msg](SubscriberId, feed::SubscriberSharedPtr const& subscriber) { subscriber->send(msg); });
+    }
+
+    benchmark::DoNotOptimize(subscribers.sent);
+    state.counters["sends_per_second"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * NUM_SUBSCRIBERS), benchmark::Counter::kIsRate
+    );
+}
+
+BENCHMARK(benchmarkStreamFanOut);
+BENCHMARK(benchmarkAccountFanOut);
+BENCHMARK(benchmarkStreamFanOutWithChurn);
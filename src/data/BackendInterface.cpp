@@ -302,6 +302,20 @@ BackendInterface::setRange(uint32_t min, uint32_t max, bool force)
     range = {min, max};
 }
 
+void
+BackendInterface::updateMinSequence(uint32_t newMin)
+{
+    std::scoped_lock const lck(rngMtx_);
+
+    if (not range or newMin > range->maxSequence)
+        return;
+
+    if (newMin > range->minSequence)
+        closeTimeIndex_.removeBelow(newMin);
+
+    range->minSequence = newMin;
+}
+
 LedgerPage
 BackendInterface::fetchLedgerPage(
     std::optional<ripple::uint256> const& cursor,
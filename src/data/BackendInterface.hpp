@@ -21,6 +21,7 @@
 
 #include "data/DBHelpers.hpp"
 #include "data/LedgerCache.hpp"
+#include "data/LedgerCloseTimeIndex.hpp"
 #include "data/Types.hpp"
 #include "etl/CorruptionDetector.hpp"
 #include "util/log/Logger.hpp"
@@ -140,6 +141,7 @@ protected:
     mutable std::shared_mutex rngMtx_;
     std::optional<LedgerRange> range;
     LedgerCache cache_;
+    LedgerCloseTimeIndex closeTimeIndex_;
     std::optional<etl::CorruptionDetector<LedgerCache>> corruptionDetector_;
 
 public:
@@ -165,6 +167,24 @@ public:
         return cache_;
     }
 
+    /**
+     * @return Immutable index of ledger close times
+     */
+    LedgerCloseTimeIndex const&
+    closeTimeIndex() const
+    {
+        return closeTimeIndex_;
+    }
+
+    /**
+     * @return Mutable index of ledger close times
+     */
+    LedgerCloseTimeIndex&
+    closeTimeIndex()
+    {
+        return closeTimeIndex_;
+    }
+
     /**
      * @brief Sets the corruption detector.
      *
@@ -205,6 +225,18 @@ public:
     virtual std::optional<std::uint32_t>
     fetchLatestLedgerSequence(boost::asio::yield_context yield) const = 0;
 
+    /**
+     * @brief Fetches the persisted close times of a range of ledgers.
+     *
+     * @param firstSequence The first sequence to fetch the close time for
+     * @param lastSequence The last sequence to fetch the close time for
+     * @param yield The coroutine context
+     * @return The close times found, sorted by sequence; ledgers without a persisted close time are skipped
+     */
+    virtual std::vector<LedgerCloseTime>
+    fetchLedgerCloseTimes(std::uint32_t firstSequence, std::uint32_t lastSequence, boost::asio::yield_context yield)
+        const = 0;
+
     /**
      * @brief Fetch the current ledger range.
      *
@@ -244,6 +276,16 @@ public:
     void
     setRange(uint32_t min, uint32_t max, bool force = false);
 
+    /**
+     * @brief Updates the cached minimum of the range, e.g. after online deletion or a backfill changed it in the DB.
+     *
+     * Does nothing if the range is not set yet or if newMin is greater than maxSequence.
+     *
+     * @param newMin The new minimum sequence available
+     */
+    void
+    updateMinSequence(uint32_t newMin);
+
     /**
      * @brief Fetch the fees from a specific ledger sequence.
      *
@@ -293,6 +335,32 @@ public:
         boost::asio::yield_context yield
     ) const = 0;
 
+    /**
+     * @brief Fetches a transaction by its index within a ledger, e.g. to resolve a CTID.
+     *
+     * @param ledgerSequence The ledger sequence the transaction was validated in
+     * @param transactionIndex The index of the transaction within the ledger
+     * @param yield The coroutine context
+     * @return The transaction if the index has an entry for it; nullopt otherwise
+     */
+    virtual std::optional<TransactionAndMetadata>
+    fetchTransactionByIndex(
+        std::uint32_t ledgerSequence,
+        std::uint32_t transactionIndex,
+        boost::asio::yield_context yield
+    ) const = 0;
+
+    /**
+     * @brief Fetches the first ledger written to the transaction index used by @ref fetchTransactionByIndex.
+     *
+     * Ledgers below it were written before the index existed and have no entries in it.
+     *
+     * @param yield The coroutine context
+     * @return The sequence of the first indexed ledger; nullopt if no ledger was indexed yet
+     */
+    virtual std::optional<std::uint32_t>
+    fetchFirstIndexedTransactionSequence(boost::asio::yield_context yield) const = 0;
+
     /**
      * @brief Fetches all transactions from a specific ledger.
      *
@@ -575,11 +643,24 @@ public:
     virtual void
     writeLedgerObject(std::string&& key, std::uint32_t seq, std::string&& blob);
 
+    /**
+     * @brief Writes an object of a full ledger state, e.g. the state a backfill downloads below the ledger range.
+     *
+     * Unlike writeLedgerObject, the object is not added to the diff of the ledger.
+     *
+     * @param key The key to write the ledger object under
+     * @param seq The ledger sequence to write for
+     * @param blob The data to write
+     */
+    virtual void
+    writeLedgerStateObject(std::string&& key, std::uint32_t seq, std::string&& blob) = 0;
+
     /**
      * @brief Writes a new transaction.
      *
      * @param hash The hash of the transaction
      * @param seq The ledger sequence to write for
+     * @param transactionIndex The index of the transaction within the ledger
      * @param date The timestamp of the entry
      * @param transaction The transaction data to write
      * @param metadata The metadata to write
@@ -588,6 +669,7 @@ public:
     writeTransaction(
         std::string&& hash,
         std::uint32_t seq,
+        std::uint32_t transactionIndex,
         std::uint32_t date,
         std::string&& transaction,
         std::string&& metadata
@@ -627,6 +709,58 @@ public:
     virtual void
     writeSuccessor(std::string&& key, std::uint32_t seq, std::string&& successor) = 0;
 
+    /**
+     * @brief Atomically advances the minimum sequence stored in the DB.
+     *
+     * Online deletion calls this before removing the history below the new minimum so that readers stop serving it
+     * first; a backfill calls it to lower the minimum after the history below it was written. On success the cached
+     * range is updated as well.
+     *
+     * @param currentMin The minimum sequence the caller expects to be stored in the DB
+     * @param newMin The new minimum sequence
+     * @return true on success; false if the stored minimum is not currentMin anymore
+     */
+    virtual bool
+    advanceMinSequence(std::uint32_t currentMin, std::uint32_t newMin) = 0;
+
+    /**
+     * @brief Deletes the history of a ledger that fell out of the available range.
+     *
+     * Removes the ledger header, its transactions and diff, the account and NFT transaction index entries pointing to
+     * it and all versions of the modified objects that are not needed to serve ledgers starting at minSequence.
+     *
+     * @param data The keys referencing the ledger to delete
+     * @param minSequence The minimum sequence that has to stay readable; must be greater than data.ledgerSequence
+     * @param yield The coroutine context
+     */
+    virtual void
+    deleteLedgerHistory(LedgerHistoryData const& data, std::uint32_t minSequence, boost::asio::yield_context yield) = 0;
+
+    /**
+     * @brief Takes or renews the lease that allows a single process to write new ledgers.
+     *
+     * The lease is stored in the DB and updated atomically. It can be taken if it is held by the same owner, if it
+     * expired or if nobody ever took it. The expiry is computed from the local clock, so the clocks of the processes
+     * sharing the DB must be synchronized.
+     *
+     * @param owner A unique identifier of the calling process
+     * @param duration How long the lease stays valid unless it is renewed
+     * @return true if owner holds the lease now; false if another process holds it
+     * @throw DatabaseTimeout if the lease could not be read or updated in time
+     */
+    virtual bool
+    tryAcquireWriterLease(std::string const& owner, std::chrono::milliseconds duration) = 0;
+
+    /**
+     * @brief Gives up the writer lease so that another process can take it over immediately.
+     *
+     * Does nothing if the lease is held by another process.
+     *
+     * @param owner The identifier the lease was taken with
+     */
+    virtual void
+    releaseWriterLease(std::string const& owner) = 0;
+
     /**
      * @brief Starts a write transaction with the DB. No-op for cassandra.
      *
@@ -646,6 +780,14 @@ public:
     bool
     finishWrites(std::uint32_t ledgerSequence);
 
+    /**
+     * @brief Blocks until all writes submitted so far are done.
+     *
+     * Unlike finishWrites this does not touch the ledger range.
+     */
+    virtual void
+    waitForWritesToFinish() = 0;
+
     /**
      * @return true if database is overwhelmed; false otherwise
      */
@@ -43,6 +43,7 @@
 #include <xrpl/protocol/LedgerHeader.h>
 #include <xrpl/protocol/nft.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
@@ -50,6 +51,7 @@
 #include <iterator>
 #include <limits>
 #include <optional>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -68,6 +70,18 @@ namespace data::cassandra {
  */
 template <SomeSettingsProvider SettingsProviderType, SomeExecutionStrategy ExecutionStrategyType>
 class BasicCassandraBackend : public BackendInterface {
+    // number of consecutive ledgers stored in one partition of the ledger_close_times table
+    static constexpr std::uint32_t CLOSE_TIME_BUCKET_SIZE = 1u << 16;
+
+    // upper bound on the number of tx buckets read in parallel by one round trip of fetchBucketedTransactions
+    static constexpr std::uint32_t MAX_BUCKET_READ_BATCH = 64u;
+
+    // the writer_lease table has a single row
+    static inline std::string const WRITER_LEASE_NAME = "etl";
+
+    // the row of the index_starts table recording the first ledger written to ledger_transactions_by_index
+    static inline std::string const TRANSACTION_INDEX_NAME = "ledger_transactions_by_index";
+
     util::Logger log_{"Backend"};
 
     SettingsProviderType settingsProvider_;
@@ -79,6 +93,12 @@ class BasicCassandraBackend : public BackendInterface {
 
     std::atomic_uint32_t ledgerSequence_ = 0u;
 
+    // whether this process made sure the start of the transaction index is recorded
+    std::atomic_bool transactionIndexStartRecorded_ = false;
+
+    // the first ledger of the transaction index once known; it never changes after it was recorded
+    mutable std::atomic_uint32_t firstIndexedTransactionSequence_ = 0u;
+
 public:
     /**
      * @brief Create a new cassandra/scylla backend instance.
@@ -114,6 +134,8 @@ public:
             throw;
         }
 
+        checkTxBucketing();
+
         LOG(log_.info()) << "Created (revamped) CassandraBackend";
     }
 
@@ -130,6 +152,21 @@ public:
         if (!rng)
             return {{}, {}};
 
+        if (auto const bucketSize = settingsProvider_.getTxBucketSize(); bucketSize) {
+            return fetchBucketedTransactions(
+                account,
+                schema_->selectAccountTxBucketed,
+                schema_->selectAccountTxBucketedForward,
+                false,
+                *bucketSize,
+                *rng,
+                limit,
+                forward,
+                cursorIn,
+                yield
+            );
+        }
+
         Statement const statement = [this, forward, &account]() {
             if (forward)
                 return schema_->selectAccountTxForward.bind(account);
@@ -200,6 +237,12 @@ public:
             return false;
         }
 
+        if (not transactionIndexStartRecorded_) {
+            // IF NOT EXISTS keeps the first ledger ever indexed, no matter how many writers recorded it since
+            executor_.writeSync(schema_->insertIndexStart, TRANSACTION_INDEX_NAME, ledgerSequence_);
+            transactionIndexStartRecorded_ = true;
+        }
+
         LOG(log_.info()) << "Committed ledger " << ledgerSequence_;
         return true;
     }
@@ -211,6 +254,13 @@ public:
 
         executor_.write(schema_->insertLedgerHash, ledgerHeader.hash, ledgerHeader.seq);
 
+        executor_.write(
+            schema_->insertLedgerCloseTime,
+            ledgerHeader.seq / CLOSE_TIME_BUCKET_SIZE,
+            ledgerHeader.seq,
+            ledgerHeader.closeTime.time_since_epoch().count()
+        );
+
         ledgerSequence_ = ledgerHeader.seq;
     }
 
@@ -314,6 +364,33 @@ public:
         return std::nullopt;
     }
 
+    std::vector<LedgerCloseTime>
+    fetchLedgerCloseTimes(
+        std::uint32_t const firstSequence,
+        std::uint32_t const lastSequence,
+        boost::asio::yield_context yield
+    ) const override
+    {
+        std::vector<LedgerCloseTime> closeTimes;
+        for (auto bucket = firstSequence / CLOSE_TIME_BUCKET_SIZE; bucket <= lastSequence / CLOSE_TIME_BUCKET_SIZE;
+             ++bucket) {
+            auto const res =
+                executor_.read(yield, schema_->selectLedgerCloseTimes, bucket, firstSequence, lastSequence);
+            if (not res) {
+                LOG(log_.error()) << "Could not fetch ledger close times: " << res.error() << "; bucket = " << bucket;
+                return {};
+            }
+
+            for (auto [seq, closeTime] : extract<std::uint32_t, std::uint32_t>(res.value())) {
+                closeTimes.push_back(
+                    {.sequence = seq, .closeTime = ripple::NetClock::time_point{ripple::NetClock::duration{closeTime}}}
+                );
+            }
+        }
+
+        return closeTimes;
+    }
+
     std::vector<TransactionAndMetadata>
     fetchAllTransactionsInLedger(std::uint32_t const ledgerSequence, boost::asio::yield_context yield) const override
     {
@@ -401,6 +478,21 @@ public:
         if (!rng)
             return {{}, {}};
 
+        if (auto const bucketSize = settingsProvider_.getTxBucketSize(); bucketSize) {
+            return fetchBucketedTransactions(
+                tokenID,
+                schema_->selectNFTTxBucketed,
+                schema_->selectNFTTxBucketedForward,
+                true,
+                *bucketSize,
+                *rng,
+                limit,
+                forward,
+                cursorIn,
+                yield
+            );
+        }
+
         Statement const statement = [this, forward, &tokenID]() {
             if (forward)
                 return schema_->selectNFTTxForward.bind(tokenID);
@@ -602,6 +694,46 @@ public:
         return std::nullopt;
     }
 
+    std::optional<TransactionAndMetadata>
+    fetchTransactionByIndex(
+        std::uint32_t const ledgerSequence,
+        std::uint32_t const transactionIndex,
+        boost::asio::yield_context yield
+    ) const override
+    {
+        auto const res = executor_.read(yield, schema_->selectTransactionHashByIndex, ledgerSequence, transactionIndex);
+        if (not res) {
+            LOG(log_.error()) << "Could not fetch transaction hash by index: " << res.error();
+            return std::nullopt;
+        }
+
+        if (auto const hash = res->template get<ripple::uint256>(); hash)
+            return fetchTransaction(*hash, yield);
+
+        LOG(log_.debug()) << "Could not fetch transaction hash by index - no rows";
+        return std::nullopt;
+    }
+
+    std::optional<std::uint32_t>
+    fetchFirstIndexedTransactionSequence(boost::asio::yield_context yield) const override
+    {
+        if (auto const cached = firstIndexedTransactionSequence_.load(); cached != 0u)
+            return cached;
+
+        auto const res = executor_.read(yield, schema_->selectIndexStart, TRANSACTION_INDEX_NAME);
+        if (not res) {
+            LOG(log_.error()) << "Could not fetch the start of the transaction index: " << res.error();
+            return std::nullopt;
+        }
+
+        if (auto const sequence = res->template get<std::uint32_t>(); sequence) {
+            firstIndexedTransactionSequence_ = *sequence;
+            return sequence;
+        }
+
+        return std::nullopt;
+    }
+
     std::optional<ripple::uint256>
     doFetchSuccessorKey(ripple::uint256 key, std::uint32_t const ledgerSequence, boost::asio::yield_context yield)
         const override
@@ -713,10 +845,21 @@ public:
     {
         std::vector<ripple::uint256> liveAccounts;
         std::optional<ripple::AccountID> lastItem;
+        std::uint32_t lastBucket = 0;
+        std::set<ripple::uint256> seenAccounts;
+        auto const isBucketed = settingsProvider_.getTxBucketSize().has_value();
 
         while (liveAccounts.size() < number) {
-            Statement const statement = lastItem ? schema_->selectAccountFromToken.bind(*lastItem, Limit{pageSize})
-                                                 : schema_->selectAccountFromBegining.bind(Limit{pageSize});
+            Statement const statement = [&]() {
+                if (isBucketed) {
+                    return lastItem
+                        ? schema_->selectAccountBucketedFromToken.bind(*lastItem, lastBucket, Limit{pageSize})
+                        : schema_->selectAccountBucketedFromBegining.bind(Limit{pageSize});
+                }
+
+                return lastItem ? schema_->selectAccountFromToken.bind(*lastItem, Limit{pageSize})
+                                : schema_->selectAccountFromBegining.bind(Limit{pageSize});
+            }();
 
             auto const res = executor_.read(yield, statement);
             if (res) {
@@ -725,11 +868,22 @@ public:
                     LOG(log_.debug()) << "No rows returned";
                     break;
                 }
-                // The results should not contain duplicates, we just filter out deleted accounts
+                // The results should not contain duplicates, we just filter out deleted accounts.
+                // Note: with bucketed account_tx the same account may be returned once per bucket.
                 std::vector<ripple::uint256> fullAccounts;
-                for (auto [account] : extract<ripple::AccountID>(results)) {
-                    fullAccounts.push_back(ripple::keylet::account(account).key);
-                    lastItem = account;
+                if (isBucketed) {
+                    for (auto [account, bucket] : extract<ripple::AccountID, std::uint32_t>(results)) {
+                        if (auto const key = ripple::keylet::account(account).key; seenAccounts.insert(key).second)
+                            fullAccounts.push_back(key);
+
+                        lastItem = account;
+                        lastBucket = bucket;
+                    }
+                } else {
+                    for (auto [account] : extract<ripple::AccountID>(results)) {
+                        fullAccounts.push_back(ripple::keylet::account(account).key);
+                        lastItem = account;
+                    }
                 }
                 auto const objs = doFetchLedgerObjects(fullAccounts, seq, yield);
 
@@ -807,6 +961,13 @@ public:
         executor_.write(schema_->insertObject, std::move(key), seq, std::move(blob));
     }
 
+    void
+    writeLedgerStateObject(std::string&& key, std::uint32_t const seq, std::string&& blob) override
+    {
+        ASSERT(key.size() == ripple::uint256::size(), "Key must be 256 bits");
+        executor_.write(schema_->insertObject, std::move(key), seq, std::move(blob));
+    }
+
     void
     writeSuccessor(std::string&& key, std::uint32_t const seq, std::string&& successor) override
     {
@@ -824,12 +985,22 @@ public:
         std::vector<Statement> statements;
         statements.reserve(data.size() * 10);  // assume 10 transactions avg
 
+        auto const bucketSize = settingsProvider_.getTxBucketSize();
         for (auto& record : data) {
             std::transform(
                 std::begin(record.accounts),
                 std::end(record.accounts),
                 std::back_inserter(statements),
-                [this, &record](auto&& account) {
+                [this, &record, &bucketSize](auto&& account) {
+                    if (bucketSize) {
+                        return schema_->insertAccountTxBucketed.bind(
+                            std::forward<decltype(account)>(account),
+                            record.ledgerSequence / *bucketSize,
+                            std::make_tuple(record.ledgerSequence, record.transactionIndex),
+                            record.txHash
+                        );
+                    }
+
                     return schema_->insertAccountTx.bind(
                         std::forward<decltype(account)>(account),
                         std::make_tuple(record.ledgerSequence, record.transactionIndex),
@@ -848,11 +1019,26 @@ public:
         std::vector<Statement> statements;
         statements.reserve(data.size());
 
-        std::transform(std::cbegin(data), std::cend(data), std::back_inserter(statements), [this](auto const& record) {
-            return schema_->insertNFTTx.bind(
-                record.tokenID, std::make_tuple(record.ledgerSequence, record.transactionIndex), record.txHash
-            );
-        });
+        auto const bucketSize = settingsProvider_.getTxBucketSize();
+        std::transform(
+            std::cbegin(data),
+            std::cend(data),
+            std::back_inserter(statements),
+            [this, &bucketSize](auto const& record) {
+                if (bucketSize) {
+                    return schema_->insertNFTTxBucketed.bind(
+                        record.tokenID,
+                        record.ledgerSequence / *bucketSize,
+                        std::make_tuple(record.ledgerSequence, record.transactionIndex),
+                        record.txHash
+                    );
+                }
+
+                return schema_->insertNFTTx.bind(
+                    record.tokenID, std::make_tuple(record.ledgerSequence, record.transactionIndex), record.txHash
+                );
+            }
+        );
 
         executor_.write(std::move(statements));
     }
@@ -861,6 +1047,7 @@ public:
     writeTransaction(
         std::string&& hash,
         std::uint32_t const seq,
+        std::uint32_t const transactionIndex,
         std::uint32_t const date,
         std::string&& transaction,
         std::string&& metadata
@@ -869,6 +1056,7 @@ public:
         LOG(log_.trace()) << "Writing txn to database";
 
         executor_.write(schema_->insertLedgerTransaction, seq, hash);
+        executor_.write(schema_->insertLedgerTransactionByIndex, seq, transactionIndex, hash);
         executor_.write(
             schema_->insertTransaction, std::move(hash), seq, date, std::move(transaction), std::move(metadata)
         );
@@ -905,6 +1093,148 @@ public:
         executor_.write(std::move(statements));
     }
 
+    bool
+    advanceMinSequence(std::uint32_t const currentMin, std::uint32_t const newMin) override
+    {
+        auto const res = executor_.writeSync(schema_->updateMinLedgerSequence, newMin, currentMin);
+        auto const maybeSuccess = res->template get<bool>();
+        if (not maybeSuccess or not maybeSuccess.value()) {
+            LOG(log_.warn()) << "Could not advance min sequence from " << currentMin << " to " << newMin;
+            return false;
+        }
+
+        updateMinSequence(newMin);
+        LOG(log_.info()) << "Advanced min sequence from " << currentMin << " to " << newMin;
+        return true;
+    }
+
+    bool
+    tryAcquireWriterLease(std::string const& owner, std::chrono::milliseconds const duration) override
+    {
+        using namespace std::chrono;
+        auto const now = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+        auto const expiresAt = now + duration.count();
+
+        // most calls find the lease held by its owner, so it is read with a plain SELECT and at most one lightweight
+        // transaction is run: to renew the lease, to take it over once it expired or to create it
+        auto const lease = executeWriterLeaseStatement(schema_->selectWriterLease.bind(WRITER_LEASE_NAME), duration);
+        auto const current = lease->template get<std::string, std::int64_t>();
+        if (not current) {
+            return isApplied(executeWriterLeaseStatement(
+                schema_->insertWriterLease.bind(WRITER_LEASE_NAME, owner, expiresAt), duration
+            ));
+        }
+
+        auto const& [currentOwner, currentExpiresAt] = *current;
+        if (currentOwner == owner) {
+            return isApplied(executeWriterLeaseStatement(
+                schema_->renewWriterLease.bind(expiresAt, WRITER_LEASE_NAME, owner), duration
+            ));
+        }
+
+        if (currentExpiresAt >= now)
+            return false;
+
+        return isApplied(executeWriterLeaseStatement(
+            schema_->takeOverWriterLease.bind(owner, expiresAt, WRITER_LEASE_NAME, now), duration
+        ));
+    }
+
+    void
+    releaseWriterLease(std::string const& owner) override
+    {
+        static constexpr auto RELEASE_TIMEOUT = std::chrono::seconds{5};
+
+        try {
+            auto const res = executeWriterLeaseStatement(
+                schema_->renewWriterLease.bind(std::int64_t{0}, WRITER_LEASE_NAME, owner), RELEASE_TIMEOUT
+            );
+            if (not isApplied(res))
+                LOG(log_.warn()) << "Writer lease was not held by " << owner << " anymore";
+        } catch (DatabaseTimeout const&) {
+            LOG(log_.warn()) << "Could not release writer lease; it will expire on its own";
+        }
+    }
+
+    void
+    deleteLedgerHistory(
+        LedgerHistoryData const& data,
+        std::uint32_t const minSequence,
+        boost::asio::yield_context yield
+    ) override
+    {
+        ASSERT(
+            data.ledgerSequence < minSequence,
+            "Only ledgers below the min sequence can be deleted. ledger = {}, minSequence = {}",
+            data.ledgerSequence,
+            minSequence
+        );
+
+        std::vector<Statement> statements;
+        statements.reserve(
+            6 + data.txHashes.size() + data.accounts.size() + data.nftIDs.size() + (data.objectKeys.size() * 2)
+        );
+
+        statements.push_back(schema_->deleteLedgerHeader.bind(data.ledgerSequence));
+        statements.push_back(
+            schema_->deleteLedgerCloseTime.bind(data.ledgerSequence / CLOSE_TIME_BUCKET_SIZE, data.ledgerSequence)
+        );
+        if (data.ledgerHash)
+            statements.push_back(schema_->deleteLedgerHash.bind(*data.ledgerHash));
+        statements.push_back(schema_->deleteLedgerTransactions.bind(data.ledgerSequence));
+        statements.push_back(schema_->deleteLedgerTransactionsByIndex.bind(data.ledgerSequence));
+        statements.push_back(schema_->deleteDiff.bind(data.ledgerSequence));
+
+        for (auto const& hash : data.txHashes)
+            statements.push_back(schema_->deleteTransaction.bind(hash));
+
+        // index entries of this and any older ledger are dropped from the partitions touched by this ledger
+        auto const firstKept = std::make_tuple(minSequence, std::uint32_t{0});
+        auto const bucketSize = settingsProvider_.getTxBucketSize();
+        for (auto const& account : data.accounts) {
+            if (bucketSize) {
+                statements.push_back(
+                    schema_->deleteAccountTxBucketedBefore.bind(account, data.ledgerSequence / *bucketSize, firstKept)
+                );
+            } else {
+                statements.push_back(schema_->deleteAccountTxBefore.bind(account, firstKept));
+            }
+        }
+
+        for (auto const& tokenID : data.nftIDs) {
+            if (bucketSize) {
+                statements.push_back(
+                    schema_->deleteNFTTxBucketedBefore.bind(tokenID, data.ledgerSequence / *bucketSize, firstKept)
+                );
+            } else {
+                statements.push_back(schema_->deleteNFTTxBefore.bind(tokenID, firstKept));
+            }
+        }
+
+        // The newest version at or below minSequence is still needed to serve minSequence, unless it is a deletion
+        for (auto const& key : data.objectKeys) {
+            if (auto const res = executor_.read(yield, schema_->selectObject, key, minSequence); res) {
+                if (auto const result = res->template get<Blob, std::uint32_t>(); result) {
+                    auto const& [blob, seq] = result.value();
+                    statements.push_back(schema_->deleteObjectVersionsBefore.bind(key, blob.empty() ? seq + 1 : seq));
+                }
+            } else {
+                LOG(log_.error()) << "Could not fetch object version to keep: " << res.error();
+            }
+
+            if (auto const res = executor_.read(yield, schema_->selectSuccessorSequence, key, minSequence); res) {
+                if (auto const seq = res->template get<std::uint32_t>(); seq)
+                    statements.push_back(schema_->deleteSuccessorVersionsBefore.bind(key, *seq));
+            } else {
+                LOG(log_.error()) << "Could not fetch successor version to keep: " << res.error();
+            }
+        }
+
+        LOG(log_.debug()) << "Deleting history of ledger " << data.ledgerSequence << " with " << statements.size()
+                          << " statements";
+        executor_.write(std::move(statements));
+    }
+
     void
     startWrites() const override
     {
@@ -912,6 +1242,12 @@ public:
         // probably was used in PG to start a transaction or smth.
     }
 
+    void
+    waitForWritesToFinish() override
+    {
+        executor_.sync();
+    }
+
     bool
     isTooBusy() const override
     {
@@ -925,6 +1261,154 @@ public:
     }
 
 private:
+    /**
+     * @brief Refuse to run if `tx_bucket_size` does not match the transaction index tables already in the database.
+     *
+     * Enabling bucketing on a database that was populated without it (or disabling it on one populated with it) would
+     * silently hide all the history written so far from account_tx and nft_history. Such a database has to be synced
+     * into a fresh keyspace instead.
+     *
+     * @throw std::runtime_error if the configured bucketing does not match the stored data
+     */
+    void
+    checkTxBucketing() const
+    {
+        auto const isBucketed = settingsProvider_.getTxBucketSize().has_value();
+        auto const& selectOtherTable = isBucketed ? schema_->selectAnyAccountTx : schema_->selectAnyAccountTxBucketed;
+
+        auto const res = handle_.execute(selectOtherTable);
+        if (not res)
+            throw std::runtime_error("Could not check transaction index tables: " + res.error());
+
+        if (res->hasRows()) {
+            throw std::runtime_error(
+                isBucketed ? "`tx_bucket_size` is set but account_tx already holds history written without it"
+                           : "`tx_bucket_size` is not set but account_tx_bucketed already holds history written with it"
+            );
+        }
+    }
+
+    /**
+     * @brief Fetch a page of transactions from one of the bucketed transaction index tables.
+     *
+     * Buckets are walked newest first unless forward is set, starting from the bucket of the cursor and bounded by the
+     * available ledger range, until limit hashes were collected. Buckets are read in parallel batches which double in
+     * size every round trip (up to MAX_BUCKET_READ_BATCH), so dense accounts are served by a single read while sparse
+     * ones do not pay a round trip per empty bucket. The returned cursor has the same semantics as the one returned
+     * for the non-bucketed tables.
+     *
+     * @param key The partition key (account or token ID)
+     * @param selectBackward The statement to read a bucket in descending order
+     * @param selectForward The statement to read a bucket in ascending order
+     * @param forwardIsInclusive Whether selectForward includes the cursor row (`>=`) instead of excluding it (`>`)
+     * @param bucketSize The number of ledgers per bucket
+     * @param rng The currently available ledger range
+     * @param limit The maximum number of transactions to return
+     * @param forward Whether to fetch the page forwards or backwards from the given cursor
+     * @param cursorIn The cursor to resume fetching from
+     * @param yield The coroutine context
+     * @return Results and a cursor to resume from
+     */
+    template <typename KeyType>
+    TransactionsAndCursor
+    fetchBucketedTransactions(
+        KeyType const& key,
+        PreparedStatement const& selectBackward,
+        PreparedStatement const& selectForward,
+        bool const forwardIsInclusive,
+        std::uint32_t const bucketSize,
+        LedgerRange const& rng,
+        std::uint32_t const limit,
+        bool const forward,
+        std::optional<TransactionsCursor> const& cursorIn,
+        boost::asio::yield_context yield
+    ) const
+    {
+        auto const placeHolder = forward ? 0u : std::numeric_limits<std::uint32_t>::max();
+        auto const seqIdx = cursorIn ? cursorIn->asTuple() : std::make_tuple(placeHolder, placeHolder);
+
+        // only buckets that overlap with the available ledger range are walked
+        auto const startSequence = forward ? std::max(std::get<0>(seqIdx), rng.minSequence)
+                                           : std::min(std::get<0>(seqIdx), rng.maxSequence);
+        auto const firstBucket = startSequence / bucketSize;
+        auto const lastBucket = (forward ? rng.maxSequence : rng.minSequence) / bucketSize;
+
+        if (forward ? firstBucket > lastBucket : firstBucket < lastBucket)
+            return {};
+
+        auto const numBuckets = (forward ? lastBucket - firstBucket : firstBucket - lastBucket) + 1;
+
+        std::vector<ripple::uint256> hashes = {};
+        std::optional<TransactionsCursor> cursor;
+        std::uint32_t numRead = 0u;
+        std::uint32_t batchSize = 1u;
+
+        while (hashes.size() < limit and numRead < numBuckets) {
+            auto const remaining = Limit{limit - static_cast<std::uint32_t>(hashes.size())};
+            auto const count = std::min(batchSize, numBuckets - numRead);
+
+            std::vector<Statement> statements;
+            statements.reserve(count);
+            for (auto i = 0u; i < count; ++i) {
+                auto const bucket = forward ? firstBucket + numRead + i : firstBucket - numRead - i;
+
+                // the cursor bound is only relevant for the first bucket; all rows of the following buckets are
+                // strictly after (or before) it anyway
+                auto statement = forward ? selectForward.bind(key, bucket) : selectBackward.bind(key, bucket);
+                statement.bindAt(2, seqIdx);
+                statement.bindAt(3, remaining);
+                statements.push_back(std::move(statement));
+            }
+
+            // results come back in bucket order; rows of buckets past the limit are discarded
+            for (auto const& res : executor_.readEach(yield, statements)) {
+                for (auto [hash, data] : extract<ripple::uint256, std::tuple<uint32_t, uint32_t>>(res)) {
+                    if (hashes.size() >= limit)
+                        break;
+
+                    hashes.push_back(hash);
+                    cursor = data;
+                }
+            }
+
+            numRead += count;
+            batchSize = std::min(batchSize * 2, MAX_BUCKET_READ_BATCH);
+        }
+
+        LOG(log_.debug()) << "Read " << numRead << " buckets; num_rows = " << hashes.size();
+
+        // forward queries by ledger/tx sequence `>=` have to advance the index by one
+        if (cursor and forward and forwardIsInclusive)
+            ++cursor->transactionIndex;
+
+        auto const txns = fetchTransactions(hashes, yield);
+        if (txns.size() == limit)
+            return {txns, cursor};
+
+        return {txns, {}};
+    }
+
+    // unlike writeSync, lease requests are not retried forever, so a process can't keep writing after its lease expired
+    Handle::ResultOrErrorType
+    executeWriterLeaseStatement(Statement statement, std::chrono::milliseconds const timeout)
+    {
+        statement.setTimeout(timeout);
+        auto res = handle_.execute(statement);
+        if (not res) {
+            LOG(log_.warn()) << "Writer lease request failed: " << res.error();
+            throw DatabaseTimeout{};
+        }
+        return res;
+    }
+
+    template <typename ResultType>
+    static bool
+    isApplied(ResultType const& res)
+    {
+        auto const applied = res->template get<bool>();
+        return applied and *applied;
+    }
+
     bool
     executeSyncUpdate(Statement statement)
     {
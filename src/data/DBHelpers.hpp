@@ -38,6 +38,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <vector>
 
 /**
  * @brief Struct used to keep track of what to write to account_transactions/account_tx tables.
@@ -87,6 +88,24 @@ struct NFTTransactionsData {
         : tokenID(tokenID), ledgerSequence(meta.getLgrSeq()), transactionIndex(meta.getIndex()), txHash(txHash)
     {
     }
+
+    /**
+     * @brief Construct a new NFTTransactionsData object from its parts
+     *
+     * @param tokenID The token ID
+     * @param ledgerSequence The ledger sequence
+     * @param transactionIndex The index of the transaction in the ledger
+     * @param txHash The transaction hash
+     */
+    NFTTransactionsData(
+        ripple::uint256 const& tokenID,
+        std::uint32_t ledgerSequence,
+        std::uint32_t transactionIndex,
+        ripple::uint256 const& txHash
+    )
+        : tokenID(tokenID), ledgerSequence(ledgerSequence), transactionIndex(transactionIndex), txHash(txHash)
+    {
+    }
 };
 
 /**
@@ -172,6 +191,18 @@ struct NFTsData {
     }
 };
 
+/**
+ * @brief Everything that references a single ledger and has to be removed when online deletion drops that ledger.
+ */
+struct LedgerHistoryData {
+    std::uint32_t ledgerSequence{};
+    std::optional<ripple::uint256> ledgerHash;
+    std::vector<ripple::uint256> txHashes;
+    std::vector<ripple::uint256> objectKeys;  // keys of the objects modified in the ledger, i.e. its diff
+    boost::container::flat_set<ripple::AccountID> accounts;
+    boost::container::flat_set<ripple::uint256> nftIDs;
+};
+
 /**
  * @brief Check whether the supplied object is an offer.
  *
@@ -26,13 +26,23 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace data {
 
+namespace {
+
+// how far getNeighbors walks from the previous key before falling back to a tree lookup
+constexpr std::size_t MAX_NEIGHBOR_STEPS = 8;
+
+}  // namespace
+
 uint32_t
 LedgerCache::latestLedgerSequence() const
 {
@@ -53,6 +63,19 @@ LedgerCache::waitUntilCacheContainsSeq(uint32_t seq)
 
 void
 LedgerCache::update(std::vector<LedgerObject> const& objs, uint32_t seq, bool isBackground)
+{
+    updateImpl(objs, seq, isBackground);
+}
+
+void
+LedgerCache::update(std::vector<LedgerObject>&& objs, uint32_t seq, bool isBackground)
+{
+    updateImpl(std::move(objs), seq, isBackground);
+}
+
+template <typename ObjectsType>
+void
+LedgerCache::updateImpl(ObjectsType&& objs, uint32_t seq, bool isBackground)
 {
     if (disabled_)
         return;
@@ -68,14 +91,18 @@ LedgerCache::update(std::vector<LedgerObject> const& objs, uint32_t seq, bool is
             );
             latestSeq_ = seq;
         }
-        for (auto const& obj : objs) {
+        for (auto& obj : objs) {
             if (!obj.blob.empty()) {
                 if (isBackground && deletes_.contains(obj.key))
                     continue;
 
                 auto& e = map_[obj.key];
                 if (seq > e.seq) {
-                    e = {seq, obj.blob};
+                    if constexpr (std::is_rvalue_reference_v<ObjectsType&&>) {
+                        e = {seq, std::move(obj.blob)};
+                    } else {
+                        e = {seq, obj.blob};
+                    }
                 }
             } else {
                 map_.erase(obj.key);
@@ -120,6 +147,46 @@ LedgerCache::getPredecessor(ripple::uint256 const& key, uint32_t seq) const
     return {{e->first, e->second.blob}};
 }
 
+std::optional<std::vector<LedgerCache::Neighbors>>
+LedgerCache::getNeighbors(std::vector<ripple::uint256> const& keys, uint32_t seq) const
+{
+    if (disabled_ or not full_)
+        return {};
+
+    std::shared_lock const lck{mtx_};
+    successorReqCounter_.get() += keys.size();
+    if (seq != latestSeq_)
+        return {};
+
+    std::vector<Neighbors> result;
+    result.reserve(keys.size());
+
+    auto it = map_.begin();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto const& key = keys[i];
+        ASSERT(i == 0 or keys[i - 1] <= key, "Keys must be sorted");
+
+        // find the first entry not less than key, walking from the previous position while it is close
+        std::size_t steps = 0;
+        while (it != map_.end() and it->first < key and steps++ < MAX_NEIGHBOR_STEPS)
+            ++it;
+        if (it != map_.end() and it->first < key)
+            it = map_.lower_bound(key);
+
+        auto& neighbors = result.emplace_back();
+        if (it != map_.begin())
+            neighbors.predecessor = std::prev(it)->first;
+
+        auto const successor = (it != map_.end() and it->first == key) ? std::next(it) : it;
+        if (successor != map_.end()) {
+            neighbors.successor = successor->first;
+            ++successorHitCounter_.get();
+        }
+    }
+
+    return result;
+}
+
 std::optional<Blob>
 LedgerCache::get(ripple::uint256 const& key, uint32_t seq) const
 {
@@ -82,6 +82,10 @@ class LedgerCache {
     // temporary set to prevent background thread from writing already deleted data. not used when cache is full
     std::unordered_set<ripple::uint256, ripple::hardened_hash<>> deletes_;
 
+    template <typename ObjectsType>
+    void
+    updateImpl(ObjectsType&& objs, uint32_t seq, bool isBackground);
+
 public:
     /**
      * @brief Update the cache with new ledger objects.
@@ -93,6 +97,16 @@ public:
     void
     update(std::vector<LedgerObject> const& objs, uint32_t seq, bool isBackground = false);
 
+    /**
+     * @brief Update the cache with new ledger objects, taking over their blobs instead of copying them.
+     *
+     * @param objs The ledger objects to update cache with; their blobs are moved from
+     * @param seq The sequence to update cache for
+     * @param isBackground Should be set to true when writing old data from a background thread
+     */
+    void
+    update(std::vector<LedgerObject>&& objs, uint32_t seq, bool isBackground = false);
+
     /**
      * @brief Fetch a cached object by its key and sequence number.
      *
@@ -127,6 +141,30 @@ public:
     std::optional<LedgerObject>
     getPredecessor(ripple::uint256 const& key, uint32_t seq) const;
 
+    /**
+     * @brief The keys next to a key in the cache.
+     */
+    struct Neighbors {
+        std::optional<ripple::uint256> predecessor;
+        std::optional<ripple::uint256> successor;
+    };
+
+    /**
+     * @brief Gets the cached predecessor and successor keys of many keys at once.
+     *
+     * The keys are visited in order under a single lock and each search continues from where the previous one
+     * stopped, so keys that are close to each other cost a few steps instead of a full tree lookup. As with
+     * @ref getSuccessor() and @ref getPredecessor(), a key is never its own neighbor.
+     *
+     * Note: This function always returns std::nullopt when @ref isFull() returns false.
+     *
+     * @param keys The keys to fetch for, sorted in ascending order
+     * @param seq The sequence to fetch for
+     * @return The neighbors of each key in the order of keys if the cache has seq; otherwise nullopt is returned
+     */
+    std::optional<std::vector<Neighbors>>
+    getNeighbors(std::vector<ripple::uint256> const& keys, uint32_t seq) const;
+
     /**
      * @brief Disables the cache.
      */
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/LedgerCloseTimeIndex.hpp"
+
+#include "data/Types.hpp"
+#include "util/Assert.hpp"
+#include "util/TimeUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace data {
+
+void
+LedgerCloseTimeIndex::setSampleInterval(std::uint32_t interval)
+{
+    ASSERT(interval > 0, "Sample interval must be greater than 0");
+    sampleInterval_ = interval;
+}
+
+std::uint32_t
+LedgerCloseTimeIndex::sampleInterval() const
+{
+    return sampleInterval_;
+}
+
+void
+LedgerCloseTimeIndex::add(LedgerCloseTime const& ledger)
+{
+    if (ledger.sequence % sampleInterval_ != 0)
+        return;
+
+    std::scoped_lock const lck{mtx_};
+    if (entries_.empty() or ledger.sequence > entries_.back().sequence) {
+        entries_.push_back(ledger);
+        return;
+    }
+
+    auto const it = std::ranges::lower_bound(entries_, ledger.sequence, {}, &LedgerCloseTime::sequence);
+    if (it != entries_.end() and it->sequence == ledger.sequence) {
+        *it = ledger;
+    } else {
+        entries_.insert(it, ledger);
+    }
+}
+
+void
+LedgerCloseTimeIndex::add(std::vector<LedgerCloseTime> const& ledgers)
+{
+    std::vector<LedgerCloseTime> sampled;
+    std::ranges::copy_if(ledgers, std::back_inserter(sampled), [this](auto const& ledger) {
+        return ledger.sequence % sampleInterval_ == 0;
+    });
+
+    if (sampled.empty())
+        return;
+
+    std::scoped_lock const lck{mtx_};
+    if (entries_.empty() or sampled.front().sequence > entries_.back().sequence) {
+        entries_.insert(entries_.end(), sampled.begin(), sampled.end());
+        return;
+    }
+
+    // usually happens when older ledgers are loaded from the DB while new ones are already being published
+    std::vector<LedgerCloseTime> merged;
+    merged.reserve(entries_.size() + sampled.size());
+    std::ranges::merge(
+        entries_, sampled, std::back_inserter(merged), {}, &LedgerCloseTime::sequence, &LedgerCloseTime::sequence
+    );
+
+    auto const duplicates = std::ranges::unique(merged, {}, &LedgerCloseTime::sequence);
+    merged.erase(duplicates.begin(), duplicates.end());
+    entries_ = std::move(merged);
+}
+
+void
+LedgerCloseTimeIndex::removeBelow(std::uint32_t minSequence)
+{
+    std::scoped_lock const lck{mtx_};
+    auto const it = std::ranges::lower_bound(entries_, minSequence, {}, &LedgerCloseTime::sequence);
+    entries_.erase(entries_.begin(), it);
+}
+
+LedgerCloseTimeIndex::Window
+LedgerCloseTimeIndex::lookup(std::chrono::system_clock::time_point time) const
+{
+    std::shared_lock const lck{mtx_};
+
+    auto const it = std::ranges::upper_bound(entries_, time, {}, [](auto const& entry) {
+        return util::SystemTpFromLedgerCloseTime(entry.closeTime);
+    });
+
+    Window window;
+    if (it != entries_.end())
+        window.firstClosedAfter = it->sequence;
+    if (it != entries_.begin())
+        window.lastClosedAtOrBefore = std::prev(it)->sequence;
+
+    return window;
+}
+
+std::size_t
+LedgerCloseTimeIndex::size() const
+{
+    std::shared_lock const lck{mtx_};
+    return entries_.size();
+}
+
+}  // namespace data
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/Types.hpp"
+
+#include <xrpl/basics/chrono.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace data {
+
+/**
+ * @brief In-memory index from ledger close time to ledger sequence.
+ *
+ * Holds a sorted array with the close time of every sample interval-th ledger. Close times never decrease with the
+ * sequence, so a lookup narrows a point in time down to a window of at most sample interval ledgers without reading
+ * the DB. The index may have gaps, e.g. for ledgers written before close times were persisted; lookups stay correct
+ * but the returned window gets wider.
+ */
+class LedgerCloseTimeIndex {
+public:
+    /**
+     * @brief Indexed ledgers surrounding a point in time.
+     *
+     * The latest ledger closed at or before that time is in [lastClosedAtOrBefore, firstClosedAfter).
+     */
+    struct Window {
+        std::optional<std::uint32_t> lastClosedAtOrBefore; /**< latest indexed ledger closed at or before the time */
+        std::optional<std::uint32_t> firstClosedAfter;     /**< earliest indexed ledger closed after the time */
+
+        bool
+        operator==(Window const&) const = default;
+    };
+
+    /**
+     * @brief Default number of ledgers covered by each entry; a date lookup then reads at most 8 ledgers from the DB.
+     */
+    static constexpr std::uint32_t DEFAULT_SAMPLE_INTERVAL = 256;
+
+private:
+    mutable std::shared_mutex mtx_;
+    std::vector<LedgerCloseTime> entries_;
+    std::atomic_uint32_t sampleInterval_ = DEFAULT_SAMPLE_INTERVAL;
+
+public:
+    /**
+     * @brief Set how many ledgers are covered by each entry of the index; must be set before adding ledgers.
+     *
+     * @param interval Only ledgers with a sequence divisible by this interval are indexed
+     */
+    void
+    setSampleInterval(std::uint32_t interval);
+
+    /**
+     * @return The number of ledgers covered by each entry of the index
+     */
+    std::uint32_t
+    sampleInterval() const;
+
+    /**
+     * @brief Add the close time of a ledger if it is sampled.
+     *
+     * @param ledger The ledger to add
+     */
+    void
+    add(LedgerCloseTime const& ledger);
+
+    /**
+     * @brief Add the close times of many ledgers at once; non-sampled ledgers are skipped.
+     *
+     * @param ledgers The ledgers to add, sorted by sequence
+     */
+    void
+    add(std::vector<LedgerCloseTime> const& ledgers);
+
+    /**
+     * @brief Drop all entries for ledgers below the given sequence.
+     *
+     * @param minSequence The minimum sequence still available
+     */
+    void
+    removeBelow(std::uint32_t minSequence);
+
+    /**
+     * @brief Find the indexed ledgers surrounding the given point in time.
+     *
+     * @param time The point in time to look up
+     * @return The window containing the latest ledger closed at or before time
+     */
+    Window
+    lookup(std::chrono::system_clock::time_point time) const;
+
+    /**
+     * @return The number of entries in the index
+     */
+    std::size_t
+    size() const;
+};
+
+}  // namespace data
@@ -20,6 +20,7 @@
 #pragma once
 
 #include <xrpl/basics/base_uint.h>
+#include <xrpl/basics/chrono.h>
 #include <xrpl/protocol/AccountID.h>
 
 #include <concepts>
@@ -46,6 +47,17 @@ struct LedgerObject {
     operator==(LedgerObject const& other) const = default;
 };
 
+/**
+ * @brief Represents the close time of a ledger.
+ */
+struct LedgerCloseTime {
+    std::uint32_t sequence = 0;
+    ripple::NetClock::time_point closeTime;
+
+    bool
+    operator==(LedgerCloseTime const& other) const = default;
+};
+
 /**
  * @brief Represents a page of LedgerObjects.
  */
@@ -45,6 +45,7 @@ concept SomeSettingsProvider = requires(T a) {
     { a.getKeyspace() } -> std::same_as<std::string>;
     { a.getTablePrefix() } -> std::same_as<std::optional<std::string>>;
     { a.getReplicationFactor() } -> std::same_as<uint16_t>;
+    { a.getTxBucketSize() } -> std::same_as<std::optional<uint32_t>>;
 };
 
 /**
@@ -128,6 +128,19 @@ public:
             qualifiedTableName(settingsProvider_.get(), "ledger_transactions")
         ));
 
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                     ledger_sequence bigint,
+                   transaction_index bigint,
+                                hash blob,
+                 PRIMARY KEY (ledger_sequence, transaction_index) 
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "ledger_transactions_by_index")
+        ));
+
         statements.emplace_back(fmt::format(
             R"(
            CREATE TABLE IF NOT EXISTS {}
@@ -200,6 +213,47 @@ public:
             qualifiedTableName(settingsProvider_.get(), "ledger_range")
         ));
 
+        // First ledger written with each secondary index, e.g. ledger_transactions_by_index. Ledgers below it were
+        // written before the index existed.
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                           name blob PRIMARY KEY,
+                 first_sequence bigint
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "index_starts")
+        ));
+
+        // Lease of the ETL writer. expires_at is in milliseconds since the unix epoch.
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                        name blob PRIMARY KEY,
+                       owner blob,
+                  expires_at bigint
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "writer_lease")
+        ));
+
+        // Close time of each ledger, partitioned by buckets of consecutive sequences. Used to load the in-memory
+        // close time index on startup.
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                      bucket bigint,
+                    sequence bigint,
+                  close_time bigint,
+                 PRIMARY KEY (bucket, sequence)
+                  )
+            )",
+            qualifiedTableName(settingsProvider_.get(), "ledger_close_times")
+        ));
+
         statements.emplace_back(fmt::format(
             R"(
            CREATE TABLE IF NOT EXISTS {}
@@ -257,6 +311,39 @@ public:
             qualifiedTableName(settingsProvider_.get(), "nf_token_transactions")
         ));
 
+        // Bucketed variants of account_tx and nf_token_transactions. Only used if `tx_bucket_size` is configured.
+        // Note: the bucket of a row is ledger_sequence / tx_bucket_size, so the bucket size must never change
+        // once data was written to these tables.
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                    account blob,    
+                     bucket bigint,
+                    seq_idx tuple<bigint, bigint>, 
+                       hash blob,
+                    PRIMARY KEY ((account, bucket), seq_idx) 
+                  ) 
+             WITH CLUSTERING ORDER BY (seq_idx DESC)
+            )",
+            qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+        ));
+
+        statements.emplace_back(fmt::format(
+            R"(
+           CREATE TABLE IF NOT EXISTS {}
+                  ( 
+                    token_id blob,    
+                      bucket bigint,
+                     seq_idx tuple<bigint, bigint>,
+                        hash blob,
+                     PRIMARY KEY ((token_id, bucket), seq_idx) 
+                  ) 
+             WITH CLUSTERING ORDER BY (seq_idx DESC)
+            )",
+            qualifiedTableName(settingsProvider_.get(), "nf_token_transactions_bucketed")
+        ));
+
         return statements;
     }();
 
@@ -316,6 +403,17 @@ public:
             ));
         }();
 
+        PreparedStatement insertLedgerTransactionByIndex = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (ledger_sequence, transaction_index, hash)
+                VALUES (?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transactions_by_index")
+            ));
+        }();
+
         PreparedStatement insertSuccessor = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -393,6 +491,28 @@ public:
             ));
         }();
 
+        PreparedStatement insertAccountTxBucketed = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (account, bucket, seq_idx, hash)
+                VALUES (?, ?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+            ));
+        }();
+
+        PreparedStatement insertNFTTxBucketed = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (token_id, bucket, seq_idx, hash)
+                VALUES (?, ?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "nf_token_transactions_bucketed")
+            ));
+        }();
+
         PreparedStatement insertLedgerHeader = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -404,6 +524,30 @@ public:
             ));
         }();
 
+        PreparedStatement insertWriterLease = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (name, owner, expires_at)
+                VALUES (?, ?, ?)
+                IF NOT EXISTS
+                )",
+                qualifiedTableName(settingsProvider_.get(), "writer_lease")
+            ));
+        }();
+
+        PreparedStatement insertIndexStart = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (name, first_sequence)
+                VALUES (?, ?)
+                IF NOT EXISTS
+                )",
+                qualifiedTableName(settingsProvider_.get(), "index_starts")
+            ));
+        }();
+
         PreparedStatement insertLedgerHash = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -415,6 +559,17 @@ public:
             ));
         }();
 
+        PreparedStatement insertLedgerCloseTime = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                INSERT INTO {} 
+                       (bucket, sequence, close_time)
+                VALUES (?, ?, ?)
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_close_times")
+            ));
+        }();
+
         //
         // Update (and "delete") queries
         //
@@ -442,6 +597,185 @@ public:
             ));
         }();
 
+        PreparedStatement updateMinLedgerSequence = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                UPDATE {} 
+                   SET sequence = ?
+                 WHERE is_latest = false
+                    IF sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_range")
+            ));
+        }();
+
+        PreparedStatement renewWriterLease = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                UPDATE {} 
+                   SET expires_at = ?
+                 WHERE name = ?
+                    IF owner = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "writer_lease")
+            ));
+        }();
+
+        PreparedStatement takeOverWriterLease = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                UPDATE {} 
+                   SET owner = ?, expires_at = ?
+                 WHERE name = ?
+                    IF expires_at < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "writer_lease")
+            ));
+        }();
+
+        //
+        // Delete queries, used by online deletion
+        //
+
+        PreparedStatement deleteLedgerHeader = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledgers")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerHash = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE hash = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_hashes")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerCloseTime = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE bucket = ?
+                   AND sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_close_times")
+            ));
+        }();
+
+        PreparedStatement deleteTransaction = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE hash = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "transactions")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerTransactions = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE ledger_sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transactions")
+            ));
+        }();
+
+        PreparedStatement deleteLedgerTransactionsByIndex = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE ledger_sequence = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transactions_by_index")
+            ));
+        }();
+
+        PreparedStatement deleteDiff = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE seq = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "diff")
+            ));
+        }();
+
+        PreparedStatement deleteObjectVersionsBefore = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE key = ?
+                   AND sequence < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "objects")
+            ));
+        }();
+
+        PreparedStatement deleteSuccessorVersionsBefore = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE key = ?
+                   AND seq < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "successor")
+            ));
+        }();
+
+        PreparedStatement deleteAccountTxBefore = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE account = ?
+                   AND seq_idx < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx")
+            ));
+        }();
+
+        PreparedStatement deleteNFTTxBefore = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE token_id = ?
+                   AND seq_idx < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "nf_token_transactions")
+            ));
+        }();
+
+        PreparedStatement deleteAccountTxBucketedBefore = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE account = ?
+                   AND bucket = ?
+                   AND seq_idx < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+            ));
+        }();
+
+        PreparedStatement deleteNFTTxBucketedBefore = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                DELETE FROM {}
+                 WHERE token_id = ?
+                   AND bucket = ?
+                   AND seq_idx < ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "nf_token_transactions_bucketed")
+            ));
+        }();
+
         //
         // Select queries
         //
@@ -460,6 +794,20 @@ public:
             ));
         }();
 
+        PreparedStatement selectSuccessorSequence = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT seq 
+                  FROM {}               
+                 WHERE key = ?
+                   AND seq <= ?
+              ORDER BY seq DESC 
+                 LIMIT 1
+                )",
+                qualifiedTableName(settingsProvider_.get(), "successor")
+            ));
+        }();
+
         PreparedStatement selectDiff = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -507,6 +855,18 @@ public:
             ));
         }();
 
+        PreparedStatement selectTransactionHashByIndex = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT hash
+                  FROM {}
+                 WHERE ledger_sequence = ?
+                   AND transaction_index = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_transactions_by_index")
+            ));
+        }();
+
         PreparedStatement selectLedgerPageKeys = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -562,6 +922,28 @@ public:
             ));
         }();
 
+        PreparedStatement selectAnyAccountTx = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT account 
+                  FROM {}               
+                 LIMIT 1
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx")
+            ));
+        }();
+
+        PreparedStatement selectAnyAccountTxBucketed = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT account 
+                  FROM {}               
+                 LIMIT 1
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+            ));
+        }();
+
         PreparedStatement selectAccountFromBegining = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -602,6 +984,61 @@ public:
             ));
         }();
 
+        PreparedStatement selectAccountTxBucketed = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT hash, seq_idx 
+                  FROM {}               
+                 WHERE account = ?
+                   AND bucket = ?
+                   AND seq_idx < ?
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+            ));
+        }();
+
+        PreparedStatement selectAccountTxBucketedForward = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT hash, seq_idx 
+                  FROM {}               
+                 WHERE account = ?
+                   AND bucket = ?
+                   AND seq_idx > ?
+              ORDER BY seq_idx ASC 
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+            ));
+        }();
+
+        PreparedStatement selectAccountBucketedFromBegining = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT account, bucket 
+                  FROM {}               
+                 WHERE token(account, bucket) > 0
+                   PER PARTITION LIMIT 1 
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+            ));
+        }();
+
+        PreparedStatement selectAccountBucketedFromToken = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT account, bucket 
+                  FROM {}               
+                 WHERE token(account, bucket) > token(?, ?)
+                   PER PARTITION LIMIT 1 
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "account_tx_bucketed")
+            ));
+        }();
+
         PreparedStatement selectNFT = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -658,6 +1095,36 @@ public:
             ));
         }();
 
+        PreparedStatement selectNFTTxBucketed = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT hash, seq_idx
+                  FROM {}    
+                 WHERE token_id = ?
+                   AND bucket = ?
+                   AND seq_idx < ?
+              ORDER BY seq_idx DESC
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "nf_token_transactions_bucketed")
+            ));
+        }();
+
+        PreparedStatement selectNFTTxBucketedForward = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT hash, seq_idx
+                  FROM {}    
+                 WHERE token_id = ?
+                   AND bucket = ?
+                   AND seq_idx >= ?
+              ORDER BY seq_idx ASC
+                 LIMIT ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "nf_token_transactions_bucketed")
+            ));
+        }();
+
         PreparedStatement selectNFTIDsByIssuer = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -721,6 +1188,28 @@ public:
             ));
         }();
 
+        PreparedStatement selectIndexStart = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT first_sequence
+                  FROM {}
+                 WHERE name = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "index_starts")
+            ));
+        }();
+
+        PreparedStatement selectWriterLease = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT owner, expires_at
+                  FROM {}
+                 WHERE name = ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "writer_lease")
+            ));
+        }();
+
         PreparedStatement selectLedgerRange = [this]() {
             return handle_.get().prepare(fmt::format(
                 R"(
@@ -730,6 +1219,19 @@ public:
                 qualifiedTableName(settingsProvider_.get(), "ledger_range")
             ));
         }();
+
+        PreparedStatement selectLedgerCloseTimes = [this]() {
+            return handle_.get().prepare(fmt::format(
+                R"(
+                SELECT sequence, close_time
+                  FROM {}
+                 WHERE bucket = ?
+                   AND sequence >= ?
+                   AND sequence <= ?
+                )",
+                qualifiedTableName(settingsProvider_.get(), "ledger_close_times")
+            ));
+        }();
     };
 
     /**
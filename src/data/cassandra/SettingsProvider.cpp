@@ -73,8 +73,11 @@ SettingsProvider::SettingsProvider(util::Config const& cfg)
     , keyspace_{cfg.valueOr<std::string>("keyspace", "clio")}
     , tablePrefix_{cfg.maybeValue<std::string>("table_prefix")}
     , replicationFactor_{cfg.valueOr<uint16_t>("replication_factor", 3)}
+    , txBucketSize_{cfg.maybeValue<uint32_t>("tx_bucket_size")}
     , settings_{parseSettings()}
 {
+    if (txBucketSize_ and *txBucketSize_ == 0)
+        throw std::runtime_error("`tx_bucket_size` must be greater than zero");
 }
 
 Settings
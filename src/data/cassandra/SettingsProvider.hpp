@@ -39,6 +39,7 @@ class SettingsProvider {
     std::string keyspace_;
     std::optional<std::string> tablePrefix_;
     uint16_t replicationFactor_;
+    std::optional<uint32_t> txBucketSize_;
     Settings settings_;
 
 public:
@@ -82,6 +83,20 @@ public:
         return replicationFactor_;
     }
 
+    /**
+     * @brief Get the number of ledgers per partition bucket of the transaction index tables.
+     *
+     * When set, `account_tx` and `nf_token_transactions` data is written into tables partitioned by
+     * `(account/token, ledger_sequence / bucketSize)` instead of a single partition per account/token.
+     *
+     * @return The bucket size in ledgers if bucketing is enabled; nullopt otherwise
+     */
+    [[nodiscard]] std::optional<uint32_t>
+    getTxBucketSize() const
+    {
+        return txBucketSize_;
+    }
+
 private:
     [[nodiscard]] std::optional<std::string>
     parseOptionalCertificate() const;
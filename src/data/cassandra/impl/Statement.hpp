@@ -30,6 +30,7 @@
 #include <xrpl/protocol/AccountID.h>
 #include <xrpl/protocol/STAccount.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <stdexcept>
@@ -144,6 +145,17 @@ public:
             static_assert(unsupported_v<DecayedType>);
         }
     }
+
+    /**
+     * @brief Limits how long the statement may take, overriding the request timeout of the cluster.
+     *
+     * @param timeout The timeout
+     */
+    void
+    setTimeout(std::chrono::milliseconds const timeout) const
+    {
+        cass_statement_set_request_timeout(*this, static_cast<cass_uint64_t>(timeout.count()));
+    }
 };
 
 /**
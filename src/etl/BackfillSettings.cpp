@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/BackfillSettings.hpp"
+
+#include "util/config/Config.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace etl {
+
+[[nodiscard]] bool
+BackfillSettings::isEnabled() const
+{
+    return startSequence.has_value();
+}
+
+[[nodiscard]] BackfillSettings
+make_BackfillSettings(util::Config const& config)
+{
+    BackfillSettings settings;
+    if (not config.contains("backfill"))
+        return settings;
+
+    auto const section = config.section("backfill");
+    settings.startSequence = section.maybeValue<std::uint32_t>("start_sequence");
+    settings.numWorkers = section.valueOr<std::uint32_t>("workers", settings.numWorkers);
+    settings.batchSize = section.valueOr<std::uint32_t>("batch_size", settings.batchSize);
+
+    if (settings.numWorkers == 0)
+        throw std::runtime_error("backfill.workers must be greater than 0");
+    if (settings.batchSize == 0)
+        throw std::runtime_error("backfill.batch_size must be greater than 0");
+
+    return settings;
+}
+
+}  // namespace etl
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "util/config/Config.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace etl {
+
+/**
+ * @brief Settings for the backfill of ledger history below the oldest ledger in the database
+ */
+struct BackfillSettings {
+    std::optional<std::uint32_t> startSequence; /**< oldest ledger to backfill; backfill is disabled if not set */
+    std::uint32_t numWorkers = 8;               /**< number of ledgers fetched and written concurrently */
+    std::uint32_t batchSize = 100000;           /**< number of ledgers added to the ledger range at once */
+
+    auto
+    operator<=>(BackfillSettings const&) const = default;
+
+    /** @returns True if a start sequence is configured; false otherwise */
+    [[nodiscard]] bool
+    isEnabled() const;
+};
+
+/**
+ * @brief Create a BackfillSettings object from the `backfill` section of a Config object
+ *
+ * @param config The configuration object
+ * @returns The BackfillSettings object
+ * @throws std::runtime_error if `workers` or `batch_size` is 0
+ */
+[[nodiscard]] BackfillSettings
+make_BackfillSettings(util::Config const& config);
+
+}  // namespace etl
@@ -20,8 +20,11 @@
 /** @file */
 #pragma once
 
+#include "util/Assert.hpp"
+
 #include <xrpl/basics/base_uint.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
@@ -142,6 +145,126 @@ public:
     }
 };
 
+/**
+ * @brief Bounded single-producer single-consumer ring buffer.
+ *
+ * Both push and pop are lock-free as long as the buffer is neither full nor empty. Only a producer pushing into a full
+ * buffer or a consumer popping from an empty one blocks, using an atomic wait on the index the other side advances.
+ *
+ * @note At most one thread may push and at most one thread may pop at any given time.
+ */
+template <typename T>
+class SpscRingBuffer {
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<T> slots_;
+
+    // head_ is only written by the consumer and tail_ only by the producer; keep them on separate cache lines
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t head_ = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t tail_ = 0;
+
+public:
+    /**
+     * @brief Create an instance of the ring buffer.
+     *
+     * @param capacity Maximum number of elements the buffer can hold. Must be greater than zero.
+     */
+    explicit SpscRingBuffer(std::size_t capacity) : slots_(capacity)
+    {
+        ASSERT(capacity > 0, "Ring buffer capacity must be greater than zero");
+    }
+
+    /**
+     * @brief Push element into the buffer.
+     *
+     * Note: This method will block until free space is available.
+     *
+     * @param elt Element to push. Ownership is transferred
+     */
+    void
+    push(T&& elt)
+    {
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        auto head = head_.load(std::memory_order_acquire);
+        while (tail - head == slots_.size()) {
+            head_.wait(head, std::memory_order_acquire);
+            head = head_.load(std::memory_order_acquire);
+        }
+
+        slots_[tail % slots_.size()] = std::move(elt);
+        tail_.store(tail + 1, std::memory_order_release);
+        tail_.notify_one();
+    }
+
+    /**
+     * @brief Pop element from the buffer.
+     *
+     * Note: Will block until the buffer is non-empty.
+     *
+     * @return Element popped from the buffer
+     */
+    T
+    pop()
+    {
+        auto const head = head_.load(std::memory_order_relaxed);
+        auto tail = tail_.load(std::memory_order_acquire);
+        while (tail == head) {
+            tail_.wait(tail, std::memory_order_acquire);
+            tail = tail_.load(std::memory_order_acquire);
+        }
+
+        return take(head);
+    }
+
+    /**
+     * @brief Attempt to pop an element.
+     *
+     * @return Element popped from the buffer or empty optional if the buffer was empty
+     */
+    std::optional<T>
+    tryPop()
+    {
+        auto const head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head)
+            return std::nullopt;
+
+        return take(head);
+    }
+
+    /**
+     * @brief Get the number of elements in the buffer.
+     *
+     * Note: The value is only a snapshot if the producer or the consumer is active concurrently.
+     *
+     * @return The size of the buffer
+     */
+    std::size_t
+    size() const
+    {
+        auto const head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    /**
+     * @return The maximum number of elements the buffer can hold
+     */
+    std::size_t
+    capacity() const
+    {
+        return slots_.size();
+    }
+
+private:
+    T
+    take(std::uint64_t head)
+    {
+        T ret = std::move(slots_[head % slots_.size()]);
+        head_.store(head + 1, std::memory_order_release);
+        head_.notify_one();
+        return ret;
+    }
+};
+
 /**
  * @brief Parititions the uint256 keyspace into numMarkers partitions, each of equal size.
  *
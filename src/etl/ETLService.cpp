@@ -21,8 +21,13 @@
 
 #include "data/BackendInterface.hpp"
 #include "data/LedgerCache.hpp"
+#include "etl/BackfillSettings.hpp"
 #include "etl/CorruptionDetector.hpp"
+#include "etl/HistoryPruner.hpp"
 #include "etl/NetworkValidatedLedgersInterface.hpp"
+#include "etl/WriterLease.hpp"
+#include "etl/impl/LedgerDiffBroadcaster.hpp"
+#include "etl/impl/LedgerDiffReceiver.hpp"
 #include "feed/SubscriptionManagerInterface.hpp"
 #include "util/Assert.hpp"
 #include "util/Constants.hpp"
@@ -33,17 +38,73 @@
 #include <xrpl/beast/core/CurrentThreadName.h>
 #include <xrpl/protocol/LedgerHeader.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 namespace etl {
+
+namespace {
+
+std::string
+ledgerStreamSecret(util::Config const& config)
+{
+    auto secret = config.valueOrThrow<std::string>(
+        "ledger_stream.secret", "ledger_stream.secret is required to send or receive ledgers"
+    );
+    if (secret.empty())
+        throw std::runtime_error("ledger_stream.secret must not be empty");
+
+    return secret;
+}
+
+std::shared_ptr<impl::LedgerDiffBroadcaster>
+makeLedgerBroadcaster(util::Config const& config, boost::asio::io_context& ioc)
+{
+    auto const port = config.maybeValue<std::uint16_t>("ledger_stream.port");
+    if (not port)
+        return nullptr;
+
+    auto const maxQueueSize = config.valueOr<std::size_t>("ledger_stream.max_queue_size", 16);
+    if (maxQueueSize == 0)
+        throw std::runtime_error("ledger_stream.max_queue_size must be greater than 0");
+
+    return std::make_shared<impl::LedgerDiffBroadcaster>(
+        ioc,
+        config.valueOr<std::string>("ledger_stream.ip", "127.0.0.1"),
+        *port,
+        ledgerStreamSecret(config),
+        maxQueueSize
+    );
+}
+
+std::shared_ptr<impl::LedgerDiffReceiver>
+makeLedgerReceiver(util::Config const& config, boost::asio::io_context& ioc)
+{
+    std::vector<impl::LedgerDiffReceiver::Peer> peers;
+    for (auto const& entry : config.arrayOr("ledger_stream.peers", {})) {
+        peers.push_back(
+            {.ip = entry.valueOrThrow<std::string>("ip", "ledger_stream.peers entries must have an ip"),
+             .port = entry.valueOrThrow<std::string>("port", "ledger_stream.peers entries must have a port")}
+        );
+    }
+
+    if (peers.empty())
+        return nullptr;
+
+    return std::make_shared<impl::LedgerDiffReceiver>(ioc, std::move(peers), ledgerStreamSecret(config));
+}
+
+}  // namespace
+
 // Database must be populated when this starts
 std::optional<uint32_t>
 ETLService::runETLPipeline(uint32_t startSequence, uint32_t numExtractors)
@@ -57,6 +118,9 @@ ETLService::runETLPipeline(uint32_t startSequence, uint32_t numExtractors)
 
     LOG(log_.debug()) << "Starting etl pipeline";
     state_.isWriting = true;
+    state_.writeConflict = false;
+    if (writerLease_)
+        writerLease_->keepAlive([this]() { state_.writeConflict = true; });
 
     auto const rng = backend_->hardFetchLedgerRangeNoThrow();
     ASSERT(rng.has_value(), "Parent ledger range can't be null");
@@ -69,7 +133,7 @@ ETLService::runETLPipeline(uint32_t startSequence, uint32_t numExtractors)
 
     auto const begin = std::chrono::system_clock::now();
     auto extractors = std::vector<std::unique_ptr<ExtractorType>>{};
-    auto pipe = DataPipeType{numExtractors, startSequence};
+    auto pipe = DataPipeType{numExtractors, startSequence, extractorMemoryBudget_};
 
     for (auto i = 0u; i < numExtractors; ++i) {
         extractors.push_back(std::make_unique<ExtractorType>(
@@ -93,6 +157,8 @@ ETLService::runETLPipeline(uint32_t startSequence, uint32_t numExtractors)
                       << ((end - begin).count()) / NANOSECONDS_PER_SECOND;
 
     state_.isWriting = false;
+    if (writerLease_)
+        writerLease_->release();
 
     LOG(log_.debug()) << "Stopping etl pipeline";
     return lastPublishedSeq;
@@ -165,21 +231,31 @@ ETLService::monitor()
 uint32_t
 ETLService::publishNextSequence(uint32_t nextSequence)
 {
-    if (auto rng = backend_->hardFetchLedgerRangeNoThrow(); rng && rng->maxSequence >= nextSequence) {
+    if (publishFromLedgerStream(nextSequence)) {
+        ++nextSequence;
+    } else if (auto rng = backend_->hardFetchLedgerRangeNoThrow(); rng && rng->maxSequence >= nextSequence) {
         ledgerPublisher_.publish(nextSequence, {});
         ++nextSequence;
     } else if (networkValidatedLedgers_->waitUntilValidatedByNetwork(nextSequence, util::MILLISECONDS_PER_SECOND)) {
         LOG(log_.info()) << "Ledger with sequence = " << nextSequence << " has been validated by the network. "
                          << "Attempting to find in database and publish";
 
-        // Attempt to take over responsibility of ETL writer after 10 failed
-        // attempts to publish the ledger. publishLedger() fails if the
-        // ledger that has been validated by the network is not found in the
-        // database after the specified number of attempts. publishLedger()
-        // waits one second between each attempt to read the ledger from the
-        // database
-        constexpr size_t timeoutSeconds = 10;
-        bool const success = ledgerPublisher_.publish(nextSequence, timeoutSeconds);
+        bool success = false;
+        if (writerLease_) {
+            // Take over responsibility of ETL writer as soon as the lease of the current writer expires
+            success = not writerLease_->waitForLease([this, nextSequence]() {
+                return ledgerPublisher_.publish(nextSequence, 1);
+            });
+        } else {
+            // Attempt to take over responsibility of ETL writer after 10 failed
+            // attempts to publish the ledger. publishLedger() fails if the
+            // ledger that has been validated by the network is not found in the
+            // database after the specified number of attempts. publishLedger()
+            // waits one second between each attempt to read the ledger from the
+            // database
+            constexpr size_t timeoutSeconds = 10;
+            success = ledgerPublisher_.publish(nextSequence, timeoutSeconds);
+        }
 
         if (!success) {
             LOG(log_.warn()) << "Failed to publish ledger with sequence = " << nextSequence << " . Beginning ETL";
@@ -226,7 +302,9 @@ ETLService::monitorReadOnly()
     latestSequence++;
 
     while (not isStopping()) {
-        if (auto rng = backend_->hardFetchLedgerRangeNoThrow(); rng && rng->maxSequence >= latestSequence) {
+        if (publishFromLedgerStream(latestSequence)) {
+            latestSequence = latestSequence + 1;
+        } else if (auto rng = backend_->hardFetchLedgerRangeNoThrow(); rng && rng->maxSequence >= latestSequence) {
             ledgerPublisher_.publish(latestSequence, {});
             latestSequence = latestSequence + 1;
         } else {
@@ -238,6 +316,59 @@ ETLService::monitorReadOnly()
     }
 }
 
+bool
+ETLService::publishFromLedgerStream(uint32_t sequence)
+{
+    // a ledger is broadcast only after the writer committed it, so it is already in the database when received
+    static constexpr auto LEDGER_STREAM_WAIT = std::chrono::seconds{1};
+
+    if (not ledgerReceiver_)
+        return false;
+
+    auto ledger = ledgerReceiver_->waitFor(sequence, LEDGER_STREAM_WAIT);
+    if (not ledger)
+        return false;
+
+    // the diff goes straight into the cache, so make sure it belongs to the ledger that was actually committed
+    auto const committed = data::synchronousAndRetryOnTimeout([this, sequence](auto yield) {
+        return backend_->fetchLedgerBySequence(sequence, yield);
+    });
+    if (not committed or committed->hash != ledger->header.hash) {
+        LOG(log_.error()) << "Ledger " << sequence << " received from the ledger stream does not match the database";
+        return false;
+    }
+
+    LOG(log_.debug()) << "Received ledger " << sequence << " from the ledger stream";
+    ledgerPublisher_.publish(std::move(*ledger));
+    return true;
+}
+
+void
+ETLService::loadCloseTimeIndex()
+{
+    // number of ledgers to read close times for at once
+    static constexpr std::uint32_t CHUNK_SIZE = 1u << 16;
+
+    auto const range = backend_->hardFetchLedgerRangeNoThrow();
+    if (not range)
+        return;
+
+    LOG(log_.info()) << "Loading close time index for ledgers " << range->minSequence << " to " << range->maxSequence;
+
+    for (auto first = range->minSequence; not isStopping(); first += CHUNK_SIZE) {
+        auto const last = std::min(range->maxSequence, first + CHUNK_SIZE - 1);
+        auto const closeTimes = data::synchronousAndRetryOnTimeout([this, first, last](auto yield) {
+            return backend_->fetchLedgerCloseTimes(first, last, yield);
+        });
+        backend_->closeTimeIndex().add(closeTimes);
+
+        if (last == range->maxSequence)
+            break;
+    }
+
+    LOG(log_.info()) << "Close time index has " << backend_->closeTimeIndex().size() << " entries";
+}
+
 void
 ETLService::run()
 {
@@ -250,6 +381,19 @@ ETLService::run()
 void
 ETLService::doWork()
 {
+    if (not state_.isReadOnly)
+        historyPruner_.run();
+    backfiller_.run();
+    if (ledgerBroadcaster_)
+        ledgerBroadcaster_->run();
+    if (ledgerReceiver_)
+        ledgerReceiver_->run();
+
+    closeTimeIndexLoader_ = std::thread([this]() {
+        beast::setCurrentThreadName("ETLService close time index loader");
+        loadCloseTimeIndex();
+    });
+
     worker_ = std::thread([this]() {
         beast::setCurrentThreadName("ETLService worker");
 
@@ -275,14 +419,38 @@ ETLService::ETLService(
     , cacheLoader_(config, backend, backend->cache())
     , ledgerFetcher_(backend, balancer)
     , ledgerLoader_(backend, balancer, ledgerFetcher_, state_)
-    , ledgerPublisher_(ioc, backend, backend->cache(), subscriptions, state_)
+    , ledgerBroadcaster_(makeLedgerBroadcaster(config, ioc))
+    , ledgerReceiver_(makeLedgerReceiver(config, ioc))
+    , ledgerPublisher_(ioc, backend, backend->cache(), subscriptions, state_, ledgerBroadcaster_)
     , amendmentBlockHandler_(ioc, state_)
+    , historyPruner_(make_HistoryPrunerSettings(config), backend, state_)
+    , backfiller_(make_BackfillSettings(config), backend, balancer, ledgerLoader_, state_)
 {
     startSequence_ = config.maybeValue<uint32_t>("start_sequence");
     finishSequence_ = config.maybeValue<uint32_t>("finish_sequence");
     state_.isReadOnly = config.valueOr("read_only", static_cast<bool>(state_.isReadOnly));
+    if (make_BackfillSettings(config).isEnabled()) {
+        if (make_HistoryPrunerSettings(config).isEnabled())
+            throw std::runtime_error("backfill and online_delete can't be enabled at the same time");
+
+        // The backfill writes ledgers without finishing them, so this process must never become the ETL writer
+        LOG(log_.info()) << "Backfill is enabled. Running in read-only mode";
+        state_.isReadOnly = true;
+    }
     extractorThreads_ = config.valueOr<uint32_t>("extractor_threads", extractorThreads_);
+    if (auto const budget = config.maybeValue<std::size_t>("extractor_memory_budget_mb"); budget) {
+        if (*budget == 0)
+            throw std::runtime_error("extractor_memory_budget_mb must be greater than 0");
+        extractorMemoryBudget_ = *budget * 1024 * 1024;
+    }
     txnThreshold_ = config.valueOr<size_t>("txn_threshold", txnThreshold_);
+    auto const closeTimeSampleInterval =
+        config.valueOr<std::uint32_t>("close_time_sample_interval", backend_->closeTimeIndex().sampleInterval());
+    if (closeTimeSampleInterval == 0)
+        throw std::runtime_error("close_time_sample_interval must be greater than 0");
+    backend_->closeTimeIndex().setSampleInterval(closeTimeSampleInterval);
+    if (auto const leaseSettings = make_WriterLeaseSettings(config); leaseSettings.isEnabled())
+        writerLease_.emplace(leaseSettings, backend_, state_);
 
     // This should probably be done in the backend factory but we don't have state available until here
     backend_->setCorruptionDetector(CorruptionDetector<data::LedgerCache>{state_, backend->cache()});
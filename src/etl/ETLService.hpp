@@ -24,11 +24,16 @@
 #include "etl/CacheLoader.hpp"
 #include "etl/ETLHelpers.hpp"
 #include "etl/ETLState.hpp"
+#include "etl/HistoryPruner.hpp"
 #include "etl/LoadBalancer.hpp"
 #include "etl/SystemState.hpp"
+#include "etl/WriterLease.hpp"
 #include "etl/impl/AmendmentBlock.hpp"
+#include "etl/impl/Backfiller.hpp"
 #include "etl/impl/ExtractionDataPipe.hpp"
 #include "etl/impl/Extractor.hpp"
+#include "etl/impl/LedgerDiffBroadcaster.hpp"
+#include "etl/impl/LedgerDiffReceiver.hpp"
 #include "etl/impl/LedgerFetcher.hpp"
 #include "etl/impl/LedgerLoader.hpp"
 #include "etl/impl/LedgerPublisher.hpp"
@@ -88,6 +93,9 @@ class ETLService {
     using AmendmentBlockHandlerType = etl::impl::AmendmentBlockHandler<>;
     using TransformerType =
         etl::impl::Transformer<DataPipeType, LedgerLoaderType, LedgerPublisherType, AmendmentBlockHandlerType>;
+    using BackfillerType = etl::impl::Backfiller<LoadBalancerType, LedgerLoaderType>;
+
+    static constexpr std::size_t DEFAULT_EXTRACTOR_MEMORY_BUDGET_MB = 1024;
 
     util::Logger log_{"ETL"};
 
@@ -96,15 +104,22 @@ class ETLService {
     std::shared_ptr<NetworkValidatedLedgersInterface> networkValidatedLedgers_;
 
     std::uint32_t extractorThreads_ = 1;
+    std::size_t extractorMemoryBudget_ = DEFAULT_EXTRACTOR_MEMORY_BUDGET_MB * 1024 * 1024;
     std::thread worker_;
+    std::thread closeTimeIndexLoader_;
 
     CacheLoaderType cacheLoader_;
     LedgerFetcherType ledgerFetcher_;
     LedgerLoaderType ledgerLoader_;
+    std::shared_ptr<etl::impl::LedgerDiffBroadcaster> ledgerBroadcaster_;
+    std::shared_ptr<etl::impl::LedgerDiffReceiver> ledgerReceiver_;
     LedgerPublisherType ledgerPublisher_;
     AmendmentBlockHandlerType amendmentBlockHandler_;
 
     SystemState state_;
+    HistoryPruner historyPruner_;
+    std::optional<WriterLease> writerLease_;
+    BackfillerType backfiller_;
 
     size_t numMarkers_ = 2;
     std::optional<uint32_t> startSequence_;
@@ -170,9 +185,17 @@ public:
 
         state_.isStopping = true;
         cacheLoader_.stop();
+        historyPruner_.stop();
+        backfiller_.stop();
+        if (ledgerBroadcaster_)
+            ledgerBroadcaster_->stop();
+        if (ledgerReceiver_)
+            ledgerReceiver_->stop();
 
         if (worker_.joinable())
             worker_.join();
+        if (closeTimeIndexLoader_.joinable())
+            closeTimeIndexLoader_.join();
 
         LOG(log_.debug()) << "Joined ETLService worker thread";
     }
@@ -283,6 +306,21 @@ private:
     void
     monitorReadOnly();
 
+    /**
+     * @brief Publish a ledger received from the ETL writer over the ledger stream, if enabled.
+     *
+     * @param sequence the ledger sequence to publish
+     * @return true if the ledger was received and published; false if it has to be read from the database instead
+     */
+    bool
+    publishFromLedgerStream(uint32_t sequence);
+
+    /**
+     * @brief Load the close times of all ledgers in the DB into the close time index of the backend.
+     */
+    void
+    loadCloseTimeIndex();
+
     /**
      * @return true if stopping; false otherwise
      */
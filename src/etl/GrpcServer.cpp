@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/GrpcServer.hpp"
+
+#include "data/BackendInterface.hpp"
+#include "util/config/Config.hpp"
+#include "util/log/Logger.hpp"
+
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server_builder.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace etl {
+
+GrpcServer::GrpcServer(std::string const& ip, std::string const& port, std::shared_ptr<BackendInterface> backend)
+    : service_{std::move(backend)}
+{
+    auto const address = ip + ":" + port;
+
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(address, grpc::InsecureServerCredentials());
+    builder.RegisterService(&service_);
+    builder.SetMaxSendMessageSize(-1);
+
+    server_ = builder.BuildAndStart();
+    if (not server_)
+        throw std::runtime_error("Failed to start gRPC server on " + address);
+
+    LOG(log_.info()) << "gRPC server listening on " << address;
+}
+
+GrpcServer::~GrpcServer()
+{
+    server_->Shutdown();
+}
+
+std::unique_ptr<GrpcServer>
+GrpcServer::make_GrpcServer(util::Config const& config, std::shared_ptr<BackendInterface> backend)
+{
+    if (not config.contains("grpc_server"))
+        return nullptr;
+
+    auto const serverConfig = config.section("grpc_server");
+    return std::make_unique<GrpcServer>(
+        serverConfig.valueOr<std::string>("ip", "127.0.0.1"),
+        serverConfig.valueOrThrow<std::string>("port", "grpc_server.port is required"),
+        std::move(backend)
+    );
+}
+
+}  // namespace etl
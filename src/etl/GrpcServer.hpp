@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/BackendInterface.hpp"
+#include "etl/impl/GrpcLedgerService.hpp"
+#include "util/config/Config.hpp"
+#include "util/log/Logger.hpp"
+
+#include <grpcpp/server.h>
+
+#include <memory>
+#include <string>
+
+namespace etl {
+
+/**
+ * @brief A gRPC server allowing other Clio nodes to use this one as an ETL source.
+ *
+ * Serves GetLedger and GetLedgerData of rippled's XRPLedgerAPIService from the database and cache, so that tiers of
+ * Clio nodes can extract ledgers and download their initial ledger from each other instead of from rippled.
+ */
+class GrpcServer {
+    util::Logger log_{"ETL"};
+
+    impl::GrpcLedgerService service_;
+    std::unique_ptr<grpc::Server> server_;
+
+public:
+    /**
+     * @brief Create a server and start listening
+     *
+     * @param ip The address to listen on
+     * @param port The port to listen on
+     * @param backend The backend to read ledgers from
+     * @throws std::runtime_error if the server could not be started
+     */
+    GrpcServer(std::string const& ip, std::string const& port, std::shared_ptr<BackendInterface> backend);
+
+    /**
+     * @brief Stop the server, waiting for the requests in progress to finish
+     */
+    ~GrpcServer();
+
+    GrpcServer(GrpcServer const&) = delete;
+    GrpcServer&
+    operator=(GrpcServer const&) = delete;
+
+    /**
+     * @brief A factory function creating a server if it is enabled in the config
+     *
+     * @param config The configuration to use
+     * @param backend The backend to read ledgers from
+     * @return The running server; nullptr if grpc_server is not configured
+     */
+    static std::unique_ptr<GrpcServer>
+    make_GrpcServer(util::Config const& config, std::shared_ptr<BackendInterface> backend);
+};
+
+}  // namespace etl
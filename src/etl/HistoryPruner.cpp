@@ -0,0 +1,241 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/HistoryPruner.hpp"
+
+#include "data/BackendInterface.hpp"
+#include "data/DBHelpers.hpp"
+#include "etl/NFTHelpers.hpp"
+#include "etl/SystemState.hpp"
+#include "util/config/Config.hpp"
+#include "util/log/Logger.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <xrpl/beast/core/CurrentThreadName.h>
+#include <xrpl/protocol/STTx.h>
+#include <xrpl/protocol/Serializer.h>
+#include <xrpl/protocol/TxMeta.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace etl {
+
+[[nodiscard]] bool
+HistoryPrunerSettings::isEnabled() const
+{
+    return minSequence.has_value() or retainLedgers.has_value();
+}
+
+[[nodiscard]] std::optional<std::uint32_t>
+HistoryPrunerSettings::targetMinSequence(std::uint32_t const maxSequence) const
+{
+    std::optional<std::uint32_t> target;
+    if (minSequence)
+        target = std::min(*minSequence, maxSequence);
+
+    if (retainLedgers and maxSequence >= *retainLedgers)
+        target = std::max(target.value_or(0), maxSequence - *retainLedgers + 1);
+
+    return target;
+}
+
+[[nodiscard]] HistoryPrunerSettings
+make_HistoryPrunerSettings(util::Config const& config)
+{
+    HistoryPrunerSettings settings;
+    if (not config.contains("online_delete"))
+        return settings;
+
+    auto const section = config.section("online_delete");
+    settings.minSequence = section.maybeValue<std::uint32_t>("min_sequence");
+    settings.retainLedgers = section.maybeValue<std::uint32_t>("retain_ledgers");
+    settings.step = section.valueOr<std::uint32_t>("step", settings.step);
+    settings.maxLedgersPerSecond =
+        section.valueOr<std::uint32_t>("max_ledgers_per_second", settings.maxLedgersPerSecond);
+    settings.intervalSeconds = section.valueOr<std::uint32_t>("interval", settings.intervalSeconds);
+
+    if (settings.retainLedgers == 0u)
+        throw std::runtime_error("online_delete.retain_ledgers must be greater than 0");
+    if (settings.step == 0)
+        throw std::runtime_error("online_delete.step must be greater than 0");
+
+    return settings;
+}
+
+HistoryPruner::HistoryPruner(
+    HistoryPrunerSettings settings,
+    std::shared_ptr<BackendInterface> backend,
+    SystemState const& state
+)
+    : backend_{std::move(backend)}, state_{state}, settings_{settings}
+{
+}
+
+HistoryPruner::~HistoryPruner()
+{
+    stop();
+}
+
+void
+HistoryPruner::run()
+{
+    if (not settings_.isEnabled() or worker_.joinable())
+        return;
+
+    LOG(log_.info()) << "Starting online deletion. step = " << settings_.step
+                     << "; max ledgers per second = " << settings_.maxLedgersPerSecond;
+
+    worker_ = std::thread([this]() {
+        beast::setCurrentThreadName("ETLService history pruner");
+
+        while (not isStopping()) {
+            if (state_.get().isWriting)
+                prune();
+
+            std::unique_lock lck(mtx_);
+            cv_.wait_for(lck, std::chrono::seconds{settings_.intervalSeconds}, [this]() { return isStopping(); });
+        }
+    });
+}
+
+void
+HistoryPruner::stop()
+{
+    {
+        std::scoped_lock const lck(mtx_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    if (worker_.joinable())
+        worker_.join();
+}
+
+std::uint32_t
+HistoryPruner::prune()
+{
+    auto const range = backend_->hardFetchLedgerRangeNoThrow();
+    if (not range)
+        return 0;
+
+    auto const target = settings_.targetMinSequence(range->maxSequence);
+    if (not target or *target <= range->minSequence)
+        return 0;
+
+    LOG(log_.info()) << "Deleting history from " << range->minSequence << " up to " << *target;
+
+    std::uint32_t numDeleted = 0;
+    auto currentMin = range->minSequence;
+    while (currentMin < *target and not isStopping()) {
+        auto const newMin = std::min(*target, currentMin + settings_.step);
+        if (not backend_->advanceMinSequence(currentMin, newMin)) {
+            LOG(log_.warn()) << "Min sequence was changed by another process. Stop deleting history";
+            break;
+        }
+
+        // The ledgers are not served anymore, finish the step even if stopping to not leave orphaned data behind
+        for (auto seq = currentMin; seq < newMin; ++seq) {
+            throttle();
+
+            auto const history = data::synchronousAndRetryOnTimeout([this, seq](auto yield) {
+                return collectLedgerHistory(seq, yield);
+            });
+            data::synchronousAndRetryOnTimeout([this, &history, newMin](auto yield) {
+                backend_->deleteLedgerHistory(history, newMin, yield);
+            });
+
+            ++numDeleted;
+        }
+
+        LOG(log_.info()) << "Deleted history of ledgers " << currentMin << " to " << newMin - 1;
+        currentMin = newMin;
+    }
+
+    return numDeleted;
+}
+
+LedgerHistoryData
+HistoryPruner::collectLedgerHistory(std::uint32_t const sequence, boost::asio::yield_context yield) const
+{
+    LedgerHistoryData result;
+    result.ledgerSequence = sequence;
+
+    if (auto const header = backend_->fetchLedgerBySequence(sequence, yield); header)
+        result.ledgerHash = header->hash;
+
+    for (auto const& txn : backend_->fetchAllTransactionsInLedger(sequence, yield)) {
+        ripple::SerialIter it{txn.transaction.data(), txn.transaction.size()};
+        ripple::STTx const sttx{it};
+        ripple::TxMeta txMeta{sttx.getTransactionID(), sequence, txn.metadata};
+
+        result.txHashes.push_back(sttx.getTransactionID());
+
+        auto const accounts = txMeta.getAffectedAccounts();
+        result.accounts.insert(accounts.begin(), accounts.end());
+
+        auto const [nftTxs, _] = getNFTDataFromTx(txMeta, sttx);
+        for (auto const& nftTx : nftTxs)
+            result.nftIDs.insert(nftTx.tokenID);
+    }
+
+    for (auto const& object : backend_->fetchLedgerDiff(sequence, yield))
+        result.objectKeys.push_back(object.key);
+
+    return result;
+}
+
+void
+HistoryPruner::throttle()
+{
+    static constexpr auto BUSY_DELAY = std::chrono::milliseconds{100};
+
+    // deleting history must never slow down ETL, so back off while the DB is overwhelmed
+    while (backend_->isTooBusy() and not isStopping())
+        std::this_thread::sleep_for(BUSY_DELAY);
+
+    if (settings_.maxLedgersPerSecond == 0 or isStopping())
+        return;
+
+    // pace against a deadline rather than sleeping a full period after each ledger, so the time spent deleting
+    // counts towards the period and the configured rate is actually reached
+    auto const period = std::chrono::steady_clock::duration{std::chrono::seconds{1}} / settings_.maxLedgersPerSecond;
+    auto const now = std::chrono::steady_clock::now();
+
+    if (nextDeletion_ > now)
+        std::this_thread::sleep_until(nextDeletion_);
+
+    nextDeletion_ = std::max(nextDeletion_, now) + period;
+}
+
+[[nodiscard]] bool
+HistoryPruner::isStopping() const
+{
+    return stopping_ or state_.get().isStopping;
+}
+
+}  // namespace etl
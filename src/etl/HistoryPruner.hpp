@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/BackendInterface.hpp"
+#include "data/DBHelpers.hpp"
+#include "etl/SystemState.hpp"
+#include "util/config/Config.hpp"
+#include "util/log/Logger.hpp"
+
+#include <boost/asio/spawn.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace etl {
+
+/**
+ * @brief Settings for online deletion of old ledger history
+ */
+struct HistoryPrunerSettings {
+    std::optional<std::uint32_t> minSequence;   /**< history below this sequence is deleted */
+    std::optional<std::uint32_t> retainLedgers; /**< number of most recent ledgers to keep */
+    std::uint32_t step = 100;                   /**< number of ledgers removed per update of the ledger range */
+    std::uint32_t maxLedgersPerSecond = 200;    /**< upper bound on the deletion rate; 0 means unlimited */
+    std::uint32_t intervalSeconds = 60;         /**< how often to check whether there is history to delete */
+
+    auto
+    operator<=>(HistoryPrunerSettings const&) const = default;
+
+    /** @returns True if either a min sequence or a retention window is configured; false otherwise */
+    [[nodiscard]] bool
+    isEnabled() const;
+
+    /**
+     * @brief Calculate the minimum sequence that should be available in the DB.
+     *
+     * @param maxSequence The latest sequence available in the DB
+     * @return The new minimum sequence; nullopt if nothing should be deleted
+     */
+    [[nodiscard]] std::optional<std::uint32_t>
+    targetMinSequence(std::uint32_t maxSequence) const;
+};
+
+/**
+ * @brief Create a HistoryPrunerSettings object from the `online_delete` section of a Config object
+ *
+ * @param config The configuration object
+ * @returns The HistoryPrunerSettings object
+ * @throws std::runtime_error if `retain_ledgers` or `step` is 0
+ */
+[[nodiscard]] HistoryPrunerSettings
+make_HistoryPrunerSettings(util::Config const& config);
+
+/**
+ * @brief Deletes ledger history that fell out of the configured retention window.
+ *
+ * Runs on a dedicated thread and only does work while this process is the ETL writer. History is deleted in steps:
+ * the minimum of the ledger range is advanced first, so readers stop serving the affected ledgers, and the data of
+ * those ledgers is deleted afterwards at a limited rate.
+ *
+ * The newest version of every object that is still live at the new minimum is kept. Successor entries are only pruned
+ * for the keys found in the diff of a deleted ledger and the NFT tables are not pruned at all. If the process stops in
+ * the middle of a step the remaining ledgers of that step are left in the database.
+ */
+class HistoryPruner {
+    util::Logger log_{"ETL"};
+    std::shared_ptr<BackendInterface> backend_;
+    std::reference_wrapper<SystemState const> state_;
+    HistoryPrunerSettings settings_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::atomic_bool stopping_ = false;
+    std::thread worker_;
+
+    // only touched by the thread running prune()
+    std::chrono::steady_clock::time_point nextDeletion_;
+
+public:
+    /**
+     * @brief Construct a new History Pruner object
+     *
+     * @param settings The settings to use
+     * @param backend The backend to delete history from
+     * @param state The state of the ETL subsystem
+     */
+    HistoryPruner(HistoryPrunerSettings settings, std::shared_ptr<BackendInterface> backend, SystemState const& state);
+
+    /**
+     * @brief Stops the pruner and joins the worker thread
+     */
+    ~HistoryPruner();
+
+    HistoryPruner(HistoryPruner const&) = delete;
+    HistoryPruner&
+    operator=(HistoryPruner const&) = delete;
+
+    /**
+     * @brief Spawn the worker thread if online deletion is enabled
+     */
+    void
+    run();
+
+    /**
+     * @brief Requests the pruner to stop and waits for the worker thread to finish
+     */
+    void
+    stop();
+
+    /**
+     * @brief Delete all history below the current target minimum sequence.
+     *
+     * @return The number of ledgers that were deleted
+     */
+    std::uint32_t
+    prune();
+
+private:
+    [[nodiscard]] LedgerHistoryData
+    collectLedgerHistory(std::uint32_t sequence, boost::asio::yield_context yield) const;
+
+    void
+    throttle();
+
+    [[nodiscard]] bool
+    isStopping() const;
+};
+
+}  // namespace etl
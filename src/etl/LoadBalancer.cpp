@@ -23,28 +23,40 @@
 #include "etl/ETLState.hpp"
 #include "etl/NetworkValidatedLedgersInterface.hpp"
 #include "etl/Source.hpp"
+#include "etl/impl/ForwardingCache.hpp"
+#include "etl/impl/ForwardingCoalescer.hpp"
+#include "etl/impl/LedgerRecording.hpp"
+#include "etl/impl/SourceStats.hpp"
 #include "feed/SubscriptionManagerInterface.hpp"
 #include "rpc/Errors.hpp"
 #include "util/Assert.hpp"
 #include "util/Random.hpp"
 #include "util/log/Logger.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
 
+#include <boost/asio/experimental/concurrent_channel.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/json/array.hpp>
 #include <boost/json/object.hpp>
 #include <boost/json/value.hpp>
+#include <boost/system/error_code.hpp>
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <memory>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -53,6 +65,28 @@ using namespace util;
 
 namespace etl {
 
+namespace {
+
+// the result of one of the requests of a hedged forward
+struct HedgeAttempt {
+    std::size_t sourceIdx = 0;
+    std::expected<boost::json::object, rpc::ClioError> response;
+};
+
+// responses shared between requests carry the id of the request they were received for
+boost::json::object
+withRequestId(boost::json::object response, boost::json::object const& request)
+{
+    if (auto const it = request.find("id"); it != request.end()) {
+        response["id"] = it->value();
+    } else {
+        response.erase("id");
+    }
+    return response;
+}
+
+}  // namespace
+
 std::shared_ptr<LoadBalancer>
 LoadBalancer::make_LoadBalancer(
     Config const& config,
@@ -76,10 +110,48 @@ LoadBalancer::LoadBalancer(
     std::shared_ptr<NetworkValidatedLedgersInterface> validatedLedgers,
     SourceFactory sourceFactory
 )
+    : hedgeMinDelay_{Config::toMilliseconds(config.valueOr<float>("forwarding.hedge_min_delay", 0.05f))}
+    , hedgedRequests_{PrometheusService::counterInt(
+          "forwarding_hedged_total_number",
+          util::prometheus::Labels{},
+          "Number of forwarded requests also sent to a second source because the first one was slow or failed"
+      )}
+    , hedgeWins_{PrometheusService::counterInt(
+          "forwarding_hedge_won_total_number",
+          util::prometheus::Labels{},
+          "Number of hedged forwarded requests answered by the second source"
+      )}
 {
+    if (auto const commands = config.maybeArray("forwarding.idempotent_commands"); commands) {
+        idempotentCommands_.clear();
+        for (auto const& command : *commands) {
+            auto name =
+                command.valueOrThrow<std::string>("'forwarding.idempotent_commands' must contain command names");
+
+            // idempotent commands may be sent twice by hedging and answered from the cache
+            if (not impl::ForwardingCache::READ_ONLY_COMMANDS.contains(name)) {
+                throw std::runtime_error(
+                    fmt::format("'forwarding.idempotent_commands' must only contain read-only commands, got '{}'", name)
+                );
+            }
+            idempotentCommands_.insert(std::move(name));
+        }
+    }
+
+    if (auto const percentile = config.maybeValue<double>("forwarding.hedge_percentile"); percentile) {
+        if (*percentile <= 0. or *percentile >= 1.)
+            throw std::runtime_error("'forwarding.hedge_percentile' must be between 0 and 1");
+        hedgePercentile_ = *percentile;
+    }
+
     auto const forwardingCacheTimeout = config.valueOr<float>("forwarding.cache_timeout", 0.f);
     if (forwardingCacheTimeout > 0.f) {
-        forwardingCache_ = impl::ForwardingCache{Config::toMilliseconds(forwardingCacheTimeout)};
+        forwardingCache_.emplace(Config::toMilliseconds(forwardingCacheTimeout), idempotentCommands_);
+    }
+
+    if (auto const recordingFile = config.maybeValue<std::string>("etl_recording_file"); recordingFile) {
+        LOG(log_.warn()) << "Recording fetched ledgers to " << *recordingFile;
+        recorder_.emplace(*recordingFile);
     }
 
     static constexpr std::uint32_t MAX_DOWNLOAD = 256;
@@ -103,6 +175,7 @@ LoadBalancer::LoadBalancer(
 
     auto const forwardingTimeout = Config::toMilliseconds(config.valueOr<float>("forwarding.request_timeout", 10.));
     for (auto const& entry : config.array("etl_sources")) {
+        auto const sourceIdx = sources_.size();
         auto source = sourceFactory(
             entry,
             ioc,
@@ -110,11 +183,15 @@ LoadBalancer::LoadBalancer(
             subscriptions,
             validatedLedgers,
             forwardingTimeout,
-            [this]() {
+            [this, sourceIdx]() {
+                sourceStats_[sourceIdx]->setConnected(true);
                 if (not hasForwardingSource_)
                     chooseForwardingSource();
             },
-            [this]() { chooseForwardingSource(); },
+            [this, sourceIdx]() {
+                sourceStats_[sourceIdx]->setConnected(false);
+                chooseForwardingSource();
+            },
             [this]() {
                 if (forwardingCache_.has_value())
                     forwardingCache_->invalidate();
@@ -139,6 +216,7 @@ LoadBalancer::LoadBalancer(
         }
 
         sources_.push_back(std::move(source));
+        sourceStats_.push_back(std::make_unique<impl::SourceStats>(std::to_string(sourceStats_.size())));
         LOG(log_.info()) << "Added etl source - " << sources_.back()->toString();
     }
 
@@ -178,11 +256,30 @@ LoadBalancer::loadInitialLedger(uint32_t sequence, bool cacheOnly, std::chrono::
             return res;
         },
         sequence,
+        impl::SourceStats::Operation::LoadInitialLedger,
         retryAfter
     );
     return response;
 }
 
+void
+LoadBalancer::loadLedgerState(uint32_t sequence, std::chrono::steady_clock::duration retryAfter)
+{
+    execute(
+        [this, sequence](auto& source) {
+            auto const res = source->loadLedgerState(sequence, downloadRanges_);
+            if (!res) {
+                LOG(log_.error()) << "Failed to download ledger state."
+                                  << " Sequence = " << sequence << " source = " << source->toString();
+            }
+            return res;
+        },
+        sequence,
+        impl::SourceStats::Operation::LoadInitialLedger,
+        retryAfter
+    );
+}
+
 LoadBalancer::OptionalGetLedgerResponseType
 LoadBalancer::fetchLedger(
     uint32_t ledgerSequence,
@@ -191,6 +288,12 @@ LoadBalancer::fetchLedger(
     std::chrono::steady_clock::duration retryAfter
 )
 {
+    // recordings are replayed without the state of the previous ledger, so they must contain the neighbors. The
+    // initial ledger is fetched without objects and is not recorded.
+    auto const record = recorder_.has_value() and getObjects;
+    if (record)
+        getObjectNeighbors = true;
+
     GetLedgerResponseType response;
     execute(
         [&response, ledgerSequence, getObjects, getObjectNeighbors, log = log_](auto& source) {
@@ -208,8 +311,13 @@ LoadBalancer::fetchLedger(
             return false;
         },
         ledgerSequence,
+        impl::SourceStats::Operation::FetchLedger,
         retryAfter
     );
+
+    if (record and response.validated())
+        recorder_->record(response);
+
     return response;
 }
 
@@ -223,56 +331,194 @@ LoadBalancer::forwardToRippled(
 {
     if (forwardingCache_) {
         if (auto cachedResponse = forwardingCache_->get(request); cachedResponse) {
-            return std::move(cachedResponse).value();
+            return withRequestId(std::move(cachedResponse).value(), request);
         }
     }
 
     ASSERT(not sources_.empty(), "ETL sources must be configured to forward requests.");
-    std::size_t sourceIdx = util::Random::uniform(0ul, sources_.size() - 1);
+    auto const xUserValue = isAdmin ? ADMIN_FORWARDING_X_USER_VALUE : USER_FORWARDING_X_USER_VALUE;
+
+    auto const commandIt = request.find("command");
+    auto const isIdempotent = commandIt != request.end() and commandIt->value().is_string() and
+        idempotentCommands_.contains(std::string{commandIt->value().as_string()});
+
+    auto const forward = [&]() -> std::expected<boost::json::object, rpc::ClioError> {
+        auto response = forwardToSources(request, clientIp, xUserValue, isIdempotent, yield);
+        if (response and forwardingCache_ and not response->contains("error"))
+            forwardingCache_->put(request, *response);
+        return response;
+    };
+
+    if (not isIdempotent)
+        return forward();
 
-    auto numAttempts = 0u;
+    std::string const command{commandIt->value().as_string()};
+    auto const key = fmt::format("{}|{}", xUserValue, impl::ForwardingCache::makeKey(request));
+    auto response = forwardingCoalescer_.forward(command, key, forward, yield);
+    if (not response)
+        return response;
 
-    auto xUserValue = isAdmin ? ADMIN_FORWARDING_X_USER_VALUE : USER_FORWARDING_X_USER_VALUE;
+    return withRequestId(std::move(response).value(), request);
+}
 
-    std::optional<boost::json::object> response;
+std::expected<boost::json::object, rpc::ClioError>
+LoadBalancer::forwardToSources(
+    boost::json::object const& request,
+    std::optional<std::string> const& clientIp,
+    std::string_view xUserValue,
+    bool hedge,
+    boost::asio::yield_context yield
+)
+{
+    auto const firstIdx = pickSource(impl::SourceStats::Operation::Forward);
+    std::vector<std::size_t> tried;
     rpc::ClioError error = rpc::ClioError::etlCONNECTION_ERROR;
-    while (numAttempts < sources_.size()) {
-        auto res = sources_[sourceIdx]->forwardToRippled(request, clientIp, xUserValue, yield);
-        if (res) {
-            response = std::move(res).value();
-            break;
+
+    if (hedge and hedgePercentile_ and sources_.size() > 1) {
+        // hedging to a disconnected source would only add a failing request
+        auto const hedgeIdx = pickSource(impl::SourceStats::Operation::Forward, std::array{firstIdx});
+        if (sourceStats_[hedgeIdx]->isConnected()) {
+            auto res = forwardHedged(firstIdx, hedgeIdx, request, clientIp, xUserValue, yield);
+            if (res)
+                return res;
+
+            error = res.error();
+            tried = {firstIdx, hedgeIdx};
         }
+    }
+
+    for (std::size_t n = 0; n < sources_.size(); ++n) {
+        auto const sourceIdx = (firstIdx + n) % sources_.size();
+        if (std::ranges::find(tried, sourceIdx) != tried.end())
+            continue;
+
+        auto res = forwardToSource(sourceIdx, request, clientIp, xUserValue, yield);
+        if (res)
+            return res;
+
         error = std::max(error, res.error());  // Choose the best result between all sources
+    }
 
-        sourceIdx = (sourceIdx + 1) % sources_.size();
-        ++numAttempts;
+    return std::unexpected{error};
+}
+
+std::expected<boost::json::object, rpc::ClioError>
+LoadBalancer::forwardHedged(
+    std::size_t const sourceIdx,
+    std::size_t const hedgeSourceIdx,
+    boost::json::object const& request,
+    std::optional<std::string> const& clientIp,
+    std::string_view xUserValue,
+    boost::asio::yield_context yield
+)
+{
+    // an empty message means the hedge delay has passed
+    using Channel =
+        boost::asio::experimental::concurrent_channel<void(boost::system::error_code, std::optional<HedgeAttempt>)>;
+
+    // the losing request outlives this function, so it gets copies of everything it needs and keeps the sources alive
+    auto const channel = std::make_shared<Channel>(yield.get_executor(), 3);
+    auto const start = [self = shared_from_this(),
+                        channel,
+                        request,
+                        clientIp,
+                        xUserValue = std::string{xUserValue}](std::size_t idx) {
+        boost::asio::spawn(channel->get_executor(), [=](boost::asio::yield_context yield) {
+            auto response = self->forwardToSource(idx, request, clientIp, xUserValue, yield);
+            channel->try_send(
+                boost::system::error_code{}, HedgeAttempt{.sourceIdx = idx, .response = std::move(response)}
+            );
+        });
+    };
+
+    auto delay = hedgeMinDelay_;
+    if (auto const percentile =
+            sourceStats_[sourceIdx]->latencyPercentile(impl::SourceStats::Operation::Forward, *hedgePercentile_);
+        percentile) {
+        delay = std::max(delay, *percentile);
     }
 
-    if (response) {
-        if (forwardingCache_ and not response->contains("error"))
-            forwardingCache_->put(request, *response);
-        return std::move(response).value();
+    boost::asio::spawn(yield.get_executor(), [channel, delay](boost::asio::yield_context yield) {
+        boost::asio::steady_timer timer{yield.get_executor(), delay};
+        boost::system::error_code ec;
+        timer.async_wait(yield[ec]);
+        channel->try_send(boost::system::error_code{}, std::nullopt);
+    });
+
+    start(sourceIdx);
+    auto numPending = 1u;
+    auto hedged = false;
+
+    rpc::ClioError error = rpc::ClioError::etlCONNECTION_ERROR;
+    while (numPending > 0 or not hedged) {
+        boost::system::error_code ec;
+        auto attempt = channel->async_receive(yield[ec]);
+        if (ec)
+            break;
+
+        if (attempt) {
+            --numPending;
+            if (attempt->response) {
+                if (attempt->sourceIdx == hedgeSourceIdx)
+                    ++hedgeWins_.get();
+                return std::move(attempt->response);
+            }
+            error = std::max(error, attempt->response.error());
+        }
+
+        // the delay has passed or the first source failed early
+        if (not hedged) {
+            LOG(log_.debug()) << "Hedging forwarded request to " << sources_[hedgeSourceIdx]->toString();
+            ++hedgedRequests_.get();
+            start(hedgeSourceIdx);
+            ++numPending;
+            hedged = true;
+        }
     }
 
     return std::unexpected{error};
 }
 
+std::expected<boost::json::object, rpc::ClioError>
+LoadBalancer::forwardToSource(
+    std::size_t const sourceIdx,
+    boost::json::object const& request,
+    std::optional<std::string> const& clientIp,
+    std::string_view xUserValue,
+    boost::asio::yield_context yield
+)
+{
+    auto& stats = *sourceStats_[sourceIdx];
+    auto const start = stats.start(impl::SourceStats::Operation::Forward);
+    auto response = sources_[sourceIdx]->forwardToRippled(request, clientIp, xUserValue, yield);
+    stats.finish(impl::SourceStats::Operation::Forward, start, response.has_value());
+    return response;
+}
+
 boost::json::value
 LoadBalancer::toJson() const
 {
     boost::json::array ret;
-    for (auto& src : sources_)
-        ret.push_back(src->toJson());
+    for (std::size_t i = 0; i < sources_.size(); ++i) {
+        auto json = sources_[i]->toJson();
+        json["stats"] = sourceStats_[i]->toJson();
+        ret.push_back(std::move(json));
+    }
 
     return ret;
 }
 
 template <typename Func>
 void
-LoadBalancer::execute(Func f, uint32_t ledgerSequence, std::chrono::steady_clock::duration retryAfter)
+LoadBalancer::execute(
+    Func f,
+    uint32_t ledgerSequence,
+    impl::SourceStats::Operation op,
+    std::chrono::steady_clock::duration retryAfter
+)
 {
     ASSERT(not sources_.empty(), "ETL sources must be configured to execute functions.");
-    size_t sourceIdx = util::Random::uniform(0ul, sources_.size() - 1);
+    size_t sourceIdx = pickSource(op);
 
     size_t numAttempts = 0;
 
@@ -286,7 +532,10 @@ LoadBalancer::execute(Func f, uint32_t ledgerSequence, std::chrono::steady_clock
         but this does NOT happen in the normal case and is safe to remove
         This || true is only needed when loading full history standalone */
         if (source->hasLedger(ledgerSequence)) {
+            auto& stats = *sourceStats_[sourceIdx];
+            auto const start = stats.start(op);
             bool const res = f(source);
+            stats.finish(op, start, res);
             if (res) {
                 LOG(log_.debug()) << "Successfully executed func at source = " << source->toString()
                                   << " - ledger sequence = " << ledgerSequence;
@@ -309,6 +558,34 @@ LoadBalancer::execute(Func f, uint32_t ledgerSequence, std::chrono::steady_clock
     }
 }
 
+std::size_t
+LoadBalancer::pickSource(impl::SourceStats::Operation op, std::span<std::size_t const> excluded) const
+{
+    ASSERT(excluded.size() < sources_.size(), "At least one source must not be excluded");
+
+    // start from a random source so that sources with equal scores (e.g. not measured yet) share the load
+    auto const first = util::Random::uniform(0ul, sources_.size() - 1);
+    std::optional<std::size_t> best;
+    auto bestScore = 0.0;
+    auto bestConnected = false;
+
+    // disconnected sources are only used if no source is connected
+    for (std::size_t n = 0; n < sourceStats_.size(); ++n) {
+        auto const i = (first + n) % sourceStats_.size();
+        if (std::ranges::find(excluded, i) != excluded.end())
+            continue;
+
+        auto const score = sourceStats_[i]->score(op);
+        auto const connected = sourceStats_[i]->isConnected();
+        if (not best or (connected and not bestConnected) or (connected == bestConnected and score < bestScore)) {
+            best = i;
+            bestScore = score;
+            bestConnected = connected;
+        }
+    }
+    return *best;
+}
+
 std::optional<ETLState>
 LoadBalancer::getETLState() noexcept
 {
@@ -24,9 +24,13 @@
 #include "etl/NetworkValidatedLedgersInterface.hpp"
 #include "etl/Source.hpp"
 #include "etl/impl/ForwardingCache.hpp"
+#include "etl/impl/ForwardingCoalescer.hpp"
+#include "etl/impl/LedgerRecording.hpp"
+#include "etl/impl/SourceStats.hpp"
 #include "feed/SubscriptionManagerInterface.hpp"
 #include "rpc/Errors.hpp"
 #include "util/config/Config.hpp"
+#include "util/prometheus/Counter.hpp"
 #include "util/log/Logger.hpp"
 
 #include <boost/asio.hpp>
@@ -41,12 +45,16 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
+#include <unordered_set>
 #include <vector>
 
 namespace etl {
@@ -57,8 +65,10 @@ namespace etl {
  * This class spawns a listener for each etl source, which listens to messages on the ledgers stream (to keep track of
  * which ledgers have been validated by the network, and the range of ledgers each etl source has). This class also
  * allows requests for ledger data to be load balanced across all possible ETL sources.
+ *
+ * @note Must be owned by a std::shared_ptr, as hedged requests keep the load balancer alive until they finish.
  */
-class LoadBalancer {
+class LoadBalancer : public std::enable_shared_from_this<LoadBalancer> {
 public:
     using RawLedgerObjectType = org::xrpl::rpc::v1::RawLedgerObject;
     using GetLedgerResponseType = org::xrpl::rpc::v1::GetLedgerResponse;
@@ -71,12 +81,20 @@ private:
     // Forwarding cache must be destroyed after sources because sources have a callback to invalidate cache
     std::optional<impl::ForwardingCache> forwardingCache_;
     std::optional<std::string> forwardingXUserValue_;
+    std::unordered_set<std::string> idempotentCommands_ = impl::ForwardingCache::CACHEABLE_COMMANDS;
+    impl::ForwardingCoalescer forwardingCoalescer_;
+    std::optional<double> hedgePercentile_;  // hedging is off if not set
+    std::chrono::steady_clock::duration hedgeMinDelay_;
+    std::reference_wrapper<util::prometheus::CounterInt> hedgedRequests_;
+    std::reference_wrapper<util::prometheus::CounterInt> hedgeWins_;
 
     std::vector<SourcePtr> sources_;
+    std::vector<std::unique_ptr<impl::SourceStats>> sourceStats_;  // same order as sources_
     std::optional<ETLState> etlState_;
     std::uint32_t downloadRanges_ =
         DEFAULT_DOWNLOAD_RANGES; /*< The number of markers to use when downloading initial ledger */
     std::atomic_bool hasForwardingSource_{false};
+    std::optional<impl::LedgerRecorder> recorder_;  // records fetched ledgers if etl_recording_file is set
 
 public:
     /**
@@ -147,6 +165,16 @@ public:
         std::chrono::steady_clock::duration retryAfter = std::chrono::seconds{2}
     );
 
+    /**
+     * @brief Download the full state of a ledger into the database only, without touching the cache.
+     * @note This function will retry indefinitely until the state is downloaded.
+     *
+     * @param sequence Sequence of ledger to download
+     * @param retryAfter Time to wait between retries (2 seconds by default)
+     */
+    void
+    loadLedgerState(uint32_t sequence, std::chrono::steady_clock::duration retryAfter = std::chrono::seconds{2});
+
     /**
      * @brief Fetch data for a specific ledger.
      *
@@ -177,7 +205,11 @@ public:
     toJson() const;
 
     /**
-     * @brief Forward a JSON RPC request to a randomly selected rippled node.
+     * @brief Forward a JSON RPC request to a rippled node, preferring fast and lightly loaded nodes.
+     *
+     * Identical requests to idempotent commands that are forwarded at the same time share a single request to rippled.
+     * If hedging is configured, requests to idempotent commands that take longer than usual are also sent to a second
+     * source and the first successful response is used.
      *
      * @param request JSON-RPC request to forward
      * @param clientIp The IP address of the peer, if known
@@ -202,20 +234,103 @@ public:
 
 private:
     /**
-     * @brief Execute a function on a randomly selected source.
+     * @brief Execute a function on a source chosen by pickSource().
      *
      * @note f is a function that takes an Source as an argument and returns a bool.
-     * Attempt to execute f for one randomly chosen Source that has the specified ledger. If f returns false, another
-     * randomly chosen Source is used. The process repeats until f returns true.
+     * Attempt to execute f for the chosen Source if it has the specified ledger. If f returns false, the next Source is
+     * used. The process repeats until f returns true.
      *
      * @param f Function to execute. This function takes the ETL source as an argument, and returns a bool
      * @param ledgerSequence f is executed for each Source that has this ledger
+     * @param op The kind of operation f executes, used to measure the sources
      * @param retryAfter Time to wait between retries (2 seconds by default)
      * server is shutting down
      */
     template <typename Func>
     void
-    execute(Func f, uint32_t ledgerSequence, std::chrono::steady_clock::duration retryAfter = std::chrono::seconds{2});
+    execute(
+        Func f,
+        uint32_t ledgerSequence,
+        impl::SourceStats::Operation op,
+        std::chrono::steady_clock::duration retryAfter = std::chrono::seconds{2}
+    );
+
+    /**
+     * @brief Choose the source to send a request to first.
+     *
+     * The connected source with the lowest score for the operation is used, ties are broken randomly. As the score
+     * grows with the number of requests in flight, requests spread over the sources instead of all going to the
+     * fastest one. Disconnected sources are only chosen if no source is connected.
+     *
+     * @param op The kind of operation to execute
+     * @param excluded The indexes of sources that must not be chosen; at least one source must remain
+     * @return The index of the source
+     */
+    std::size_t
+    pickSource(impl::SourceStats::Operation op, std::span<std::size_t const> excluded = {}) const;
+
+    /**
+     * @brief Forward a request to the sources until one of them responds.
+     *
+     * @param request JSON-RPC request to forward
+     * @param clientIp The IP address of the peer, if known
+     * @param xUserValue The value of the X-User header
+     * @param hedge Whether the request may be hedged; only safe for idempotent commands
+     * @param yield The coroutine context
+     * @return Response received from rippled node as JSON object on success or error on failure
+     */
+    std::expected<boost::json::object, rpc::ClioError>
+    forwardToSources(
+        boost::json::object const& request,
+        std::optional<std::string> const& clientIp,
+        std::string_view xUserValue,
+        bool hedge,
+        boost::asio::yield_context yield
+    );
+
+    /**
+     * @brief Forward a request to a source, sending it to a second source as well if the response is late.
+     *
+     * The request is sent to the second source if the first one fails or does not respond within the configured
+     * percentile of its latency. The first successful response is returned; the other request is left to finish on
+     * its own and its response is dropped.
+     *
+     * @param sourceIdx The index of the source to send the request to first
+     * @param hedgeSourceIdx The index of the source to send the request to if the first one is late
+     * @param request JSON-RPC request to forward
+     * @param clientIp The IP address of the peer, if known
+     * @param xUserValue The value of the X-User header
+     * @param yield The coroutine context
+     * @return The first successful response or the best error if both sources failed
+     */
+    std::expected<boost::json::object, rpc::ClioError>
+    forwardHedged(
+        std::size_t sourceIdx,
+        std::size_t hedgeSourceIdx,
+        boost::json::object const& request,
+        std::optional<std::string> const& clientIp,
+        std::string_view xUserValue,
+        boost::asio::yield_context yield
+    );
+
+    /**
+     * @brief Forward a request to one source, recording its stats.
+     *
+     * @param sourceIdx The index of the source
+     * @param request JSON-RPC request to forward
+     * @param clientIp The IP address of the peer, if known
+     * @param xUserValue The value of the X-User header
+     * @param yield The coroutine context
+     * @return Response received from rippled node as JSON object on success or error on failure
+     */
+    std::expected<boost::json::object, rpc::ClioError>
+    forwardToSource(
+        std::size_t sourceIdx,
+        boost::json::object const& request,
+        std::optional<std::string> const& clientIp,
+        std::string_view xUserValue,
+        boost::asio::yield_context yield
+    );
 
     /**
      * @brief Choose a new source to forward requests
@@ -126,6 +126,16 @@ public:
     virtual std::pair<std::vector<std::string>, bool>
     loadInitialLedger(uint32_t sequence, std::uint32_t numMarkers, bool cacheOnly = false) = 0;
 
+    /**
+     * @brief Download the full state of a ledger into the database only, e.g. for a backfill.
+     *
+     * @param sequence Sequence of the ledger to download
+     * @param numMarkers Number of markers to generate for async calls
+     * @return true if the download was successful; false otherwise
+     */
+    virtual bool
+    loadLedgerState(uint32_t sequence, std::uint32_t numMarkers) = 0;
+
     /**
      * @brief Forward a request to rippled.
      *
@@ -0,0 +1,240 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/WriterLease.hpp"
+
+#include "data/BackendInterface.hpp"
+#include "etl/SystemState.hpp"
+#include "util/Assert.hpp"
+#include "util/config/Config.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <xrpl/beast/core/CurrentThreadName.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace etl {
+
+[[nodiscard]] bool
+WriterLeaseSettings::isEnabled() const
+{
+    return durationMs.has_value();
+}
+
+[[nodiscard]] WriterLeaseSettings
+make_WriterLeaseSettings(util::Config const& config)
+{
+    WriterLeaseSettings settings;
+    if (not config.contains("writer_lease"))
+        return settings;
+
+    auto const section = config.section("writer_lease");
+    settings.durationMs = section.maybeValue<std::uint32_t>("duration_ms");
+    if (not settings.durationMs)
+        return settings;
+
+    if (*settings.durationMs == 0)
+        throw std::runtime_error("writer_lease.duration_ms must be greater than 0");
+
+    // renewing a few times per lease duration tolerates a slow DB request without losing the lease
+    static constexpr std::uint32_t RENEWALS_PER_DURATION = 3;
+    settings.renewIntervalMs = section.valueOr<std::uint32_t>(
+        "renew_interval_ms", std::max<std::uint32_t>(*settings.durationMs / RENEWALS_PER_DURATION, 1)
+    );
+
+    if (settings.renewIntervalMs == 0 or settings.renewIntervalMs >= *settings.durationMs)
+        throw std::runtime_error("writer_lease.renew_interval_ms must be greater than 0 and less than duration_ms");
+
+    return settings;
+}
+
+WriterLease::WriterLease(
+    WriterLeaseSettings settings,
+    std::shared_ptr<BackendInterface> backend,
+    SystemState const& state
+)
+    : backend_{std::move(backend)}
+    , state_{state}
+    , settings_{settings}
+    , owner_{boost::uuids::to_string(boost::uuids::random_generator{}())}
+    , isOwner_{PrometheusService::boolMetric(
+          "etl_writer_lease_owned",
+          util::prometheus::Labels{},
+          "Whether this process holds the lease to be the ETL writer"
+      )}
+    , handoverTime_{PrometheusService::histogramInt(
+          "etl_writer_handover_milliseconds_histogram",
+          util::prometheus::Labels{},
+          std::vector<std::int64_t>{50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000},
+          "Time from the first missing ledger until this process became the ETL writer"
+      )}
+{
+    ASSERT(settings_.isEnabled(), "Writer lease must be enabled");
+    isOwner_ = false;
+}
+
+WriterLease::~WriterLease()
+{
+    release();
+}
+
+bool
+WriterLease::waitForLease(std::function<bool()> const& publishLedger)
+{
+    auto const start = std::chrono::steady_clock::now();
+    while (not state_.get().isStopping) {
+        if (publishLedger())
+            return false;
+
+        if (tryAcquire().value_or(false)) {
+            auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start
+            );
+            handoverTime_.get().observe(elapsed.count());
+            isOwner_ = true;
+
+            LOG(log_.info()) << "Acquired writer lease as " << owner_ << " after " << elapsed.count() << " ms";
+            return true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{settings_.renewIntervalMs});
+    }
+
+    return false;
+}
+
+void
+WriterLease::keepAlive(std::function<void()> onLost)
+{
+    stopRenewing();
+
+    {
+        std::scoped_lock const lck(mtx_);
+        renewing_ = true;
+    }
+
+    renewer_ = std::thread([this, onLost = std::move(onLost)]() {
+        beast::setCurrentThreadName("ETLService writer lease");
+
+        std::unique_lock lck(mtx_);
+        while (renewing_) {
+            cv_.wait_for(lck, std::chrono::milliseconds{settings_.renewIntervalMs}, [this]() {
+                return not renewing_;
+            });
+            if (not renewing_)
+                break;
+
+            auto const acquired = tryAcquire();
+            if (acquired.value_or(false))
+                continue;
+
+            if (not acquired) {
+                // the lease may still be ours; give up only if the next renewal would come too late
+                auto const renewInterval = std::chrono::milliseconds{settings_.renewIntervalMs};
+                if (std::chrono::steady_clock::now() + renewInterval < validUntil_)
+                    continue;
+
+                LOG(log_.warn()) << "Writer lease could not be renewed before it expired";
+            } else {
+                LOG(log_.warn()) << "Writer lease was taken over by another process";
+            }
+
+            isOwner_ = false;
+            renewing_ = false;
+            lck.unlock();
+
+            onLost();
+            return;
+        }
+    });
+}
+
+void
+WriterLease::release()
+{
+    stopRenewing();
+
+    if (isOwner()) {
+        backend_->releaseWriterLease(owner_);
+        isOwner_ = false;
+        LOG(log_.info()) << "Released writer lease";
+    }
+}
+
+bool
+WriterLease::isOwner() const
+{
+    return isOwner_;
+}
+
+std::string const&
+WriterLease::owner() const
+{
+    return owner_;
+}
+
+std::optional<bool>
+WriterLease::tryAcquire()
+{
+    auto const duration = std::chrono::milliseconds{*settings_.durationMs};
+    auto const requested = std::chrono::steady_clock::now();
+
+    try {
+        if (not backend_->tryAcquireWriterLease(owner_, duration))
+            return false;
+    } catch (data::DatabaseTimeout const&) {
+        LOG(log_.warn()) << "Could not access the writer lease in the DB";
+        return std::nullopt;
+    }
+
+    // the DB computes the expiry from a later time, so the local estimate errs on the safe side
+    validUntil_ = requested + duration;
+    return true;
+}
+
+void
+WriterLease::stopRenewing()
+{
+    {
+        std::scoped_lock const lck(mtx_);
+        renewing_ = false;
+    }
+    cv_.notify_all();
+
+    if (renewer_.joinable())
+        renewer_.join();
+}
+
+}  // namespace etl
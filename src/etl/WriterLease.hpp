@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/BackendInterface.hpp"
+#include "etl/SystemState.hpp"
+#include "util/config/Config.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Bool.hpp"
+#include "util/prometheus/Histogram.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace etl {
+
+/**
+ * @brief Settings for the lease that decides which process is the ETL writer
+ */
+struct WriterLeaseSettings {
+    std::optional<std::uint32_t> durationMs; /**< how long the lease stays valid without being renewed */
+    std::uint32_t renewIntervalMs = 0;       /**< how often the writer renews and standby processes try to take over */
+
+    auto
+    operator<=>(WriterLeaseSettings const&) const = default;
+
+    /** @returns True if a lease duration is configured; false otherwise */
+    [[nodiscard]] bool
+    isEnabled() const;
+};
+
+/**
+ * @brief Create a WriterLeaseSettings object from the `writer_lease` section of a Config object
+ *
+ * @param config The configuration object
+ * @returns The WriterLeaseSettings object
+ * @throws std::runtime_error if `duration_ms` is 0 or `renew_interval_ms` is not between 0 and `duration_ms`
+ */
+[[nodiscard]] WriterLeaseSettings
+make_WriterLeaseSettings(util::Config const& config);
+
+/**
+ * @brief A lease stored in the DB that allows a single process to be the ETL writer.
+ *
+ * The writer renews the lease in the background. A standby process that can't find a ledger validated by the network
+ * in the DB tries to take the lease over; this only succeeds once the writer stopped renewing it for the lease
+ * duration, so a crashed writer is replaced after at most the duration plus one renew interval. If the writer finds
+ * that the lease was taken over it reports a write conflict and steps down.
+ */
+class WriterLease {
+    util::Logger log_{"ETL"};
+    std::shared_ptr<BackendInterface> backend_;
+    std::reference_wrapper<SystemState const> state_;
+    WriterLeaseSettings settings_;
+    std::string owner_;
+
+    util::prometheus::Bool isOwner_;
+    std::reference_wrapper<util::prometheus::HistogramInt> handoverTime_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool renewing_ = false;
+    std::thread renewer_;
+    std::chrono::steady_clock::time_point validUntil_;  // when the lease expires unless it is renewed
+
+public:
+    /**
+     * @brief Construct a new Writer Lease object
+     *
+     * @param settings The settings to use; the lease must be enabled
+     * @param backend The backend storing the lease
+     * @param state The state of the ETL subsystem
+     */
+    WriterLease(WriterLeaseSettings settings, std::shared_ptr<BackendInterface> backend, SystemState const& state);
+
+    /**
+     * @brief Stops renewing and releases the lease if it is held
+     */
+    ~WriterLease();
+
+    WriterLease(WriterLease const&) = delete;
+    WriterLease&
+    operator=(WriterLease const&) = delete;
+
+    /**
+     * @brief Wait until either a ledger shows up in the DB or the lease is acquired.
+     *
+     * The lease is only tried if the ledger was not published, every renew interval, until the process is stopping.
+     *
+     * @param publishLedger Publishes the awaited ledger; returns false if it is not in the DB yet
+     * @return true if the lease was acquired and this process should become the writer; false otherwise
+     */
+    bool
+    waitForLease(std::function<bool()> const& publishLedger);
+
+    /**
+     * @brief Keep renewing the acquired lease in the background until it is released or lost.
+     *
+     * A renewal that fails because the DB did not respond is retried at the next interval, as long as the lease is
+     * still valid by then.
+     *
+     * @param onLost Called from the background thread if another process took the lease over or the lease could not
+     * be renewed before it expired
+     */
+    void
+    keepAlive(std::function<void()> onLost);
+
+    /**
+     * @brief Stop renewing the lease and give it up so that another process can take over right away
+     */
+    void
+    release();
+
+    /**
+     * @return true if this process holds the lease; false otherwise
+     */
+    bool
+    isOwner() const;
+
+    /**
+     * @return The unique identifier this process takes the lease with
+     */
+    std::string const&
+    owner() const;
+
+private:
+    std::optional<bool>
+    tryAcquire();
+
+    void
+    stopRenewing();
+};
+
+}  // namespace etl
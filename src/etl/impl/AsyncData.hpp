@@ -20,12 +20,17 @@
 #pragma once
 
 #include "data/BackendInterface.hpp"
+#include "data/DBHelpers.hpp"
 #include "data/Types.hpp"
 #include "etl/ETLHelpers.hpp"
 #include "etl/NFTHelpers.hpp"
 #include "util/Assert.hpp"
 #include "util/log/Logger.hpp"
+#include "util/prometheus/Counter.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
 
+#include <google/protobuf/arena.h>
 #include <grpcpp/client_context.h>
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/support/status.h>
@@ -34,8 +39,10 @@
 #include <xrpl/basics/strHex.h>
 #include <xrpl/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -44,11 +51,24 @@
 
 namespace etl::impl {
 
+/**
+ * @brief State of the download of one marker range of the initial ledger.
+ *
+ * Only one request per marker is outstanding at any time and the next page is requested only once the current one is
+ * processed, so process() is never run concurrently for the same instance even if several threads drain the
+ * completion queue.
+ *
+ * For the same reason a single response is enough. It lives on an arena that is reset before each page is requested,
+ * so the thousands of objects of a page are allocated in a few blocks instead of one by one.
+ */
 class AsyncCallData {
+    static constexpr std::size_t ARENA_START_BLOCK_SIZE = 64 * 1024;
+    static constexpr std::size_t ARENA_MAX_BLOCK_SIZE = 1024 * 1024;
+
     util::Logger log_{"ETL"};
 
-    std::unique_ptr<org::xrpl::rpc::v1::GetLedgerDataResponse> cur_;
-    std::unique_ptr<org::xrpl::rpc::v1::GetLedgerDataResponse> next_;
+    std::unique_ptr<google::protobuf::Arena> arena_;
+    org::xrpl::rpc::v1::GetLedgerDataResponse* response_ = nullptr;
 
     org::xrpl::rpc::v1::GetLedgerDataRequest request_;
     std::unique_ptr<grpc::ClientContext> context_;
@@ -56,10 +76,22 @@ class AsyncCallData {
     grpc::Status status_;
     unsigned char nextPrefix_;
 
+    std::string firstKey_;
     std::string lastKey_;
 
+    std::string prefixHex_;
+    std::size_t numLoaded_ = 0;
+    std::reference_wrapper<util::prometheus::CounterInt> objectsLoaded_;
+    std::chrono::steady_clock::time_point const start_ = std::chrono::steady_clock::now();
+
 public:
     AsyncCallData(uint32_t seq, ripple::uint256 const& marker, std::optional<ripple::uint256> const& nextMarker)
+        : prefixHex_{ripple::strHex(std::string(1, marker.data()[0]))}
+        , objectsLoaded_{PrometheusService::counterInt(
+              "etl_initial_load_objects_total_number",
+              util::prometheus::Labels({util::prometheus::Label{"marker", prefixHex_}}),
+              "The total number of ledger objects downloaded per marker range during the initial ledger load"
+          )}
     {
         request_.mutable_ledger()->set_sequence(seq);
         if (marker.isNonZero()) {
@@ -83,20 +115,32 @@ public:
             prefix
         );
 
-        cur_ = std::make_unique<org::xrpl::rpc::v1::GetLedgerDataResponse>();
-        next_ = std::make_unique<org::xrpl::rpc::v1::GetLedgerDataResponse>();
+        google::protobuf::ArenaOptions options;
+        options.start_block_size = ARENA_START_BLOCK_SIZE;
+        options.max_block_size = ARENA_MAX_BLOCK_SIZE;
+        arena_ = std::make_unique<google::protobuf::Arena>(options);
+        response_ = google::protobuf::Arena::CreateMessage<org::xrpl::rpc::v1::GetLedgerDataResponse>(arena_.get());
         context_ = std::make_unique<grpc::ClientContext>();
     }
 
     enum class CallStatus { MORE, DONE, ERRORED };
 
+    /**
+     * @brief Where the downloaded objects are written to
+     */
+    enum class Target {
+        CacheAndDB, /**< The initial ledger of an empty database */
+        Cache,      /**< Only the cache, the ledger is in the database already */
+        DB,         /**< Only the database, without diff; book successors are written too as the cache is not used */
+    };
+
     CallStatus
     process(
         std::unique_ptr<org::xrpl::rpc::v1::XRPLedgerAPIService::Stub>& stub,
         grpc::CompletionQueue& cq,
         BackendInterface& backend,
         bool abort,
-        bool cacheOnly = false
+        Target target = Target::CacheAndDB
     )
     {
         LOG(log_.trace()) << "Processing response. "
@@ -110,58 +154,84 @@ public:
                               << " message = " << status_.error_message();
             return CallStatus::ERRORED;
         }
-        if (!next_->is_unlimited()) {
+        if (!response_->is_unlimited()) {
             LOG(log_.warn()) << "AsyncCallData is_unlimited is false. "
                              << "Make sure secure_gateway is set correctly at the ETL source";
         }
 
-        std::swap(cur_, next_);
-
         bool more = true;
 
         // if no marker returned, we are done
-        if (cur_->marker().empty())
+        if (response_->marker().empty())
             more = false;
 
         // if returned marker is greater than our end, we are done
-        unsigned char const prefix = cur_->marker()[0];
+        unsigned char const prefix = response_->marker()[0];
         if (nextPrefix_ != 0x00 && prefix >= nextPrefix_)
             more = false;
 
-        // if we are not done, make the next async call
-        if (more) {
-            request_.set_marker(cur_->marker());
-            call(stub, cq);
-        }
-
-        auto const numObjects = cur_->ledger_objects().objects_size();
+        auto const numObjects = response_->ledger_objects().objects_size();
         LOG(log_.debug()) << "Writing " << numObjects << " objects";
 
+        auto const seq = request_.ledger().sequence();
         std::vector<data::LedgerObject> cacheUpdates;
-        cacheUpdates.reserve(numObjects);
+        if (target != Target::DB)
+            cacheUpdates.reserve(numObjects);
+        std::vector<NFTsData> nfts;
+        std::size_t numUpdates = 0;
 
         for (int i = 0; i < numObjects; ++i) {
-            auto& obj = *(cur_->mutable_ledger_objects()->mutable_objects(i));
+            auto& obj = *(response_->mutable_ledger_objects()->mutable_objects(i));
             if (!more && nextPrefix_ != 0x00) {
                 if (static_cast<unsigned char>(obj.key()[0]) >= nextPrefix_)
                     continue;
             }
-            cacheUpdates.push_back(
-                {*ripple::uint256::fromVoidChecked(obj.key()), {obj.data().begin(), obj.data().end()}}
-            );
-            if (!cacheOnly) {
-                if (!lastKey_.empty())
-                    backend.writeSuccessor(std::move(lastKey_), request_.ledger().sequence(), std::string{obj.key()});
-                lastKey_ = obj.key();
-                backend.writeNFTs(getNFTDataFromObj(request_.ledger().sequence(), obj.key(), obj.data()));
-                backend.writeLedgerObject(
-                    std::move(*obj.mutable_key()), request_.ledger().sequence(), std::move(*obj.mutable_data())
+            ++numUpdates;
+            if (target != Target::DB) {
+                cacheUpdates.push_back(
+                    {*ripple::uint256::fromVoidChecked(obj.key()), {obj.data().begin(), obj.data().end()}}
                 );
             }
+            if (target == Target::Cache)
+                continue;
+
+            if (target == Target::DB)
+                writeBookSuccessor(backend, seq, obj.key(), obj.data());
+            if (!lastKey_.empty()) {
+                backend.writeSuccessor(std::move(lastKey_), seq, std::string{obj.key()});
+            } else {
+                firstKey_ = obj.key();
+            }
+            lastKey_ = obj.key();
+            auto objNfts = getNFTDataFromObj(seq, obj.key(), obj.data());
+            nfts.insert(nfts.end(), objNfts.begin(), objNfts.end());
+
+            if (target == Target::DB) {
+                backend.writeLedgerStateObject(std::move(*obj.mutable_key()), seq, std::move(*obj.mutable_data()));
+            } else {
+                backend.writeLedgerObject(std::move(*obj.mutable_key()), seq, std::move(*obj.mutable_data()));
+            }
         }
-        backend.cache().update(cacheUpdates, request_.ledger().sequence(), cacheOnly);
+
+        if (target != Target::Cache)
+            backend.writeNFTs(nfts);
+
+        if (target != Target::DB)
+            backend.cache().update(std::move(cacheUpdates), seq, target == Target::Cache);
+        numLoaded_ += numUpdates;
+        objectsLoaded_.get() += numUpdates;
         LOG(log_.debug()) << "Wrote " << numObjects << " objects. Got more: " << (more ? "YES" : "NO");
 
+        // the next page is requested only now so that pages of the same marker are never processed concurrently
+        if (more) {
+            request_.set_marker(response_->marker());
+            call(stub, cq);
+        } else {
+            auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+            LOG(log_.info()) << "Finished marker " << prefixHex_ << ". Objects loaded = " << numLoaded_
+                             << ", time = " << seconds << "s, objects per second = " << numLoaded_ / seconds;
+        }
+
         return more ? CallStatus::MORE : CallStatus::DONE;
     }
 
@@ -170,22 +240,26 @@ public:
     {
         context_ = std::make_unique<grpc::ClientContext>();
 
+        // the previous page is fully processed by now
+        arena_->Reset();
+        response_ = google::protobuf::Arena::CreateMessage<org::xrpl::rpc::v1::GetLedgerDataResponse>(arena_.get());
+
         std::unique_ptr<grpc::ClientAsyncResponseReader<org::xrpl::rpc::v1::GetLedgerDataResponse>> rpc(
             stub->PrepareAsyncGetLedgerData(context_.get(), request_, &cq)
         );
 
         rpc->StartCall();
 
-        rpc->Finish(next_.get(), &status_, this);
+        rpc->Finish(response_, &status_, this);
     }
 
     std::string
     getMarkerPrefix()
     {
-        if (next_->marker().empty()) {
+        if (response_->marker().empty()) {
             return "";
         }
-        return ripple::strHex(std::string{next_->marker().data()[0]});
+        return ripple::strHex(std::string{response_->marker().data()[0]});
     }
 
     std::string
@@ -193,6 +267,28 @@ public:
     {
         return lastKey_;
     }
+
+    /** @return The first key of the marker range written to the database; empty if there is none */
+    std::string const&
+    getFirstKey() const
+    {
+        return firstKey_;
+    }
+
+private:
+    void
+    writeBookSuccessor(BackendInterface& backend, std::uint32_t seq, std::string const& key, std::string const& blob)
+    {
+        auto const uint256Key = *ripple::uint256::fromVoidChecked(key);
+        if (not isBookDir(uint256Key, blob))
+            return;
+
+        // the keys arrive sorted and a book never spans two marker ranges, so the first directory of a book follows
+        // its base directly unless the base is an object itself
+        auto const base = getBookBase(uint256Key);
+        if (lastKey_.empty() or *ripple::uint256::fromVoidChecked(lastKey_) < base)
+            backend.writeSuccessor(uint256ToString(base), seq, std::string{key});
+    }
 };
 
 inline std::vector<AsyncCallData>
@@ -0,0 +1,302 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/BackendInterface.hpp"
+#include "etl/BackfillSettings.hpp"
+#include "etl/SystemState.hpp"
+#include "etl/impl/Successors.hpp"
+#include "util/LedgerUtils.hpp"
+#include "util/Profiler.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Counter.hpp"
+#include "util/prometheus/Gauge.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <xrpl/basics/Slice.h>
+#include <xrpl/beast/core/CurrentThreadName.h>
+#include <xrpl/protocol/LedgerHeader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace etl::impl {
+
+/**
+ * @brief Writes the ledger history below the oldest ledger in the database.
+ *
+ * The history is written in batches going back from the oldest ledger in the database. Each batch starts with the full
+ * state of its first ledger, so objects that did not change until the old minimum can be read at every sequence of
+ * the batch. The ledgers of the batch are then fetched together with their objects and object neighbors, so every
+ * ledger can be written independently of the others by one of several concurrent workers. Once all ledgers of a batch
+ * are written the minimum of the ledger range is moved to the start of the batch, which is also the checkpoint a
+ * restarted backfill resumes from.
+ *
+ * The ledger cache is not touched and finishWrites is never called, so the backfill must not run in a process that is
+ * the ETL writer.
+ */
+template <typename LoadBalancerType, typename LedgerLoaderType>
+class Backfiller {
+    util::Logger log_{"ETL"};
+
+    BackfillSettings settings_;
+    std::shared_ptr<BackendInterface> backend_;
+    std::shared_ptr<LoadBalancerType> loadBalancer_;
+    std::reference_wrapper<LedgerLoaderType> loader_;
+    std::reference_wrapper<SystemState const> state_;
+
+    std::reference_wrapper<util::prometheus::CounterInt> ledgersWritten_ = PrometheusService::counterInt(
+        "etl_backfill_ledgers_total_number",
+        {},
+        "Total number of ledgers written by the backfill"
+    );
+    std::reference_wrapper<util::prometheus::CounterInt> transactionsWritten_ = PrometheusService::counterInt(
+        "etl_backfill_transactions_total_number",
+        {},
+        "Total number of transactions written by the backfill"
+    );
+    std::reference_wrapper<util::prometheus::GaugeInt> checkpoint_ = PrometheusService::gaugeInt(
+        "etl_backfill_min_sequence",
+        {},
+        "Oldest ledger of the ledger range as moved by the backfill"
+    );
+
+    std::atomic_bool stopping_ = false;
+    std::thread worker_;
+
+public:
+    /**
+     * @brief Construct a new Backfiller object
+     *
+     * @param settings The settings to use
+     * @param backend The backend to write the history to
+     * @param balancer The load balancer to fetch ledgers from
+     * @param loader The loader used to write the transactions of a ledger
+     * @param state The state of the ETL subsystem
+     */
+    Backfiller(
+        BackfillSettings settings,
+        std::shared_ptr<BackendInterface> backend,
+        std::shared_ptr<LoadBalancerType> balancer,
+        LedgerLoaderType& loader,
+        SystemState const& state
+    )
+        : settings_{settings}
+        , backend_{std::move(backend)}
+        , loadBalancer_{std::move(balancer)}
+        , loader_{std::ref(loader)}
+        , state_{std::cref(state)}
+    {
+    }
+
+    /**
+     * @brief Stops the backfill and joins the worker thread
+     */
+    ~Backfiller()
+    {
+        stop();
+    }
+
+    Backfiller(Backfiller const&) = delete;
+    Backfiller&
+    operator=(Backfiller const&) = delete;
+
+    /**
+     * @brief Spawn the worker thread if backfill is enabled
+     */
+    void
+    run()
+    {
+        if (not settings_.isEnabled() or worker_.joinable())
+            return;
+
+        LOG(log_.info()) << "Starting backfill down to " << *settings_.startSequence
+                         << ". workers = " << settings_.numWorkers << "; batch size = " << settings_.batchSize;
+
+        worker_ = std::thread([this]() {
+            beast::setCurrentThreadName("ETLService backfill");
+            auto const numWritten = backfill();
+            LOG(log_.info()) << "Backfill finished. Wrote " << numWritten << " ledgers";
+        });
+    }
+
+    /**
+     * @brief Requests the backfill to stop and waits for the worker thread to finish
+     *
+     * The batch in progress is abandoned; its ledgers are written again when the backfill resumes.
+     */
+    void
+    stop()
+    {
+        stopping_ = true;
+        if (worker_.joinable())
+            worker_.join();
+    }
+
+    /**
+     * @brief Write all history between the configured start sequence and the oldest ledger in the database.
+     *
+     * @return The number of ledgers added to the ledger range
+     */
+    std::uint32_t
+    backfill()
+    {
+        if (not settings_.isEnabled())
+            return 0;
+
+        auto const range = backend_->hardFetchLedgerRangeNoThrow();
+        if (not range) {
+            LOG(log_.warn()) << "Database is empty. Nothing to backfill";
+            return 0;
+        }
+
+        std::uint32_t numWritten = 0;
+        auto currentMin = range->minSequence;
+        checkpoint_.get().set(currentMin);
+
+        while (currentMin > *settings_.startSequence and not isStopping()) {
+            auto const first = currentMin - std::min(settings_.batchSize, currentMin - *settings_.startSequence);
+            auto const last = currentMin - 1;
+
+            auto const [success, seconds] =
+                ::util::timed<std::chrono::duration<double>>([this, first, last]() { return writeBatch(first, last); });
+            if (not success) {
+                LOG(log_.warn()) << "Backfill of ledgers " << first << " to " << last
+                                 << " did not complete. Will resume from " << currentMin;
+                break;
+            }
+
+            if (not backend_->advanceMinSequence(currentMin, first)) {
+                LOG(log_.warn()) << "Min sequence was changed by another process. Stop backfill";
+                break;
+            }
+
+            auto const numLedgers = last - first + 1;
+            LOG(log_.info()) << "Backfilled ledgers " << first << " to " << last << " in " << seconds
+                             << " seconds. ledgers per second = " << numLedgers / seconds;
+
+            numWritten += numLedgers;
+            currentMin = first;
+            checkpoint_.get().set(currentMin);
+        }
+
+        return numWritten;
+    }
+
+private:
+    bool
+    writeBatch(std::uint32_t const first, std::uint32_t const last)
+    {
+        // the diffs below only tell which objects changed, the objects that did not change until the old minimum
+        // need a version at or below the batch as well
+        LOG(log_.info()) << "Loading the state of ledger " << first << " for backfill";
+        loadBalancer_->loadLedgerState(first);
+        if (isStopping())
+            return false;
+
+        std::atomic_uint32_t next = first;
+        std::atomic_bool failed = false;
+
+        auto const numWorkers = std::min(settings_.numWorkers, last - first + 1);
+        std::vector<std::thread> workers;
+        workers.reserve(numWorkers);
+
+        for (std::uint32_t i = 0; i < numWorkers; ++i) {
+            workers.emplace_back([this, &next, &failed, last]() {
+                while (not failed and not isStopping()) {
+                    auto const seq = next++;
+                    if (seq > last)
+                        break;
+
+                    if (not writeLedger(seq))
+                        failed = true;
+                }
+            });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+
+        if (failed or isStopping())
+            return false;
+
+        // the ledger range must not cover the batch before all of its writes are done
+        backend_->waitForWritesToFinish();
+        return true;
+    }
+
+    bool
+    writeLedger(std::uint32_t const seq)
+    {
+        auto response = loadBalancer_->fetchLedger(seq, true, true);
+        if (not response) {
+            LOG(log_.warn()) << "Could not fetch ledger " << seq << " for backfill";
+            return false;
+        }
+
+        if (not response->object_neighbors_included()) {
+            LOG(log_.error()) << "Object neighbors of ledger " << seq << " not included. Can't backfill";
+            return false;
+        }
+
+        try {
+            auto const lgrInfo = ::util::deserializeHeader(ripple::makeSlice(response->ledger_header()));
+            auto const numTransactions = response->transactions_list().transactions_size();
+
+            backend_->writeLedger(lgrInfo, std::move(*response->mutable_ledger_header()));
+            auto insertTxResult = loader_.get().insertTransactions(lgrInfo, *response);
+
+            auto& objects = *(response->mutable_ledger_objects()->mutable_objects());
+            writeSuccessorsFromNeighbors(*backend_, lgrInfo.seq, *response, objects);
+            for (auto& obj : objects)
+                backend_->writeLedgerObject(std::move(*obj.mutable_key()), lgrInfo.seq, std::move(*obj.mutable_data()));
+
+            backend_->writeAccountTransactions(std::move(insertTxResult.accountTxData));
+            backend_->writeNFTs(insertTxResult.nfTokensData);
+            backend_->writeNFTTransactions(insertTxResult.nfTokenTxData);
+
+            ++ledgersWritten_.get();
+            transactionsWritten_.get() += numTransactions;
+        } catch (std::exception const& e) {
+            LOG(log_.error()) << "Could not backfill ledger " << seq << ": " << e.what();
+            return false;
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] bool
+    isStopping() const
+    {
+        return stopping_ or state_.get().isStopping;
+    }
+};
+
+}  // namespace etl::impl
@@ -41,6 +41,7 @@
 #include <memory>
 #include <ranges>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace etl::impl {
@@ -127,7 +128,7 @@ private:
                         return backend_->fetchLedgerPage(start, seq, cachePageFetchSize, false, token);
                     });
 
-                    cache_.get().update(res.objects, seq, true);
+                    cache_.get().update(std::move(res.objects), seq, true);
 
                     if (not res.cursor or res.cursor > end) {
                         if (--remaining_ <= 0) {
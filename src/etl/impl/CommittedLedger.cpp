@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/CommittedLedger.hpp"
+
+#include "data/Types.hpp"
+#include "util/LedgerUtils.hpp"
+
+#include <xrpl/basics/Slice.h>
+#include <xrpl/protocol/Fees.h>
+#include <xrpl/protocol/LedgerHeader.h>
+#include <xrpl/protocol/Serializer.h>
+#include <xrpl/protocol/XRPAmount.h>
+
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace etl::impl {
+
+namespace {
+
+// bump when the layout below changes; nodes ignore ledgers of a different version
+constexpr std::uint32_t FORMAT_VERSION = 1;
+
+}  // namespace
+
+std::string
+CommittedLedger::serialize() const
+{
+    ripple::Serializer s;
+    s.add32(FORMAT_VERSION);
+
+    ripple::Serializer header;
+    ripple::addRaw(this->header, header, /* includeHash = */ true);
+    s.addVL(header.slice());
+    s.add32(minSequence);
+
+    s.add8(fees.has_value() ? 1 : 0);
+    if (fees) {
+        s.add64(fees->base.drops());
+        s.add64(fees->reserve.drops());
+        s.add64(fees->increment.drops());
+    }
+
+    s.add32(static_cast<std::uint32_t>(diff.size()));
+    for (auto const& obj : diff) {
+        s.addBitString(obj.key);
+        s.addVL(obj.blob);
+    }
+
+    s.add32(static_cast<std::uint32_t>(transactions.size()));
+    for (auto const& txn : transactions) {
+        s.addVL(txn.transaction);
+        s.addVL(txn.metadata);
+        s.add32(txn.date);
+    }
+
+    return std::string{reinterpret_cast<char const*>(s.data()), s.size()};
+}
+
+std::optional<CommittedLedger>
+CommittedLedger::deserialize(ripple::Slice data)
+{
+    try {
+        ripple::SerialIter it{data};
+        if (it.get32() != FORMAT_VERSION)
+            return std::nullopt;
+
+        CommittedLedger ledger;
+
+        auto const header = it.getVL();
+        ledger.header = ::util::deserializeHeader(ripple::makeSlice(header));
+        ledger.minSequence = it.get32();
+
+        if (it.get8() != 0) {
+            ripple::Fees fees;
+            fees.base = ripple::XRPAmount{static_cast<std::int64_t>(it.get64())};
+            fees.reserve = ripple::XRPAmount{static_cast<std::int64_t>(it.get64())};
+            fees.increment = ripple::XRPAmount{static_cast<std::int64_t>(it.get64())};
+            ledger.fees = fees;
+        }
+
+        auto const numObjects = it.get32();
+        for (std::uint32_t i = 0; i < numObjects; ++i) {
+            auto const key = it.get256();
+            ledger.diff.push_back({key, it.getVL()});
+        }
+
+        auto const numTransactions = it.get32();
+        for (std::uint32_t i = 0; i < numTransactions; ++i) {
+            auto transaction = it.getVL();
+            auto metadata = it.getVL();
+            auto const date = it.get32();
+            ledger.transactions.emplace_back(std::move(transaction), std::move(metadata), ledger.header.seq, date);
+        }
+
+        if (not it.empty())
+            return std::nullopt;
+
+        return ledger;
+    } catch (std::exception const&) {
+        return std::nullopt;
+    }
+}
+
+}  // namespace etl::impl
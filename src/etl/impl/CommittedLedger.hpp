@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/Types.hpp"
+
+#include <xrpl/basics/Slice.h>
+#include <xrpl/protocol/Fees.h>
+#include <xrpl/protocol/LedgerHeader.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace etl::impl {
+
+/**
+ * @brief A ledger that was written to the database, together with the data needed to publish it without reading it
+ * back.
+ */
+struct CommittedLedger {
+    ripple::LedgerHeader header;
+    std::vector<data::TransactionAndMetadata> transactions; /**< ordered by transaction index */
+    std::vector<data::LedgerObject> diff;                   /**< objects created, modified or deleted by the ledger */
+    std::optional<ripple::Fees> fees;                       /**< read from the database if not set */
+    std::uint32_t minSequence = 0; /**< minimum of the ledger range when the ledger was written; 0 if unknown */
+
+    /**
+     * @brief Serialize the ledger to be sent to other Clio nodes.
+     *
+     * @return The serialized ledger
+     */
+    [[nodiscard]] std::string
+    serialize() const;
+
+    /**
+     * @brief Deserialize a ledger that was serialized by another Clio node.
+     *
+     * @param data The serialized ledger
+     * @return The ledger; nullopt if the data is malformed or was written by an incompatible version
+     */
+    [[nodiscard]] static std::optional<CommittedLedger>
+    deserialize(ripple::Slice data);
+};
+
+}  // namespace etl::impl
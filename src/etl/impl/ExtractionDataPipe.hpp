@@ -20,34 +20,43 @@
 #pragma once
 
 #include "etl/ETLHelpers.hpp"
-#include "util/log/Logger.hpp"
+#include "etl/impl/ExtractionScheduler.hpp"
+#include "util/prometheus/Gauge.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 namespace etl::impl {
 
 /**
- * @brief A collection of thread safe async queues used by Extractor and Transformer to communicate
+ * @brief A collection of bounded ring buffers used by Extractor and Transformer to communicate
+ *
+ * Each extractor owns exactly one of the buffers (selected by sequence modulo stride) and the Transformer is the only
+ * consumer, so every buffer is single-producer single-consumer.
  */
 template <typename RawDataType>
 class ExtractionDataPipe {
 public:
     using DataType = std::optional<RawDataType>;
-    using QueueType = ThreadSafeQueue<DataType>;  // TODO: probably should use boost::lockfree::queue instead?
+    using QueueType = SpscRingBuffer<DataType>;
 
     constexpr static auto TOTAL_MAX_IN_QUEUE = 1000u;
 
 private:
-    util::Logger log_{"ETL"};
-
     uint32_t stride_;
     uint32_t startSequence_;
 
     std::vector<std::shared_ptr<QueueType>> queues_;
+    std::vector<std::reference_wrapper<util::prometheus::GaugeInt>> queueSizes_;
+    ExtractionScheduler scheduler_;
 
 public:
     /**
@@ -55,12 +64,25 @@ public:
      *
      * @param stride
      * @param startSequence
+     * @param memoryBudget The number of bytes the extracted data may take while waiting for the Transformer
      */
-    ExtractionDataPipe(uint32_t stride, uint32_t startSequence) : stride_{stride}, startSequence_{startSequence}
+    ExtractionDataPipe(
+        uint32_t stride,
+        uint32_t startSequence,
+        std::size_t memoryBudget = ExtractionScheduler::UNLIMITED
+    )
+        : stride_{stride}, startSequence_{startSequence}, scheduler_{startSequence, memoryBudget}
     {
-        auto const maxQueueSize = TOTAL_MAX_IN_QUEUE / stride;
-        for (size_t i = 0; i < stride_; ++i)
+        auto const maxQueueSize = std::max(TOTAL_MAX_IN_QUEUE / stride, 1u);
+        for (size_t i = 0; i < stride_; ++i) {
             queues_.push_back(std::make_unique<QueueType>(maxQueueSize));
+            queueSizes_.push_back(std::ref(PrometheusService::gaugeInt(
+                "etl_extraction_queue_size",
+                util::prometheus::Labels({util::prometheus::Label{"extractor", std::to_string(i)}}),
+                "The number of extracted ledgers waiting for the transformer in the extractor's queue"
+            )));
+            queueSizes_.back().get().set(0);
+        }
     }
 
     /**
@@ -74,7 +96,14 @@ public:
     void
     push(uint32_t sequence, DataType&& data)
     {
-        getQueue(sequence)->push(std::move(data));
+        if constexpr (requires(RawDataType const& raw) { raw.ByteSizeLong(); }) {
+            if (data)
+                scheduler_.onExtracted(data->ByteSizeLong());
+        }
+
+        auto const idx = indexOf(sequence);
+        queues_[idx]->push(std::move(data));
+        queueSizes_[idx].get().set(queues_[idx]->size());
     }
 
     /**
@@ -88,7 +117,23 @@ public:
     DataType
     popNext(uint32_t sequence)
     {
-        return getQueue(sequence)->pop();
+        auto const idx = indexOf(sequence);
+        auto data = queues_[idx]->pop();
+        queueSizes_[idx].get().set(queues_[idx]->size());
+        scheduler_.onTransformStarted(sequence);
+        return data;
+    }
+
+    /**
+     * @brief Wait until data for the given sequence may be extracted without exceeding the memory budget
+     *
+     * @param sequence The sequence about to be extracted
+     * @return true if the sequence may be extracted; false if the pipe was cleaned up while waiting
+     */
+    bool
+    waitForTurn(uint32_t sequence)
+    {
+        return scheduler_.waitForTurn(sequence);
     }
 
     /**
@@ -120,16 +165,18 @@ public:
     cleanup()
     {
         // TODO: this should not have to be called by hand. it should be done via RAII
-        for (auto i = 0u; i < stride_; ++i)
-            getQueue(i)->tryPop();  // pop from each queue that might be blocked on a push
+        scheduler_.stop();
+        for (auto i = 0u; i < stride_; ++i) {
+            queues_[i]->tryPop();  // pop from each queue that might be blocked on a push
+            queueSizes_[i].get().set(queues_[i]->size());
+        }
     }
 
 private:
-    std::shared_ptr<QueueType>
-    getQueue(uint32_t sequence)
+    std::size_t
+    indexOf(uint32_t sequence) const
     {
-        LOG(log_.debug()) << "Grabbing extraction queue for " << sequence << "; start was " << startSequence_;
-        return queues_[(sequence - startSequence_) % stride_];
+        return (sequence - startSequence_) % stride_;
     }
 };
 
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/ExtractionScheduler.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace etl::impl {
+
+ExtractionScheduler::ExtractionScheduler(uint32_t startSequence, std::size_t memoryBudget)
+    : memoryBudget_{memoryBudget}, nextToTransform_{startSequence}
+{
+}
+
+bool
+ExtractionScheduler::waitForTurn(uint32_t sequence)
+{
+    std::unique_lock lock{mtx_};
+    cv_.wait(lock, [this, sequence]() {
+        return stopped_ or sequence < nextToTransform_ or sequence - nextToTransform_ < windowLocked();
+    });
+    return not stopped_;
+}
+
+void
+ExtractionScheduler::onExtracted(std::size_t size)
+{
+    {
+        std::scoped_lock const lock{mtx_};
+        if (averageSize_ == 0.) {
+            averageSize_ = static_cast<double>(size);
+        } else {
+            averageSize_ = (SMOOTHING * static_cast<double>(size)) + ((1. - SMOOTHING) * averageSize_);
+        }
+    }
+    cv_.notify_all();  // the window grows if ledgers got smaller
+}
+
+void
+ExtractionScheduler::onTransformStarted(uint32_t sequence)
+{
+    {
+        std::scoped_lock const lock{mtx_};
+        nextToTransform_ = std::max(nextToTransform_, sequence + 1);
+    }
+    cv_.notify_all();
+}
+
+void
+ExtractionScheduler::stop()
+{
+    {
+        std::scoped_lock const lock{mtx_};
+        stopped_ = true;
+    }
+    cv_.notify_all();
+}
+
+std::size_t
+ExtractionScheduler::window() const
+{
+    std::scoped_lock const lock{mtx_};
+    return windowLocked();
+}
+
+std::size_t
+ExtractionScheduler::windowLocked() const
+{
+    if (memoryBudget_ == UNLIMITED or averageSize_ < 1.)
+        return UNLIMITED;
+
+    return std::max<std::size_t>(1, static_cast<std::size_t>(static_cast<double>(memoryBudget_) / averageSize_));
+}
+
+}  // namespace etl::impl
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+namespace etl::impl {
+
+/**
+ * @brief Decides when an extractor may fetch its next ledger, so that buffered ledgers fit in a memory budget.
+ *
+ * Extractors only fetch ledgers validated by the network, so the number of fetches in flight already follows the lag:
+ * at the tip only the extractor of the next ledger is busy, and after falling behind all of them fetch in parallel.
+ * The scheduler bounds how far ahead of the Transformer they may get. The ledger the Transformer needs next is always
+ * allowed; the ones after it only while their expected size, estimated from the ledgers extracted so far, fits in the
+ * budget.
+ */
+class ExtractionScheduler {
+    static constexpr double SMOOTHING = 0.1;  // weight of the newest ledger in the average size
+
+    std::size_t memoryBudget_;
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    uint32_t nextToTransform_;
+    double averageSize_ = 0.;
+    bool stopped_ = false;
+
+public:
+    /** @brief The budget used when none is configured */
+    static constexpr std::size_t UNLIMITED = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief Create a scheduler
+     *
+     * @param startSequence The first sequence the Transformer will need
+     * @param memoryBudget The number of bytes that extracted ledgers may take while they wait for the Transformer
+     */
+    ExtractionScheduler(uint32_t startSequence, std::size_t memoryBudget);
+
+    /**
+     * @brief Block until the given sequence may be fetched or the scheduler is stopped
+     *
+     * @param sequence The sequence the extractor is about to fetch
+     * @return true if the sequence may be fetched; false if the scheduler was stopped
+     */
+    bool
+    waitForTurn(uint32_t sequence);
+
+    /**
+     * @brief Account for a ledger that was extracted
+     *
+     * @param size The size of the extracted ledger in bytes
+     */
+    void
+    onExtracted(std::size_t size);
+
+    /**
+     * @brief Account for the Transformer taking a ledger, which lets extractors fetch further ahead
+     *
+     * @param sequence The sequence taken by the Transformer
+     */
+    void
+    onTransformStarted(uint32_t sequence);
+
+    /**
+     * @brief Wake up all waiting extractors; they are not allowed to fetch anymore.
+     */
+    void
+    stop();
+
+    /**
+     * @return The number of ledgers, starting with the one the Transformer needs next, that may be buffered
+     */
+    std::size_t
+    window() const;
+
+private:
+    std::size_t
+    windowLocked() const;
+};
+
+}  // namespace etl::impl
@@ -21,6 +21,7 @@
 
 #include "etl/NetworkValidatedLedgersInterface.hpp"
 #include "etl/SystemState.hpp"
+#include "etl/impl/PipelineMetrics.hpp"
 #include "util/Assert.hpp"
 #include "util/Profiler.hpp"
 #include "util/log/Logger.hpp"
@@ -50,6 +51,7 @@ class Extractor {
     uint32_t startSequence_;
     std::optional<uint32_t> finishSequence_;
     std::reference_wrapper<SystemState const> state_;  // shared state for ETL
+    PipelineMetrics metrics_;
 
     std::thread thread_;
 
@@ -96,10 +98,15 @@ private:
 
         while (!shouldFinish(currentSequence) && networkValidatedLedgers_->waitUntilValidatedByNetwork(currentSequence)
         ) {
+            // buffering another ledger must fit in the memory budget; the pipe stops waiting once it is cleaned up
+            if (not pipe_.get().waitForTurn(currentSequence))
+                break;
+
             auto [fetchResponse, time] = ::util::timed<std::chrono::duration<double>>([this, currentSequence]() {
                 return ledgerFetcher_.get().fetchDataAndDiff(currentSequence);
             });
             totalTime += time;
+            metrics_.observe(PipelineMetrics::Stage::Extract, std::chrono::duration<double>{time});
 
             // if the fetch is unsuccessful, stop. fetchLedger only returns false if the server is shutting down, or
             // if the ledger was found in the database (which means another process already wrote the ledger that
@@ -19,18 +19,25 @@
 
 #include "etl/impl/ForwardingCache.hpp"
 
-#include "util/Assert.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
 
 #include <boost/json/object.hpp>
+#include <boost/json/serialize.hpp>
+#include <boost/json/value.hpp>
 #include <boost/json/value_to.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace etl::impl {
 
@@ -45,6 +52,33 @@ getCommand(boost::json::object const& request)
     return boost::json::value_to<std::string>(request.at("command"));
 }
 
+void
+appendNormalized(std::string& out, boost::json::object const& object, bool skipId)
+{
+    std::vector<std::string_view> keys;
+    for (auto const& [key, _] : object) {
+        if (not skipId or key != "id")
+            keys.push_back(key);
+    }
+    std::ranges::sort(keys);
+
+    out += '{';
+    for (auto const key : keys) {
+        if (key != keys.front())
+            out += ',';
+
+        out += boost::json::serialize(boost::json::value(key));
+        out += ':';
+
+        if (auto const& value = object.at(key); value.is_object()) {
+            appendNormalized(out, value.as_object(), false);
+        } else {
+            out += boost::json::serialize(value);
+        }
+    }
+    out += '}';
+}
+
 }  // namespace
 
 void
@@ -75,60 +109,127 @@ CacheEntry::invalidate()
 std::unordered_set<std::string> const
     ForwardingCache::CACHEABLE_COMMANDS{"server_info", "server_state", "server_definitions", "fee", "ledger_closed"};
 
-ForwardingCache::ForwardingCache(std::chrono::steady_clock::duration const cacheTimeout) : cacheTimeout_{cacheTimeout}
+std::unordered_set<std::string> const ForwardingCache::READ_ONLY_COMMANDS{
+    "account_channels",
+    "account_currencies",
+    "account_info",
+    "account_lines",
+    "account_nfts",
+    "account_objects",
+    "account_offers",
+    "account_tx",
+    "book_offers",
+    "deposit_authorized",
+    "fee",
+    "gateway_balances",
+    "ledger",
+    "ledger_closed",
+    "ledger_current",
+    "ledger_data",
+    "ledger_entry",
+    "manifest",
+    "nft_buy_offers",
+    "nft_sell_offers",
+    "noripple_check",
+    "ripple_path_find",
+    "server_definitions",
+    "server_info",
+    "server_state",
+    "transaction_entry",
+    "tx",
+    "version",
+};
+
+ForwardingCache::ForwardingCache(
+    std::chrono::steady_clock::duration const cacheTimeout,
+    std::unordered_set<std::string> commands
+)
+    : cacheTimeout_{cacheTimeout}, commands_{std::move(commands)}
 {
-    for (auto const& command : CACHEABLE_COMMANDS) {
-        cache_.emplace(command, CacheEntry{});
+    using util::prometheus::Label;
+    using util::prometheus::Labels;
+
+    for (auto const& command : commands_) {
+        counters_.emplace(
+            command,
+            CommandCounters{
+                .hits = PrometheusService::counterInt(
+                    "forwarding_cache_hit_total_number",
+                    Labels({Label{"command", command}}),
+                    "Number of forwarded requests served from the cache"
+                ),
+                .misses = PrometheusService::counterInt(
+                    "forwarding_cache_miss_total_number",
+                    Labels({Label{"command", command}}),
+                    "Number of cacheable forwarded requests not found in the cache"
+                )
+            }
+        );
     }
 }
 
+std::string
+ForwardingCache::makeKey(boost::json::object const& request)
+{
+    std::string key;
+    appendNormalized(key, request, true);
+    return key;
+}
+
 bool
-ForwardingCache::shouldCache(boost::json::object const& request)
+ForwardingCache::shouldCache(boost::json::object const& request) const
 {
     auto const command = getCommand(request);
-    return command.has_value() and CACHEABLE_COMMANDS.contains(*command);
+    return command.has_value() and commands_.contains(*command);
 }
 
 std::optional<boost::json::object>
 ForwardingCache::get(boost::json::object const& request) const
 {
     auto const command = getCommand(request);
-
-    if (not command.has_value()) {
+    if (not command.has_value() or not commands_.contains(*command))
         return std::nullopt;
-    }
 
-    auto it = cache_.find(*command);
-    if (it == cache_.end())
-        return std::nullopt;
+    auto const& counters = counters_.at(*command);
+    auto const key = makeKey(request);
 
-    auto const& entry = it->second.lock<std::shared_lock>();
-    if (std::chrono::steady_clock::now() - entry->lastUpdated() > cacheTimeout_)
-        return std::nullopt;
+    {
+        auto const cache = cache_.lock<std::shared_lock>();
+        if (auto it = cache->find(key);
+            it != cache->end() and std::chrono::steady_clock::now() - it->second.lastUpdated() <= cacheTimeout_) {
+            ++counters.hits.get();
+            return it->second.get();
+        }
+    }
 
-    return entry->get();
+    ++counters.misses.get();
+    return std::nullopt;
 }
 
 void
 ForwardingCache::put(boost::json::object const& request, boost::json::object const& response)
 {
-    auto const command = getCommand(request);
-    if (not command.has_value() or not shouldCache(request))
+    if (not shouldCache(request))
         return;
 
-    ASSERT(cache_.contains(*command), "Command is not in the cache: {}", *command);
+    auto const key = makeKey(request);
+    auto cache = cache_.lock<std::unique_lock>();
+
+    if (cache->size() >= MAX_ENTRIES and not cache->contains(key)) {
+        auto const now = std::chrono::steady_clock::now();
+        std::erase_if(*cache, [&](auto const& entry) { return now - entry.second.lastUpdated() > cacheTimeout_; });
 
-    auto entry = cache_[*command].lock<std::unique_lock>();
-    entry->put(response);
+        if (cache->size() >= MAX_ENTRIES)
+            return;
+    }
+
+    (*cache)[key].put(response);
 }
 
 void
 ForwardingCache::invalidate()
 {
-    for (auto& [_, entry] : cache_) {
-        auto entryLock = entry.lock<std::unique_lock>();
-        entryLock->invalidate();
-    }
+    cache_.lock<std::unique_lock>()->clear();
 }
 
 }  // namespace etl::impl
@@ -20,10 +20,13 @@
 #pragma once
 
 #include "util/Mutex.hpp"
+#include "util/prometheus/Counter.hpp"
 
 #include <boost/json/object.hpp>
 
 #include <chrono>
+#include <cstddef>
+#include <functional>
 #include <optional>
 #include <shared_mutex>
 #include <string>
@@ -73,20 +76,49 @@ public:
 
 /**
  * @brief A class to store a cache of forwarding responses
+ *
+ * Responses are stored per request, so requests to the same command with different parameters are cached separately.
+ * Only the commands configured as idempotent are cached.
  */
 class ForwardingCache {
+    struct CommandCounters {
+        std::reference_wrapper<util::prometheus::CounterInt> hits;
+        std::reference_wrapper<util::prometheus::CounterInt> misses;
+    };
+
     std::chrono::steady_clock::duration cacheTimeout_;
-    std::unordered_map<std::string, util::Mutex<CacheEntry, std::shared_mutex>> cache_;
+    std::unordered_set<std::string> commands_;
+    std::unordered_map<std::string, CommandCounters> counters_;
+    util::Mutex<std::unordered_map<std::string, CacheEntry>, std::shared_mutex> cache_;
 
 public:
     static std::unordered_set<std::string> const CACHEABLE_COMMANDS;
+    /** @brief Commands that never change the state of rippled; only these may be configured as idempotent */
+    static std::unordered_set<std::string> const READ_ONLY_COMMANDS;
+    static constexpr std::size_t MAX_ENTRIES = 1024;
 
     /**
      * @brief Construct a new Forwarding Cache object
      *
      * @param cacheTimeout The time for cache entries to expire
+     * @param commands The commands to cache
+     */
+    ForwardingCache(
+        std::chrono::steady_clock::duration cacheTimeout,
+        std::unordered_set<std::string> commands = CACHEABLE_COMMANDS
+    );
+
+    /**
+     * @brief Make a key identifying a request
+     *
+     * The key is the request serialized with sorted keys and without the id, so requests that differ only in those
+     * have the same key.
+     *
+     * @param request The request to make the key for
+     * @return The key
      */
-    ForwardingCache(std::chrono::steady_clock::duration cacheTimeout);
+    [[nodiscard]] static std::string
+    makeKey(boost::json::object const& request);
 
     /**
      * @brief Check if a request should be cached
@@ -94,8 +126,8 @@ public:
      * @param request The request to check
      * @return true if the request should be cached and false otherwise
      */
-    [[nodiscard]] static bool
-    shouldCache(boost::json::object const& request);
+    [[nodiscard]] bool
+    shouldCache(boost::json::object const& request) const;
 
     /**
      * @brief Get a response from the cache
@@ -0,0 +1,107 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/ForwardingCoalescer.hpp"
+
+#include "rpc/Errors.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace etl::impl {
+
+ForwardingCoalescer::Response
+ForwardingCoalescer::forward(
+    std::string const& command,
+    std::string const& key,
+    std::function<Response()> const& forward,
+    boost::asio::yield_context yield
+)
+{
+    std::shared_ptr<Flight> flight;
+    std::shared_ptr<Channel> channel;
+    {
+        auto flights = flights_.lock();
+        auto [it, inserted] = flights->try_emplace(key);
+        if (inserted) {
+            it->second = std::make_shared<Flight>();
+        } else {
+            channel = std::make_shared<Channel>(yield.get_executor(), 1);
+            it->second->waiters.push_back(channel);
+        }
+        flight = it->second;
+    }
+
+    if (channel) {
+        using util::prometheus::Label;
+        using util::prometheus::Labels;
+        ++PrometheusService::counterInt(
+            "forwarding_coalesced_total_number",
+            Labels({Label{"command", command}}),
+            "Number of forwarded requests answered with the response of an identical request in flight"
+        );
+
+        boost::system::error_code ec;
+        channel->async_receive(yield[ec]);
+
+        auto const lock = flights_.lock();
+        if (ec or not flight->response.has_value())
+            return std::unexpected{rpc::ClioError::etlREQUEST_ERROR};
+
+        return *flight->response;
+    }
+
+    Response response = std::unexpected{rpc::ClioError::etlREQUEST_ERROR};
+    try {
+        response = forward();
+    } catch (...) {
+        complete(key, *flight, response);
+        throw;
+    }
+
+    complete(key, *flight, response);
+    return response;
+}
+
+void
+ForwardingCoalescer::complete(std::string const& key, Flight& flight, Response const& response)
+{
+    std::vector<std::shared_ptr<Channel>> waiters;
+    {
+        auto flights = flights_.lock();
+        flights->erase(key);
+        flight.response = response;
+        waiters = std::move(flight.waiters);
+    }
+
+    for (auto const& waiter : waiters)
+        waiter->try_send(boost::system::error_code{});
+}
+
+}  // namespace etl::impl
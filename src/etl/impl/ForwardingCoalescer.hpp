@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "rpc/Errors.hpp"
+#include "util/Mutex.hpp"
+
+#include <boost/asio/experimental/concurrent_channel.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/json/object.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <expected>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace etl::impl {
+
+/**
+ * @brief Lets identical forwarded requests that are in flight at the same time share a single request to rippled.
+ *
+ * The first request with a given key is forwarded; requests with the same key arriving before its response wait for
+ * that response instead of being forwarded themselves.
+ */
+class ForwardingCoalescer {
+public:
+    using Response = std::expected<boost::json::object, rpc::ClioError>;
+
+private:
+    using Channel = boost::asio::experimental::concurrent_channel<void(boost::system::error_code)>;
+
+    struct Flight {
+        std::optional<Response> response;
+        std::vector<std::shared_ptr<Channel>> waiters;
+    };
+
+    util::Mutex<std::unordered_map<std::string, std::shared_ptr<Flight>>> flights_;
+
+public:
+    /**
+     * @brief Forward a request or wait for the response of an identical request in flight
+     *
+     * @param command The command of the request, used for metrics
+     * @param key Identifies identical requests
+     * @param forward Forwards the request; only called if no request with the same key is in flight
+     * @param yield The coroutine context
+     * @return The response
+     */
+    Response
+    forward(
+        std::string const& command,
+        std::string const& key,
+        std::function<Response()> const& forward,
+        boost::asio::yield_context yield
+    );
+
+private:
+    void
+    complete(std::string const& key, Flight& flight, Response const& response);
+};
+
+}  // namespace etl::impl
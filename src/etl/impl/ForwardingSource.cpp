@@ -21,6 +21,7 @@
 
 #include "rpc/Errors.hpp"
 #include "util/log/Logger.hpp"
+#include "util/requests/WsConnection.hpp"
 
 #include <boost/asio/spawn.hpp>
 #include <boost/beast/http/field.hpp>
@@ -30,8 +31,11 @@
 #include <boost/json/serialize.hpp>
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <exception>
+#include <iterator>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -64,6 +68,25 @@ ForwardingSource::forwardToRippled(
     boost::asio::yield_context yield
 ) const
 {
+    auto const key = fmt::format("{}|{}", forwardToRippledClientIp.value_or(""), xUserValue);
+
+    if (auto connection = takeIdleConnection(key); connection) {
+        auto response = sendRequest(*connection, request, yield);
+        if (response) {
+            putIdleConnection(key, std::move(connection));
+            return response;
+        }
+
+        // rippled may have closed the connection while it was idle, so such errors are retried on a new connection.
+        // A write to a closed connection often succeeds though, so a failed read is only retried if the request is
+        // safe to send twice.
+        auto const& error = response.error();
+        if (error.error != rpc::ClioError::etlREQUEST_ERROR or (error.isWritten and not isSafeToResend(request)))
+            return std::unexpected{error.error};
+
+        LOG(log_.debug()) << "Reused connection to rippled failed. Reconnecting.";
+    }
+
     auto connectionBuilder = connectionBuilder_;
     if (forwardToRippledClientIp) {
         connectionBuilder.addHeader(
@@ -78,23 +101,37 @@ ForwardingSource::forwardToRippled(
         LOG(log_.debug()) << "Couldn't connect to rippled to forward request.";
         return std::unexpected{rpc::ClioError::etlCONNECTION_ERROR};
     }
-    auto& connection = expectedConnection.value();
 
-    auto writeError = connection->write(boost::json::serialize(request), yield, forwardingTimeout_);
+    auto response = sendRequest(*expectedConnection.value(), request, yield);
+    if (not response)
+        return std::unexpected{response.error().error};
+
+    putIdleConnection(key, std::move(expectedConnection).value());
+    return response;
+}
+
+std::expected<boost::json::object, ForwardingSource::SendError>
+ForwardingSource::sendRequest(
+    util::requests::WsConnection& connection,
+    boost::json::object const& request,
+    boost::asio::yield_context yield
+) const
+{
+    auto writeError = connection.write(boost::json::serialize(request), yield, forwardingTimeout_);
     if (writeError) {
         LOG(log_.debug()) << "Error sending request to rippled to forward request.";
-        return std::unexpected{rpc::ClioError::etlREQUEST_ERROR};
+        return std::unexpected{SendError{.error = rpc::ClioError::etlREQUEST_ERROR, .isWritten = false}};
     }
 
-    auto response = connection->read(yield, forwardingTimeout_);
+    auto response = connection.read(yield, forwardingTimeout_);
     if (not response) {
         if (auto errorCode = response.error().errorCode();
             errorCode.has_value() and errorCode->value() == boost::system::errc::timed_out) {
             LOG(log_.debug()) << "Request to rippled timed out";
-            return std::unexpected{rpc::ClioError::etlREQUEST_TIMEOUT};
+            return std::unexpected{SendError{.error = rpc::ClioError::etlREQUEST_TIMEOUT, .isWritten = true}};
         }
         LOG(log_.debug()) << "Error sending request to rippled to forward request.";
-        return std::unexpected{rpc::ClioError::etlREQUEST_ERROR};
+        return std::unexpected{SendError{.error = rpc::ClioError::etlREQUEST_ERROR, .isWritten = true}};
     }
 
     boost::json::value parsedResponse;
@@ -104,7 +141,7 @@ ForwardingSource::forwardToRippled(
             throw std::runtime_error("response is not an object");
     } catch (std::exception const& e) {
         LOG(log_.debug()) << "Error parsing response from rippled: " << e.what() << ". Response: " << *response;
-        return std::unexpected{rpc::ClioError::etlINVALID_RESPONSE};
+        return std::unexpected{SendError{.error = rpc::ClioError::etlINVALID_RESPONSE, .isWritten = true}};
     }
 
     auto responseObject = parsedResponse.as_object();
@@ -113,4 +150,68 @@ ForwardingSource::forwardToRippled(
     return responseObject;
 }
 
+util::requests::WsConnectionPtr
+ForwardingSource::takeIdleConnection(std::string const& key) const
+{
+    auto idleConnections = idleConnections_->lock();
+
+    auto it = idleConnections->byKey.find(key);
+    if (it == idleConnections->byKey.end())
+        return nullptr;
+
+    auto& connections = it->second;
+    auto const expiredEnd = std::ranges::find_if(connections, [now = std::chrono::steady_clock::now()](auto const& c) {
+        return now - c.idleSince < IDLE_TIMEOUT;
+    });
+    auto const numExpired = static_cast<std::size_t>(std::distance(connections.begin(), expiredEnd));
+    connections.erase(connections.begin(), expiredEnd);
+
+    util::requests::WsConnectionPtr result;
+    if (not connections.empty()) {
+        result = std::move(connections.back().connection);
+        connections.pop_back();
+    }
+
+    idleConnections->size -= numExpired + (result ? 1 : 0);
+    if (connections.empty())
+        idleConnections->byKey.erase(it);
+
+    return result;
+}
+
+void
+ForwardingSource::putIdleConnection(std::string const& key, util::requests::WsConnectionPtr connection) const
+{
+    auto idleConnections = idleConnections_->lock();
+    auto const now = std::chrono::steady_clock::now();
+
+    if (idleConnections->size >= MAX_IDLE_CONNECTIONS) {
+        std::erase_if(idleConnections->byKey, [&](auto& entry) {
+            idleConnections->size -= std::erase_if(entry.second, [now](auto const& c) {
+                return now - c.idleSince >= IDLE_TIMEOUT;
+            });
+            return entry.second.empty();
+        });
+    }
+
+    if (idleConnections->size >= MAX_IDLE_CONNECTIONS)
+        return;
+
+    idleConnections->byKey[key].push_back({.connection = std::move(connection), .idleSince = now});
+    ++idleConnections->size;
+}
+
+bool
+ForwardingSource::isSafeToResend(boost::json::object const& request)
+{
+    // a transaction is applied only once, but the result of sending it again hides the result of the first submission
+    static constexpr std::array<std::string_view, 2> NOT_SAFE_TO_RESEND = {"submit", "submit_multisigned"};
+
+    auto const it = request.find("command");
+    if (it == request.end() or not it->value().is_string())
+        return true;
+
+    return std::ranges::find(NOT_SAFE_TO_RESEND, std::string_view{it->value().as_string()}) == NOT_SAFE_TO_RESEND.end();
+}
+
 }  // namespace etl::impl
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "rpc/Errors.hpp"
+#include "util/Mutex.hpp"
 #include "util/log/Logger.hpp"
 #include "util/requests/WsConnection.hpp"
 
@@ -27,19 +28,49 @@
 #include <boost/json/object.hpp>
 
 #include <chrono>
+#include <cstddef>
 #include <expected>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace etl::impl {
 
+/**
+ * @brief Forwards requests to rippled over WebSocket.
+ *
+ * Connections are kept open after a successful request and reused by the next request with the same client IP and
+ * X-User value, as rippled reads both from the connection headers. A connection serves one request at a time.
+ * A request that fails on a reused connection is sent again on a new one, unless rippled may have received it and
+ * sending it twice could apply it twice.
+ */
 class ForwardingSource {
+    struct IdleConnection {
+        util::requests::WsConnectionPtr connection;
+        std::chrono::steady_clock::time_point idleSince;
+    };
+
+    struct SendError {
+        rpc::ClioError error;
+        bool isWritten;  // rippled may have received the request
+    };
+
+    struct IdleConnections {
+        std::unordered_map<std::string, std::vector<IdleConnection>> byKey;  // oldest first
+        std::size_t size = 0;
+    };
+
     util::Logger log_;
     util::requests::WsConnectionBuilder connectionBuilder_;
     std::chrono::steady_clock::duration forwardingTimeout_;
+    std::unique_ptr<util::Mutex<IdleConnections>> idleConnections_ = std::make_unique<util::Mutex<IdleConnections>>();
 
     static constexpr std::chrono::seconds CONNECTION_TIMEOUT{3};
+    static constexpr std::chrono::seconds IDLE_TIMEOUT{30};
+    static constexpr std::size_t MAX_IDLE_CONNECTIONS = 64;
 
 public:
     ForwardingSource(
@@ -65,6 +96,23 @@ public:
         std::string_view xUserValue,
         boost::asio::yield_context yield
     ) const;
+
+private:
+    std::expected<boost::json::object, SendError>
+    sendRequest(
+        util::requests::WsConnection& connection,
+        boost::json::object const& request,
+        boost::asio::yield_context yield
+    ) const;
+
+    util::requests::WsConnectionPtr
+    takeIdleConnection(std::string const& key) const;
+
+    void
+    putIdleConnection(std::string const& key, util::requests::WsConnectionPtr connection) const;
+
+    static bool
+    isSafeToResend(boost::json::object const& request);
 };
 
 }  // namespace etl::impl
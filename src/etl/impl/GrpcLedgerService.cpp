@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/GrpcLedgerService.hpp"
+
+#include "data/BackendInterface.hpp"
+#include "data/DBHelpers.hpp"
+#include "data/Types.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/status.h>
+#include <org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <org/xrpl/rpc/v1/get_ledger_data.pb.h>
+#include <org/xrpl/rpc/v1/ledger.pb.h>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/protocol/LedgerHeader.h>
+#include <xrpl/protocol/Serializer.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace etl::impl {
+
+namespace {
+
+util::prometheus::CounterInt&
+makeRequestsCounter(std::string method)
+{
+    return PrometheusService::counterInt(
+        "etl_grpc_server_requests_total_number",
+        util::prometheus::Labels({util::prometheus::Label{"method", std::move(method)}}),
+        "Number of gRPC requests served to other Clio nodes"
+    );
+}
+
+}  // namespace
+
+GrpcLedgerService::GrpcLedgerService(std::shared_ptr<BackendInterface> backend)
+    : backend_{std::move(backend)}
+    , getLedgerCounter_{makeRequestsCounter("GetLedger")}
+    , getLedgerDataCounter_{makeRequestsCounter("GetLedgerData")}
+{
+}
+
+grpc::Status
+GrpcLedgerService::GetLedger(
+    [[maybe_unused]] grpc::ServerContext* context,
+    org::xrpl::rpc::v1::GetLedgerRequest const* request,
+    org::xrpl::rpc::v1::GetLedgerResponse* response
+)
+{
+    ++getLedgerCounter_.get();
+
+    try {
+        return data::synchronousAndRetryOnTimeout([&](auto yield) {
+            response->Clear();
+
+            auto const header = fetchHeader(request->ledger(), yield);
+            if (not header)
+                return grpc::Status{grpc::StatusCode::NOT_FOUND, "ledger not found"};
+
+            ripple::Serializer serializedHeader;
+            ripple::addRaw(*header, serializedHeader, /* includeHash = */ true);
+            response->set_ledger_header(serializedHeader.data(), serializedHeader.size());
+            response->set_validated(true);
+            response->set_is_unlimited(true);
+
+            if (request->transactions() and request->expand()) {
+                auto* list = response->mutable_transactions_list();
+                for (auto const& txn : backend_->fetchAllTransactionsInLedger(header->seq, yield)) {
+                    auto* item = list->add_transactions();
+                    item->set_transaction_blob(txn.transaction.data(), txn.transaction.size());
+                    item->set_metadata_blob(txn.metadata.data(), txn.metadata.size());
+                }
+            } else if (request->transactions()) {
+                auto* list = response->mutable_hashes_list();
+                for (auto const& hash : backend_->fetchAllTransactionHashesInLedger(header->seq, yield))
+                    list->add_hashes(hash.data(), hash.size());
+            }
+
+            if (request->get_objects()) {
+                auto const diff = backend_->fetchLedgerDiff(header->seq, yield);
+
+                // an object is new if it did not exist in the previous ledger
+                std::vector<ripple::uint256> keys;
+                keys.reserve(diff.size());
+                std::ranges::transform(diff, std::back_inserter(keys), &data::LedgerObject::key);
+                auto const previous = backend_->fetchLedgerObjects(keys, header->seq - 1, yield);
+
+                auto* objects = response->mutable_ledger_objects();
+                for (std::size_t i = 0; i < diff.size(); ++i) {
+                    auto* item = objects->add_objects();
+                    item->set_key(diff[i].key.data(), diff[i].key.size());
+                    item->set_data(diff[i].blob.data(), diff[i].blob.size());
+
+                    if (diff[i].blob.empty()) {
+                        item->set_mod_type(org::xrpl::rpc::v1::RawLedgerObject::DELETED);
+                    } else if (previous[i].empty()) {
+                        item->set_mod_type(org::xrpl::rpc::v1::RawLedgerObject::CREATED);
+                    } else {
+                        item->set_mod_type(org::xrpl::rpc::v1::RawLedgerObject::MODIFIED);
+                    }
+                }
+
+                auto const withNeighbors = request->get_object_neighbors();
+                if (withNeighbors and not addObjectNeighbors(header->seq, diff, previous, *response)) {
+                    return grpc::Status{
+                        grpc::StatusCode::FAILED_PRECONDITION,
+                        "object neighbors are only available for the latest ledger in a full cache"
+                    };
+                }
+            }
+
+            return grpc::Status::OK;
+        });
+    } catch (std::exception const& e) {
+        LOG(log_.error()) << "Failed to serve GetLedger: " << e.what();
+        return {grpc::StatusCode::INTERNAL, e.what()};
+    }
+}
+
+grpc::Status
+GrpcLedgerService::GetLedgerData(
+    [[maybe_unused]] grpc::ServerContext* context,
+    org::xrpl::rpc::v1::GetLedgerDataRequest const* request,
+    org::xrpl::rpc::v1::GetLedgerDataResponse* response
+)
+{
+    ++getLedgerDataCounter_.get();
+
+    std::optional<ripple::uint256> marker;
+    if (not request->marker().empty()) {
+        marker = ripple::uint256::fromVoidChecked(request->marker());
+        if (not marker)
+            return {grpc::StatusCode::INVALID_ARGUMENT, "malformed marker"};
+    }
+
+    std::optional<ripple::uint256> endMarker;
+    if (not request->end_marker().empty()) {
+        endMarker = ripple::uint256::fromVoidChecked(request->end_marker());
+        if (not endMarker)
+            return {grpc::StatusCode::INVALID_ARGUMENT, "malformed end_marker"};
+    }
+
+    try {
+        return data::synchronousAndRetryOnTimeout([&](auto yield) {
+            response->Clear();
+
+            auto const header = fetchHeader(request->ledger(), yield);
+            if (not header)
+                return grpc::Status{grpc::StatusCode::NOT_FOUND, "ledger not found"};
+
+            auto page = backend_->fetchLedgerPage(marker, header->seq, PAGE_SIZE, /* outOfOrder = */ false, yield);
+
+            response->set_ledger_index(header->seq);
+            response->set_ledger_hash(header->hash.data(), header->hash.size());
+            response->set_is_unlimited(true);
+
+            auto* objects = response->mutable_ledger_objects();
+            for (auto const& obj : page.objects) {
+                if (endMarker and obj.key > *endMarker) {
+                    page.cursor.reset();
+                    break;
+                }
+
+                auto* item = objects->add_objects();
+                item->set_key(obj.key.data(), obj.key.size());
+                item->set_data(obj.blob.data(), obj.blob.size());
+            }
+
+            // like rippled, the marker is exclusive: the next page starts after it
+            if (page.cursor)
+                response->set_marker(page.cursor->data(), page.cursor->size());
+
+            return grpc::Status::OK;
+        });
+    } catch (std::exception const& e) {
+        LOG(log_.error()) << "Failed to serve GetLedgerData: " << e.what();
+        return {grpc::StatusCode::INTERNAL, e.what()};
+    }
+}
+
+bool
+GrpcLedgerService::addObjectNeighbors(
+    std::uint32_t seq,
+    std::vector<data::LedgerObject> const& diff,
+    std::vector<data::Blob> const& previous,
+    org::xrpl::rpc::v1::GetLedgerResponse& response
+) const
+{
+    // like rippled, only created and deleted objects get neighbors, looked up in the ledger after the change
+    std::vector<std::size_t> changed;
+    std::vector<ripple::uint256> bookBases;
+    for (std::size_t i = 0; i < diff.size(); ++i) {
+        if (not diff[i].blob.empty() and not previous[i].empty())
+            continue;
+
+        changed.push_back(i);
+        // a deleted directory is only recognizable by its previous version
+        auto const& blob = diff[i].blob.empty() ? previous[i] : diff[i].blob;
+        if (not blob.empty() and isBookDir(diff[i].key, blob))
+            bookBases.push_back(getBookBase(diff[i].key));
+    }
+
+    std::ranges::sort(changed, {}, [&](std::size_t i) { return diff[i].key; });
+    std::vector<ripple::uint256> keys;
+    keys.reserve(changed.size());
+    std::ranges::transform(changed, std::back_inserter(keys), [&](std::size_t i) { return diff[i].key; });
+
+    std::ranges::sort(bookBases);
+    auto const [first, last] = std::ranges::unique(bookBases);
+    bookBases.erase(first, last);
+
+    auto const neighbors = backend_->cache().getNeighbors(keys, seq);
+    auto const firstDirs = backend_->cache().getNeighbors(bookBases, seq);
+    if (not neighbors or not firstDirs)
+        return false;
+
+    auto* objects = response.mutable_ledger_objects()->mutable_objects();
+    for (std::size_t i = 0; i < changed.size(); ++i) {
+        auto& item = (*objects)[static_cast<int>(changed[i])];
+        if (auto const& pred = (*neighbors)[i].predecessor; pred)
+            item.set_predecessor(pred->data(), pred->size());
+        if (auto const& succ = (*neighbors)[i].successor; succ)
+            item.set_successor(succ->data(), succ->size());
+    }
+
+    for (std::size_t i = 0; i < bookBases.size(); ++i) {
+        auto* item = response.add_book_successors();
+        item->set_book_base(bookBases[i].data(), bookBases[i].size());
+        if (auto const& succ = (*firstDirs)[i].successor; succ)
+            item->set_first_book(succ->data(), succ->size());
+    }
+
+    response.set_object_neighbors_included(true);
+    return true;
+}
+
+std::optional<ripple::LedgerHeader>
+GrpcLedgerService::fetchHeader(
+    org::xrpl::rpc::v1::LedgerSpecifier const& specifier,
+    boost::asio::yield_context yield
+) const
+{
+    // ledgers outside of the range may be partially written or deleted
+    auto const range = backend_->fetchLedgerRange();
+    if (not range)
+        return std::nullopt;
+
+    auto header = [&]() -> std::optional<ripple::LedgerHeader> {
+        switch (specifier.ledger_case()) {
+            case org::xrpl::rpc::v1::LedgerSpecifier::kSequence:
+                return backend_->fetchLedgerBySequence(specifier.sequence(), yield);
+            case org::xrpl::rpc::v1::LedgerSpecifier::kHash:
+                if (auto const hash = ripple::uint256::fromVoidChecked(specifier.hash()); hash)
+                    return backend_->fetchLedgerByHash(*hash, yield);
+                return std::nullopt;
+            default:
+                // Clio only has validated ledgers, so every shortcut refers to the most recent one
+                return backend_->fetchLedgerBySequence(range->maxSequence, yield);
+        }
+    }();
+
+    if (not header or header->seq < range->minSequence or header->seq > range->maxSequence)
+        return std::nullopt;
+
+    return header;
+}
+
+}  // namespace etl::impl
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/BackendInterface.hpp"
+#include "data/Types.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Counter.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/status.h>
+#include <org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <org/xrpl/rpc/v1/get_ledger_data.pb.h>
+#include <org/xrpl/rpc/v1/ledger.pb.h>
+#include <xrpl/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+#include <xrpl/protocol/LedgerHeader.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace etl::impl {
+
+/**
+ * @brief Serves the part of rippled's XRPLedgerAPIService used by Clio's ETL from the database and cache.
+ *
+ * This allows Clio nodes to extract ledgers from another Clio node instead of rippled. Object neighbors are computed
+ * from the cache, so they can only be requested for the latest ledger and only while the cache is full.
+ */
+class GrpcLedgerService final : public org::xrpl::rpc::v1::XRPLedgerAPIService::Service {
+public:
+    /** @brief Maximum number of objects returned by one GetLedgerData call */
+    static constexpr std::uint32_t PAGE_SIZE = 2048;
+
+private:
+    util::Logger log_{"ETL"};
+    std::shared_ptr<BackendInterface> backend_;
+
+    std::reference_wrapper<util::prometheus::CounterInt> getLedgerCounter_;
+    std::reference_wrapper<util::prometheus::CounterInt> getLedgerDataCounter_;
+
+public:
+    /**
+     * @brief Construct a new service
+     *
+     * @param backend The backend to read ledgers from
+     */
+    explicit GrpcLedgerService(std::shared_ptr<BackendInterface> backend);
+
+    /**
+     * @brief Get the header and optionally the transactions and the object diff of a ledger
+     *
+     * @param context The call context; unused
+     * @param request The request
+     * @param response The response to fill
+     * @return The status of the call
+     */
+    grpc::Status
+    GetLedger(
+        grpc::ServerContext* context,
+        org::xrpl::rpc::v1::GetLedgerRequest const* request,
+        org::xrpl::rpc::v1::GetLedgerResponse* response
+    ) override;
+
+    /**
+     * @brief Get a page of the objects of a ledger
+     *
+     * @param context The call context; unused
+     * @param request The request
+     * @param response The response to fill
+     * @return The status of the call
+     */
+    grpc::Status
+    GetLedgerData(
+        grpc::ServerContext* context,
+        org::xrpl::rpc::v1::GetLedgerDataRequest const* request,
+        org::xrpl::rpc::v1::GetLedgerDataResponse* response
+    ) override;
+
+private:
+    /**
+     * @brief Add the neighbors of created and deleted objects and the first directories of changed books
+     *
+     * @param seq The sequence of the ledger
+     * @param diff The objects changed by the ledger, in the order of the response
+     * @param previous The versions of the changed objects in the previous ledger
+     * @param response The response to add the neighbors to
+     * @return true if the neighbors were added; false if the cache does not have the ledger
+     */
+    bool
+    addObjectNeighbors(
+        std::uint32_t seq,
+        std::vector<data::LedgerObject> const& diff,
+        std::vector<data::Blob> const& previous,
+        org::xrpl::rpc::v1::GetLedgerResponse& response
+    ) const;
+
+    std::optional<ripple::LedgerHeader>
+    fetchHeader(org::xrpl::rpc::v1::LedgerSpecifier const& specifier, boost::asio::yield_context yield) const;
+};
+
+}  // namespace etl::impl
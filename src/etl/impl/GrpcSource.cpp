@@ -20,6 +20,8 @@
 #include "etl/impl/GrpcSource.hpp"
 
 #include "data/BackendInterface.hpp"
+#include "data/DBHelpers.hpp"
+#include "data/Types.hpp"
 #include "etl/impl/AsyncData.hpp"
 #include "util/Assert.hpp"
 #include "util/log/Logger.hpp"
@@ -34,6 +36,8 @@
 #include <org/xrpl/rpc/v1/get_ledger.pb.h>
 #include <org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <exception>
@@ -41,6 +45,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -105,52 +110,115 @@ GrpcSource::loadInitialLedger(uint32_t const sequence, uint32_t const numMarkers
 
     std::vector<etl::impl::AsyncCallData> calls = impl::makeAsyncCallData(sequence, numMarkers);
 
-    LOG(log_.debug()) << "Starting data download for ledger " << sequence << ".";
+    if (calls.empty())
+        return {{}, true};
 
-    grpc::CompletionQueue cq;
-    for (auto& c : calls)
-        c.call(stub_, cq);
+    auto const target = cacheOnly ? AsyncCallData::Target::Cache : AsyncCallData::Target::CacheAndDB;
+    auto const success = download(sequence, calls, target);
+
+    LOG(log_.info()) << "Finished loadInitialLedger. cache size = " << backend_->cache().size()
+                     << ", abort = " << not success << ".";
 
-    void* tag = nullptr;
-    bool ok = false;
-    size_t numFinished = 0;
-    bool abort = false;
-    size_t const incr = 500000;
-    size_t progress = incr;
     std::vector<std::string> edgeKeys;
+    for (auto& call : calls) {
+        if (auto lastKey = call.getLastKey(); !lastKey.empty())
+            edgeKeys.push_back(std::move(lastKey));
+    }
 
-    while (numFinished < calls.size() && cq.Next(&tag, &ok)) {
-        ASSERT(tag != nullptr, "Tag can't be null.");
-        auto ptr = static_cast<etl::impl::AsyncCallData*>(tag);
+    return {std::move(edgeKeys), success};
+}
 
-        if (!ok) {
-            LOG(log_.error()) << "loadInitialLedger - ok is false";
-            return {{}, false};  // handle cancelled
-        }
+bool
+GrpcSource::loadLedgerState(uint32_t const sequence, uint32_t const numMarkers)
+{
+    if (!stub_)
+        return false;
 
-        LOG(log_.trace()) << "Marker prefix = " << ptr->getMarkerPrefix();
+    std::vector<etl::impl::AsyncCallData> calls = impl::makeAsyncCallData(sequence, numMarkers);
+    if (!download(sequence, calls, AsyncCallData::Target::DB))
+        return false;
 
-        auto result = ptr->process(stub_, cq, *backend_, abort, cacheOnly);
-        if (result != etl::impl::AsyncCallData::CallStatus::MORE) {
-            ++numFinished;
-            LOG(log_.debug()) << "Finished a marker. Current number of finished = " << numFinished;
+    // the successors within a marker range are written during the download; link the ranges, which are in key order
+    auto prev = uint256ToString(data::firstKey);
+    for (auto& call : calls) {
+        if (call.getFirstKey().empty())
+            continue;
 
-            if (auto lastKey = ptr->getLastKey(); !lastKey.empty())
-                edgeKeys.push_back(std::move(lastKey));
-        }
+        backend_->writeSuccessor(std::move(prev), sequence, std::string{call.getFirstKey()});
+        prev = call.getLastKey();
+    }
+    backend_->writeSuccessor(std::move(prev), sequence, uint256ToString(data::lastKey));
 
-        if (result == etl::impl::AsyncCallData::CallStatus::ERRORED)
-            abort = true;
+    LOG(log_.info()) << "Finished loading the state of ledger " << sequence << ".";
+    return true;
+}
+
+bool
+GrpcSource::download(uint32_t const sequence, std::vector<AsyncCallData>& calls, AsyncCallData::Target const target)
+{
+    if (calls.empty())
+        return true;
+
+    LOG(log_.debug()) << "Starting data download for ledger " << sequence << ".";
+
+    grpc::CompletionQueue cq;
+    for (auto& c : calls)
+        c.call(stub_, cq);
 
-        if (backend_->cache().size() > progress) {
-            LOG(log_.info()) << "Downloaded " << backend_->cache().size() << " records from rippled";
-            progress += incr;
+    std::atomic_size_t numFinished = 0;
+    std::atomic_bool abort = false;
+    size_t const incr = 500000;
+    std::atomic_size_t progress = incr;
+
+    // every thread drains the same completion queue; the last one to finish a marker shuts the queue down
+    auto const drainQueue = [&]() {
+        void* tag = nullptr;
+        bool ok = false;
+
+        while (cq.Next(&tag, &ok)) {
+            ASSERT(tag != nullptr, "Tag can't be null.");
+            auto ptr = static_cast<etl::impl::AsyncCallData*>(tag);
+
+            auto result = etl::impl::AsyncCallData::CallStatus::ERRORED;
+            if (ok) {
+                LOG(log_.trace()) << "Marker prefix = " << ptr->getMarkerPrefix();
+                result = ptr->process(stub_, cq, *backend_, abort, target);
+            } else {
+                LOG(log_.error()) << "download - ok is false";  // handle cancelled
+            }
+
+            if (result == etl::impl::AsyncCallData::CallStatus::ERRORED)
+                abort = true;
+
+            auto const cacheSize = backend_->cache().size();
+            if (auto current = progress.load();
+                cacheSize > current and progress.compare_exchange_strong(current, current + incr)) {
+                LOG(log_.info()) << "Downloaded " << cacheSize << " records from rippled";
+            }
+
+            if (result != etl::impl::AsyncCallData::CallStatus::MORE) {
+                auto const finished = ++numFinished;
+                LOG(log_.debug()) << "Finished a marker. Current number of finished = " << finished;
+
+                if (finished == calls.size())
+                    cq.Shutdown();
+            }
         }
-    }
+    };
+
+    auto const numThreads = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, calls.size());
+    LOG(log_.debug()) << "Processing " << calls.size() << " markers on " << numThreads << " threads.";
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (std::size_t i = 1; i < numThreads; ++i)
+        threads.emplace_back(drainQueue);
+
+    drainQueue();
+    for (auto& thread : threads)
+        thread.join();
 
-    LOG(log_.info()) << "Finished loadInitialLedger. cache size = " << backend_->cache().size() << ", abort = " << abort
-                     << ".";
-    return {std::move(edgeKeys), !abort};
+    return !abort;
 }
 
 }  // namespace etl::impl
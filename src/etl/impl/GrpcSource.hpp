@@ -20,6 +20,7 @@
 #pragma once
 
 #include "data/BackendInterface.hpp"
+#include "etl/impl/AsyncData.hpp"
 #include "util/log/Logger.hpp"
 
 #include <grpcpp/support/status.h>
@@ -58,6 +59,8 @@ public:
     /**
      * @brief Download a ledger in full.
      *
+     * The marker ranges are downloaded concurrently and processed by up to one thread per hardware core.
+     *
      * @param sequence Sequence of the ledger to download
      * @param numMarkers Number of markers to generate for async calls
      * @param cacheOnly Only insert into cache, not the DB; defaults to false
@@ -65,6 +68,23 @@ public:
      */
     std::pair<std::vector<std::string>, bool>
     loadInitialLedger(uint32_t sequence, uint32_t numMarkers, bool cacheOnly = false);
+
+    /**
+     * @brief Download the full state of a ledger into the database only.
+     *
+     * Objects are written without adding them to the diff of the ledger and the cache is not touched. All successors,
+     * including book successors, are written as well, so the state can be read from the database at the given sequence.
+     *
+     * @param sequence Sequence of the ledger to download
+     * @param numMarkers Number of markers to generate for async calls
+     * @return true if the download was successful; false otherwise
+     */
+    bool
+    loadLedgerState(uint32_t sequence, uint32_t numMarkers);
+
+private:
+    bool
+    download(uint32_t sequence, std::vector<AsyncCallData>& calls, AsyncCallData::Target target);
 };
 
 }  // namespace etl::impl
@@ -0,0 +1,240 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/LedgerDiffBroadcaster.hpp"
+
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/LedgerStreamHandshake.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace etl::impl {
+
+LedgerDiffBroadcaster::LedgerDiffBroadcaster(
+    boost::asio::io_context& ioc,
+    std::string const& ip,
+    std::uint16_t port,
+    std::string secret,
+    std::size_t maxQueueSize
+)
+    : strand_{boost::asio::make_strand(ioc)}
+    , acceptor_{strand_, boost::asio::ip::tcp::endpoint{boost::asio::ip::make_address(ip), port}}
+    , handshake_{std::move(secret)}
+    , maxQueueSize_{maxQueueSize}
+    , numClients_{PrometheusService::gaugeInt(
+          "etl_ledger_stream_clients",
+          util::prometheus::Labels{},
+          "Number of Clio nodes receiving the ledgers written by this node"
+      )}
+    , numDropped_{PrometheusService::counterInt(
+          "etl_ledger_stream_dropped_clients_total_number",
+          util::prometheus::Labels{},
+          "Number of Clio nodes disconnected because they could not keep up with the ledger stream"
+      )}
+{
+    LOG(log_.info()) << "Ledger stream listening on " << ip << ":" << this->port();
+}
+
+void
+LedgerDiffBroadcaster::run()
+{
+    boost::asio::post(strand_, [self = shared_from_this()]() { self->accept(); });
+}
+
+void
+LedgerDiffBroadcaster::stop()
+{
+    boost::asio::post(strand_, [self = shared_from_this()]() {
+        boost::system::error_code ec;
+        self->acceptor_.close(ec);
+
+        for (auto const& client : self->clients_)
+            client->socket.close(ec);
+
+        self->clients_.clear();
+        self->numClients_.get().set(0);
+    });
+}
+
+void
+LedgerDiffBroadcaster::broadcast(CommittedLedger const& ledger)
+{
+    auto const payload = ledger.serialize();
+    auto const size = static_cast<std::uint32_t>(payload.size());
+
+    std::string frame;
+    frame.reserve(sizeof(size) + payload.size());
+    for (auto shift = 24; shift >= 0; shift -= 8)
+        frame.push_back(static_cast<char>((size >> shift) & 0xFF));
+    frame.append(payload);
+
+    auto sharedFrame = std::make_shared<std::string const>(std::move(frame));
+    boost::asio::post(strand_, [self = shared_from_this(), frame = std::move(sharedFrame), seq = ledger.header.seq]() {
+        // copy as drop modifies clients_
+        auto const clients = self->clients_;
+        for (auto const& client : clients) {
+            if (client->queue.size() >= self->maxQueueSize_) {
+                LOG(self->log_.warn()) << "Ledger stream client is lagging behind. Disconnecting at ledger " << seq;
+                ++self->numDropped_.get();
+                self->drop(client);
+                continue;
+            }
+
+            client->queue.push_back(frame);
+            if (not client->isWriting)
+                self->write(client);
+        }
+    });
+}
+
+std::uint16_t
+LedgerDiffBroadcaster::port() const
+{
+    boost::system::error_code ec;
+    return acceptor_.local_endpoint(ec).port();
+}
+
+void
+LedgerDiffBroadcaster::accept()
+{
+    acceptor_.async_accept(boost::asio::bind_executor(
+        strand_,
+        [self = shared_from_this()](boost::system::error_code const& ec, boost::asio::ip::tcp::socket socket) {
+            if (ec == boost::asio::error::operation_aborted or not self->acceptor_.is_open())
+                return;
+
+            if (ec) {
+                LOG(self->log_.warn()) << "Could not accept ledger stream client: " << ec.message();
+            } else {
+                self->authenticate(std::move(socket));
+            }
+
+            self->accept();
+        }
+    ));
+}
+
+void
+LedgerDiffBroadcaster::authenticate(boost::asio::ip::tcp::socket socket)
+{
+    boost::asio::spawn(
+        strand_,
+        [self = shared_from_this(), socket = std::make_shared<boost::asio::ip::tcp::socket>(std::move(socket))](
+            boost::asio::yield_context yield
+        ) {
+            boost::system::error_code ec;
+            auto const endpoint = socket->remote_endpoint(ec);
+
+            auto session = self->handshake_.accept(socket, yield);
+            if (not session) {
+                LOG(self->log_.warn()) << "Ledger stream client from " << endpoint << " failed to authenticate";
+                socket->close(ec);
+                return;
+            }
+
+            // stopped while authenticating
+            if (not self->acceptor_.is_open()) {
+                socket->close(ec);
+                return;
+            }
+
+            LOG(self->log_.info()) << "Ledger stream client connected from " << endpoint;
+            socket->set_option(boost::asio::ip::tcp::no_delay{true}, ec);
+
+            self->clients_.push_back(
+                std::make_shared<Client>(Client{.socket = std::move(*socket), .session = std::move(*session)})
+            );
+            self->numClients_.get().set(static_cast<std::int64_t>(self->clients_.size()));
+        }
+    );
+}
+
+void
+LedgerDiffBroadcaster::write(std::shared_ptr<Client> client)
+{
+    client->isWriting = true;
+    auto frame = client->queue.front();  // the queue is cleared if the client is dropped while writing
+
+    // frames are signed in the order they are written, which is the order the client verifies them in
+    client->mac = client->session.sign(std::string_view{*frame}.substr(sizeof(std::uint32_t)));
+    std::array const buffers = {boost::asio::buffer(*frame), boost::asio::buffer(client->mac)};
+
+    boost::asio::async_write(
+        client->socket,
+        buffers,
+        boost::asio::bind_executor(
+            strand_,
+            [self = shared_from_this(), client, frame](boost::system::error_code const& ec, std::size_t) {
+                if (ec) {
+                    if (ec != boost::asio::error::operation_aborted)
+                        LOG(self->log_.info()) << "Ledger stream client disconnected: " << ec.message();
+
+                    self->drop(client);
+                    return;
+                }
+
+                // dropped while the write was completing
+                if (not client->socket.is_open())
+                    return;
+
+                client->queue.pop_front();
+                if (client->queue.empty()) {
+                    client->isWriting = false;
+                } else {
+                    self->write(client);
+                }
+            }
+        )
+    );
+}
+
+void
+LedgerDiffBroadcaster::drop(std::shared_ptr<Client> const& client)
+{
+    boost::system::error_code ec;
+    client->socket.close(ec);
+    client->queue.clear();
+
+    std::erase(clients_, client);
+    numClients_.get().set(static_cast<std::int64_t>(clients_.size()));
+}
+
+}  // namespace etl::impl
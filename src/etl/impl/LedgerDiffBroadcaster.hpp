@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/LedgerStreamHandshake.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Counter.hpp"
+#include "util/prometheus/Gauge.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace etl::impl {
+
+/**
+ * @brief Sends every ledger written by this node to the other Clio nodes connected to it.
+ *
+ * Ledgers are sent over TCP as a 4 byte big-endian length followed by CommittedLedger::serialize() and the MAC of the
+ * LedgerStreamSession, but only to nodes that passed the LedgerStreamHandshake. A node that does not keep up and has
+ * more than maxQueueSize ledgers waiting is disconnected; it reads from the database until it reconnects.
+ */
+class LedgerDiffBroadcaster : public std::enable_shared_from_this<LedgerDiffBroadcaster> {
+    struct Client {
+        boost::asio::ip::tcp::socket socket;
+        LedgerStreamSession session;
+        std::deque<std::shared_ptr<std::string const>> queue;
+        LedgerStreamSession::Mac mac{};  // of the frame being written
+        bool isWriting = false;
+    };
+
+    util::Logger log_{"ETL"};
+
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    LedgerStreamHandshake handshake_;
+    std::size_t maxQueueSize_;
+    std::vector<std::shared_ptr<Client>> clients_;  // only accessed on strand_
+
+    std::reference_wrapper<util::prometheus::GaugeInt> numClients_;
+    std::reference_wrapper<util::prometheus::CounterInt> numDropped_;
+
+public:
+    /**
+     * @brief Construct a new broadcaster and bind it to the given address
+     *
+     * @param ioc The io_context to run on
+     * @param ip The address to listen on
+     * @param port The port to listen on; 0 picks a free port
+     * @param secret The secret nodes have to prove to know before receiving ledgers
+     * @param maxQueueSize The maximum number of ledgers waiting to be sent to a single node
+     * @throws boost::system::system_error if the address can't be bound
+     */
+    LedgerDiffBroadcaster(
+        boost::asio::io_context& ioc,
+        std::string const& ip,
+        std::uint16_t port,
+        std::string secret,
+        std::size_t maxQueueSize
+    );
+
+    /**
+     * @brief Start accepting connections
+     */
+    void
+    run();
+
+    /**
+     * @brief Stop accepting connections and disconnect all nodes
+     */
+    void
+    stop();
+
+    /**
+     * @brief Send a ledger to all connected nodes
+     *
+     * @param ledger The ledger to send
+     */
+    void
+    broadcast(CommittedLedger const& ledger);
+
+    /** @return The port the broadcaster listens on */
+    std::uint16_t
+    port() const;
+
+private:
+    void
+    accept();
+
+    void
+    authenticate(boost::asio::ip::tcp::socket socket);
+
+    void
+    write(std::shared_ptr<Client> client);
+
+    void
+    drop(std::shared_ptr<Client> const& client);
+};
+
+}  // namespace etl::impl
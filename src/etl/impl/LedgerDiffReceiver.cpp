@@ -0,0 +1,205 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/LedgerDiffReceiver.hpp"
+
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/LedgerStreamHandshake.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/system/error_code.hpp>
+#include <xrpl/basics/Slice.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace etl::impl {
+
+LedgerDiffReceiver::LedgerDiffReceiver(boost::asio::io_context& ioc, std::vector<Peer> peers, std::string secret)
+    : strand_{boost::asio::make_strand(ioc)}
+    , peers_{std::move(peers)}
+    , handshake_{std::move(secret)}
+    , numReceived_{PrometheusService::counterInt(
+          "etl_ledger_stream_received_total_number",
+          util::prometheus::Labels{},
+          "Number of ledgers received from the ETL writer"
+      )}
+{
+}
+
+void
+LedgerDiffReceiver::run()
+{
+    for (auto const& peer : peers_) {
+        boost::asio::spawn(strand_, [self = shared_from_this(), peer](boost::asio::yield_context yield) {
+            boost::asio::steady_timer timer{self->strand_};
+
+            while (not self->stopping_) {
+                auto socket = std::make_shared<boost::asio::ip::tcp::socket>(self->strand_);
+                self->sockets_.push_back(socket);
+
+                boost::system::error_code ec;
+                boost::asio::ip::tcp::resolver resolver{self->strand_};
+                auto const endpoints = resolver.async_resolve(peer.ip, peer.port, yield[ec]);
+                if (not ec)
+                    boost::asio::async_connect(*socket, endpoints, yield[ec]);
+
+                if (not ec and not self->stopping_) {
+                    if (auto session = self->handshake_.connect(socket, yield); session) {
+                        LOG(self->log_.info()) << "Connected to ledger stream of " << peer.ip << ":" << peer.port;
+                        self->receive(*socket, *session, yield);
+                        LOG(self->log_.info()) << "Disconnected from ledger stream of " << peer.ip << ":" << peer.port;
+                    } else if (not self->stopping_) {
+                        LOG(self->log_.warn()) << "Ledger stream of " << peer.ip << ":" << peer.port
+                                               << " failed to authenticate";
+                    }
+                }
+
+                std::erase(self->sockets_, socket);
+                if (self->stopping_)
+                    break;
+
+                timer.expires_after(RETRY_DELAY);
+                timer.async_wait(yield[ec]);
+            }
+        });
+    }
+}
+
+void
+LedgerDiffReceiver::stop()
+{
+    {
+        std::scoped_lock const lck(mtx_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    boost::asio::post(strand_, [self = shared_from_this()]() {
+        boost::system::error_code ec;
+        for (auto const& socket : self->sockets_)
+            socket->close(ec);
+    });
+}
+
+std::optional<CommittedLedger>
+LedgerDiffReceiver::waitFor(std::uint32_t const sequence, std::chrono::steady_clock::duration const timeout)
+{
+    std::unique_lock lck(mtx_);
+
+    if (std::chrono::steady_clock::now() - lastReceived_ < ACTIVITY_TIMEOUT) {
+        cv_.wait_for(lck, timeout, [this, sequence]() {
+            return stopping_ or (not ledgers_.empty() and ledgers_.rbegin()->first >= sequence);
+        });
+    }
+
+    std::optional<CommittedLedger> result;
+    if (auto node = ledgers_.extract(sequence); node)
+        result = std::move(node.mapped());
+
+    // older ledgers will not be asked for anymore
+    ledgers_.erase(ledgers_.begin(), ledgers_.lower_bound(sequence));
+    return result;
+}
+
+void
+LedgerDiffReceiver::push(CommittedLedger ledger)
+{
+    {
+        std::scoped_lock const lck(mtx_);
+        lastReceived_ = std::chrono::steady_clock::now();
+
+        auto const seq = ledger.header.seq;
+        ledgers_.insert_or_assign(seq, std::move(ledger));
+        while (ledgers_.size() > MAX_BUFFERED_LEDGERS)
+            ledgers_.erase(ledgers_.begin());
+    }
+
+    ++numReceived_.get();
+    cv_.notify_all();
+}
+
+void
+LedgerDiffReceiver::receive(
+    boost::asio::ip::tcp::socket& socket,
+    LedgerStreamSession& session,
+    boost::asio::yield_context yield
+)
+{
+    boost::system::error_code ec;
+    std::array<unsigned char, 4> sizeBuffer{};
+    std::string payload;
+    LedgerStreamSession::Mac mac{};
+
+    while (not stopping_) {
+        boost::asio::async_read(socket, boost::asio::buffer(sizeBuffer), yield[ec]);
+        if (ec)
+            return;
+
+        std::uint32_t size = 0;
+        for (auto const byte : sizeBuffer)
+            size = (size << 8) | byte;
+
+        if (size > MAX_FRAME_SIZE) {
+            LOG(log_.error()) << "Ledger stream frame of " << size << " bytes is too large";
+            return;
+        }
+
+        payload.resize(size);
+        std::array const buffers = {boost::asio::buffer(payload), boost::asio::buffer(mac)};
+        boost::asio::async_read(socket, buffers, yield[ec]);
+        if (ec)
+            return;
+
+        if (not session.verify(payload, mac)) {
+            LOG(log_.error()) << "Received ledger stream frame with invalid MAC";
+            return;
+        }
+
+        auto ledger = CommittedLedger::deserialize(ripple::makeSlice(payload));
+        if (not ledger) {
+            LOG(log_.error()) << "Received malformed ledger or incompatible version on the ledger stream";
+            return;
+        }
+
+        push(std::move(*ledger));
+    }
+}
+
+}  // namespace etl::impl
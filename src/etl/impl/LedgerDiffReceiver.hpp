@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/LedgerStreamHandshake.hpp"
+#include "util/log/Logger.hpp"
+#include "util/prometheus/Counter.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace etl::impl {
+
+/**
+ * @brief Receives the ledgers broadcast by whichever of the configured Clio nodes is currently the ETL writer.
+ *
+ * A connection is kept to every peer and reestablished if it is lost. Ledgers are only received from peers that passed
+ * the LedgerStreamHandshake, and only if the MAC of their frame matches the session; otherwise the connection is
+ * dropped. Only the last few received ledgers are kept.
+ */
+class LedgerDiffReceiver : public std::enable_shared_from_this<LedgerDiffReceiver> {
+public:
+    /** @brief Address of a Clio node broadcasting ledgers */
+    struct Peer {
+        std::string ip;
+        std::string port;
+    };
+
+private:
+    // ledgers are only waited for if one was received recently, so idle peers don't delay the database fallback
+    static constexpr std::chrono::seconds ACTIVITY_TIMEOUT{10};
+    static constexpr std::chrono::seconds RETRY_DELAY{1};
+    static constexpr std::size_t MAX_BUFFERED_LEDGERS = 16;
+    static constexpr std::uint32_t MAX_FRAME_SIZE = 1u << 28;
+
+    util::Logger log_{"ETL"};
+
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    std::vector<Peer> peers_;
+    LedgerStreamHandshake handshake_;
+    std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> sockets_;  // only accessed on strand_
+    std::atomic_bool stopping_ = false;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::map<std::uint32_t, CommittedLedger> ledgers_;
+    std::chrono::steady_clock::time_point lastReceived_;
+
+    std::reference_wrapper<util::prometheus::CounterInt> numReceived_;
+
+public:
+    /**
+     * @brief Construct a new receiver
+     *
+     * @param ioc The io_context to run on
+     * @param peers The nodes to receive ledgers from
+     * @param secret The secret shared with the peers
+     */
+    LedgerDiffReceiver(boost::asio::io_context& ioc, std::vector<Peer> peers, std::string secret);
+
+    /**
+     * @brief Connect to all peers
+     */
+    void
+    run();
+
+    /**
+     * @brief Disconnect from all peers and wake up waiting threads
+     */
+    void
+    stop();
+
+    /**
+     * @brief Wait for a ledger to be received.
+     *
+     * Returns immediately if no ledger was received recently or if a newer ledger was received instead.
+     *
+     * @param sequence The sequence of the ledger
+     * @param timeout The maximum time to wait
+     * @return The ledger; nullopt if it was not received in time
+     */
+    std::optional<CommittedLedger>
+    waitFor(std::uint32_t sequence, std::chrono::steady_clock::duration timeout);
+
+    /**
+     * @brief Store a ledger received from a peer and wake up threads waiting for it
+     *
+     * @param ledger The received ledger
+     */
+    void
+    push(CommittedLedger ledger);
+
+private:
+    void
+    receive(boost::asio::ip::tcp::socket& socket, LedgerStreamSession& session, boost::asio::yield_context yield);
+};
+
+}  // namespace etl::impl
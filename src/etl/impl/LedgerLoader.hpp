@@ -38,6 +38,7 @@
 #include <xrpl/protocol/Serializer.h>
 #include <xrpl/protocol/TxMeta.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -55,6 +56,7 @@ struct FormattedTransactionsData {
     std::vector<AccountTransactionsData> accountTxData;
     std::vector<NFTTransactionsData> nfTokenTxData;
     std::vector<NFTsData> nfTokensData;
+    std::vector<data::TransactionAndMetadata> transactions; /**< ordered by transaction index, for publishing */
 };
 
 namespace etl::impl {
@@ -98,7 +100,8 @@ public:
      * @brief Insert extracted transaction into the ledger
      *
      * Insert all of the extracted transactions into the ledger, returning transactions related to accounts,
-     * transactions related to NFTs, and NFTs themselves for later processsing.
+     * transactions related to NFTs, and NFTs themselves for later processsing. A copy of the transactions and their
+     * metadata is returned as well, so the ledger can be published without reading it back from the database.
      *
      * @param ledger ledger to insert transactions into
      * @param data data extracted from an ETL source
@@ -108,6 +111,7 @@ public:
     insertTransactions(ripple::LedgerHeader const& ledger, GetLedgerResponseType& data)
     {
         FormattedTransactionsData result;
+        std::vector<std::pair<std::uint32_t, ::data::TransactionAndMetadata>> indexedTransactions;
 
         for (auto& txn : *(data.mutable_transactions_list()->mutable_transactions())) {
             std::string* raw = txn.mutable_transaction_blob();
@@ -125,17 +129,35 @@ public:
                 result.nfTokensData.push_back(*maybeNFT);
 
             result.accountTxData.emplace_back(txMeta, sttx.getTransactionID());
+            indexedTransactions.emplace_back(
+                txMeta.getIndex(),
+                ::data::TransactionAndMetadata{
+                    ::data::Blob{raw->begin(), raw->end()},
+                    ::data::Blob{txn.metadata_blob().begin(), txn.metadata_blob().end()},
+                    ledger.seq,
+                    ledger.closeTime.time_since_epoch().count()
+                }
+            );
+
             static constexpr std::size_t KEY_SIZE = 32;
             std::string keyStr{reinterpret_cast<char const*>(sttx.getTransactionID().data()), KEY_SIZE};
             backend_->writeTransaction(
                 std::move(keyStr),
                 ledger.seq,
+                txMeta.getIndex(),
                 ledger.closeTime.time_since_epoch().count(),
                 std::move(*raw),
                 std::move(*txn.mutable_metadata_blob())
             );
         }
 
+        std::sort(indexedTransactions.begin(), indexedTransactions.end(), [](auto const& lhs, auto const& rhs) {
+            return lhs.first < rhs.first;
+        });
+        result.transactions.reserve(indexedTransactions.size());
+        for (auto& indexed : indexedTransactions)
+            result.transactions.push_back(std::move(indexed.second));
+
         result.nfTokensData = getUniqueNFTsDatas(result.nfTokensData);
         return result;
     }
@@ -23,6 +23,10 @@
 #include "data/DBHelpers.hpp"
 #include "data/Types.hpp"
 #include "etl/SystemState.hpp"
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/LedgerDiffBroadcaster.hpp"
+#include "etl/impl/PipelineMetrics.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/SubscriptionManagerInterface.hpp"
 #include "util/Assert.hpp"
 #include "util/log/Logger.hpp"
@@ -87,6 +91,9 @@ class LedgerPublisher {
     std::optional<uint32_t> lastPublishedSequence_;
     mutable std::shared_mutex lastPublishedSeqMtx_;
 
+    std::shared_ptr<LedgerDiffBroadcaster> broadcaster_;
+    PipelineMetrics metrics_;
+
 public:
     /**
      * @brief Create an instance of the publisher
@@ -96,13 +103,15 @@ public:
         std::shared_ptr<BackendInterface> backend,
         CacheType& cache,
         std::shared_ptr<feed::SubscriptionManagerInterface> subscriptions,
-        SystemState const& state
+        SystemState const& state,
+        std::shared_ptr<LedgerDiffBroadcaster> broadcaster = nullptr
     )
         : publishStrand_{boost::asio::make_strand(ioc)}
         , backend_{std::move(backend)}
         , cache_{cache}
         , subscriptions_{std::move(subscriptions)}
         , state_{std::cref(state)}
+        , broadcaster_{std::move(broadcaster)}
     {
     }
 
@@ -140,6 +149,9 @@ public:
                 continue;
             }
 
+            // online deletion may have been advanced by another process
+            backend_->updateMinSequence(range->minSequence);
+
             auto lgr = data::synchronousAndRetryOnTimeout([&](auto yield) {
                 return backend_->fetchLedgerBySequence(ledgerSequence, yield);
             });
@@ -156,78 +168,38 @@ public:
      * @brief Publish the passed ledger asynchronously.
      *
      * All ledgers are published thru publishStrand_ which ensures that all publishes are performed in a serial fashion.
+     * The transactions and fees of the ledger are read from the database.
      *
      * @param lgrInfo the ledger to publish
      */
     void
     publish(ripple::LedgerHeader const& lgrInfo)
     {
-        boost::asio::post(publishStrand_, [this, lgrInfo = lgrInfo]() {
-            LOG(log_.info()) << "Publishing ledger " << std::to_string(lgrInfo.seq);
-
-            if (!state_.get().isWriting) {
-                LOG(log_.info()) << "Updating ledger range for read node.";
-
-                if (!cache_.get().isDisabled()) {
-                    std::vector<data::LedgerObject> const diff = data::synchronousAndRetryOnTimeout([&](auto yield) {
-                        return backend_->fetchLedgerDiff(lgrInfo.seq, yield);
-                    });
-
-                    cache_.get().update(diff, lgrInfo.seq);
-                }
-
-                backend_->updateRange(lgrInfo.seq);
-            }
-
-            setLastClose(lgrInfo.closeTime);
-            auto age = lastCloseAgeSeconds();
-
-            // if the ledger closed over MAX_LEDGER_AGE_SECONDS ago, assume we are still catching up and don't publish
-            // TODO: this probably should be a strategy
-            static constexpr std::uint32_t MAX_LEDGER_AGE_SECONDS = 600;
-            if (age < MAX_LEDGER_AGE_SECONDS) {
-                std::optional<ripple::Fees> fees = data::synchronousAndRetryOnTimeout([&](auto yield) {
-                    return backend_->fetchFees(lgrInfo.seq, yield);
-                });
-                ASSERT(fees.has_value(), "Fees must exist for ledger {}", lgrInfo.seq);
-
-                std::vector<data::TransactionAndMetadata> transactions =
-                    data::synchronousAndRetryOnTimeout([&](auto yield) {
-                        return backend_->fetchAllTransactionsInLedger(lgrInfo.seq, yield);
-                    });
-
-                auto const ledgerRange = backend_->fetchLedgerRange();
-                ASSERT(ledgerRange.has_value(), "Ledger range must exist");
-
-                std::string const range =
-                    std::to_string(ledgerRange->minSequence) + "-" + std::to_string(ledgerRange->maxSequence);
-
-                subscriptions_->pubLedger(lgrInfo, *fees, range, transactions.size());
-
-                // order with transaction index
-                std::sort(transactions.begin(), transactions.end(), [](auto const& t1, auto const& t2) {
-                    ripple::SerialIter iter1{t1.metadata.data(), t1.metadata.size()};
-                    ripple::STObject const object1(iter1, ripple::sfMetadata);
-                    ripple::SerialIter iter2{t2.metadata.data(), t2.metadata.size()};
-                    ripple::STObject const object2(iter2, ripple::sfMetadata);
-                    return object1.getFieldU32(ripple::sfTransactionIndex) <
-                        object2.getFieldU32(ripple::sfTransactionIndex);
-                });
-
-                for (auto& txAndMeta : transactions)
-                    subscriptions_->pubTransaction(txAndMeta, lgrInfo);
-
-                subscriptions_->pubBookChanges(lgrInfo, transactions);
+        doPublish(lgrInfo, std::nullopt);
+    }
 
-                setLastPublishTime();
-                LOG(log_.info()) << "Published ledger " << std::to_string(lgrInfo.seq);
-            } else {
-                LOG(log_.info()) << "Skipping publishing ledger " << std::to_string(lgrInfo.seq);
-            }
-        });
+    /**
+     * @brief Publish a ledger using the data the ETL writer already has in memory.
+     *
+     * On the writer the ledger is also broadcast to other Clio nodes, if a broadcaster is set. Other nodes use the diff
+     * of a ledger received that way to update their cache instead of reading it from the database.
+     *
+     * @param ledger the ledger to publish
+     */
+    void
+    publish(CommittedLedger ledger)
+    {
+        auto const lgrInfo = ledger.header;
+        doPublish(lgrInfo, std::move(ledger));
+    }
 
-        // we track latest publish-requested seq, not necessarily already published
-        setLastPublishedSequence(lgrInfo.seq);
+    /**
+     * @return true if the ledgers published by the writer are broadcast to other Clio nodes; false otherwise
+     */
+    bool
+    broadcastsLedgers() const
+    {
+        return broadcaster_ != nullptr;
     }
 
     /**
@@ -277,6 +249,102 @@ public:
     }
 
 private:
+    void
+    doPublish(ripple::LedgerHeader const& lgrInfo, std::optional<CommittedLedger> ledger)
+    {
+        boost::asio::post(publishStrand_, [this, lgrInfo, ledger = std::move(ledger)]() mutable {
+            LOG(log_.info()) << "Publishing ledger " << std::to_string(lgrInfo.seq);
+
+            if (!state_.get().isWriting) {
+                LOG(log_.info()) << "Updating ledger range for read node.";
+
+                // online deletion may have been advanced by the writer
+                if (ledger and ledger->minSequence != 0)
+                    backend_->updateMinSequence(ledger->minSequence);
+
+                if (!cache_.get().isDisabled()) {
+                    if (ledger) {
+                        cache_.get().update(std::move(ledger->diff), lgrInfo.seq);
+                    } else {
+                        std::vector<data::LedgerObject> diff =
+                            data::synchronousAndRetryOnTimeout([&](auto yield) {
+                                return backend_->fetchLedgerDiff(lgrInfo.seq, yield);
+                            });
+
+                        cache_.get().update(std::move(diff), lgrInfo.seq);
+                    }
+                }
+
+                backend_->updateRange(lgrInfo.seq);
+            } else if (ledger and broadcaster_) {
+                broadcaster_->broadcast(*ledger);
+            }
+
+            backend_->closeTimeIndex().add(
+                data::LedgerCloseTime{.sequence = lgrInfo.seq, .closeTime = lgrInfo.closeTime}
+            );
+
+            setLastClose(lgrInfo.closeTime);
+            auto age = lastCloseAgeSeconds();
+
+            // if the ledger closed over MAX_LEDGER_AGE_SECONDS ago, assume we are still catching up and don't publish
+            // TODO: this probably should be a strategy
+            static constexpr std::uint32_t MAX_LEDGER_AGE_SECONDS = 600;
+            if (age < MAX_LEDGER_AGE_SECONDS) {
+                std::optional<ripple::Fees> fees = ledger ? ledger->fees : std::nullopt;
+                if (not fees) {
+                    fees = data::synchronousAndRetryOnTimeout([&](auto yield) {
+                        return backend_->fetchFees(lgrInfo.seq, yield);
+                    });
+                }
+                ASSERT(fees.has_value(), "Fees must exist for ledger {}", lgrInfo.seq);
+
+                std::vector<data::TransactionAndMetadata> transactions;
+                if (ledger) {
+                    transactions = std::move(ledger->transactions);
+                } else {
+                    transactions = data::synchronousAndRetryOnTimeout([&](auto yield) {
+                        return backend_->fetchAllTransactionsInLedger(lgrInfo.seq, yield);
+                    });
+
+                    // order with transaction index
+                    std::sort(transactions.begin(), transactions.end(), [](auto const& t1, auto const& t2) {
+                        ripple::SerialIter iter1{t1.metadata.data(), t1.metadata.size()};
+                        ripple::STObject const object1(iter1, ripple::sfMetadata);
+                        ripple::SerialIter iter2{t2.metadata.data(), t2.metadata.size()};
+                        ripple::STObject const object2(iter2, ripple::sfMetadata);
+                        return object1.getFieldU32(ripple::sfTransactionIndex) <
+                            object2.getFieldU32(ripple::sfTransactionIndex);
+                    });
+                }
+
+                auto const ledgerRange = backend_->fetchLedgerRange();
+                ASSERT(ledgerRange.has_value(), "Ledger range must exist");
+
+                std::string const range =
+                    std::to_string(ledgerRange->minSequence) + "-" + std::to_string(ledgerRange->maxSequence);
+
+                subscriptions_->pubLedger(lgrInfo, *fees, range, transactions.size());
+
+                // the funds of the owners of all the offers are resolved together when the first one is published
+                feed::OwnerFunds ownerFunds{backend_, lgrInfo.seq, transactions};
+                for (auto& txAndMeta : transactions)
+                    subscriptions_->pubTransaction(txAndMeta, lgrInfo, ownerFunds);
+
+                subscriptions_->pubBookChanges(lgrInfo, transactions);
+
+                setLastPublishTime();
+                metrics_.observePublished(lgrInfo);
+                LOG(log_.info()) << "Published ledger " << std::to_string(lgrInfo.seq);
+            } else {
+                LOG(log_.info()) << "Skipping publishing ledger " << std::to_string(lgrInfo.seq);
+            }
+        });
+
+        // we track latest publish-requested seq, not necessarily already published
+        setLastPublishedSequence(lgrInfo.seq);
+    }
+
     void
     setLastClose(std::chrono::time_point<ripple::NetClock> lastCloseTime)
     {
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/LedgerRecording.hpp"
+
+#include "util/LedgerUtils.hpp"
+
+#include <fmt/core.h>
+#include <xrpl/basics/Slice.h>
+#include <xrpl/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace etl::impl {
+
+namespace {
+
+constexpr std::size_t FRAME_HEADER_SIZE = 4;
+using FrameHeader = std::array<unsigned char, FRAME_HEADER_SIZE>;
+
+FrameHeader
+encodeSize(uint32_t size)
+{
+    FrameHeader header{};
+    for (auto i = FRAME_HEADER_SIZE; i > 0; --i, size >>= 8u)
+        header[i - 1] = static_cast<unsigned char>(size & 0xFFu);
+    return header;
+}
+
+uint32_t
+decodeSize(FrameHeader const& header)
+{
+    uint32_t size = 0;
+    for (auto const byte : header)
+        size = (size << 8u) | byte;
+    return size;
+}
+
+uint32_t
+sequenceOf(org::xrpl::rpc::v1::GetLedgerResponse const& response)
+{
+    return util::deserializeHeader(ripple::makeSlice(response.ledger_header())).seq;
+}
+
+}  // namespace
+
+LedgerRecorder::LedgerRecorder(std::string const& path) : file_{path, std::ios::binary | std::ios::trunc}
+{
+    if (not file_)
+        throw std::runtime_error(fmt::format("Can't open ledger recording file {}", path));
+
+    file_.write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+    file_.flush();
+}
+
+void
+LedgerRecorder::record(org::xrpl::rpc::v1::GetLedgerResponse const& response)
+{
+    auto const serialized = response.SerializeAsString();
+    auto const frameHeader = encodeSize(static_cast<uint32_t>(serialized.size()));
+
+    std::scoped_lock const lock{mtx_};
+    file_.write(reinterpret_cast<char const*>(frameHeader.data()), frameHeader.size());
+    file_.write(serialized.data(), static_cast<std::streamsize>(serialized.size()));
+    file_.flush();
+}
+
+LedgerReplay::LedgerReplay(std::string const& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (not file)
+        throw std::runtime_error(fmt::format("Can't open ledger recording file {}", path));
+
+    std::string magic(LedgerRecorder::MAGIC.size(), '\0');
+    if (not file.read(magic.data(), static_cast<std::streamsize>(magic.size())) or magic != LedgerRecorder::MAGIC)
+        throw std::runtime_error(fmt::format("{} is not a ledger recording", path));
+
+    FrameHeader frameHeader{};
+    while (file.read(reinterpret_cast<char*>(frameHeader.data()), frameHeader.size())) {
+        auto const size = decodeSize(frameHeader);
+
+        std::string serialized(size, '\0');
+        GetLedgerResponseType response;
+        if (not file.read(serialized.data(), size) or not response.ParseFromString(serialized))
+            throw std::runtime_error(fmt::format("Ledger recording {} is truncated or corrupted", path));
+
+        auto const sequence = sequenceOf(response);
+        ledgers_.insert_or_assign(sequence, std::move(response));
+    }
+
+    if (file.gcount() != 0)
+        throw std::runtime_error(fmt::format("Ledger recording {} is truncated", path));
+}
+
+LedgerReplay::LedgerReplay(std::vector<GetLedgerResponseType> ledgers)
+{
+    for (auto& ledger : ledgers) {
+        auto const sequence = sequenceOf(ledger);
+        ledgers_.insert_or_assign(sequence, std::move(ledger));
+    }
+}
+
+LedgerReplay::OptionalGetLedgerResponseType
+LedgerReplay::fetchLedger(
+    uint32_t ledgerSequence,
+    [[maybe_unused]] bool getObjects,
+    [[maybe_unused]] bool getObjectNeighbors,
+    [[maybe_unused]] std::chrono::steady_clock::duration retryAfter
+) const
+{
+    if (auto const it = ledgers_.find(ledgerSequence); it != ledgers_.end())
+        return it->second;
+
+    return std::nullopt;
+}
+
+std::vector<std::string>
+LedgerReplay::loadInitialLedger(
+    [[maybe_unused]] uint32_t sequence,
+    [[maybe_unused]] bool cacheOnly,
+    [[maybe_unused]] std::chrono::steady_clock::duration retryAfter
+) const
+{
+    return {};
+}
+
+std::optional<uint32_t>
+LedgerReplay::firstSequence() const
+{
+    if (ledgers_.empty())
+        return std::nullopt;
+
+    return ledgers_.begin()->first;
+}
+
+std::optional<uint32_t>
+LedgerReplay::lastSequence() const
+{
+    if (ledgers_.empty())
+        return std::nullopt;
+
+    return ledgers_.rbegin()->first;
+}
+
+std::size_t
+LedgerReplay::size() const
+{
+    return ledgers_.size();
+}
+
+}  // namespace etl::impl
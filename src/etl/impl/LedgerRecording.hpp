@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include <xrpl/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace etl::impl {
+
+/**
+ * @brief Appends the ledgers fetched from rippled to a file, so they can be replayed offline with LedgerReplay.
+ *
+ * The file starts with a magic string followed by one frame per ledger: the length of the serialized
+ * GetLedgerResponse as a 4 byte big endian integer and the serialized response itself.
+ */
+class LedgerRecorder {
+    std::mutex mtx_;
+    std::ofstream file_;
+
+public:
+    /** @brief The string every recording starts with */
+    static constexpr std::string_view MAGIC = "CLIOLDG1";
+
+    /**
+     * @brief Create a recorder writing to the given file; the file is truncated.
+     *
+     * @param path The file to write the ledgers to
+     * @throw std::runtime_error if the file can't be opened
+     */
+    explicit LedgerRecorder(std::string const& path);
+
+    /**
+     * @brief Append a ledger to the recording.
+     *
+     * @param response The response received from rippled
+     */
+    void
+    record(org::xrpl::rpc::v1::GetLedgerResponse const& response);
+};
+
+/**
+ * @brief Feeds the ledgers of a recording back to the ETL, in place of the LoadBalancer.
+ *
+ * All ledgers are kept in memory so that they can be served as fast as the consumer can take them.
+ */
+class LedgerReplay {
+public:
+    using RawLedgerObjectType = org::xrpl::rpc::v1::RawLedgerObject;
+    using GetLedgerResponseType = org::xrpl::rpc::v1::GetLedgerResponse;
+    using OptionalGetLedgerResponseType = std::optional<GetLedgerResponseType>;
+
+private:
+    std::map<uint32_t, GetLedgerResponseType> ledgers_;
+
+public:
+    /**
+     * @brief Load a recording made by LedgerRecorder.
+     *
+     * @param path The file to read the ledgers from
+     * @throw std::runtime_error if the file can't be opened or is not a valid recording
+     */
+    explicit LedgerReplay(std::string const& path);
+
+    /**
+     * @brief Create a replay of the given ledgers.
+     *
+     * @param ledgers The ledgers to replay
+     */
+    explicit LedgerReplay(std::vector<GetLedgerResponseType> ledgers);
+
+    /**
+     * @brief Fetch data for a specific ledger.
+     *
+     * The ledgers are returned as they were recorded, the flags are only accepted for compatibility with the
+     * LoadBalancer.
+     *
+     * @param ledgerSequence Sequence of the ledger to fetch
+     * @param getObjects Ignored
+     * @param getObjectNeighbors Ignored
+     * @param retryAfter Ignored
+     * @return The recorded ledger; nullopt if it is not part of the recording, which ends the extraction
+     */
+    OptionalGetLedgerResponseType
+    fetchLedger(
+        uint32_t ledgerSequence,
+        bool getObjects,
+        bool getObjectNeighbors,
+        std::chrono::steady_clock::duration retryAfter = std::chrono::seconds{0}
+    ) const;
+
+    /**
+     * @brief Initial ledgers are not recorded; the replay always starts from an empty database.
+     *
+     * @param sequence Ignored
+     * @param cacheOnly Ignored
+     * @param retryAfter Ignored
+     * @return An empty list of edge keys
+     */
+    std::vector<std::string>
+    loadInitialLedger(
+        uint32_t sequence,
+        bool cacheOnly = false,
+        std::chrono::steady_clock::duration retryAfter = std::chrono::seconds{0}
+    ) const;
+
+    /** @return The sequence of the first recorded ledger; nullopt if the recording is empty */
+    std::optional<uint32_t>
+    firstSequence() const;
+
+    /** @return The sequence of the last recorded ledger; nullopt if the recording is empty */
+    std::optional<uint32_t>
+    lastSequence() const;
+
+    /** @return The number of recorded ledgers */
+    std::size_t
+    size() const;
+};
+
+}  // namespace etl::impl
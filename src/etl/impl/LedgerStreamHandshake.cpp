@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/LedgerStreamHandshake.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/error_code.hpp>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <xrpl/basics/Slice.h>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/beast/utility/rngfill.h>
+#include <xrpl/crypto/csprng.h>
+#include <xrpl/protocol/digest.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace etl::impl {
+
+namespace {
+
+constexpr std::string_view RECEIVER_ROLE = "receiver";
+constexpr std::string_view BROADCASTER_ROLE = "broadcaster";
+constexpr std::string_view SESSION_KEY_LABEL = "session";
+
+ripple::uint256
+makeNonce()
+{
+    ripple::uint256 nonce;
+    beast::rngfill(nonce.begin(), ripple::uint256::size(), ripple::crypto_prng());
+    return nonce;
+}
+
+/**
+ * @brief Closes the socket unless cancelled before the handshake timeout.
+ */
+class Deadline {
+    boost::asio::steady_timer timer_;
+
+public:
+    Deadline(std::shared_ptr<boost::asio::ip::tcp::socket> const& socket, std::chrono::steady_clock::duration timeout)
+        : timer_{socket->get_executor(), timeout}
+    {
+        timer_.async_wait([weak = std::weak_ptr{socket}](boost::system::error_code const& ec) {
+            if (auto const socket = weak.lock(); socket and not ec) {
+                boost::system::error_code ignored;
+                socket->close(ignored);
+            }
+        });
+    }
+
+    /** @return true if the deadline did not pass yet; false otherwise */
+    bool
+    cancel()
+    {
+        return timer_.cancel() > 0;
+    }
+};
+
+}  // namespace
+
+LedgerStreamSession::LedgerStreamSession(ripple::uint256 const& key) : key_{key}
+{
+}
+
+LedgerStreamSession::Mac
+LedgerStreamSession::sign(std::string_view frame)
+{
+    auto result = mac(frame);
+    ++numFrames_;
+    return result;
+}
+
+bool
+LedgerStreamSession::verify(std::string_view frame, Mac const& mac)
+{
+    auto const expected = this->mac(frame);
+    ++numFrames_;
+    return CRYPTO_memcmp(mac.data(), expected.data(), expected.size()) == 0;
+}
+
+LedgerStreamSession::Mac
+LedgerStreamSession::mac(std::string_view frame) const
+{
+    std::array<unsigned char, sizeof(numFrames_)> counter{};
+    for (std::size_t i = 0; i < counter.size(); ++i)
+        counter[i] = static_cast<unsigned char>((numFrames_ >> (8 * (counter.size() - 1 - i))) & 0xFF);
+
+    Mac result{};
+    auto* ctx = HMAC_CTX_new();
+    HMAC_Init_ex(ctx, key_.data(), static_cast<int>(key_.size()), EVP_sha256(), nullptr);
+    HMAC_Update(ctx, counter.data(), counter.size());
+    HMAC_Update(ctx, reinterpret_cast<unsigned char const*>(frame.data()), frame.size());
+    unsigned int size = 0;
+    HMAC_Final(ctx, result.data(), &size);
+    HMAC_CTX_free(ctx);
+    return result;
+}
+
+LedgerStreamHandshake::LedgerStreamHandshake(std::string secret) : secret_{std::move(secret)}
+{
+}
+
+std::optional<LedgerStreamSession>
+LedgerStreamHandshake::accept(
+    std::shared_ptr<boost::asio::ip::tcp::socket> const& socket,
+    boost::asio::yield_context yield
+) const
+{
+    Deadline deadline{socket, TIMEOUT};
+    boost::system::error_code ec;
+
+    ripple::uint256 receiverNonce;
+    boost::asio::async_read(*socket, boost::asio::buffer(receiverNonce.data(), receiverNonce.size()), yield[ec]);
+    if (ec)
+        return std::nullopt;
+
+    auto const broadcasterNonce = makeNonce();
+    auto const ownProof = proof(BROADCASTER_ROLE, receiverNonce, broadcasterNonce);
+    std::array const message = {
+        boost::asio::buffer(broadcasterNonce.data(), broadcasterNonce.size()),
+        boost::asio::buffer(ownProof.data(), ownProof.size())
+    };
+    boost::asio::async_write(*socket, message, yield[ec]);
+    if (ec)
+        return std::nullopt;
+
+    ripple::uint256 receiverProof;
+    boost::asio::async_read(*socket, boost::asio::buffer(receiverProof.data(), receiverProof.size()), yield[ec]);
+    if (ec)
+        return std::nullopt;
+
+    if (not deadline.cancel() or not isValidProof(receiverProof, RECEIVER_ROLE, receiverNonce, broadcasterNonce))
+        return std::nullopt;
+
+    return session(receiverNonce, broadcasterNonce);
+}
+
+std::optional<LedgerStreamSession>
+LedgerStreamHandshake::connect(
+    std::shared_ptr<boost::asio::ip::tcp::socket> const& socket,
+    boost::asio::yield_context yield
+) const
+{
+    Deadline deadline{socket, TIMEOUT};
+    boost::system::error_code ec;
+
+    auto const receiverNonce = makeNonce();
+    boost::asio::async_write(*socket, boost::asio::buffer(receiverNonce.data(), receiverNonce.size()), yield[ec]);
+    if (ec)
+        return std::nullopt;
+
+    ripple::uint256 broadcasterNonce;
+    ripple::uint256 broadcasterProof;
+    std::array const message = {
+        boost::asio::buffer(broadcasterNonce.data(), broadcasterNonce.size()),
+        boost::asio::buffer(broadcasterProof.data(), broadcasterProof.size())
+    };
+    boost::asio::async_read(*socket, message, yield[ec]);
+    if (ec or not isValidProof(broadcasterProof, BROADCASTER_ROLE, receiverNonce, broadcasterNonce))
+        return std::nullopt;
+
+    auto const ownProof = proof(RECEIVER_ROLE, receiverNonce, broadcasterNonce);
+    boost::asio::async_write(*socket, boost::asio::buffer(ownProof.data(), ownProof.size()), yield[ec]);
+
+    if (ec or not deadline.cancel())
+        return std::nullopt;
+
+    return session(receiverNonce, broadcasterNonce);
+}
+
+LedgerStreamSession
+LedgerStreamHandshake::session(ripple::uint256 const& receiverNonce, ripple::uint256 const& broadcasterNonce) const
+{
+    return LedgerStreamSession{proof(SESSION_KEY_LABEL, receiverNonce, broadcasterNonce)};
+}
+
+ripple::uint256
+LedgerStreamHandshake::proof(
+    std::string_view role,
+    ripple::uint256 const& receiverNonce,
+    ripple::uint256 const& broadcasterNonce
+) const
+{
+    return ripple::sha512Half(
+        ripple::Slice{role.data(), role.size()}, ripple::makeSlice(secret_), receiverNonce, broadcasterNonce
+    );
+}
+
+bool
+LedgerStreamHandshake::isValidProof(
+    ripple::uint256 const& received,
+    std::string_view role,
+    ripple::uint256 const& receiverNonce,
+    ripple::uint256 const& broadcasterNonce
+) const
+{
+    auto const expected = proof(role, receiverNonce, broadcasterNonce);
+    return CRYPTO_memcmp(received.data(), expected.data(), expected.size()) == 0;
+}
+
+}  // namespace etl::impl
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/spawn.hpp>
+#include <xrpl/basics/base_uint.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace etl::impl {
+
+/**
+ * @brief Authenticates the frames sent over a ledger stream connection after the handshake.
+ *
+ * Every frame is followed by an HMAC-SHA256 of the number of frames sent before it and the frame itself. The key is
+ * derived from the secret and both nonces of the handshake, so frames can neither be forged nor replayed, reordered or
+ * moved to another connection.
+ */
+class LedgerStreamSession {
+    ripple::uint256 key_;
+    std::uint64_t numFrames_ = 0;
+
+public:
+    static constexpr std::size_t MAC_SIZE = 32;
+    using Mac = std::array<unsigned char, MAC_SIZE>;
+
+    /**
+     * @brief Construct a new session
+     *
+     * @param key The session key agreed on in the handshake
+     */
+    explicit LedgerStreamSession(ripple::uint256 const& key);
+
+    /**
+     * @brief Authenticate the next frame sent
+     *
+     * @param frame The frame
+     * @return The MAC to send after the frame
+     */
+    [[nodiscard]] Mac
+    sign(std::string_view frame);
+
+    /**
+     * @brief Check the next frame received
+     *
+     * @param frame The frame
+     * @param mac The MAC received after the frame
+     * @return true if the frame was sent by the other end of this session; false otherwise
+     */
+    [[nodiscard]] bool
+    verify(std::string_view frame, Mac const& mac);
+
+private:
+    [[nodiscard]] Mac
+    mac(std::string_view frame) const;
+};
+
+/**
+ * @brief Mutual authentication of a ledger stream connection with a secret shared by all Clio nodes.
+ *
+ * The secret itself is never sent. The receiver sends a random nonce, the broadcaster answers with its own nonce and
+ * a proof, and the receiver finishes with its proof. A proof is the SHA-512 half of the role of the sender, the
+ * secret and both nonces, so it can neither be replayed on another connection nor reflected back to its sender. The
+ * frames sent afterwards are authenticated by the LedgerStreamSession the handshake returns.
+ */
+class LedgerStreamHandshake {
+    static constexpr std::chrono::seconds TIMEOUT{5};
+
+    std::string secret_;
+
+public:
+    /**
+     * @brief Construct a new handshake
+     *
+     * @param secret The secret shared by all nodes of the ledger stream
+     */
+    explicit LedgerStreamHandshake(std::string secret);
+
+    /**
+     * @brief Authenticate a receiver that connected to the broadcaster.
+     *
+     * @param socket The connected socket; closed if the handshake does not finish in time
+     * @param yield The coroutine context
+     * @return The session to sign the frames with if both sides proved to know the secret; nullopt otherwise
+     */
+    std::optional<LedgerStreamSession>
+    accept(std::shared_ptr<boost::asio::ip::tcp::socket> const& socket, boost::asio::yield_context yield) const;
+
+    /**
+     * @brief Authenticate the broadcaster the receiver connected to.
+     *
+     * @param socket The connected socket; closed if the handshake does not finish in time
+     * @param yield The coroutine context
+     * @return The session to verify the frames with if both sides proved to know the secret; nullopt otherwise
+     */
+    std::optional<LedgerStreamSession>
+    connect(std::shared_ptr<boost::asio::ip::tcp::socket> const& socket, boost::asio::yield_context yield) const;
+
+private:
+    [[nodiscard]] LedgerStreamSession
+    session(ripple::uint256 const& receiverNonce, ripple::uint256 const& broadcasterNonce) const;
+
+    [[nodiscard]] ripple::uint256
+    proof(std::string_view role, ripple::uint256 const& receiverNonce, ripple::uint256 const& broadcasterNonce) const;
+
+    [[nodiscard]] bool
+    isValidProof(
+        ripple::uint256 const& received,
+        std::string_view role,
+        ripple::uint256 const& receiverNonce,
+        ripple::uint256 const& broadcasterNonce
+    ) const;
+};
+
+}  // namespace etl::impl
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/PipelineMetrics.hpp"
+
+#include "data/DBHelpers.hpp"
+#include "util/prometheus/Histogram.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <xrpl/protocol/LedgerHeader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace etl::impl {
+
+namespace {
+
+std::vector<std::int64_t> const stageBuckets{1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 60000};
+std::vector<std::int64_t> const publishLagBuckets{
+    1000, 2000, 3000, 4000, 5000, 7500, 10000, 15000, 30000, 60000, 600000
+};
+
+char const*
+toString(PipelineMetrics::Stage stage)
+{
+    switch (stage) {
+        case PipelineMetrics::Stage::Extract:
+            return "extract";
+        case PipelineMetrics::Stage::Transform:
+            return "transform";
+        case PipelineMetrics::Stage::InsertTransactions:
+            return "insert_transactions";
+        case PipelineMetrics::Stage::WriteSuccessors:
+            return "write_successors";
+        case PipelineMetrics::Stage::UpdateCache:
+            return "update_cache";
+        case PipelineMetrics::Stage::FinishWrites:
+            return "finish_writes";
+    }
+    return "unknown";
+}
+
+util::prometheus::HistogramInt&
+makeHistogram(PipelineMetrics::Stage stage)
+{
+    using util::prometheus::Label;
+    using util::prometheus::Labels;
+
+    return PrometheusService::histogramInt(
+        "etl_stage_duration_milliseconds_histogram",
+        Labels({Label{"stage", toString(stage)}}),
+        stageBuckets,
+        "The time spent on one ledger in each stage of ETL"
+    );
+}
+
+}  // namespace
+
+PipelineMetrics::PipelineMetrics()
+    : stageDurations_{
+          makeHistogram(Stage::Extract),
+          makeHistogram(Stage::Transform),
+          makeHistogram(Stage::InsertTransactions),
+          makeHistogram(Stage::WriteSuccessors),
+          makeHistogram(Stage::UpdateCache),
+          makeHistogram(Stage::FinishWrites)
+      }
+    , publishLag_{PrometheusService::histogramInt(
+          "etl_publish_lag_milliseconds_histogram",
+          util::prometheus::Labels{},
+          publishLagBuckets,
+          "The time from the close of a ledger to its publication"
+      )}
+{
+}
+
+void
+PipelineMetrics::observe(Stage stage, std::chrono::duration<double> duration)
+{
+    auto const milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    stageDurations_[static_cast<std::size_t>(stage)].get().observe(milliseconds);
+}
+
+void
+PipelineMetrics::observePublished(ripple::LedgerHeader const& header)
+{
+    auto const closeTime = std::chrono::system_clock::time_point{
+        std::chrono::seconds{rippleEpochStart} + header.closeTime.time_since_epoch()
+    };
+    auto const lag =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - closeTime);
+
+    // the rounded close time can be slightly in the future
+    publishLag_.get().observe(std::max<std::int64_t>(lag.count(), 0));
+}
+
+}  // namespace etl::impl
@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "util/prometheus/Histogram.hpp"
+
+#include <xrpl/protocol/LedgerHeader.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace etl::impl {
+
+/**
+ * @brief Histograms of the time spent in each stage of the ETL pipeline.
+ *
+ * All instances share the same underlying metrics, so every part of the pipeline can own one.
+ */
+class PipelineMetrics {
+public:
+    /** @brief The stages of the pipeline */
+    enum class Stage : std::size_t {
+        Extract,            /**< fetching a ledger from an ETL source, including retries */
+        Transform,          /**< building and writing a ledger, from the extracted data to the committed ledger */
+        InsertTransactions, /**< preparing and writing the transactions */
+        WriteSuccessors,    /**< writing the successors sent by rippled */
+        UpdateCache,        /**< writing the objects and updating the cache */
+        FinishWrites        /**< waiting for all writes of the ledger to complete */
+    };
+
+private:
+    static constexpr std::size_t NUM_STAGES = 6;
+
+    std::array<std::reference_wrapper<util::prometheus::HistogramInt>, NUM_STAGES> stageDurations_;
+    std::reference_wrapper<util::prometheus::HistogramInt> publishLag_;
+
+public:
+    /**
+     * @brief Create the metrics or get the existing ones.
+     */
+    PipelineMetrics();
+
+    /**
+     * @brief Record the time spent in a stage for one ledger
+     *
+     * @param stage The stage
+     * @param duration The time spent
+     */
+    void
+    observe(Stage stage, std::chrono::duration<double> duration);
+
+    /**
+     * @brief Run a function and record its duration as the time spent in a stage
+     *
+     * @param stage The stage
+     * @param func The function to run
+     * @return The result of the function
+     */
+    template <typename FnType>
+    decltype(auto)
+    measure(Stage stage, FnType&& func)
+    {
+        struct Observer {
+            PipelineMetrics& metrics;
+            Stage stage;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            ~Observer()
+            {
+                metrics.observe(stage, std::chrono::steady_clock::now() - start);
+            }
+        } const observer{*this, stage};
+
+        return std::forward<FnType>(func)();
+    }
+
+    /**
+     * @brief Record the time from the close of a ledger to its publication.
+     *
+     * The close time is rounded by the network to the close time resolution of the ledger, so this is an approximation.
+     *
+     * @param header The header of the published ledger
+     */
+    void
+    observePublished(ripple::LedgerHeader const& header);
+};
+
+}  // namespace etl::impl
@@ -201,6 +201,19 @@ public:
         return grpcSource_.loadInitialLedger(sequence, numMarkers, cacheOnly);
     }
 
+    /**
+     * @brief Download the full state of a ledger into the database only, e.g. for a backfill.
+     *
+     * @param sequence Sequence of the ledger to download
+     * @param numMarkers Number of markers to generate for async calls
+     * @return true if the download was successful; false otherwise
+     */
+    bool
+    loadLedgerState(uint32_t sequence, std::uint32_t numMarkers) final
+    {
+        return grpcSource_.loadLedgerState(sequence, numMarkers);
+    }
+
     /**
      * @brief Forward a request to rippled.
      *
@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/SourceStats.hpp"
+
+#include "util/prometheus/Histogram.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <boost/json/object.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace etl::impl {
+
+namespace {
+
+std::vector<std::int64_t> const histogramBuckets{1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 60000};
+
+// a source without any finished request yet is assumed to be this fast
+constexpr double MIN_LATENCY_SECONDS = 0.001;
+
+char const*
+toString(SourceStats::Operation op)
+{
+    switch (op) {
+        case SourceStats::Operation::Forward:
+            return "forward";
+        case SourceStats::Operation::FetchLedger:
+            return "fetch_ledger";
+        case SourceStats::Operation::LoadInitialLedger:
+            return "load_initial_ledger";
+    }
+    return "unknown";
+}
+
+util::prometheus::HistogramInt&
+makeHistogram(std::string const& sourceLabel, SourceStats::Operation op)
+{
+    using util::prometheus::Label;
+    using util::prometheus::Labels;
+
+    return PrometheusService::histogramInt(
+        "etl_source_request_duration_milliseconds_histogram",
+        Labels({Label{"source", sourceLabel}, Label{"operation", toString(op)}}),
+        histogramBuckets,
+        "The duration of requests to an ETL source"
+    );
+}
+
+}  // namespace
+
+SourceStats::SourceStats(std::string const& sourceLabel)
+    : trackers_{
+          Tracker{.histogram = makeHistogram(sourceLabel, Operation::Forward)},
+          Tracker{.histogram = makeHistogram(sourceLabel, Operation::FetchLedger)},
+          Tracker{.histogram = makeHistogram(sourceLabel, Operation::LoadInitialLedger)}
+      }
+{
+}
+
+std::chrono::steady_clock::time_point
+SourceStats::start(Operation op)
+{
+    ++trackers_[static_cast<std::size_t>(op)].inFlight;
+    return std::chrono::steady_clock::now();
+}
+
+void
+SourceStats::finish(Operation op, std::chrono::steady_clock::time_point startTime, bool success)
+{
+    auto& tracker = trackers_[static_cast<std::size_t>(op)];
+    auto const duration = std::chrono::steady_clock::now() - startTime;
+
+    --tracker.inFlight;
+    tracker.histogram.get().observe(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+
+    auto const seconds = std::chrono::duration<double>(duration).count();
+
+    std::scoped_lock const lck{tracker.mtx};
+    tracker.errorRate = (1. - SMOOTHING) * tracker.errorRate + SMOOTHING * (success ? 0. : 1.);
+    // a timed out request took at least as long as a successful one would have
+    tracker.latency = tracker.latency == 0. ? seconds : (1. - SMOOTHING) * tracker.latency + SMOOTHING * seconds;
+
+    // the hedge delay is derived from the samples, so they only contain requests that got a response
+    if (success) {
+        tracker.samples[tracker.numSamples % NUM_SAMPLES] = seconds;
+        ++tracker.numSamples;
+    }
+}
+
+double
+SourceStats::score(Operation op) const
+{
+    auto const& tracker = trackers_[static_cast<std::size_t>(op)];
+
+    std::scoped_lock const lck{tracker.mtx};
+    auto const latency = std::max(tracker.latency, MIN_LATENCY_SECONDS);
+    return latency * (1. + tracker.inFlight) * (1. + ERROR_PENALTY * tracker.errorRate) +
+        FAILURE_PENALTY_SECONDS * tracker.errorRate;
+}
+
+void
+SourceStats::setConnected(bool connected)
+{
+    connected_ = connected;
+}
+
+bool
+SourceStats::isConnected() const
+{
+    return connected_;
+}
+
+std::optional<std::chrono::steady_clock::duration>
+SourceStats::latencyPercentile(Operation op, double percentile) const
+{
+    auto const& tracker = trackers_[static_cast<std::size_t>(op)];
+
+    std::vector<double> samples;
+    {
+        std::scoped_lock const lck{tracker.mtx};
+        if (tracker.numSamples < MIN_SAMPLES)
+            return std::nullopt;
+
+        auto const count = std::min(tracker.numSamples, NUM_SAMPLES);
+        samples.assign(tracker.samples.begin(), std::next(tracker.samples.begin(), static_cast<std::ptrdiff_t>(count)));
+    }
+
+    auto const nth = std::next(samples.begin(), static_cast<std::ptrdiff_t>(percentile * (samples.size() - 1)));
+    std::ranges::nth_element(samples, nth);
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(*nth));
+}
+
+boost::json::object
+SourceStats::toJson() const
+{
+    boost::json::object result;
+    for (auto const op : {Operation::Forward, Operation::FetchLedger, Operation::LoadInitialLedger}) {
+        auto const& tracker = trackers_[static_cast<std::size_t>(op)];
+
+        std::scoped_lock const lck{tracker.mtx};
+        result[toString(op)] = {
+            {"latency_ms", tracker.latency * 1000.},
+            {"error_rate", tracker.errorRate},
+            {"in_flight", tracker.inFlight.load()},
+        };
+    }
+    return result;
+}
+
+}  // namespace etl::impl
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "util/prometheus/Histogram.hpp"
+
+#include <boost/json/object.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace etl::impl {
+
+/**
+ * @brief Tracks the latency, error rate and number of requests in flight of one ETL source.
+ *
+ * Latency and error rate are exponentially weighted moving averages, so the score of a source follows its recent
+ * behaviour. Each kind of operation is tracked separately as their latencies differ by orders of magnitude.
+ */
+class SourceStats {
+public:
+    /** @brief The kinds of operations executed on a source */
+    enum class Operation : std::size_t { Forward, FetchLedger, LoadInitialLedger };
+
+private:
+    static constexpr std::size_t NUM_OPERATIONS = 3;
+    static constexpr double SMOOTHING = 0.2;  // weight of the newest sample
+    static constexpr double ERROR_PENALTY = 10.;
+    static constexpr double FAILURE_PENALTY_SECONDS = 5.;  // added at full error rate, as failures may be fast
+    static constexpr std::size_t NUM_SAMPLES = 128;
+    static constexpr std::size_t MIN_SAMPLES = 16;
+
+    struct Tracker {
+        mutable std::mutex mtx;
+        double latency = 0.;    // seconds, failed and timed out requests included
+        double errorRate = 0.;  // 1 for every failed request, 0 for every successful one
+        std::array<double, NUM_SAMPLES> samples{};  // latest latencies of successful requests, used as a ring buffer
+        std::size_t numSamples = 0;
+        std::atomic_uint32_t inFlight = 0;
+        std::reference_wrapper<util::prometheus::HistogramInt> histogram;
+    };
+
+    std::array<Tracker, NUM_OPERATIONS> trackers_;
+    std::atomic_bool connected_ = false;
+
+public:
+    /**
+     * @brief Construct stats for a source
+     *
+     * @param sourceLabel The value of the source label of the metrics
+     */
+    explicit SourceStats(std::string const& sourceLabel);
+
+    /**
+     * @brief Register the start of a request
+     *
+     * @param op The operation started
+     * @return The start time to pass to finish()
+     */
+    std::chrono::steady_clock::time_point
+    start(Operation op);
+
+    /**
+     * @brief Register the end of a request started with start()
+     *
+     * @param op The operation finished
+     * @param startTime The value returned by start()
+     * @param success Whether the request succeeded
+     */
+    void
+    finish(Operation op, std::chrono::steady_clock::time_point startTime, bool success);
+
+    /**
+     * @brief Get the expected cost of sending a request to the source; lower is better
+     *
+     * A source that was not used yet has the lowest possible score, so that every source gets measured. A source that
+     * failed recently scores worse than a healthy one even if it failed quickly.
+     *
+     * @param op The operation to score
+     * @return The score
+     */
+    double
+    score(Operation op) const;
+
+    /**
+     * @brief Set whether the source is connected
+     *
+     * @param connected Whether the source is connected
+     */
+    void
+    setConnected(bool connected);
+
+    /**
+     * @return true if the source is connected; false otherwise
+     */
+    bool
+    isConnected() const;
+
+    /**
+     * @brief Get a percentile of the latency of the latest successful requests
+     *
+     * @param op The operation to get the latency of
+     * @param percentile The percentile, between 0 and 1
+     * @return The latency; std::nullopt if there are too few requests to tell
+     */
+    std::optional<std::chrono::steady_clock::duration>
+    latencyPercentile(Operation op, double percentile) const;
+
+    /**
+     * @brief Represent the stats as a JSON object
+     *
+     * @return The stats of every operation
+     */
+    boost::json::object
+    toJson() const;
+};
+
+}  // namespace etl::impl
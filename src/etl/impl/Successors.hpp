@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#pragma once
+
+#include "data/BackendInterface.hpp"
+#include "data/DBHelpers.hpp"
+#include "data/Types.hpp"
+#include "util/log/Logger.hpp"
+
+#include <xrpl/basics/strHex.h>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace etl::impl {
+
+/**
+ * @brief Write the successors of a ledger fetched with object neighbors.
+ *
+ * The book successors and the neighbors of created and deleted objects sent by rippled are written as they are, so the
+ * cache is not needed. The response and its objects are only read, so this can run concurrently with code that moves
+ * data out of other parts of the response.
+ *
+ * @param backend The backend to write the successors to
+ * @param seq The sequence of the ledger
+ * @param rawData The ledger fetched with object neighbors
+ * @param objects The ledger objects of rawData
+ */
+template <typename GetLedgerResponseType, typename ObjectsType>
+void
+writeSuccessorsFromNeighbors(
+    BackendInterface& backend,
+    std::uint32_t const seq,
+    GetLedgerResponseType const& rawData,
+    ObjectsType const& objects
+)
+{
+    using RawLedgerObjectType = std::decay_t<decltype(*objects.begin())>;
+    static util::Logger const log{"ETL"};
+
+    for (auto const& obj : rawData.book_successors()) {
+        auto firstBook = obj.first_book().empty() ? uint256ToString(data::lastKey) : obj.first_book();
+        LOG(log.debug()) << "writing book successor " << ripple::strHex(obj.book_base()) << " - "
+                         << ripple::strHex(firstBook);
+
+        backend.writeSuccessor(std::string{obj.book_base()}, seq, std::move(firstBook));
+    }
+
+    for (auto const& obj : objects) {
+        if (obj.mod_type() == RawLedgerObjectType::MODIFIED) {
+            LOG(log.debug()) << "object modified " << ripple::strHex(obj.key());
+            continue;
+        }
+
+        auto pred = obj.predecessor().empty() ? uint256ToString(data::firstKey) : obj.predecessor();
+        auto succ = obj.successor().empty() ? uint256ToString(data::lastKey) : obj.successor();
+
+        if (obj.mod_type() == RawLedgerObjectType::DELETED) {
+            LOG(log.debug()) << "Modifying successors for deleted object " << ripple::strHex(obj.key()) << " - "
+                             << ripple::strHex(pred) << " - " << ripple::strHex(succ);
+
+            backend.writeSuccessor(std::move(pred), seq, std::move(succ));
+        } else {
+            LOG(log.debug()) << "adding successor for new object " << ripple::strHex(obj.key()) << " - "
+                             << ripple::strHex(pred) << " - " << ripple::strHex(succ);
+
+            backend.writeSuccessor(std::move(pred), seq, std::string{obj.key()});
+            backend.writeSuccessor(std::string{obj.key()}, seq, std::move(succ));
+        }
+    }
+}
+
+}  // namespace etl::impl
@@ -24,10 +24,14 @@
 #include "data/Types.hpp"
 #include "etl/SystemState.hpp"
 #include "etl/impl/AmendmentBlock.hpp"
+#include "etl/impl/CommittedLedger.hpp"
 #include "etl/impl/LedgerLoader.hpp"
+#include "etl/impl/PipelineMetrics.hpp"
+#include "etl/impl/Successors.hpp"
 #include "util/Assert.hpp"
 #include "util/LedgerUtils.hpp"
 #include "util/Profiler.hpp"
+#include "util/async/context/BasicExecutionContext.hpp"
 #include "util/log/Logger.hpp"
 
 #include <grpcpp/grpcpp.h>
@@ -35,14 +39,18 @@
 #include <xrpl/basics/strHex.h>
 #include <xrpl/beast/core/CurrentThreadName.h>
 #include <xrpl/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+#include <xrpl/protocol/Fees.h>
+#include <xrpl/protocol/Indexes.h>
 #include <xrpl/protocol/LedgerHeader.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
-#include <set>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -61,6 +69,10 @@ namespace etl::impl {
 
 /**
  * @brief Transformer thread that prepares new ledger out of raw data from GRPC.
+ *
+ * Transactions and the successors sent by rippled do not depend on the cache, so they are processed on a small worker
+ * pool while the transformer thread writes the ledger objects and updates the cache. The cache update and
+ * finishWrites always happen on the transformer thread, in ledger order.
  */
 template <
     typename DataPipeType,
@@ -71,6 +83,9 @@ class Transformer {
     using GetLedgerResponseType = typename LedgerLoaderType::GetLedgerResponseType;
     using RawLedgerObjectType = typename LedgerLoaderType::RawLedgerObjectType;
 
+    // one worker for the transactions and one for the successors sent by rippled
+    static constexpr std::size_t NUM_WORKERS = 2;
+
     util::Logger log_{"ETL"};
 
     std::reference_wrapper<DataPipeType> pipe_;
@@ -82,8 +97,12 @@ class Transformer {
     uint32_t startSequence_;
     std::reference_wrapper<SystemState> state_;  // shared state for ETL
 
+    util::async::PoolExecutionContext workers_{NUM_WORKERS};
     std::thread thread_;
 
+    std::optional<ripple::Fees> fees_;  // fees as of the last built ledger, handed over to the publisher
+    PipelineMetrics metrics_;
+
 public:
     /**
      * @brief Create an instance of the transformer.
@@ -150,7 +169,8 @@ private:
                 continue;
 
             auto const start = std::chrono::system_clock::now();
-            auto [lgrInfo, success] = buildNextLedger(*fetchResponse);
+            auto [ledger, success] =
+                metrics_.measure(PipelineMetrics::Stage::Transform, [&]() { return buildNextLedger(*fetchResponse); });
 
             if (success) {
                 auto const numTxns = fetchResponse->transactions_list().transactions_size();
@@ -159,18 +179,20 @@ private:
                 auto const duration = ((end - start).count()) / 1000000000.0;
 
                 LOG(log_.info()) << "Load phase of ETL. Successfully wrote ledger! Ledger info: "
-                                 << util::toString(lgrInfo) << ". txn count = " << numTxns
+                                 << util::toString(ledger.header) << ". txn count = " << numTxns
                                  << ". object count = " << numObjects << ". load time = " << duration
                                  << ". load txns per second = " << numTxns / duration
                                  << ". load objs per second = " << numObjects / duration;
 
                 // success is false if the ledger was already written
-                publisher_.get().publish(lgrInfo);
+                publisher_.get().publish(std::move(ledger));
             } else {
-                LOG(log_.error()) << "Error writing ledger. " << util::toString(lgrInfo);
+                LOG(log_.error()) << "Error writing ledger. " << util::toString(ledger.header);
             }
 
-            setWriteConflict(not success);
+            // never clear the flag here, it may have been raised by losing the writer lease
+            if (not success)
+                setWriteConflict(true);
         }
     }
 
@@ -179,9 +201,9 @@ private:
      * @note rawData should be data that corresponds to the ledger immediately following the previous seq.
      *
      * @param rawData Data extracted from an ETL source
-     * @return The newly built ledger and data to write to the database
+     * @return The newly built ledger with the data needed to publish it and whether it was written
      */
-    std::pair<ripple::LedgerHeader, bool>
+    std::pair<CommittedLedger, bool>
     buildNextLedger(GetLedgerResponseType& rawData)
     {
         LOG(log_.debug()) << "Beginning ledger update";
@@ -191,55 +213,109 @@ private:
         backend_->startWrites();
         backend_->writeLedger(lgrInfo, std::move(*rawData.mutable_ledger_header()));
 
-        writeSuccessors(lgrInfo, rawData);
-        std::optional<FormattedTransactionsData> insertTxResultOp;
+        // the workers and this thread touch disjoint parts of rawData; only this thread modifies the objects, the
+        // successor worker reads their keys and neighbors
+        auto& objects = *(rawData.mutable_ledger_objects()->mutable_objects());
+        auto txnsOperation = workers_.execute([&]() {
+            return metrics_.measure(PipelineMetrics::Stage::InsertTransactions, [&]() {
+                return loader_.get().insertTransactions(lgrInfo, rawData);
+            });
+        });
+        auto successorsOperation = workers_.execute([&]() {
+            metrics_.measure(PipelineMetrics::Stage::WriteSuccessors, [&]() {
+                writeSuccessors(lgrInfo, rawData, objects);
+            });
+        });
+
+        std::vector<data::LedgerObject> diff;
+        std::optional<std::string> error;
         try {
-            updateCache(lgrInfo, rawData);
+            diff = metrics_.measure(PipelineMetrics::Stage::UpdateCache, [&]() {
+                return updateCache(lgrInfo, rawData, objects);
+            });
 
             LOG(log_.debug()) << "Inserted/modified/deleted all objects. Number of objects = "
                               << rawData.ledger_objects().objects_size();
-
-            insertTxResultOp.emplace(loader_.get().insertTransactions(lgrInfo, rawData));
         } catch (std::runtime_error const& e) {
-            LOG(log_.fatal()) << "Failed to build next ledger: " << e.what();
+            error = e.what();
+        } catch (...) {
+            // the workers reference rawData, which must outlive them
+            successorsOperation.wait();
+            txnsOperation.wait();
+            throw;
+        }
+
+        auto const successorsResult = successorsOperation.get();
+        if (not error and not successorsResult)
+            error = successorsResult.error().message;
+
+        auto insertTxResult = txnsOperation.get();
+        if (not error and not insertTxResult)
+            error = insertTxResult.error().message;
+
+        if (error) {
+            LOG(log_.fatal()) << "Failed to build next ledger: " << *error;
 
             amendmentBlockHandler_.get().onAmendmentBlock();
-            return {ripple::LedgerHeader{}, false};
+            return {CommittedLedger{}, false};
         }
 
         LOG(log_.debug()) << "Inserted all transactions. Number of transactions  = "
                           << rawData.transactions_list().transactions_size();
 
-        backend_->writeAccountTransactions(std::move(insertTxResultOp->accountTxData));
-        backend_->writeNFTs(insertTxResultOp->nfTokensData);
-        backend_->writeNFTTransactions(insertTxResultOp->nfTokenTxData);
+        backend_->writeAccountTransactions(std::move(insertTxResult->accountTxData));
+        backend_->writeNFTs(insertTxResult->nfTokensData);
+        backend_->writeNFTTransactions(insertTxResult->nfTokenTxData);
 
         auto [success, duration] =
             ::util::timed<std::chrono::duration<double>>([&]() { return backend_->finishWrites(lgrInfo.seq); });
 
+        metrics_.observe(PipelineMetrics::Stage::FinishWrites, std::chrono::duration<double>{duration});
         LOG(log_.debug()) << "Finished writes. Total time: " << std::to_string(duration);
         LOG(log_.debug()) << "Finished ledger update: " << ::util::toString(lgrInfo);
 
-        return {lgrInfo, success};
+        CommittedLedger ledger{.header = lgrInfo};
+        if (success) {
+            updateFees(lgrInfo.seq, objects);
+
+            ledger.transactions = std::move(insertTxResult->transactions);
+            ledger.diff = std::move(diff);
+            ledger.fees = fees_;
+            if (auto const range = backend_->fetchLedgerRange(); range)
+                ledger.minSequence = range->minSequence;
+        }
+
+        return {std::move(ledger), success};
     }
 
+    // an object created or deleted by a ledger whose successors are derived from the cache
+    struct ChangedObject {
+        ripple::uint256 key;
+        bool isDeleted = false;
+        std::optional<ripple::uint256> bookBase;  // set for book directories
+    };
+
     /**
      * @brief Update cache from new ledger data.
      *
+     * @note Runs concurrently with writeSuccessors, which only reads the key, type and neighbors of the objects.
+     *
      * @param lgrInfo Ledger info
      * @param rawData Ledger data from GRPC
+     * @param objects The ledger objects of rawData
+     * @return The objects created, modified or deleted by the ledger if the publisher broadcasts them; otherwise the
+     * cache takes over the objects and nothing is returned
      */
-    void
-    updateCache(ripple::LedgerHeader const& lgrInfo, GetLedgerResponseType& rawData)
+    template <typename ObjectsType>
+    std::vector<data::LedgerObject>
+    updateCache(ripple::LedgerHeader const& lgrInfo, GetLedgerResponseType const& rawData, ObjectsType& objects)
     {
         std::vector<data::LedgerObject> cacheUpdates;
-        cacheUpdates.reserve(rawData.ledger_objects().objects_size());
+        cacheUpdates.reserve(objects.size());
 
-        // TODO change these to unordered_set
-        std::set<ripple::uint256> bookSuccessorsToCalculate;
-        std::set<ripple::uint256> modified;
+        std::vector<ChangedObject> changed;
 
-        for (auto& obj : *(rawData.mutable_ledger_objects()->mutable_objects())) {
+        for (auto& obj : objects) {
             auto key = ripple::uint256::fromVoidChecked(obj.key());
             ASSERT(key.has_value(), "Failed to deserialize key from void");
 
@@ -264,36 +340,28 @@ private:
                     checkBookBase = isBookDir(*key, *blob);
                 }
 
+                auto& change = changed.emplace_back(ChangedObject{.key = *key, .isDeleted = isDeleted});
                 if (checkBookBase) {
                     LOG(log_.debug()) << "Is book dir. Key = " << ripple::strHex(*key);
-
-                    auto const bookBase = getBookBase(*key);
-                    auto const oldFirstDir = backend_->cache().getSuccessor(bookBase, lgrInfo.seq - 1);
-                    ASSERT(
-                        oldFirstDir.has_value(),
-                        "Book base must have a successor for lgrInfo.seq - 1 = {}",
-                        lgrInfo.seq - 1
-                    );
-
-                    // We deleted the first directory, or we added a directory prior to the old first
-                    // directory
-                    if ((isDeleted && key == oldFirstDir->key) || (!isDeleted && key < oldFirstDir->key)) {
-                        LOG(log_.debug())
-                            << "Need to recalculate book base successor. base = " << ripple::strHex(bookBase)
-                            << " - key = " << ripple::strHex(*key) << " - isDeleted = " << isDeleted
-                            << " - seq = " << lgrInfo.seq;
-                        bookSuccessorsToCalculate.insert(bookBase);
-                    }
+                    change.bookBase = getBookBase(*key);
                 }
             }
 
-            if (obj.mod_type() == RawLedgerObjectType::MODIFIED)
-                modified.insert(*key);
-
-            backend_->writeLedgerObject(std::move(*obj.mutable_key()), lgrInfo.seq, std::move(*obj.mutable_data()));
+            backend_->writeLedgerObject(std::string{obj.key()}, lgrInfo.seq, std::move(*obj.mutable_data()));
         }
 
-        backend_->cache().update(cacheUpdates, lgrInfo.seq);
+        // the neighbors are looked up in key order so that each cache lookup continues from the previous one
+        std::ranges::sort(changed, {}, &ChangedObject::key);
+        auto const bookSuccessorsToCalculate = findStaleBookSuccessors(lgrInfo.seq, changed);
+
+        // without a broadcast the diff is not needed after the cache update, so the cache can keep the only copy
+        auto const keepDiff = publisher_.get().broadcastsLedgers();
+        if (keepDiff) {
+            backend_->cache().update(cacheUpdates, lgrInfo.seq);
+        } else {
+            backend_->cache().update(std::move(cacheUpdates), lgrInfo.seq);
+            cacheUpdates.clear();
+        }
 
         // rippled didn't send successor information, so use our cache
         if (!rawData.object_neighbors_included()) {
@@ -301,97 +369,160 @@ private:
             if (!backend_->cache().isFull() || backend_->cache().latestLedgerSequence() != lgrInfo.seq)
                 throw std::logic_error("Cache is not full, but object neighbors were not included");
 
-            for (auto const& obj : cacheUpdates) {
-                if (modified.contains(obj.key))
-                    continue;
+            writeSuccessorsFromCache(lgrInfo.seq, changed, bookSuccessorsToCalculate);
+        }
 
-                auto lb = backend_->cache().getPredecessor(obj.key, lgrInfo.seq);
-                if (!lb)
-                    lb = {data::firstKey, {}};
+        return cacheUpdates;
+    }
 
-                auto ub = backend_->cache().getSuccessor(obj.key, lgrInfo.seq);
-                if (!ub)
-                    ub = {data::lastKey, {}};
+    /**
+     * @brief Find the book bases whose first directory changes with the ledger.
+     *
+     * @note Must be called before the cache is updated with the ledger.
+     *
+     * @param seq The sequence of the new ledger
+     * @param changed The objects created or deleted by the ledger, sorted by key
+     * @return The sorted book bases that need their successor recalculated
+     */
+    std::vector<ripple::uint256>
+    findStaleBookSuccessors(uint32_t seq, std::vector<ChangedObject> const& changed)
+    {
+        std::vector<ripple::uint256> bookBases;
+        for (auto const& change : changed) {
+            if (change.bookBase)
+                bookBases.push_back(*change.bookBase);
+        }
 
-                if (obj.blob.empty()) {
-                    LOG(log_.debug()) << "writing successor for deleted object " << ripple::strHex(obj.key) << " - "
-                                      << ripple::strHex(lb->key) << " - " << ripple::strHex(ub->key);
+        if (bookBases.empty())
+            return {};
 
-                    backend_->writeSuccessor(uint256ToString(lb->key), lgrInfo.seq, uint256ToString(ub->key));
-                } else {
-                    backend_->writeSuccessor(uint256ToString(lb->key), lgrInfo.seq, uint256ToString(obj.key));
-                    backend_->writeSuccessor(uint256ToString(obj.key), lgrInfo.seq, uint256ToString(ub->key));
+        // the book base shares its leading bytes with its directories, so sorting by key sorts the bases too
+        auto const [first, last] = std::ranges::unique(bookBases);
+        bookBases.erase(first, last);
 
-                    LOG(log_.debug()) << "writing successor for new object " << ripple::strHex(lb->key) << " - "
-                                      << ripple::strHex(obj.key) << " - " << ripple::strHex(ub->key);
-                }
+        auto const oldFirstDirs = backend_->cache().getNeighbors(bookBases, seq - 1);
+        ASSERT(oldFirstDirs.has_value(), "Cache must have lgrInfo.seq - 1 = {}", seq - 1);
+
+        std::vector<ripple::uint256> stale;
+        for (auto const& change : changed) {
+            if (not change.bookBase)
+                continue;
+
+            auto const index = std::ranges::lower_bound(bookBases, *change.bookBase) - bookBases.begin();
+            auto const& oldFirstDir = (*oldFirstDirs)[index].successor;
+            ASSERT(oldFirstDir.has_value(), "Book base must have a successor for lgrInfo.seq - 1 = {}", seq - 1);
+
+            // We deleted the first directory, or we added a directory prior to the old first directory
+            if ((change.isDeleted && change.key == *oldFirstDir) || (!change.isDeleted && change.key < *oldFirstDir)) {
+                LOG(log_.debug()) << "Need to recalculate book base successor. base = "
+                                  << ripple::strHex(*change.bookBase) << " - key = " << ripple::strHex(change.key)
+                                  << " - isDeleted = " << change.isDeleted << " - seq = " << seq;
+                if (stale.empty() or stale.back() != *change.bookBase)
+                    stale.push_back(*change.bookBase);
             }
+        }
 
-            for (auto const& base : bookSuccessorsToCalculate) {
-                auto succ = backend_->cache().getSuccessor(base, lgrInfo.seq);
-                if (succ) {
-                    backend_->writeSuccessor(uint256ToString(base), lgrInfo.seq, uint256ToString(succ->key));
+        return stale;
+    }
 
-                    LOG(log_.debug()) << "Updating book successor " << ripple::strHex(base) << " - "
-                                      << ripple::strHex(succ->key);
-                } else {
-                    backend_->writeSuccessor(uint256ToString(base), lgrInfo.seq, uint256ToString(data::lastKey));
+    /**
+     * @brief Write the successors of created and deleted objects and of changed book bases using the updated cache.
+     *
+     * @param seq The sequence of the new ledger
+     * @param changed The objects created or deleted by the ledger, sorted by key
+     * @param bookBases The sorted book bases whose successor changed
+     */
+    void
+    writeSuccessorsFromCache(
+        uint32_t seq,
+        std::vector<ChangedObject> const& changed,
+        std::vector<ripple::uint256> const& bookBases
+    )
+    {
+        std::vector<ripple::uint256> keys;
+        keys.reserve(changed.size());
+        std::ranges::transform(changed, std::back_inserter(keys), &ChangedObject::key);
 
-                    LOG(log_.debug()) << "Updating book successor " << ripple::strHex(base) << " - "
-                                      << ripple::strHex(data::lastKey);
-                }
+        auto const neighbors = backend_->cache().getNeighbors(keys, seq);
+        ASSERT(neighbors.has_value(), "Cache must have lgrInfo.seq = {}", seq);
+
+        for (std::size_t i = 0; i < changed.size(); ++i) {
+            auto const& key = changed[i].key;
+            auto const lb = (*neighbors)[i].predecessor.value_or(data::firstKey);
+            auto const ub = (*neighbors)[i].successor.value_or(data::lastKey);
+
+            if (changed[i].isDeleted) {
+                LOG(log_.debug()) << "writing successor for deleted object " << ripple::strHex(key) << " - "
+                                  << ripple::strHex(lb) << " - " << ripple::strHex(ub);
+
+                backend_->writeSuccessor(uint256ToString(lb), seq, uint256ToString(ub));
+            } else {
+                backend_->writeSuccessor(uint256ToString(lb), seq, uint256ToString(key));
+                backend_->writeSuccessor(uint256ToString(key), seq, uint256ToString(ub));
+
+                LOG(log_.debug()) << "writing successor for new object " << ripple::strHex(lb) << " - "
+                                  << ripple::strHex(key) << " - " << ripple::strHex(ub);
             }
         }
+
+        if (bookBases.empty())
+            return;
+
+        auto const firstDirs = backend_->cache().getNeighbors(bookBases, seq);
+        ASSERT(firstDirs.has_value(), "Cache must have lgrInfo.seq = {}", seq);
+
+        for (std::size_t i = 0; i < bookBases.size(); ++i) {
+            auto const succ = (*firstDirs)[i].successor.value_or(data::lastKey);
+            backend_->writeSuccessor(uint256ToString(bookBases[i]), seq, uint256ToString(succ));
+
+            LOG(log_.debug()) << "Updating book successor " << ripple::strHex(bookBases[i]) << " - "
+                              << ripple::strHex(succ);
+        }
     }
 
     /**
      * @brief Write successors info into DB.
      *
+     * @note Runs on a worker concurrently with updateCache, which modifies the objects; they are only read here.
+     *
      * @param lgrInfo Ledger info
      * @param rawData Ledger data from GRPC
+     * @param objects The ledger objects of rawData
      */
+    template <typename ObjectsType>
     void
-    writeSuccessors(ripple::LedgerHeader const& lgrInfo, GetLedgerResponseType& rawData)
+    writeSuccessors(
+        ripple::LedgerHeader const& lgrInfo,
+        GetLedgerResponseType const& rawData,
+        ObjectsType const& objects
+    )
     {
         // Write successor info, if included from rippled
         if (rawData.object_neighbors_included()) {
             LOG(log_.debug()) << "object neighbors included";
+            writeSuccessorsFromNeighbors(*backend_, lgrInfo.seq, rawData, objects);
+        }
+    }
 
-            for (auto& obj : *(rawData.mutable_book_successors())) {
-                auto firstBook = std::move(*obj.mutable_first_book());
-                if (!firstBook.size())
-                    firstBook = uint256ToString(data::lastKey);
-                LOG(log_.debug()) << "writing book successor " << ripple::strHex(obj.book_base()) << " - "
-                                  << ripple::strHex(firstBook);
+    /**
+     * @brief Reload the fees if the fee settings changed in the ledger or were not loaded yet.
+     *
+     * @param seq The sequence of the ledger that was just written
+     * @param objects The ledger objects of the ledger
+     */
+    template <typename ObjectsType>
+    void
+    updateFees(std::uint32_t seq, ObjectsType const& objects)
+    {
+        static auto const feesKey = uint256ToString(ripple::keylet::fees().key);
 
-                backend_->writeSuccessor(std::move(*obj.mutable_book_base()), lgrInfo.seq, std::move(firstBook));
-            }
+        auto const changed =
+            std::any_of(objects.begin(), objects.end(), [](auto const& obj) { return obj.key() == feesKey; });
+        if (fees_ and not changed)
+            return;
 
-            for (auto& obj : *(rawData.mutable_ledger_objects()->mutable_objects())) {
-                if (obj.mod_type() != RawLedgerObjectType::MODIFIED) {
-                    std::string* predPtr = obj.mutable_predecessor();
-                    if (predPtr->empty())
-                        *predPtr = uint256ToString(data::firstKey);
-                    std::string* succPtr = obj.mutable_successor();
-                    if (succPtr->empty())
-                        *succPtr = uint256ToString(data::lastKey);
-
-                    if (obj.mod_type() == RawLedgerObjectType::DELETED) {
-                        LOG(log_.debug()) << "Modifying successors for deleted object " << ripple::strHex(obj.key())
-                                          << " - " << ripple::strHex(*predPtr) << " - " << ripple::strHex(*succPtr);
-
-                        backend_->writeSuccessor(std::move(*predPtr), lgrInfo.seq, std::move(*succPtr));
-                    } else {
-                        LOG(log_.debug()) << "adding successor for new object " << ripple::strHex(obj.key()) << " - "
-                                          << ripple::strHex(*predPtr) << " - " << ripple::strHex(*succPtr);
-
-                        backend_->writeSuccessor(std::move(*predPtr), lgrInfo.seq, std::string{obj.key()});
-                        backend_->writeSuccessor(std::string{obj.key()}, lgrInfo.seq, std::move(*succPtr));
-                    }
-                } else
-                    LOG(log_.debug()) << "object modified " << ripple::strHex(obj.key());
-            }
-        }
+        // usually a cache hit as the cache was updated with this ledger already
+        fees_ = data::synchronousAndRetryOnTimeout([&](auto yield) { return backend_->fetchFees(seq, yield); });
     }
 
     /** @return true if the transformer is stopping; false otherwise */
@@ -0,0 +1,211 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "feed/OwnerFunds.hpp"
+
+#include "data/BackendInterface.hpp"
+#include "data/Types.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/beast/utility/Zero.h>
+#include <xrpl/protocol/AccountID.h>
+#include <xrpl/protocol/Fees.h>
+#include <xrpl/protocol/Indexes.h>
+#include <xrpl/protocol/Keylet.h>
+#include <xrpl/protocol/LedgerFormats.h>
+#include <xrpl/protocol/SField.h>
+#include <xrpl/protocol/STAmount.h>
+#include <xrpl/protocol/STLedgerEntry.h>
+#include <xrpl/protocol/STObject.h>
+#include <xrpl/protocol/Serializer.h>
+#include <xrpl/protocol/TxFormats.h>
+#include <xrpl/protocol/XRPAmount.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace feed {
+
+namespace {
+
+// The owner and the TakerGets of an offer whose owner funds are published; rippled skips owners issuing TakerGets
+std::optional<std::pair<ripple::AccountID, ripple::STAmount>>
+fundedOffer(ripple::STObject const& tx)
+{
+    if (tx.getFieldU16(ripple::sfTransactionType) != ripple::ttOFFER_CREATE)
+        return std::nullopt;
+
+    auto const account = tx.getAccountID(ripple::sfAccount);
+    auto const amount = tx.getFieldAmount(ripple::sfTakerGets);
+    if (account == amount.issue().account)
+        return std::nullopt;
+
+    return std::make_pair(account, amount);
+}
+
+// The funds of an owner which is not the issuer of the amount, as rpc::accountFunds computes them
+ripple::STAmount
+ownerFunds(
+    std::map<ripple::uint256, ripple::SLE> const& objects,
+    std::optional<ripple::Fees> const& fees,
+    ripple::AccountID const& owner,
+    ripple::STAmount const& amount
+)
+{
+    auto const find = [&objects](ripple::Keylet const& keylet) -> ripple::SLE const* {
+        auto const it = objects.find(keylet.key);
+        return it == objects.end() ? nullptr : &it->second;
+    };
+
+    if (amount.native()) {
+        auto const* accountRoot = find(ripple::keylet::account(owner));
+        if (accountRoot == nullptr)
+            return ripple::STAmount{ripple::XRPAmount{beast::zero}};
+
+        auto const balance = accountRoot->getFieldAmount(ripple::sfBalance);
+
+        // AMM doesn't require the reserves
+        if ((accountRoot->getFlags() & ripple::lsfAMMNode) != 0u)
+            return ripple::STAmount{balance.xrp()};
+
+        auto const reserve = fees->accountReserve(accountRoot->getFieldU32(ripple::sfOwnerCount));
+        ripple::STAmount liquid = balance - reserve;
+        if (balance < reserve)
+            liquid.clear();
+
+        return ripple::STAmount{liquid.xrp()};
+    }
+
+    auto const& issue = amount.issue();
+    auto const* line = find(ripple::keylet::line(owner, issue.account, issue.currency));
+    auto const* issuerRoot = find(ripple::keylet::account(issue.account));
+    auto const frozenFlag = (issue.account > owner) ? ripple::lsfHighFreeze : ripple::lsfLowFreeze;
+    auto const frozen = issuerRoot != nullptr and
+        (issuerRoot->isFlag(ripple::lsfGlobalFreeze) or (line != nullptr and line->isFlag(frozenFlag)));
+
+    ripple::STAmount funds;
+    if (line == nullptr or frozen) {
+        funds.clear(issue);
+        return funds;
+    }
+
+    funds = line->getFieldAmount(ripple::sfBalance);
+    if (owner > issue.account) {
+        // Put balance in owner terms.
+        funds.negate();
+    }
+    funds.setIssuer(issue.account);
+    return funds;
+}
+
+}  // namespace
+
+OwnerFunds::OwnerFunds(
+    std::shared_ptr<data::BackendInterface const> backend,
+    std::uint32_t sequence,
+    std::span<data::TransactionAndMetadata const> transactions
+)
+    : backend_(std::move(backend)), sequence_(sequence), transactions_(transactions)
+{
+}
+
+std::optional<ripple::STAmount>
+OwnerFunds::get(ripple::STObject const& tx)
+{
+    auto offer = fundedOffer(tx);
+    if (not offer)
+        return std::nullopt;
+
+    Key const key{offer->first, offer->second.issue()};
+    if (auto const it = funds_.find(key); it != funds_.end())
+        return it->second;
+
+    if (not gathered_)
+        gatherOffers();
+
+    // an offer which was not gathered is resolved along with everything still pending
+    pending_.try_emplace(key, std::move(offer->second));
+    resolvePending();
+    return funds_.at(key);
+}
+
+void
+OwnerFunds::gatherOffers()
+{
+    for (auto const& txAndMeta : transactions_) {
+        ripple::SerialIter it{txAndMeta.transaction.data(), txAndMeta.transaction.size()};
+        ripple::STObject const tx{it, ripple::sfTransaction};
+
+        if (auto offer = fundedOffer(tx); offer)
+            pending_.try_emplace({offer->first, offer->second.issue()}, std::move(offer->second));
+    }
+
+    gathered_ = true;
+}
+
+void
+OwnerFunds::resolvePending()
+{
+    // the account root of XRP owners; the trust line and the issuer's account root otherwise
+    std::set<ripple::uint256> keys;
+    for (auto const& [key, amount] : pending_) {
+        auto const& [owner, issue] = key;
+        if (amount.native()) {
+            keys.insert(ripple::keylet::account(owner).key);
+        } else {
+            keys.insert(ripple::keylet::line(owner, issue.account, issue.currency).key);
+            keys.insert(ripple::keylet::account(issue.account).key);
+        }
+    }
+
+    auto const needsFees = std::ranges::any_of(pending_, [](auto const& offer) { return offer.second.native(); });
+    std::vector<ripple::uint256> const keysToFetch(keys.begin(), keys.end());
+
+    // pending_ is only cleared once everything is resolved, so a retry after a timeout fetches the whole batch again
+    data::synchronousAndRetryOnTimeout([&](boost::asio::yield_context yield) {
+        auto const blobs = backend_->fetchLedgerObjects(keysToFetch, sequence_, yield);
+        auto const fees = needsFees ? backend_->fetchFees(sequence_, yield) : std::nullopt;
+
+        std::map<ripple::uint256, ripple::SLE> objects;
+        for (std::size_t i = 0; i < keysToFetch.size(); ++i) {
+            if (blobs[i].empty())
+                continue;
+
+            ripple::SerialIter it{blobs[i].data(), blobs[i].size()};
+            objects.try_emplace(keysToFetch[i], it, keysToFetch[i]);
+        }
+
+        for (auto const& [key, amount] : pending_)
+            funds_.insert_or_assign(key, ownerFunds(objects, fees, key.first, amount));
+    });
+
+    pending_.clear();
+}
+
+}  // namespace feed
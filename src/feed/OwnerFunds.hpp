@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "data/BackendInterface.hpp"
+#include "data/Types.hpp"
+
+#include <xrpl/protocol/AccountID.h>
+#include <xrpl/protocol/Issue.h>
+#include <xrpl/protocol/STAmount.h>
+#include <xrpl/protocol/STObject.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace feed {
+
+/**
+ * @brief The funds of the owners of the offers created in a ledger, published as owner_funds of OfferCreate.
+ *
+ * The owner and TakerGets issue of every OfferCreate of the ledger are gathered the first time the funds of an offer
+ * are needed, so nothing is parsed or fetched while a ledger is published to nobody. The ledger objects they depend on
+ * are then fetched at once with fetchLedgerObjects, mostly from the ledger cache, instead of one synchronous database
+ * round trip after another. This class is not thread-safe; it's used by the thread publishing the ledger.
+ */
+class OwnerFunds {
+    using Key = std::pair<ripple::AccountID, ripple::Issue>;
+
+    std::shared_ptr<data::BackendInterface const> backend_;
+    std::uint32_t sequence_;
+    std::span<data::TransactionAndMetadata const> transactions_;
+    bool gathered_ = false;
+    std::map<Key, ripple::STAmount> pending_;  // the TakerGets of one offer per owner and issue
+    std::map<Key, ripple::STAmount> funds_;
+
+public:
+    /**
+     * @brief Construct a new Owner Funds object.
+     *
+     * @param backend The backend to fetch the funds from
+     * @param sequence The sequence of the ledger
+     * @param transactions The transactions of the ledger; they must outlive this object
+     */
+    OwnerFunds(
+        std::shared_ptr<data::BackendInterface const> backend,
+        std::uint32_t sequence,
+        std::span<data::TransactionAndMetadata const> transactions
+    );
+
+    /**
+     * @brief Get the funds of the owner of an offer.
+     *
+     * @param tx The transaction
+     * @return The funds if the transaction is an OfferCreate which needs them; nullopt otherwise
+     */
+    std::optional<ripple::STAmount>
+    get(ripple::STObject const& tx);
+
+private:
+    void
+    gatherOffers();
+
+    void
+    resolvePending();
+};
+
+}  // namespace feed
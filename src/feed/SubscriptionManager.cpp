@@ -20,6 +20,7 @@
 #include "feed/SubscriptionManager.hpp"
 
 #include "data/Types.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/Types.hpp"
 
 #include <boost/asio/spawn.hpp>
@@ -189,9 +190,13 @@ SubscriptionManager::unsubBook(ripple::Book const& book, SubscriberSharedPtr con
 }
 
 void
-SubscriptionManager::pubTransaction(data::TransactionAndMetadata const& txMeta, ripple::LedgerHeader const& lgrInfo)
+SubscriptionManager::pubTransaction(
+    data::TransactionAndMetadata const& txMeta,
+    ripple::LedgerHeader const& lgrInfo,
+    OwnerFunds& ownerFunds
+)
 {
-    transactionFeed_.pub(txMeta, lgrInfo, backend_);
+    transactionFeed_.pub(txMeta, lgrInfo, ownerFunds);
 }
 
 boost::json::object
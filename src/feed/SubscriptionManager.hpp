@@ -21,6 +21,7 @@
 
 #include "data/BackendInterface.hpp"
 #include "data/Types.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/SubscriptionManagerInterface.hpp"
 #include "feed/Types.hpp"
 #include "feed/impl/BookChangesFeed.hpp"
@@ -272,9 +273,14 @@ public:
      * @brief Forward the transactions feed.
      * @param txMeta The transaction and metadata.
      * @param lgrInfo The ledger header.
+     * @param ownerFunds The owner funds of the offers created in the ledger.
      */
     void
-    pubTransaction(data::TransactionAndMetadata const& txMeta, ripple::LedgerHeader const& lgrInfo) final;
+    pubTransaction(
+        data::TransactionAndMetadata const& txMeta,
+        ripple::LedgerHeader const& lgrInfo,
+        OwnerFunds& ownerFunds
+    ) final;
 
     /**
      * @brief Get the number of subscribers.
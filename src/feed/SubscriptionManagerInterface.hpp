@@ -20,6 +20,7 @@
 #pragma once
 
 #include "data/Types.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/Types.hpp"
 
 #include <boost/asio/executor_work_guard.hpp>
@@ -229,9 +230,14 @@ public:
      * @brief Forward the transactions feed.
      * @param txMeta The transaction and metadata.
      * @param lgrInfo The ledger header.
+     * @param ownerFunds The owner funds of the offers created in the ledger.
      */
     virtual void
-    pubTransaction(data::TransactionAndMetadata const& txMeta, ripple::LedgerHeader const& lgrInfo) = 0;
+    pubTransaction(
+        data::TransactionAndMetadata const& txMeta,
+        ripple::LedgerHeader const& lgrInfo,
+        OwnerFunds& ownerFunds
+    ) = 0;
 
     /**
      * @brief Get the number of subscribers.
@@ -20,6 +20,7 @@
 #include "feed/impl/ProposedTransactionFeed.hpp"
 
 #include "feed/Types.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
 #include "rpc/RPCHelpers.hpp"
 #include "util/log/Logger.hpp"
 
@@ -39,14 +40,7 @@ namespace feed::impl {
 void
 ProposedTransactionFeed::sub(SubscriberSharedPtr const& subscriber)
 {
-    auto const weakPtr = std::weak_ptr(subscriber);
-    auto const added = signal_.connectTrackableSlot(subscriber, [weakPtr](std::shared_ptr<std::string> const& msg) {
-        if (auto connectionPtr = weakPtr.lock()) {
-            connectionPtr->send(msg);
-        }
-    });
-
-    if (added) {
+    if (subscribers_.add(subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Subscribed tx_proposed";
         ++subAllCount_.get();
         subscriber->onDisconnect.connect([this](SubscriberPtr connection) { unsubInternal(connection); });
@@ -56,22 +50,7 @@ ProposedTransactionFeed::sub(SubscriberSharedPtr const& subscriber)
 void
 ProposedTransactionFeed::sub(ripple::AccountID const& account, SubscriberSharedPtr const& subscriber)
 {
-    auto const weakPtr = std::weak_ptr(subscriber);
-    auto const added = accountSignal_.connectTrackableSlot(
-        subscriber,
-        account,
-        [this, weakPtr](std::shared_ptr<std::string> const& msg) {
-            if (auto connectionPtr = weakPtr.lock()) {
-                // Check if this connection already sent
-                if (notified_.contains(connectionPtr.get()))
-                    return;
-
-                notified_.insert(connectionPtr.get());
-                connectionPtr->send(msg);
-            }
-        }
-    );
-    if (added) {
+    if (accountSubscribers_.add(account, subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Subscribed accounts_proposed " << account;
         ++subAccountCount_.get();
         subscriber->onDisconnect.connect([this, account](SubscriberPtr connection) {
@@ -103,14 +82,23 @@ ProposedTransactionFeed::pub(boost::json::object const& receivedTxJson)
 
     boost::asio::post(strand_, [this, pubMsg = std::move(pubMsg), affectedAccounts = std::move(affectedAccounts)]() {
         notified_.clear();
-        signal_.emit(pubMsg);
+        subscribers_.forEach([&pubMsg](SubscriberId, SubscriberSharedPtr const& subscriber) {
+            subscriber->send(pubMsg);
+        });
         // Prevent the same connection from receiving the same message twice if it is subscribed to multiple accounts
         // However, if the same connection subscribe both stream and account, it will still receive the message twice.
-        // notified_ can be cleared before signal_ emit to improve this, but let's keep it as is for now, since rippled
-        // acts like this.
+        // The stream subscribers could be marked in notified_ to improve this, but let's keep it as is for now, since
+        // rippled acts like this.
         notified_.clear();
-        for (auto const& account : affectedAccounts)
-            accountSignal_.emit(account, pubMsg);
+        for (auto const& account : affectedAccounts) {
+            accountSubscribers_.forEach(
+                account,
+                [this, &pubMsg](SubscriberId id, SubscriberSharedPtr const& subscriber) {
+                    if (notified_.insert(id))
+                        subscriber->send(pubMsg);
+                }
+            );
+        }
     });
 }
 
@@ -129,7 +117,7 @@ ProposedTransactionFeed::accountSubCount() const
 void
 ProposedTransactionFeed::unsubInternal(SubscriberPtr subscriber)
 {
-    if (signal_.disconnect(subscriber)) {
+    if (subscribers_.remove(subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Unsubscribed tx_proposed";
         --subAllCount_.get();
     }
@@ -138,7 +126,7 @@ ProposedTransactionFeed::unsubInternal(SubscriberPtr subscriber)
 void
 ProposedTransactionFeed::unsubInternal(ripple::AccountID const& account, SubscriberPtr subscriber)
 {
-    if (accountSignal_.disconnect(subscriber, account)) {
+    if (accountSubscribers_.remove(account, subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Unsubscribed accounts_proposed " << account;
         --subAccountCount_.get();
     }
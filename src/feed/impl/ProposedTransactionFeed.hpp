@@ -20,8 +20,7 @@
 #pragma once
 
 #include "feed/Types.hpp"
-#include "feed/impl/TrackableSignal.hpp"
-#include "feed/impl/TrackableSignalMap.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
 #include "feed/impl/Util.hpp"
 #include "util/log/Logger.hpp"
 #include "util/prometheus/Gauge.hpp"
@@ -38,7 +37,6 @@
 #include <functional>
 #include <memory>
 #include <string>
-#include <unordered_set>
 
 namespace feed::impl {
 
@@ -49,14 +47,14 @@ namespace feed::impl {
 class ProposedTransactionFeed {
     util::Logger logger_{"Subscriptions"};
 
-    std::unordered_set<SubscriberPtr>
-        notified_;  // Used by slots to prevent double notifications if tx contains multiple subscribed accounts
+    NotifiedSet notified_;  // Used to prevent double notifications if tx contains multiple subscribed accounts
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
     std::reference_wrapper<util::prometheus::GaugeInt> subAllCount_;
     std::reference_wrapper<util::prometheus::GaugeInt> subAccountCount_;
 
-    TrackableSignalMap<ripple::AccountID, Subscriber, std::shared_ptr<std::string>> accountSignal_;
-    TrackableSignal<Subscriber, std::shared_ptr<std::string>> signal_;
+    SubscriberIds ids_;
+    SubscriberMap<ripple::AccountID> accountSubscribers_{ids_};
+    SubscriberSet subscribers_{ids_};
 
 public:
     /**
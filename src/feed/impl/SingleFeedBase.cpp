@@ -20,7 +20,7 @@
 #include "feed/impl/SingleFeedBase.hpp"
 
 #include "feed/Types.hpp"
-#include "feed/impl/TrackableSignal.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
 #include "feed/impl/Util.hpp"
 #include "util/log/Logger.hpp"
 
@@ -43,13 +43,7 @@ SingleFeedBase::SingleFeedBase(boost::asio::io_context& ioContext, std::string c
 void
 SingleFeedBase::sub(SubscriberSharedPtr const& subscriber)
 {
-    auto const weakPtr = std::weak_ptr(subscriber);
-    auto const added = signal_.connectTrackableSlot(subscriber, [weakPtr](std::shared_ptr<std::string> const& msg) {
-        if (auto connectionPtr = weakPtr.lock())
-            connectionPtr->send(msg);
-    });
-
-    if (added) {
+    if (subscribers_.add(subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Subscribed " << name_;
         ++subCount_.get();
         subscriber->onDisconnect.connect([this](SubscriberPtr connectionDisconnecting) {
@@ -69,7 +63,9 @@ SingleFeedBase::pub(std::string msg) const
 {
     boost::asio::post(strand_, [this, msg = std::move(msg)]() mutable {
         auto const msgPtr = std::make_shared<std::string>(std::move(msg));
-        signal_.emit(msgPtr);
+        subscribers_.forEach([&msgPtr](SubscriberId, SubscriberSharedPtr const& subscriber) {
+            subscriber->send(msgPtr);
+        });
     });
 }
 
@@ -82,7 +78,7 @@ SingleFeedBase::count() const
 void
 SingleFeedBase::unsubInternal(SubscriberPtr subscriber)
 {
-    if (signal_.disconnect(subscriber)) {
+    if (subscribers_.remove(subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Unsubscribed " << name_;
         --subCount_.get();
     }
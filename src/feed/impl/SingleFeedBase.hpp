@@ -20,7 +20,7 @@
 #pragma once
 
 #include "feed/Types.hpp"
-#include "feed/impl/TrackableSignal.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
 #include "util/log/Logger.hpp"
 #include "util/prometheus/Gauge.hpp"
 
@@ -40,7 +40,8 @@ namespace feed::impl {
 class SingleFeedBase {
     boost::asio::strand<boost::asio::io_context::executor_type> strand_;
     std::reference_wrapper<util::prometheus::GaugeInt> subCount_;
-    TrackableSignal<Subscriber, std::shared_ptr<std::string> const&> signal_;
+    SubscriberIds ids_;
+    SubscriberSet subscribers_{ids_};
     util::Logger logger_{"Subscriptions"};
     std::string name_;
 
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "feed/impl/SubscriberIndex.hpp"
+
+#include "feed/Types.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace feed::impl {
+
+SubscriberId
+SubscriberIds::acquire(SubscriberPtr subscriber)
+{
+    std::scoped_lock const lk(mutex_);
+    if (auto const it = assignments_.find(subscriber); it != assignments_.end()) {
+        ++it->second.subscriptions;
+        return it->second.id;
+    }
+
+    auto id = next_;
+    if (free_.empty()) {
+        ++next_;
+    } else {
+        id = free_.back();
+        free_.pop_back();
+    }
+
+    assignments_.emplace(subscriber, Assignment{.id = id, .subscriptions = 1});
+    return id;
+}
+
+void
+SubscriberIds::release(SubscriberPtr subscriber)
+{
+    std::scoped_lock const lk(mutex_);
+    auto const it = assignments_.find(subscriber);
+    if (it == assignments_.end())
+        return;
+
+    if (--it->second.subscriptions == 0) {
+        free_.push_back(it->second.id);
+        assignments_.erase(it);
+    }
+}
+
+std::optional<SubscriberId>
+SubscriberIds::find(SubscriberPtr subscriber) const
+{
+    std::scoped_lock const lk(mutex_);
+    if (auto const it = assignments_.find(subscriber); it != assignments_.end())
+        return it->second.id;
+
+    return std::nullopt;
+}
+
+void
+NotifiedSet::clear()
+{
+    ++generation_;
+}
+
+bool
+NotifiedSet::insert(SubscriberId id)
+{
+    if (id >= notifiedIn_.size())
+        notifiedIn_.resize(static_cast<std::size_t>(id) + 1, 0);
+
+    if (notifiedIn_[id] == generation_)
+        return false;
+
+    notifiedIn_[id] = generation_;
+    return true;
+}
+
+bool
+SubscriberList::add(SubscriberId id, SubscriberSharedPtr const& subscriber)
+{
+    if (not positions_.emplace(id, entries_.size()).second)
+        return false;
+
+    entries_.push_back({.id = id, .subscriber = subscriber});
+    snapshot_.reset();
+    return true;
+}
+
+bool
+SubscriberList::remove(SubscriberId id)
+{
+    auto const it = positions_.find(id);
+    if (it == positions_.end())
+        return false;
+
+    // the order of subscribers doesn't matter, so the last one takes the place of the removed one
+    auto const position = it->second;
+    positions_.erase(it);
+    if (position + 1 != entries_.size()) {
+        entries_[position] = std::move(entries_.back());
+        positions_[entries_[position].id] = position;
+    }
+    entries_.pop_back();
+    snapshot_.reset();
+    return true;
+}
+
+bool
+SubscriberList::contains(SubscriberId id) const
+{
+    return positions_.contains(id);
+}
+
+std::size_t
+SubscriberList::size() const
+{
+    return entries_.size();
+}
+
+SubscriberList::Snapshot
+SubscriberList::snapshot() const
+{
+    if (not snapshot_)
+        snapshot_ = std::make_shared<std::vector<Entry> const>(entries_);
+
+    return snapshot_;
+}
+
+bool
+SubscriberSet::add(SubscriberSharedPtr const& subscriber)
+{
+    std::scoped_lock const lk(mutex_);
+    if (auto const id = ids_.get().find(subscriber.get()); id and subscribers_.contains(*id))
+        return false;
+
+    subscribers_.add(ids_.get().acquire(subscriber.get()), subscriber);
+    return true;
+}
+
+bool
+SubscriberSet::remove(SubscriberPtr subscriber)
+{
+    std::scoped_lock const lk(mutex_);
+    auto const id = ids_.get().find(subscriber);
+    if (not id or not subscribers_.remove(*id))
+        return false;
+
+    ids_.get().release(subscriber);
+    return true;
+}
+
+std::size_t
+SubscriberSet::count() const
+{
+    std::scoped_lock const lk(mutex_);
+    return subscribers_.size();
+}
+
+}  // namespace feed::impl
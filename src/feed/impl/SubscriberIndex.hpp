@@ -0,0 +1,374 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "feed/Types.hpp"
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace feed::impl {
+
+template <typename T>
+concept Hashable = requires(T a) {
+    { std::hash<T>{}(a) } -> std::convertible_to<std::size_t>;
+};
+
+using SubscriberId = std::uint32_t;
+
+/**
+ * @brief Assigns small dense ids to the subscribers of a feed, so that per subscriber state can live in flat vectors.
+ *
+ * A subscriber keeps its id for as long as it has at least one subscription in any index sharing this table. The id is
+ * reused afterwards. This class is thread-safe.
+ */
+class SubscriberIds {
+    struct Assignment {
+        SubscriberId id;
+        std::size_t subscriptions;
+    };
+
+    mutable std::mutex mutex_;
+    boost::unordered_flat_map<SubscriberPtr, Assignment> assignments_;
+    std::vector<SubscriberId> free_;
+    SubscriberId next_ = 0;
+
+public:
+    /**
+     * @brief Record a new subscription of a subscriber.
+     *
+     * @param subscriber The subscriber
+     * @return The id of the subscriber
+     */
+    SubscriberId
+    acquire(SubscriberPtr subscriber);
+
+    /**
+     * @brief Record that a subscription of a subscriber is gone; the id is freed once it has no subscriptions left.
+     *
+     * @param subscriber The subscriber
+     */
+    void
+    release(SubscriberPtr subscriber);
+
+    /**
+     * @brief Get the id of a subscriber.
+     *
+     * @param subscriber The subscriber
+     * @return The id if the subscriber has any subscription; nullopt otherwise
+     */
+    std::optional<SubscriberId>
+    find(SubscriberPtr subscriber) const;
+};
+
+/**
+ * @brief The subscribers already notified of the message being published.
+ *
+ * Replaces a hash set of subscribers: marks are generations stored by subscriber id, so clearing is O(1) and a lookup
+ * is a single vector access. This class is not thread-safe; feeds only use it from their strand.
+ */
+class NotifiedSet {
+    std::vector<std::uint64_t> notifiedIn_;
+    std::uint64_t generation_ = 1;
+
+public:
+    /**
+     * @brief Forget all the subscribers notified so far.
+     */
+    void
+    clear();
+
+    /**
+     * @brief Mark a subscriber as notified.
+     *
+     * @param id The id of the subscriber
+     * @return true if the subscriber was not notified yet; false otherwise
+     */
+    bool
+    insert(SubscriberId id);
+};
+
+/**
+ * @brief A compact list of subscribers with a cached immutable snapshot for publishing.
+ *
+ * Changes invalidate the snapshot, which is rebuilt by the next publish; publishing in between shares the same copy.
+ * This class is not thread-safe, the indexes below guard it.
+ */
+class SubscriberList {
+public:
+    struct Entry {
+        SubscriberId id;
+        std::weak_ptr<Subscriber> subscriber;
+    };
+
+    using Snapshot = std::shared_ptr<std::vector<Entry> const>;
+
+private:
+    std::vector<Entry> entries_;
+    boost::unordered_flat_map<SubscriberId, std::size_t> positions_;
+    mutable Snapshot snapshot_;
+
+public:
+    /**
+     * @brief Add a subscriber to the list.
+     *
+     * @param id The id of the subscriber
+     * @param subscriber The subscriber
+     * @return true if added; false if the subscriber is already in the list
+     */
+    bool
+    add(SubscriberId id, SubscriberSharedPtr const& subscriber);
+
+    /**
+     * @brief Remove a subscriber from the list.
+     *
+     * @param id The id of the subscriber
+     * @return true if removed; false if the subscriber is not in the list
+     */
+    bool
+    remove(SubscriberId id);
+
+    /**
+     * @brief Check whether a subscriber is in the list.
+     *
+     * @param id The id of the subscriber
+     * @return true if the subscriber is in the list; false otherwise
+     */
+    bool
+    contains(SubscriberId id) const;
+
+    /**
+     * @return The number of subscribers in the list
+     */
+    std::size_t
+    size() const;
+
+    /**
+     * @return The current subscribers; the snapshot stays valid and unchanged after the list is modified
+     */
+    Snapshot
+    snapshot() const;
+};
+
+/**
+ * @brief Call a function for each subscriber of a snapshot which is still alive.
+ *
+ * @param snapshot The subscribers
+ * @param fn The function to call with the id and the subscriber
+ */
+template <typename FnType>
+void
+forEachAlive(SubscriberList::Snapshot const& snapshot, FnType&& fn)
+{
+    for (auto const& entry : *snapshot) {
+        if (auto subscriber = entry.subscriber.lock())
+            fn(entry.id, subscriber);
+    }
+}
+
+/**
+ * @brief A thread-safe set of subscribers of a feed.
+ *
+ * Subscribers are held by weak pointers, so a subscriber being destroyed is skipped when publishing and can remove
+ * itself from its destructor using its raw pointer.
+ */
+class SubscriberSet {
+    std::reference_wrapper<SubscriberIds> ids_;
+    mutable std::mutex mutex_;
+    SubscriberList subscribers_;
+
+public:
+    /**
+     * @brief Construct a new Subscriber Set object.
+     *
+     * @param ids The ids of the subscribers of the feed the set belongs to
+     */
+    explicit SubscriberSet(SubscriberIds& ids) : ids_(ids)
+    {
+    }
+
+    /**
+     * @brief Add a subscriber.
+     *
+     * @param subscriber The subscriber
+     * @return true if added; false if the subscriber is already in the set
+     */
+    bool
+    add(SubscriberSharedPtr const& subscriber);
+
+    /**
+     * @brief Remove a subscriber.
+     *
+     * @param subscriber The subscriber; a raw pointer so this can be called from the subscriber's destructor
+     * @return true if removed; false if the subscriber is not in the set
+     */
+    bool
+    remove(SubscriberPtr subscriber);
+
+    /**
+     * @return The number of subscribers
+     */
+    std::size_t
+    count() const;
+
+    /**
+     * @brief Call a function for each alive subscriber; the lock is only held to take a snapshot.
+     *
+     * @param fn The function to call with the id and the subscriber
+     */
+    template <typename FnType>
+    void
+    forEach(FnType&& fn) const
+    {
+        SubscriberList::Snapshot snapshot;
+        {
+            std::scoped_lock const lk(mutex_);
+            snapshot = subscribers_.snapshot();
+        }
+        forEachAlive(snapshot, std::forward<FnType>(fn));
+    }
+};
+
+/**
+ * @brief A thread-safe index of the subscribers of a feed by the key they are interested in, e.g. an account or a book.
+ *
+ * Every key maps to a compact list of subscribers. Keys without subscribers are removed from the index.
+ *
+ * @tparam Key The type of the key
+ */
+template <Hashable Key>
+class SubscriberMap {
+    std::reference_wrapper<SubscriberIds> ids_;
+    mutable std::mutex mutex_;
+    boost::unordered_flat_map<Key, SubscriberList, std::hash<Key>> subscribers_;
+
+public:
+    /**
+     * @brief Construct a new Subscriber Map object.
+     *
+     * @param ids The ids of the subscribers of the feed the map belongs to
+     */
+    explicit SubscriberMap(SubscriberIds& ids) : ids_(ids)
+    {
+    }
+
+    /**
+     * @brief Add a subscriber for a key.
+     *
+     * @param key The key
+     * @param subscriber The subscriber
+     * @return true if added; false if the subscriber is already subscribed to the key
+     */
+    bool
+    add(Key const& key, SubscriberSharedPtr const& subscriber)
+    {
+        std::scoped_lock const lk(mutex_);
+        auto& list = subscribers_[key];
+        if (auto const id = ids_.get().find(subscriber.get()); id and list.contains(*id))
+            return false;
+
+        list.add(ids_.get().acquire(subscriber.get()), subscriber);
+        return true;
+    }
+
+    /**
+     * @brief Remove a subscriber from a key.
+     *
+     * @param key The key
+     * @param subscriber The subscriber; a raw pointer so this can be called from the subscriber's destructor
+     * @return true if removed; false if the subscriber is not subscribed to the key
+     */
+    bool
+    remove(Key const& key, SubscriberPtr subscriber)
+    {
+        std::scoped_lock const lk(mutex_);
+        auto const it = subscribers_.find(key);
+        if (it == subscribers_.end())
+            return false;
+
+        auto const id = ids_.get().find(subscriber);
+        if (not id or not it->second.remove(*id))
+            return false;
+
+        ids_.get().release(subscriber);
+        if (it->second.size() == 0)
+            subscribers_.erase(it);
+
+        return true;
+    }
+
+    /**
+     * @return true if no key has any subscriber; false otherwise
+     */
+    bool
+    empty() const
+    {
+        std::scoped_lock const lk(mutex_);
+        return subscribers_.empty();
+    }
+
+    /**
+     * @brief Get the number of subscribers of a key.
+     *
+     * @param key The key
+     * @return The number of subscribers
+     */
+    std::size_t
+    count(Key const& key) const
+    {
+        std::scoped_lock const lk(mutex_);
+        auto const it = subscribers_.find(key);
+        return it == subscribers_.end() ? 0 : it->second.size();
+    }
+
+    /**
+     * @brief Call a function for each alive subscriber of a key; the lock is only held to take a snapshot.
+     *
+     * @param key The key
+     * @param fn The function to call with the id and the subscriber
+     */
+    template <typename FnType>
+    void
+    forEach(Key const& key, FnType&& fn) const
+    {
+        SubscriberList::Snapshot snapshot;
+        {
+            std::scoped_lock const lk(mutex_);
+            auto const it = subscribers_.find(key);
+            if (it == subscribers_.end())
+                return;
+
+            snapshot = it->second.snapshot();
+        }
+        forEachAlive(snapshot, std::forward<FnType>(fn));
+    }
+};
+
+}  // namespace feed::impl
@@ -21,13 +21,14 @@
 
 #include "data/BackendInterface.hpp"
 #include "data/Types.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/Types.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
 #include "rpc/JS.hpp"
 #include "rpc/RPCHelpers.hpp"
 #include "util/log/Logger.hpp"
 
 #include <boost/asio/post.hpp>
-#include <boost/asio/spawn.hpp>
 #include <boost/json/object.hpp>
 #include <boost/json/serialize.hpp>
 #include <xrpl/basics/chrono.h>
@@ -39,40 +40,23 @@
 #include <xrpl/protocol/SField.h>
 #include <xrpl/protocol/STObject.h>
 #include <xrpl/protocol/TER.h>
-#include <xrpl/protocol/TxFormats.h>
 #include <xrpl/protocol/jss.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <unordered_set>
 #include <utility>
 
 namespace feed::impl {
 
-void
-TransactionFeed::TransactionSlot::operator()(AllVersionTransactionsType const& allVersionMsgs) const
-{
-    if (auto connection = connectionWeakPtr.lock(); connection) {
-        // Check if this connection already sent
-        if (feed.get().notified_.contains(connection.get()))
-            return;
-
-        feed.get().notified_.insert(connection.get());
-
-        if (connection->apiSubVersion < 2u) {
-            connection->send(allVersionMsgs[0]);
-            return;
-        }
-        connection->send(allVersionMsgs[1]);
-    }
-}
-
 void
 TransactionFeed::sub(SubscriberSharedPtr const& subscriber)
 {
-    auto const added = signal_.connectTrackableSlot(subscriber, TransactionSlot(*this, subscriber));
+    auto const added = subscribers_.add(subscriber);
     if (added) {
         LOG(logger_.info()) << subscriber->tag() << "Subscribed transactions";
         ++subAllCount_.get();
@@ -83,7 +67,7 @@ TransactionFeed::sub(SubscriberSharedPtr const& subscriber)
 void
 TransactionFeed::sub(ripple::AccountID const& account, SubscriberSharedPtr const& subscriber)
 {
-    auto const added = accountSignal_.connectTrackableSlot(subscriber, account, TransactionSlot(*this, subscriber));
+    auto const added = accountSubscribers_.add(account, subscriber);
     if (added) {
         LOG(logger_.info()) << subscriber->tag() << "Subscribed account " << account;
         ++subAccountCount_.get();
@@ -96,7 +80,7 @@ TransactionFeed::sub(ripple::AccountID const& account, SubscriberSharedPtr const
 void
 TransactionFeed::subProposed(SubscriberSharedPtr const& subscriber)
 {
-    auto const added = txProposedsignal_.connectTrackableSlot(subscriber, TransactionSlot(*this, subscriber));
+    auto const added = txProposedsubscribers_.add(subscriber);
     if (added) {
         subscriber->onDisconnect.connect([this](SubscriberPtr connection) { unsubProposedInternal(connection); });
     }
@@ -105,8 +89,7 @@ TransactionFeed::subProposed(SubscriberSharedPtr const& subscriber)
 void
 TransactionFeed::subProposed(ripple::AccountID const& account, SubscriberSharedPtr const& subscriber)
 {
-    auto const added =
-        accountProposedSignal_.connectTrackableSlot(subscriber, account, TransactionSlot(*this, subscriber));
+    auto const added = accountProposedSubscribers_.add(account, subscriber);
     if (added) {
         subscriber->onDisconnect.connect([this, account](SubscriberPtr connection) {
             unsubProposedInternal(account, connection);
@@ -117,7 +100,7 @@ TransactionFeed::subProposed(ripple::AccountID const& account, SubscriberSharedP
 void
 TransactionFeed::sub(ripple::Book const& book, SubscriberSharedPtr const& subscriber)
 {
-    auto const added = bookSignal_.connectTrackableSlot(subscriber, book, TransactionSlot(*this, subscriber));
+    auto const added = bookSubscribers_.add(book, subscriber);
     if (added) {
         LOG(logger_.info()) << subscriber->tag() << "Subscribed book " << book;
         ++subBookCount_.get();
@@ -173,6 +156,22 @@ TransactionFeed::bookSubCount() const
     return subBookCount_.get().value();
 }
 
+TransactionFeed::TransactionMessages::TransactionMessages(std::function<boost::json::object(std::uint32_t)> render)
+    : render_(std::move(render))
+{
+}
+
+std::shared_ptr<std::string> const&
+TransactionFeed::TransactionMessages::get(std::uint32_t apiVersion)
+{
+    // Only two formats exist: before API version 2 and from it on
+    auto const index = apiVersion < 2u ? 0u : 1u;
+    if (not rendered_[index])
+        rendered_[index] = std::make_shared<std::string>(boost::json::serialize(render_(index + 1u)));
+
+    return rendered_[index];
+}
+
 void
 TransactionFeed::pub(
     data::TransactionAndMetadata const& txMeta,
@@ -180,29 +179,80 @@ TransactionFeed::pub(
     std::shared_ptr<data::BackendInterface const> const& backend
 )
 {
+    OwnerFunds ownerFunds{backend, lgrInfo.seq, std::span{&txMeta, 1}};
+    pub(txMeta, lgrInfo, ownerFunds);
+}
+
+void
+TransactionFeed::pub(
+    data::TransactionAndMetadata const& txMeta,
+    ripple::LedgerHeader const& lgrInfo,
+    OwnerFunds& ledgerOwnerFunds
+)
+{
+    auto const watchesAll = subscribers_.count() != 0 or txProposedSubscribers_.count() != 0;
+    auto const watchesAccounts = not accountSubscribers_.empty() or not accountProposedSubscribers_.empty();
+    auto const watchesBooks = not bookSubscribers_.empty();
+    if (not watchesAll and not watchesAccounts and not watchesBooks)
+        return;
+
     auto [tx, meta] = rpc::deserializeTxPlusMeta(txMeta, lgrInfo.seq);
 
-    std::optional<ripple::STAmount> ownerFunds;
+    // Only the accounts and books someone subscribed to are kept, the transaction is dropped if there are none
+    std::unordered_set<ripple::AccountID> affectedAccounts;
+    if (watchesAccounts) {
+        for (auto const& account : meta->getAffectedAccounts()) {
+            if (accountSubscribers_.count(account) != 0 or accountProposedSubscribers_.count(account) != 0)
+                affectedAccounts.insert(account);
+        }
+    }
 
-    if (tx->getTxnType() == ripple::ttOFFER_CREATE) {
-        auto const account = tx->getAccountID(ripple::sfAccount);
-        auto const amount = tx->getFieldAmount(ripple::sfTakerGets);
-        if (account != amount.issue().account) {
-            auto fetchFundsSynchronous = [&]() {
-                data::synchronous([&](boost::asio::yield_context yield) {
-                    ownerFunds = rpc::accountFunds(*backend, lgrInfo.seq, amount, account, yield);
-                });
-            };
-            data::retryOnTimeout(fetchFundsSynchronous);
+    std::unordered_set<ripple::Book> affectedBooks;
+    if (watchesBooks) {
+        for (auto const& node : meta->getNodes()) {
+            if (node.getFieldU16(ripple::sfLedgerEntryType) != ripple::ltOFFER)
+                continue;
+
+            ripple::SField const* field = nullptr;
+
+            // We need a field that contains the TakerGets and TakerPays
+            // parameters.
+            if (node.getFName() == ripple::sfModifiedNode) {
+                field = &ripple::sfPreviousFields;
+            } else if (node.getFName() == ripple::sfCreatedNode) {
+                field = &ripple::sfNewFields;
+            } else if (node.getFName() == ripple::sfDeletedNode) {
+                field = &ripple::sfFinalFields;
+            }
+
+            if (field != nullptr) {
+                auto const data = dynamic_cast<ripple::STObject const*>(node.peekAtPField(*field));
+
+                if ((data != nullptr) && data->isFieldPresent(ripple::sfTakerPays) &&
+                    data->isFieldPresent(ripple::sfTakerGets)) {
+                    // determine the OrderBook
+                    ripple::Book const book{
+                        data->getFieldAmount(ripple::sfTakerGets).issue(),
+                        data->getFieldAmount(ripple::sfTakerPays).issue()
+                    };
+                    if (bookSubscribers_.count(book) != 0)
+                        affectedBooks.insert(book);
+                }
+            }
         }
     }
 
-    auto const genJsonByVersion = [&, tx, meta](std::uint32_t version) {
+    if (not watchesAll and affectedAccounts.empty() and affectedBooks.empty())
+        return;
+
+    auto const ownerFunds = ledgerOwnerFunds.get(*tx);
+
+    auto genJsonByVersion = [tx, meta, date = txMeta.date, lgrInfo, ownerFunds](std::uint32_t version) {
         boost::json::object pubObj;
         auto const txKey = version < 2u ? JS(transaction) : JS(tx_json);
         pubObj[txKey] = rpc::toJson(*tx);
         pubObj[JS(meta)] = rpc::toJson(*meta);
-        rpc::insertDeliveredAmount(pubObj[JS(meta)].as_object(), tx, meta, txMeta.date);
+        rpc::insertDeliveredAmount(pubObj[JS(meta)].as_object(), tx, meta, date);
         rpc::insertDeliverMaxAlias(pubObj[txKey].as_object(), version);
 
         pubObj[JS(type)] = "transaction";
@@ -233,82 +283,54 @@ TransactionFeed::pub(
         return pubObj;
     };
 
-    AllVersionTransactionsType allVersionsMsgs{
-        std::make_shared<std::string>(boost::json::serialize(genJsonByVersion(1u))),
-        std::make_shared<std::string>(boost::json::serialize(genJsonByVersion(2u)))
-    };
-
-    auto const affectedAccountsFlat = meta->getAffectedAccounts();
-    auto affectedAccounts =
-        std::unordered_set<ripple::AccountID>(affectedAccountsFlat.cbegin(), affectedAccountsFlat.cend());
-
-    std::unordered_set<ripple::Book> affectedBooks;
-
-    for (auto const& node : meta->getNodes()) {
-        if (node.getFieldU16(ripple::sfLedgerEntryType) == ripple::ltOFFER) {
-            ripple::SField const* field = nullptr;
-
-            // We need a field that contains the TakerGets and TakerPays
-            // parameters.
-            if (node.getFName() == ripple::sfModifiedNode) {
-                field = &ripple::sfPreviousFields;
-            } else if (node.getFName() == ripple::sfCreatedNode) {
-                field = &ripple::sfNewFields;
-            } else if (node.getFName() == ripple::sfDeletedNode) {
-                field = &ripple::sfFinalFields;
-            }
-
-            if (field != nullptr) {
-                auto const data = dynamic_cast<ripple::STObject const*>(node.peekAtPField(*field));
-
-                if ((data != nullptr) && data->isFieldPresent(ripple::sfTakerPays) &&
-                    data->isFieldPresent(ripple::sfTakerGets)) {
-                    // determine the OrderBook
-                    ripple::Book const book{
-                        data->getFieldAmount(ripple::sfTakerGets).issue(),
-                        data->getFieldAmount(ripple::sfTakerPays).issue()
-                    };
-                    if (affectedBooks.find(book) == affectedBooks.end()) {
-                        affectedBooks.insert(book);
-                    }
-                }
-            }
-        }
-    }
-
+    // The messages are rendered by the strand when the first subscriber of an API version is notified
     boost::asio::post(
         strand_,
         [this,
-         allVersionsMsgs = std::move(allVersionsMsgs),
+         messages = TransactionMessages(std::move(genJsonByVersion)),
          affectedAccounts = std::move(affectedAccounts),
-         affectedBooks = std::move(affectedBooks)]() {
+         affectedBooks = std::move(affectedBooks)]() mutable {
+            auto const notifySubscriber = [this, &messages](SubscriberId id, SubscriberSharedPtr const& s) {
+                notify(id, s, messages);
+            };
+
             notified_.clear();
-            signal_.emit(allVersionsMsgs);
+            subscribers_.forEach(notifySubscriber);
             // clear the notified set. If the same connection subscribes both transactions + proposed_transactions,
             // rippled SENDS the same message twice
             notified_.clear();
-            txProposedsignal_.emit(allVersionsMsgs);
+            txProposedSubscribers_.forEach(notifySubscriber);
             notified_.clear();
             // check duplicate for account and proposed_account, this prevents sending the same message multiple times
             // if it affects multiple accounts watched by the same connection
             for (auto const& account : affectedAccounts) {
-                accountSignal_.emit(account, allVersionsMsgs);
-                accountProposedSignal_.emit(account, allVersionsMsgs);
+                accountSubscribers_.forEach(account, notifySubscriber);
+                accountProposedSubscribers_.forEach(account, notifySubscriber);
             }
             notified_.clear();
             // check duplicate for books, this prevents sending the same message multiple times if it affects multiple
             // books watched by the same connection
             for (auto const& book : affectedBooks) {
-                bookSignal_.emit(book, allVersionsMsgs);
+                bookSubscribers_.forEach(book, notifySubscriber);
             }
         }
     );
 }
 
+void
+TransactionFeed::notify(SubscriberId id, SubscriberSharedPtr const& subscriber, TransactionMessages& messages)
+{
+    // Check if this connection already sent
+    if (not notified_.insert(id))
+        return;
+
+    subscriber->send(messages.get(subscriber->apiSubVersion));
+}
+
 void
 TransactionFeed::unsubInternal(SubscriberPtr subscriber)
 {
-    if (signal_.disconnect(subscriber)) {
+    if (subscribers_.remove(subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Unsubscribed transactions";
         --subAllCount_.get();
     }
@@ -317,7 +339,7 @@ TransactionFeed::unsubInternal(SubscriberPtr subscriber)
 void
 TransactionFeed::unsubInternal(ripple::AccountID const& account, SubscriberPtr subscriber)
 {
-    if (accountSignal_.disconnect(subscriber, account)) {
+    if (accountSubscribers_.remove(account, subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Unsubscribed account " << account;
         --subAccountCount_.get();
     }
@@ -326,19 +348,19 @@ TransactionFeed::unsubInternal(ripple::AccountID const& account, SubscriberPtr s
 void
 TransactionFeed::unsubProposedInternal(SubscriberPtr subscriber)
 {
-    txProposedsignal_.disconnect(subscriber);
+    txProposedSubscribers_.remove(subscriber);
 }
 
 void
 TransactionFeed::unsubProposedInternal(ripple::AccountID const& account, SubscriberPtr subscriber)
 {
-    accountProposedSignal_.disconnect(subscriber, account);
+    accountProposedSubscribers_.remove(account, subscriber);
 }
 
 void
 TransactionFeed::unsubInternal(ripple::Book const& book, SubscriberPtr subscriber)
 {
-    if (bookSignal_.disconnect(subscriber, book)) {
+    if (bookSubscribers_.remove(book, subscriber)) {
         LOG(logger_.info()) << subscriber->tag() << "Unsubscribed book " << book;
         --subBookCount_.get();
     }
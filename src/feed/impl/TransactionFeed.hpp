@@ -21,15 +21,16 @@
 
 #include "data/BackendInterface.hpp"
 #include "data/Types.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/Types.hpp"
-#include "feed/impl/TrackableSignal.hpp"
-#include "feed/impl/TrackableSignalMap.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
 #include "feed/impl/Util.hpp"
 #include "util/log/Logger.hpp"
 #include "util/prometheus/Gauge.hpp"
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/json/object.hpp>
 #include <fmt/core.h>
 #include <xrpl/protocol/AccountID.h>
 #include <xrpl/protocol/Book.h>
@@ -40,7 +41,6 @@
 #include <functional>
 #include <memory>
 #include <string>
-#include <unordered_set>
 
 namespace feed::impl {
 
@@ -48,17 +48,28 @@ class TransactionFeed {
     // Hold two versions of transaction messages
     using AllVersionTransactionsType = std::array<std::shared_ptr<std::string>, 2>;
 
-    struct TransactionSlot {
-        std::reference_wrapper<TransactionFeed> feed;
-        std::weak_ptr<Subscriber> connectionWeakPtr;
-
-        TransactionSlot(TransactionFeed& feed, SubscriberSharedPtr const& connection)
-            : feed(feed), connectionWeakPtr(connection)
-        {
-        }
-
-        void
-        operator()(AllVersionTransactionsType const& allVersionMsgs) const;
+    /**
+     * @brief The messages of a transaction, each version is rendered when the first subscriber needing it is notified.
+     * All the subscribers of the feed share the rendered messages. Only used from the strand, so not thread-safe.
+     */
+    class TransactionMessages {
+        std::function<boost::json::object(std::uint32_t)> render_;
+        AllVersionTransactionsType rendered_;
+
+    public:
+        /**
+         * @brief Construct a new Transaction Messages object.
+         * @param render Renders the message for an API version.
+         */
+        explicit TransactionMessages(std::function<boost::json::object(std::uint32_t)> render);
+
+        /**
+         * @brief Get the message for an API version, rendering it if it's the first time.
+         * @param apiVersion The API version of the subscriber.
+         * @return The serialized message.
+         */
+        std::shared_ptr<std::string> const&
+        get(std::uint32_t apiVersion);
     };
 
     util::Logger logger_{"Subscriptions"};
@@ -68,16 +79,17 @@ class TransactionFeed {
     std::reference_wrapper<util::prometheus::GaugeInt> subAccountCount_;
     std::reference_wrapper<util::prometheus::GaugeInt> subBookCount_;
 
-    TrackableSignalMap<ripple::AccountID, Subscriber, AllVersionTransactionsType const&> accountSignal_;
-    TrackableSignalMap<ripple::Book, Subscriber, AllVersionTransactionsType const&> bookSignal_;
-    TrackableSignal<Subscriber, AllVersionTransactionsType const&> signal_;
+    // All the indexes share the ids, so a subscriber is known by the same id in notified_ whatever it subscribed to
+    SubscriberIds ids_;
+    SubscriberMap<ripple::AccountID> accountSubscribers_{ids_};
+    SubscriberMap<ripple::Book> bookSubscribers_{ids_};
+    SubscriberSet subscribers_{ids_};
 
-    // Signals for proposed tx subscribers
-    TrackableSignalMap<ripple::AccountID, Subscriber, AllVersionTransactionsType const&> accountProposedSignal_;
-    TrackableSignal<Subscriber, AllVersionTransactionsType const&> txProposedsignal_;
+    // Proposed tx subscribers
+    SubscriberMap<ripple::AccountID> accountProposedSubscribers_{ids_};
+    SubscriberSet txProposedSubscribers_{ids_};
 
-    std::unordered_set<SubscriberPtr>
-        notified_;  // Used by slots to prevent double notifications if tx contains multiple subscribed accounts
+    NotifiedSet notified_;  // Used to prevent double notifications if tx contains multiple subscribed accounts
 
 public:
     /**
@@ -171,6 +183,19 @@ public:
 
     /**
      * @brief Publishes the transaction feed.
+     * Transactions nobody subscribed to are dropped before they are rendered, the rest are rendered only for the API
+     * versions of the subscribers notified.
+     * @param txMeta The transaction and metadata.
+     * @param lgrInfo The ledger header.
+     * @param ledgerOwnerFunds The owner funds of the offers created in the ledger.
+     */
+    void
+    pub(data::TransactionAndMetadata const& txMeta,
+        ripple::LedgerHeader const& lgrInfo,
+        OwnerFunds& ledgerOwnerFunds);
+
+    /**
+     * @brief Publishes a transaction on its own, fetching the owner funds it needs for it only.
      * @param txMeta The transaction and metadata.
      * @param lgrInfo The ledger header.
      * @param backend The backend.
@@ -199,6 +224,9 @@ public:
     bookSubCount() const;
 
 private:
+    void
+    notify(SubscriberId id, SubscriberSharedPtr const& subscriber, TransactionMessages& messages);
+
     void
     unsubInternal(SubscriberPtr subscriber);
 
@@ -20,6 +20,7 @@
 #include "data/AmendmentCenter.hpp"
 #include "data/BackendFactory.hpp"
 #include "etl/ETLService.hpp"
+#include "etl/GrpcServer.hpp"
 #include "etl/NetworkValidatedLedgers.hpp"
 #include "feed/SubscriptionManager.hpp"
 #include "main/Build.hpp"
@@ -219,6 +220,9 @@ try {
     // ETL is responsible for writing and publishing to streams. In read-only mode, ETL only publishes
     auto etl = etl::ETLService::make_ETLService(config, ioc, backend, subscriptions, balancer, ledgers);
 
+    // Allows other Clio nodes to use this one as an ETL source
+    auto const grpcServer = etl::GrpcServer::make_GrpcServer(config, backend);
+
     auto workQueue = rpc::WorkQueue::make_WorkQueue(config);
     auto counters = rpc::Counters::make_Counters(workQueue);
     auto const amendmentCenter = std::make_shared<data::AmendmentCenter const>(backend);
@@ -57,13 +57,9 @@ LedgerIndexHandler::process(LedgerIndexHandler::Input input, Context const& ctx)
     if (!input.date)
         return fillOutputByIndex(maxIndex);
 
-    auto const convertISOTimeStrToTicks = [](std::string const& isoTimeStr) {
-        auto const systemTime = util::SystemTpFromUTCStr(isoTimeStr, DATE_FORMAT);
-        // systemTime must be valid after validation passed
-        return systemTime->time_since_epoch().count();
-    };
-
-    auto const ticks = convertISOTimeStrToTicks(*input.date);
+    // systemTime must be valid after validation passed
+    auto const systemTime = *util::SystemTpFromUTCStr(*input.date, DATE_FORMAT);
+    auto const ticks = systemTime.time_since_epoch().count();
 
     auto const earlierThan = [&](std::uint32_t ledgerIndex) {
         auto const header = sharedPtrBackend_->fetchLedgerBySequence(ledgerIndex, ctx.yield);
@@ -71,20 +67,25 @@ LedgerIndexHandler::process(LedgerIndexHandler::Input input, Context const& ctx)
         return ticks < ledgerTime.time_since_epoch().count();
     };
 
+    // The close time index narrows the search down to the ledgers between two indexed ones. Without any indexed
+    // ledgers around the date the whole range is searched.
+    auto const window = sharedPtrBackend_->closeTimeIndex().lookup(systemTime);
+    auto const knownNotEarlier = window.lastClosedAtOrBefore and *window.lastClosedAtOrBefore >= minIndex;
+    auto const first = knownNotEarlier ? *window.lastClosedAtOrBefore + 1 : minIndex;
+    auto const last = window.firstClosedAfter ? std::min(*window.firstClosedAfter, maxIndex + 1) : maxIndex + 1;
+
     // If the given date is earlier than the first valid ledger, return lgrNotFound
-    if (earlierThan(minIndex))
+    if (not knownNotEarlier and earlierThan(minIndex))
         return Error{Status{RippledError::rpcLGR_NOT_FOUND, "ledgerNotInRange"}};
 
-    auto const view = std::ranges::iota_view{minIndex, maxIndex + 1};
+    auto const view = std::ranges::iota_view{first, std::max(first, last)};
 
     auto const greaterEqLedgerIter = std::ranges::lower_bound(
         view, ticks, [&](std::uint32_t ledgerIndex, std::int64_t) { return not earlierThan(ledgerIndex); }
     );
 
-    if (greaterEqLedgerIter != view.end())
-        return fillOutputByIndex(std::max(static_cast<std::uint32_t>(*greaterEqLedgerIter) - 1, minIndex));
-
-    return fillOutputByIndex(maxIndex);
+    auto const firstLaterLedger = greaterEqLedgerIter != view.end() ? *greaterEqLedgerIter : last;
+    return fillOutputByIndex(std::max(static_cast<std::uint32_t>(firstLaterLedger) - 1, minIndex));
 }
 
 LedgerIndexHandler::Input
@@ -238,6 +238,14 @@ private:
     std::optional<data::TransactionAndMetadata>
     fetchTxViaCtid(uint32_t ledgerSeq, uint32_t txId, boost::asio::yield_context yield) const
     {
+        if (auto tx = sharedPtrBackend_->fetchTransactionByIndex(ledgerSeq, txId, yield); tx)
+            return tx;
+
+        // only ledgers written before the transaction index table existed have no index rows; scan those instead
+        if (auto const firstIndexed = sharedPtrBackend_->fetchFirstIndexedTransactionSequence(yield);
+            firstIndexed and ledgerSeq >= *firstIndexed)
+            return std::nullopt;
+
         auto const txs = sharedPtrBackend_->fetchAllTransactionsInLedger(ledgerSeq, yield);
 
         for (auto const& tx : txs) {
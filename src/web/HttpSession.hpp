@@ -23,6 +23,7 @@
 #include "web/DOSGuard.hpp"
 #include "web/PlainWsSession.hpp"
 #include "web/impl/HttpBase.hpp"
+#include "web/impl/SendQueue.hpp"
 #include "web/interface/ConnectionBase.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
@@ -52,6 +53,7 @@ class HttpSession : public impl::HttpBase<HttpSession, HandlerType>,
                     public std::enable_shared_from_this<HttpSession<HandlerType>> {
     boost::beast::tcp_stream stream_;
     std::reference_wrapper<util::TagDecoratorFactory const> tagFactory_;
+    std::shared_ptr<impl::SendQueueBudget> sendQueueBudget_;
 
 public:
     /**
@@ -62,6 +64,7 @@ public:
      * @param adminVerification The admin verification strategy to use
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueBudget The limits and memory shared by the send queues of websocket sessions
      * @param handler The server handler to use
      * @param buffer Buffer with initial data received from the peer
      */
@@ -71,6 +74,7 @@ public:
         std::shared_ptr<impl::AdminVerificationStrategy> const& adminVerification,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<impl::SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> const& handler,
         boost::beast::flat_buffer buffer
     )
@@ -84,6 +88,7 @@ public:
           )
         , stream_(std::move(socket))
         , tagFactory_(tagFactory)
+        , sendQueueBudget_(std::move(sendQueueBudget))
     {
     }
 
@@ -125,6 +130,7 @@ public:
             this->clientIp,
             tagFactory_,
             this->dosGuard_,
+            sendQueueBudget_,
             this->handler_,
             std::move(this->buffer_),
             std::move(this->req_),
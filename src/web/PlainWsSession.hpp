@@ -21,6 +21,7 @@
 
 #include "util/Taggable.hpp"
 #include "web/DOSGuard.hpp"
+#include "web/impl/SendQueue.hpp"
 #include "web/impl/WsBase.hpp"
 #include "web/interface/ConnectionBase.hpp"
 
@@ -60,6 +61,7 @@ public:
      * @param ip Client's IP address
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueBudget The limits and memory shared by the send queues of websocket sessions
      * @param handler The server handler to use
      * @param buffer Buffer with initial data received from the peer
      * @param isAdmin Whether the connection has admin privileges
@@ -69,11 +71,19 @@ public:
         std::string ip,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<impl::SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> const& handler,
         boost::beast::flat_buffer&& buffer,
         bool isAdmin
     )
-        : impl::WsBase<PlainWsSession, HandlerType>(ip, tagFactory, dosGuard, handler, std::move(buffer))
+        : impl::WsBase<PlainWsSession, HandlerType>(
+              ip,
+              tagFactory,
+              dosGuard,
+              std::move(sendQueueBudget),
+              handler,
+              std::move(buffer)
+          )
         , ws_(std::move(socket))
     {
         ConnectionBase::isAdmin_ = isAdmin;  // NOLINT(cppcoreguidelines-prefer-member-initializer)
@@ -103,6 +113,7 @@ class WsUpgrader : public std::enable_shared_from_this<WsUpgrader<HandlerType>>
     boost::beast::flat_buffer buffer_;
     std::reference_wrapper<util::TagDecoratorFactory const> tagFactory_;
     std::reference_wrapper<web::DOSGuard> dosGuard_;
+    std::shared_ptr<impl::SendQueueBudget> sendQueueBudget_;
     http::request<http::string_body> req_;
     std::string ip_;
     std::shared_ptr<HandlerType> const handler_;
@@ -116,6 +127,7 @@ public:
      * @param ip Client's IP address
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueBudget The limits and memory shared by the send queues of websocket sessions
      * @param handler The server handler to use
      * @param buffer Buffer with initial data received from the peer. Ownership is transferred
      * @param request The request. Ownership is transferred
@@ -126,6 +138,7 @@ public:
         std::string ip,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<impl::SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> const& handler,
         boost::beast::flat_buffer&& buffer,
         http::request<http::string_body> request,
@@ -135,6 +148,7 @@ public:
         , buffer_(std::move(buffer))
         , tagFactory_(tagFactory)
         , dosGuard_(dosGuard)
+        , sendQueueBudget_(std::move(sendQueueBudget))
         , req_(std::move(request))
         , ip_(std::move(ip))
         , handler_(handler)
@@ -175,7 +189,14 @@ private:
         boost::beast::get_lowest_layer(http_).expires_never();
 
         std::make_shared<PlainWsSession<HandlerType>>(
-            http_.release_socket(), ip_, tagFactory_, dosGuard_, handler_, std::move(buffer_), isAdmin_
+            http_.release_socket(),
+            ip_,
+            tagFactory_,
+            dosGuard_,
+            sendQueueBudget_,
+            handler_,
+            std::move(buffer_),
+            isAdmin_
         )
             ->run(std::move(req_));
     }
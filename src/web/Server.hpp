@@ -24,6 +24,7 @@
 #include "web/DOSGuard.hpp"
 #include "web/HttpSession.hpp"
 #include "web/SslHttpSession.hpp"
+#include "web/impl/SendQueue.hpp"
 #include "web/interface/Concepts.hpp"
 
 #include <boost/asio/io_context.hpp>
@@ -82,6 +83,7 @@ class Detector : public std::enable_shared_from_this<Detector<PlainSessionType,
     std::optional<std::reference_wrapper<boost::asio::ssl::context>> ctx_;
     std::reference_wrapper<util::TagDecoratorFactory const> tagFactory_;
     std::reference_wrapper<web::DOSGuard> const dosGuard_;
+    std::shared_ptr<impl::SendQueueBudget> const sendQueueBudget_;
     std::shared_ptr<HandlerType> const handler_;
     boost::beast::flat_buffer buffer_;
     std::shared_ptr<impl::AdminVerificationStrategy> const adminVerification_;
@@ -94,6 +96,7 @@ public:
      * @param ctx The SSL context if any
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueBudget The limits and memory shared by the send queues of websocket sessions
      * @param handler The server handler to use
      * @param adminVerification The admin verification strategy to use
      */
@@ -102,6 +105,7 @@ public:
         std::optional<std::reference_wrapper<boost::asio::ssl::context>> ctx,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<impl::SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> handler,
         std::shared_ptr<impl::AdminVerificationStrategy> adminVerification
     )
@@ -109,6 +113,7 @@ public:
         , ctx_(ctx)
         , tagFactory_(std::cref(tagFactory))
         , dosGuard_(dosGuard)
+        , sendQueueBudget_(std::move(sendQueueBudget))
         , handler_(std::move(handler))
         , adminVerification_(std::move(adminVerification))
     {
@@ -167,6 +172,7 @@ public:
                 *ctx_,
                 tagFactory_,
                 dosGuard_,
+                sendQueueBudget_,
                 handler_,
                 std::move(buffer_)
             )
@@ -175,7 +181,14 @@ public:
         }
 
         std::make_shared<PlainSessionType<HandlerType>>(
-            stream_.release_socket(), ip, adminVerification_, tagFactory_, dosGuard_, handler_, std::move(buffer_)
+            stream_.release_socket(),
+            ip,
+            adminVerification_,
+            tagFactory_,
+            dosGuard_,
+            sendQueueBudget_,
+            handler_,
+            std::move(buffer_)
         )
             ->run();
     }
@@ -204,6 +217,7 @@ class Server : public std::enable_shared_from_this<Server<PlainSessionType, SslS
     std::optional<std::reference_wrapper<boost::asio::ssl::context>> ctx_;
     util::TagDecoratorFactory tagFactory_;
     std::reference_wrapper<web::DOSGuard> dosGuard_;
+    std::shared_ptr<impl::SendQueueBudget> sendQueueBudget_;
     std::shared_ptr<HandlerType> handler_;
     tcp::acceptor acceptor_;
     std::shared_ptr<impl::AdminVerificationStrategy> adminVerification_;
@@ -217,6 +231,7 @@ public:
      * @param endpoint The endpoint to listen on
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueSettings The limits of the send queues of websocket sessions
      * @param handler The server handler to use
      * @param adminPassword The optional password to verify admin role in requests
      */
@@ -226,6 +241,7 @@ public:
         tcp::endpoint endpoint,
         util::TagDecoratorFactory tagFactory,
         web::DOSGuard& dosGuard,
+        SendQueueSettings sendQueueSettings,
         std::shared_ptr<HandlerType> handler,
         std::optional<std::string> adminPassword
     )
@@ -233,6 +249,9 @@ public:
         , ctx_(ctx)
         , tagFactory_(tagFactory)
         , dosGuard_(std::ref(dosGuard))
+        , sendQueueBudget_(
+              sendQueueSettings.isEnabled() ? std::make_shared<impl::SendQueueBudget>(sendQueueSettings) : nullptr
+          )
         , handler_(std::move(handler))
         , acceptor_(boost::asio::make_strand(ioc))
         , adminVerification_(impl::make_AdminVerificationStrategy(std::move(adminPassword)))
@@ -288,7 +307,13 @@ private:
             auto ctxRef = ctx_ ? std::optional<std::reference_wrapper<boost::asio::ssl::context>>{ctx_} : std::nullopt;
 
             std::make_shared<Detector<PlainSessionType, SslSessionType, HandlerType>>(
-                std::move(socket), ctxRef, std::cref(tagFactory_), dosGuard_, handler_, adminVerification_
+                std::move(socket),
+                ctxRef,
+                std::cref(tagFactory_),
+                dosGuard_,
+                sendQueueBudget_,
+                handler_,
+                adminVerification_
             )
                 ->run();
         }
@@ -351,6 +376,7 @@ make_HttpServer(
         boost::asio::ip::tcp::endpoint{address, port},
         util::TagDecoratorFactory(config),
         dosGuard,
+        make_SendQueueSettings(config),
         handler,
         std::move(adminPassword)
     );
@@ -23,6 +23,7 @@
 #include "web/DOSGuard.hpp"
 #include "web/SslWsSession.hpp"
 #include "web/impl/HttpBase.hpp"
+#include "web/impl/SendQueue.hpp"
 #include "web/interface/ConnectionBase.hpp"
 
 #include <boost/asio/ip/tcp.hpp>
@@ -58,6 +59,7 @@ class SslHttpSession : public impl::HttpBase<SslHttpSession, HandlerType>,
                        public std::enable_shared_from_this<SslHttpSession<HandlerType>> {
     boost::beast::ssl_stream<boost::beast::tcp_stream> stream_;
     std::reference_wrapper<util::TagDecoratorFactory const> tagFactory_;
+    std::shared_ptr<impl::SendQueueBudget> sendQueueBudget_;
 
 public:
     /**
@@ -69,6 +71,7 @@ public:
      * @param ctx The SSL context
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueBudget The limits and memory shared by the send queues of websocket sessions
      * @param handler The server handler to use
      * @param buffer Buffer with initial data received from the peer
      */
@@ -79,6 +82,7 @@ public:
         boost::asio::ssl::context& ctx,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<impl::SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> const& handler,
         boost::beast::flat_buffer buffer
     )
@@ -92,6 +96,7 @@ public:
           )
         , stream_(std::move(socket), ctx)
         , tagFactory_(tagFactory)
+        , sendQueueBudget_(std::move(sendQueueBudget))
     {
     }
 
@@ -169,6 +174,7 @@ public:
             this->clientIp,
             tagFactory_,
             this->dosGuard_,
+            sendQueueBudget_,
             this->handler_,
             std::move(this->buffer_),
             std::move(this->req_),
@@ -21,6 +21,7 @@
 
 #include "util/Taggable.hpp"
 #include "web/DOSGuard.hpp"
+#include "web/impl/SendQueue.hpp"
 #include "web/impl/WsBase.hpp"
 #include "web/interface/ConnectionBase.hpp"
 
@@ -61,6 +62,7 @@ public:
      * @param ip Client's IP address
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueBudget The limits and memory shared by the send queues of websocket sessions
      * @param handler The server handler to use
      * @param buffer Buffer with initial data received from the peer
      * @param isAdmin Whether the connection has admin privileges
@@ -70,11 +72,19 @@ public:
         std::string ip,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<impl::SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> const& handler,
         boost::beast::flat_buffer&& buffer,
         bool isAdmin
     )
-        : impl::WsBase<SslWsSession, HandlerType>(ip, tagFactory, dosGuard, handler, std::move(buffer))
+        : impl::WsBase<SslWsSession, HandlerType>(
+              ip,
+              tagFactory,
+              dosGuard,
+              std::move(sendQueueBudget),
+              handler,
+              std::move(buffer)
+          )
         , ws_(std::move(stream))
     {
         ConnectionBase::isAdmin_ = isAdmin;  // NOLINT(cppcoreguidelines-prefer-member-initializer)
@@ -103,6 +113,7 @@ class SslWsUpgrader : public std::enable_shared_from_this<SslWsUpgrader<HandlerT
     std::string ip_;
     std::reference_wrapper<util::TagDecoratorFactory const> tagFactory_;
     std::reference_wrapper<web::DOSGuard> dosGuard_;
+    std::shared_ptr<impl::SendQueueBudget> sendQueueBudget_;
     std::shared_ptr<HandlerType> const handler_;
     http::request<http::string_body> req_;
     bool isAdmin_;
@@ -115,6 +126,7 @@ public:
      * @param ip Client's IP address
      * @param tagFactory A factory that is used to generate tags to track requests and sessions
      * @param dosGuard The denial of service guard to use
+     * @param sendQueueBudget The limits and memory shared by the send queues of websocket sessions
      * @param handler The server handler to use
      * @param buffer Buffer with initial data received from the peer. Ownership is transferred
      * @param request The request. Ownership is transferred
@@ -125,6 +137,7 @@ public:
         std::string ip,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<impl::SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> handler,
         boost::beast::flat_buffer&& buffer,
         http::request<http::string_body> request,
@@ -135,6 +148,7 @@ public:
         , ip_(std::move(ip))
         , tagFactory_(tagFactory)
         , dosGuard_(dosGuard)
+        , sendQueueBudget_(std::move(sendQueueBudget))
         , handler_(std::move(handler))
         , req_(std::move(request))
         , isAdmin_(isAdmin)
@@ -179,7 +193,7 @@ private:
         boost::beast::get_lowest_layer(https_).expires_never();
 
         std::make_shared<SslWsSession<HandlerType>>(
-            std::move(https_), ip_, tagFactory_, dosGuard_, handler_, std::move(buffer_), isAdmin_
+            std::move(https_), ip_, tagFactory_, dosGuard_, sendQueueBudget_, handler_, std::move(buffer_), isAdmin_
         )
             ->run(std::move(req_));
     }
@@ -0,0 +1,353 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "web/impl/SendQueue.hpp"
+
+#include "util/Assert.hpp"
+#include "util/config/Config.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
+
+#include <boost/json/object.hpp>
+#include <boost/json/serialize.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace web {
+
+namespace {
+
+std::optional<std::size_t>
+maybeLimit(util::Config const& section, std::string const& key)
+{
+    auto const limit = section.maybeValue<std::size_t>(key);
+    if (limit == 0u)
+        throw std::runtime_error("server.ws_send_queue." + key + " must be greater than 0");
+    return limit;
+}
+
+std::shared_ptr<std::string>
+makeGapNotice(std::size_t numDropped)
+{
+    return std::make_shared<std::string>(
+        boost::json::serialize(boost::json::object{{"type", "messagesDropped"}, {"count", numDropped}})
+    );
+}
+
+}  // namespace
+
+[[nodiscard]] bool
+SendQueueSettings::isEnabled() const
+{
+    return maxBytes.has_value() or maxMessages.has_value() or totalMaxBytes.has_value();
+}
+
+[[nodiscard]] SendQueueSettings
+make_SendQueueSettings(util::Config const& config)
+{
+    SendQueueSettings settings;
+    if (not config.contains("server.ws_send_queue"))
+        return settings;
+
+    auto const section = config.section("server.ws_send_queue");
+    settings.maxBytes = maybeLimit(section, "max_bytes");
+    settings.maxMessages = maybeLimit(section, "max_messages");
+    settings.totalMaxBytes = maybeLimit(section, "total_max_bytes");
+
+    if (auto const policy = section.maybeValue<std::string>("policy"); policy) {
+        if (*policy == "drop_oldest") {
+            settings.policy = SlowConsumerPolicy::DropOldest;
+        } else if (*policy == "gap_notice") {
+            settings.policy = SlowConsumerPolicy::GapNotice;
+        } else if (*policy == "disconnect") {
+            settings.policy = SlowConsumerPolicy::Disconnect;
+        } else {
+            throw std::runtime_error(
+                "server.ws_send_queue.policy must be one of `drop_oldest`, `gap_notice` or `disconnect`"
+            );
+        }
+    }
+
+    return settings;
+}
+
+namespace impl {
+
+SendQueueBudget::SendQueueBudget(SendQueueSettings settings)
+    : settings_{settings}
+    , totalBytes_{PrometheusService::gaugeInt(
+          "ws_send_queue_bytes",
+          util::prometheus::Labels{},
+          "Size of the messages waiting to be sent to all websocket clients"
+      )}
+    , depth_{PrometheusService::histogramInt(
+          "ws_send_queue_messages_histogram",
+          util::prometheus::Labels{},
+          std::vector<std::int64_t>{1, 2, 5, 10, 50, 100, 500, 1000, 5000},
+          "Number of messages waiting to be sent to a websocket client when a message is queued"
+      )}
+    , dropped_{PrometheusService::counterInt(
+          "ws_dropped_messages_total_number",
+          util::prometheus::Labels{},
+          "Total number of messages dropped because a websocket client was too slow"
+      )}
+    , disconnected_{PrometheusService::counterInt(
+          "ws_slow_consumer_disconnects_total_number",
+          util::prometheus::Labels{},
+          "Total number of websocket clients disconnected because they were too slow"
+      )}
+{
+}
+
+SendQueueSettings const&
+SendQueueBudget::settings() const
+{
+    return settings_;
+}
+
+void
+SendQueueBudget::add(std::int64_t bytes)
+{
+    totalBytes_.get() += bytes;
+}
+
+bool
+SendQueueBudget::isExceeded() const
+{
+    return settings_.totalMaxBytes and totalBytes_.get().value() > static_cast<std::int64_t>(*settings_.totalMaxBytes);
+}
+
+void
+SendQueueBudget::addQueue(std::shared_ptr<std::atomic_size_t const> bytes)
+{
+    queueBytes_.lock()->push_back(std::move(bytes));
+}
+
+void
+SendQueueBudget::removeQueue(std::shared_ptr<std::atomic_size_t const> const& bytes)
+{
+    std::erase(*queueBytes_.lock(), bytes);
+}
+
+bool
+SendQueueBudget::isLargest(std::size_t bytes) const
+{
+    auto const queueBytes = queueBytes_.lock();
+    return std::ranges::none_of(*queueBytes, [bytes](auto const& other) { return *other > bytes; });
+}
+
+void
+SendQueueBudget::observeDepth(std::size_t numMessages)
+{
+    depth_.get().observe(static_cast<std::int64_t>(numMessages));
+}
+
+void
+SendQueueBudget::onDropped(std::size_t numMessages)
+{
+    dropped_.get() += static_cast<std::int64_t>(numMessages);
+}
+
+void
+SendQueueBudget::onDisconnected()
+{
+    ++disconnected_.get();
+}
+
+SendQueue::SendQueue(std::shared_ptr<SendQueueBudget> budget) : budget_{std::move(budget)}
+{
+    if (budget_)
+        budget_->addQueue(sharedBytes_);
+}
+
+SendQueue::~SendQueue()
+{
+    if (not budget_)
+        return;
+
+    budget_->removeQueue(sharedBytes_);
+    budget_->add(-static_cast<std::int64_t>(bytes_));
+}
+
+SendQueue::PushResult
+SendQueue::push(std::shared_ptr<std::string> msg, bool droppable)
+{
+    auto const size = msg->size();
+    messages_.push_back({.data = std::move(msg), .droppable = droppable});
+    bytes_ += size;
+    if (not budget_)
+        return PushResult::Queued;
+
+    account(static_cast<std::int64_t>(size));
+    budget_->observeDepth(messages_.size());
+
+    if (not isOverLimit())
+        return PushResult::Queued;
+
+    auto const policy = budget_->settings().policy;
+    if (policy == SlowConsumerPolicy::Disconnect) {
+        budget_->onDisconnected();
+        return PushResult::Overflow;
+    }
+
+    std::size_t numDropped = 0;
+    auto result = PushResult::Queued;
+    while (isOverLimit()) {
+        // responses are never dropped, so a client that does not read them is disconnected whatever the policy
+        if (not dropOldestWaiting()) {
+            budget_->onDisconnected();
+            result = PushResult::Overflow;
+            break;
+        }
+        ++numDropped;
+    }
+
+    numDropped_ += numDropped;
+    if (policy == SlowConsumerPolicy::GapNotice)
+        numUnnoticedDrops_ += numDropped;
+    budget_->onDropped(numDropped);
+
+    return result;
+}
+
+std::shared_ptr<std::string> const&
+SendQueue::front() const
+{
+    ASSERT(not messages_.empty(), "Send queue must not be empty");
+    return messages_.front().data;
+}
+
+void
+SendQueue::pop()
+{
+    ASSERT(not messages_.empty(), "Send queue must not be empty");
+    auto const size = messages_.front().data->size();
+    messages_.pop_front();
+    bytes_ -= size;
+    account(-static_cast<std::int64_t>(size));
+
+    // the notice takes the place of the dropped messages, before anything that was queued after them
+    if (numUnnoticedDrops_ > 0) {
+        pushFront({.data = makeGapNotice(numUnnoticedDrops_), .droppable = false});
+        numUnnoticedDrops_ = 0;
+    }
+}
+
+void
+SendQueue::clear()
+{
+    while (messages_.size() > 1) {
+        auto const size = messages_.back().data->size();
+        messages_.pop_back();
+        bytes_ -= size;
+        account(-static_cast<std::int64_t>(size));
+    }
+    numUnnoticedDrops_ = 0;
+}
+
+bool
+SendQueue::empty() const
+{
+    return messages_.empty();
+}
+
+std::size_t
+SendQueue::size() const
+{
+    return messages_.size();
+}
+
+std::size_t
+SendQueue::bytes() const
+{
+    return bytes_;
+}
+
+std::size_t
+SendQueue::numDropped() const
+{
+    return numDropped_;
+}
+
+bool
+SendQueue::isOverLimit() const
+{
+    // a single message is always sent, however large it is
+    if (not budget_ or messages_.size() <= 1)
+        return false;
+
+    auto const& settings = budget_->settings();
+    if (settings.maxMessages and messages_.size() > *settings.maxMessages)
+        return true;
+    if (settings.maxBytes and bytes_ > *settings.maxBytes)
+        return true;
+
+    // when all queues together are too large, only the largest queue gives up messages, so connections that keep up
+    // are not punished for the one that does not
+    return budget_->isExceeded() and budget_->isLargest(bytes_);
+}
+
+bool
+SendQueue::dropOldestWaiting()
+{
+    ASSERT(messages_.size() > 1, "The message being sent can't be dropped");
+    auto const it = std::find_if(std::next(messages_.begin()), messages_.end(), [](auto const& msg) {
+        return msg.droppable;
+    });
+    if (it == messages_.end())
+        return false;
+
+    auto const size = it->data->size();
+    messages_.erase(it);
+    bytes_ -= size;
+    account(-static_cast<std::int64_t>(size));
+    return true;
+}
+
+void
+SendQueue::pushFront(Message msg)
+{
+    auto const size = msg.data->size();
+    messages_.push_front(std::move(msg));
+    bytes_ += size;
+    account(static_cast<std::int64_t>(size));
+}
+
+void
+SendQueue::account(std::int64_t bytes)
+{
+    if (not budget_)
+        return;
+
+    budget_->add(bytes);
+    *sharedBytes_ = bytes_;
+}
+
+}  // namespace impl
+}  // namespace web
@@ -0,0 +1,260 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#pragma once
+
+#include "util/Mutex.hpp"
+#include "util/config/Config.hpp"
+#include "util/prometheus/Counter.hpp"
+#include "util/prometheus/Gauge.hpp"
+#include "util/prometheus/Histogram.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace web {
+
+/**
+ * @brief What to do with a websocket client that does not read its messages fast enough
+ */
+enum class SlowConsumerPolicy {
+    DropOldest, /**< Drop the oldest messages waiting to be sent */
+    GapNotice,  /**< Drop the oldest messages and tell the client how many were dropped */
+    Disconnect, /**< Close the connection */
+};
+
+/**
+ * @brief Limits of the messages waiting to be sent to websocket clients
+ */
+struct SendQueueSettings {
+    std::optional<std::size_t> maxBytes;      /**< Per connection, including the message being sent */
+    std::optional<std::size_t> maxMessages;   /**< Per connection, including the message being sent */
+    std::optional<std::size_t> totalMaxBytes; /**< For all connections together */
+    SlowConsumerPolicy policy = SlowConsumerPolicy::Disconnect;
+
+    auto
+    operator<=>(SendQueueSettings const&) const = default;
+
+    /** @returns True if any limit is configured; false otherwise */
+    [[nodiscard]] bool
+    isEnabled() const;
+};
+
+/**
+ * @brief Create a SendQueueSettings object from the `server.ws_send_queue` section of a Config object
+ *
+ * @param config The configuration object
+ * @returns The SendQueueSettings object; without limits if the section is missing
+ * @throws std::runtime_error if a limit is 0 or the policy is unknown
+ */
+[[nodiscard]] SendQueueSettings
+make_SendQueueSettings(util::Config const& config);
+
+namespace impl {
+
+/**
+ * @brief The settings and the memory used by the send queues of all websocket connections.
+ *
+ * The size of every queue is registered, so that only the largest queue gives up messages when all queues together use
+ * more than totalMaxBytes.
+ */
+class SendQueueBudget {
+    SendQueueSettings settings_;
+    util::Mutex<std::vector<std::shared_ptr<std::atomic_size_t const>>> queueBytes_;
+    std::reference_wrapper<util::prometheus::GaugeInt> totalBytes_;
+    std::reference_wrapper<util::prometheus::HistogramInt> depth_;
+    std::reference_wrapper<util::prometheus::CounterInt> dropped_;
+    std::reference_wrapper<util::prometheus::CounterInt> disconnected_;
+
+public:
+    /**
+     * @brief Construct a new Send Queue Budget object
+     *
+     * @param settings The limits to apply to every connection
+     */
+    explicit SendQueueBudget(SendQueueSettings settings);
+
+    /** @return The limits to apply to every connection */
+    SendQueueSettings const&
+    settings() const;
+
+    /**
+     * @brief Account for bytes that are added to (or removed from, if negative) a queue
+     *
+     * @param bytes The number of bytes
+     */
+    void
+    add(std::int64_t bytes);
+
+    /** @return true if the queues of all connections together use more than totalMaxBytes; false otherwise */
+    bool
+    isExceeded() const;
+
+    /**
+     * @brief Register a queue
+     *
+     * @param bytes The size of the queue, updated by the queue
+     */
+    void
+    addQueue(std::shared_ptr<std::atomic_size_t const> bytes);
+
+    /**
+     * @brief Unregister a queue
+     *
+     * @param bytes The size of the queue as passed to addQueue
+     */
+    void
+    removeQueue(std::shared_ptr<std::atomic_size_t const> const& bytes);
+
+    /**
+     * @brief Whether no registered queue is larger than the given size
+     *
+     * @param bytes The size of a queue
+     * @return true if no queue uses more bytes; false otherwise
+     */
+    bool
+    isLargest(std::size_t bytes) const;
+
+    /**
+     * @brief Record the number of messages in a queue after a message was added
+     *
+     * @param numMessages The number of messages
+     */
+    void
+    observeDepth(std::size_t numMessages);
+
+    /**
+     * @brief Record messages dropped from a queue
+     *
+     * @param numMessages The number of messages
+     */
+    void
+    onDropped(std::size_t numMessages);
+
+    /** @brief Record a connection closed because its queue was full */
+    void
+    onDisconnected();
+};
+
+/**
+ * @brief The messages waiting to be sent to one websocket client.
+ *
+ * The first message is the one being written to the socket, so it is never dropped. Only stream messages can be
+ * dropped; responses to requests are always sent. Not thread-safe, it is only used from the strand of the connection.
+ */
+class SendQueue {
+    struct Message {
+        std::shared_ptr<std::string> data;
+        bool droppable;
+    };
+
+    std::shared_ptr<SendQueueBudget> budget_;
+    std::deque<Message> messages_;
+    std::size_t bytes_ = 0;
+    std::shared_ptr<std::atomic_size_t> sharedBytes_ = std::make_shared<std::atomic_size_t>(0);  // bytes_ for budget_
+    std::size_t numUnnoticedDrops_ = 0;
+    std::size_t numDropped_ = 0;
+
+public:
+    /**
+     * @brief Whether a message fits into the queue
+     */
+    enum class PushResult {
+        Queued,   /**< The message was queued, possibly after dropping older messages */
+        Overflow, /**< The queue is full and the policy is to disconnect or no waiting message can be dropped */
+    };
+
+    /**
+     * @brief Construct a new Send Queue object
+     *
+     * @param budget The limits and memory shared with the other connections; the queue is unbounded if nullptr
+     */
+    explicit SendQueue(std::shared_ptr<SendQueueBudget> budget);
+
+    /** @brief Returns the memory of the queued messages to the budget */
+    ~SendQueue();
+
+    SendQueue(SendQueue const&) = delete;
+    SendQueue&
+    operator=(SendQueue const&) = delete;
+
+    /**
+     * @brief Queue a message, applying the slow consumer policy if the queue is over its limits
+     *
+     * @param msg The message
+     * @param droppable Whether the slow consumer policy may drop the message; false for responses to requests
+     * @return The result
+     */
+    PushResult
+    push(std::shared_ptr<std::string> msg, bool droppable = true);
+
+    /** @return The message to send next */
+    std::shared_ptr<std::string> const&
+    front() const;
+
+    /**
+     * @brief Remove the message that was sent. A gap notice is queued next if messages were dropped.
+     */
+    void
+    pop();
+
+    /** @brief Drop all messages except the one being sent */
+    void
+    clear();
+
+    /** @return true if there are no messages; false otherwise */
+    bool
+    empty() const;
+
+    /** @return The number of messages, including the one being sent */
+    std::size_t
+    size() const;
+
+    /** @return The size of the messages in bytes, including the one being sent */
+    std::size_t
+    bytes() const;
+
+    /** @return The number of messages dropped since the queue was created */
+    std::size_t
+    numDropped() const;
+
+private:
+    bool
+    isOverLimit() const;
+
+    bool
+    dropOldestWaiting();
+
+    void
+    pushFront(Message msg);
+
+    void
+    account(std::int64_t bytes);
+};
+
+}  // namespace impl
+}  // namespace web
@@ -24,6 +24,7 @@
 #include "util/Taggable.hpp"
 #include "util/log/Logger.hpp"
 #include "web/DOSGuard.hpp"
+#include "web/impl/SendQueue.hpp"
 #include "web/interface/Concepts.hpp"
 #include "web/interface/ConnectionBase.hpp"
 
@@ -50,7 +51,6 @@
 #include <exception>
 #include <functional>
 #include <memory>
-#include <queue>
 #include <string>
 #include <utility>
 
@@ -63,6 +63,8 @@ namespace web::impl {
  * The write operation is via a queue, each write operation of this session will be sent in order.
  * The write operation also supports shared_ptr of string, so the caller can keep the string alive until it is sent.
  * It is useful when we have multiple sessions sending the same content.
+ * The queue is bounded by the limits of the send queue budget; a client that falls behind loses messages or is
+ * disconnected, depending on the configured policy.
  *
  * @tparam Derived The derived class
  * @tparam HandlerType The handler type, will be called when a request is received.
@@ -74,7 +76,7 @@ class WsBase : public ConnectionBase, public std::enable_shared_from_this<WsBase
     boost::beast::flat_buffer buffer_;
     std::reference_wrapper<web::DOSGuard> dosGuard_;
     bool sending_ = false;
-    std::queue<std::shared_ptr<std::string>> messages_;
+    SendQueue messages_;
     std::shared_ptr<HandlerType> const handler_;
 
 protected:
@@ -95,15 +97,45 @@ protected:
         }
     }
 
+    /**
+     * @brief Queue a message to be sent to the client
+     * @param msg The message to send
+     * @param droppable Whether the message may be dropped if the client is too slow; responses are never dropped
+     */
+    void
+    queue(std::shared_ptr<std::string> msg, bool droppable)
+    {
+        boost::asio::dispatch(
+            derived().ws().get_executor(),
+            [this, self = derived().shared_from_this(), msg = std::move(msg), droppable]() {
+                if (dead())
+                    return;
+
+                if (messages_.push(msg, droppable) == SendQueue::PushResult::Overflow) {
+                    LOG(perfLog_.warn()) << tag() << "closing slow client with " << messages_.size()
+                                         << " queued messages of " << messages_.bytes() << " bytes";
+                    messages_.clear();
+                    return wsFail(boost::asio::error::no_buffer_space, "send queue overflow");
+                }
+                maybeSendNext();
+            }
+        );
+    }
+
 public:
     explicit WsBase(
         std::string ip,
         std::reference_wrapper<util::TagDecoratorFactory const> tagFactory,
         std::reference_wrapper<web::DOSGuard> dosGuard,
+        std::shared_ptr<SendQueueBudget> sendQueueBudget,
         std::shared_ptr<HandlerType> const& handler,
         boost::beast::flat_buffer&& buffer
     )
-        : ConnectionBase(tagFactory, ip), buffer_(std::move(buffer)), dosGuard_(dosGuard), handler_(handler)
+        : ConnectionBase(tagFactory, ip)
+        , buffer_(std::move(buffer))
+        , dosGuard_(dosGuard)
+        , messages_(std::move(sendQueueBudget))
+        , handler_(handler)
     {
         upgraded = true;  // NOLINT (cppcoreguidelines-pro-type-member-init)
         LOG(perfLog_.debug()) << tag() << "session created";
@@ -112,6 +144,8 @@ public:
     ~WsBase() override
     {
         LOG(perfLog_.debug()) << tag() << "session closed";
+        if (messages_.numDropped() > 0)
+            LOG(perfLog_.info()) << tag() << "dropped " << messages_.numDropped() << " messages for a slow client";
         dosGuard_.get().decrement(clientIp);
     }
 
@@ -157,17 +191,12 @@ public:
      * @param msg The message to send, it will keep the string alive until it is sent. It is useful when we have
      * multiple session sending the same content.
      * Be aware that the message length will not be added to the DOSGuard from this function.
+     * If the send queue is full, older stream messages are dropped or the connection is closed.
      */
     void
     send(std::shared_ptr<std::string> msg) override
     {
-        boost::asio::dispatch(
-            derived().ws().get_executor(),
-            [this, self = derived().shared_from_this(), msg = std::move(msg)]() {
-                messages_.push(msg);
-                maybeSendNext();
-            }
-        );
+        queue(std::move(msg), true);
     }
 
     /**
@@ -193,7 +222,7 @@ public:
             msg = boost::json::serialize(jsonResponse);
         }
         auto sharedMsg = std::make_shared<std::string>(std::move(msg));
-        send(std::move(sharedMsg));
+        queue(std::move(sharedMsg), false);
     }
 
     /**
@@ -259,7 +288,7 @@ public:
                 e["request"] = std::move(requestStr);
             }
 
-            this->send(std::make_shared<std::string>(boost::json::serialize(e)));
+            this->queue(std::make_shared<std::string>(boost::json::serialize(e)), false);
         };
 
         std::string requestStr{static_cast<char const*>(buffer_.data().data()), buffer_.size()};
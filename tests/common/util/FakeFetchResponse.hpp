@@ -30,6 +30,12 @@ class FakeBook {
     std::string first_;
 
 public:
+    std::string
+    first_book() const
+    {
+        return first_;
+    }
+
     std::string*
     mutable_first_book()
     {
@@ -64,6 +70,18 @@ public:
     {
         return books_.end();
     }
+
+    auto
+    begin() const
+    {
+        return books_.begin();
+    }
+
+    auto
+    end() const
+    {
+        return books_.end();
+    }
 };
 
 class FakeLedgerObject {
@@ -84,6 +102,12 @@ public:
         return mod_;
     }
 
+    void
+    set_mod_type(ModType mod)
+    {
+        mod_ = mod;
+    }
+
     std::string
     key() const
     {
@@ -108,12 +132,24 @@ public:
         return &data_;
     }
 
+    std::string
+    predecessor() const
+    {
+        return predecessor_;
+    }
+
     std::string*
     mutable_predecessor()
     {
         return &predecessor_;
     }
 
+    std::string
+    successor() const
+    {
+        return successor_;
+    }
+
     std::string*
     mutable_successor()
     {
@@ -213,6 +249,12 @@ struct FakeFetchResponse {
         return &ledgerHeader;
     }
 
+    FakeBookSuccessors const&
+    book_successors() const
+    {
+        return bookSuccessors;
+    }
+
     FakeBookSuccessors*
     mutable_book_successors()
     {
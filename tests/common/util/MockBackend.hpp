@@ -31,6 +31,7 @@
 #include <xrpl/protocol/AccountID.h>
 #include <xrpl/protocol/LedgerHeader.h>
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -89,6 +90,20 @@ struct MockBackend : public BackendInterface {
         (const, override)
     );
 
+    MOCK_METHOD(
+        std::optional<TransactionAndMetadata>,
+        fetchTransactionByIndex,
+        (std::uint32_t const, std::uint32_t const, boost::asio::yield_context),
+        (const, override)
+    );
+
+    MOCK_METHOD(
+        std::optional<std::uint32_t>,
+        fetchFirstIndexedTransactionSequence,
+        (boost::asio::yield_context),
+        (const, override)
+    );
+
     MOCK_METHOD(
         std::vector<TransactionAndMetadata>,
         fetchAllTransactionsInLedger,
@@ -175,16 +190,25 @@ struct MockBackend : public BackendInterface {
         (const, override)
     );
 
+    MOCK_METHOD(
+        std::vector<LedgerCloseTime>,
+        fetchLedgerCloseTimes,
+        (std::uint32_t, std::uint32_t, boost::asio::yield_context),
+        (const, override)
+    );
+
     MOCK_METHOD(std::optional<LedgerRange>, hardFetchLedgerRange, (boost::asio::yield_context), (const, override));
 
     MOCK_METHOD(void, writeLedger, (ripple::LedgerHeader const&, std::string&&), (override));
 
     MOCK_METHOD(void, writeLedgerObject, (std::string&&, std::uint32_t const, std::string&&), (override));
 
+    MOCK_METHOD(void, writeLedgerStateObject, (std::string&&, std::uint32_t const, std::string&&), (override));
+
     MOCK_METHOD(
         void,
         writeTransaction,
-        (std::string&&, std::uint32_t const, std::uint32_t const, std::string&&, std::string&&),
+        (std::string&&, std::uint32_t const, std::uint32_t const, std::uint32_t const, std::string&&, std::string&&),
         (override)
     );
 
@@ -196,6 +220,21 @@ struct MockBackend : public BackendInterface {
 
     MOCK_METHOD(void, writeSuccessor, (std::string && key, std::uint32_t const, std::string&&), (override));
 
+    MOCK_METHOD(bool, advanceMinSequence, (std::uint32_t, std::uint32_t), (override));
+
+    MOCK_METHOD(bool, tryAcquireWriterLease, (std::string const&, std::chrono::milliseconds), (override));
+
+    MOCK_METHOD(void, releaseWriterLease, (std::string const&), (override));
+
+    MOCK_METHOD(void, waitForWritesToFinish, (), (override));
+
+    MOCK_METHOD(
+        void,
+        deleteLedgerHistory,
+        (LedgerHistoryData const&, std::uint32_t, boost::asio::yield_context),
+        (override)
+    );
+
     MOCK_METHOD(void, startWrites, (), (const, override));
 
     MOCK_METHOD(bool, isTooBusy, (), (const, override));
@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include "etl/impl/CommittedLedger.hpp"
+
 #include <gmock/gmock.h>
 #include <xrpl/protocol/LedgerHeader.h>
 
@@ -29,6 +31,8 @@
 struct MockLedgerPublisher {
     MOCK_METHOD(bool, publish, (uint32_t, std::optional<uint32_t>), ());
     MOCK_METHOD(void, publish, (ripple::LedgerHeader const&), ());
+    MOCK_METHOD(void, publish, (etl::impl::CommittedLedger), ());
+    MOCK_METHOD(bool, broadcastsLedgers, (), (const));
     MOCK_METHOD(std::uint32_t, lastPublishAgeSeconds, (), (const));
     MOCK_METHOD(std::chrono::time_point<std::chrono::system_clock>, getLastPublish, (), (const));
     MOCK_METHOD(std::uint32_t, lastCloseAgeSeconds, (), (const));
@@ -37,6 +37,7 @@ struct MockLoadBalancer {
     using RawLedgerObjectType = FakeLedgerObject;
 
     MOCK_METHOD(void, loadInitialLedger, (std::uint32_t, bool), ());
+    MOCK_METHOD(void, loadLedgerState, (std::uint32_t), ());
     MOCK_METHOD(std::optional<FakeFetchResponse>, fetchLedger, (uint32_t, bool, bool), ());
     MOCK_METHOD(boost::json::value, toJson, (), (const));
 
@@ -60,6 +60,7 @@ struct MockSource : etl::SourceBase {
         (override)
     );
     MOCK_METHOD((std::pair<std::vector<std::string>, bool>), loadInitialLedger, (uint32_t, uint32_t, bool), (override));
+    MOCK_METHOD(bool, loadLedgerState, (uint32_t, uint32_t), (override));
 
     using ForwardToRippledReturnType = std::expected<boost::json::object, rpc::ClioError>;
     MOCK_METHOD(
@@ -130,6 +131,12 @@ public:
         return mock_->loadInitialLedger(sequence, maxLedger, getObjects);
     }
 
+    bool
+    loadLedgerState(uint32_t sequence, uint32_t numMarkers) override
+    {
+        return mock_->loadLedgerState(sequence, numMarkers);
+    }
+
     std::expected<boost::json::object, rpc::ClioError>
     forwardToRippled(
         boost::json::object const& request,
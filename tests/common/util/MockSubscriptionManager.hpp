@@ -20,6 +20,7 @@
 #pragma once
 
 #include "data/Types.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/SubscriptionManagerInterface.hpp"
 #include "feed/Types.hpp"
 
@@ -65,7 +66,12 @@ struct MockSubscriptionManager : feed::SubscriptionManagerInterface {
 
     MOCK_METHOD(void, unsubTransactions, (feed::SubscriberSharedPtr const&), (override));
 
-    MOCK_METHOD(void, pubTransaction, (data::TransactionAndMetadata const&, ripple::LedgerHeader const&), (override));
+    MOCK_METHOD(
+        void,
+        pubTransaction,
+        (data::TransactionAndMetadata const&, ripple::LedgerHeader const&, feed::OwnerFunds&),
+        (override)
+    );
 
     MOCK_METHOD(void, subAccount, (ripple::AccountID const&, feed::SubscriberSharedPtr const&), (override));
 
@@ -30,6 +30,7 @@
 #include "util/MockPrometheus.hpp"
 #include "util/Random.hpp"
 #include "util/StringUtils.hpp"
+#include "util/TestObject.hpp"
 #include "util/config/Config.hpp"
 
 #include <TestGlobals.hpp>
@@ -50,6 +51,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -57,7 +59,9 @@
 #include <memory>
 #include <optional>
 #include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -186,6 +190,13 @@ TEST_F(BackendCassandraTest, Basic)
 
             auto hashes = backend->fetchAllTransactionHashesInLedger(lgrInfoNext.seq, yield);
             EXPECT_EQ(hashes.size(), 0);
+
+            auto closeTimes = backend->fetchLedgerCloseTimes(lgrInfoOld.seq, lgrInfoNext.seq + 1, yield);
+            ASSERT_EQ(closeTimes.size(), 2);
+            EXPECT_EQ(closeTimes[0].sequence, lgrInfoOld.seq);
+            EXPECT_EQ(closeTimes[0].closeTime, lgrInfoOld.closeTime);
+            EXPECT_EQ(closeTimes[1].sequence, lgrInfoNext.seq);
+            EXPECT_EQ(closeTimes[1].closeTime, lgrInfoNext.closeTime);
         }
 
         // the below dummy data is not expected to be consistent. The
@@ -408,6 +419,7 @@ TEST_F(BackendCassandraTest, Basic)
             backend->writeTransaction(
                 std::string{hashBlob},
                 lgrInfoNext.seq,
+                txMeta.getIndex(),
                 lgrInfoNext.closeTime.time_since_epoch().count(),
                 std::string{txnBlob},
                 std::string{metaBlob}
@@ -444,6 +456,12 @@ TEST_F(BackendCassandraTest, Basic)
             auto hashes = backend->fetchAllTransactionHashesInLedger(lgrInfoNext.seq, yield);
             EXPECT_EQ(hashes.size(), 1);
             EXPECT_EQ(ripple::strHex(hashes[0]), hashHex);
+            auto const txIndex = ripple::TxMeta{hashes[0], lgrInfoNext.seq, metaBlob}.getIndex();
+            auto txByIndex = backend->fetchTransactionByIndex(lgrInfoNext.seq, txIndex, yield);
+            ASSERT_TRUE(txByIndex);
+            EXPECT_EQ(*txByIndex, allTransactions[0]);
+            EXPECT_FALSE(backend->fetchTransactionByIndex(lgrInfoNext.seq, txIndex + 1, yield));
+            EXPECT_EQ(backend->fetchFirstIndexedTransactionSequence(yield), rng->minSequence);
             for (auto& a : affectedAccounts) {
                 auto [accountTransactions, cursor] = backend->fetchAccountTransactions(a, 100, true, {}, yield);
                 EXPECT_EQ(accountTransactions.size(), 1);
@@ -616,10 +634,12 @@ TEST_F(BackendCassandraTest, Basic)
             backend->startWrites();
 
             backend->writeLedger(lgrInfo, ledgerHeaderToBinaryString(lgrInfo));
+            std::uint32_t txIndex = 0;
             for (auto [hash, txn, meta] : txns) {
                 backend->writeTransaction(
                     std::move(hash),
                     lgrInfo.seq,
+                    txIndex++,
                     lgrInfo.closeTime.time_since_epoch().count(),
                     std::move(txn),
                     std::move(meta)
@@ -1263,3 +1283,192 @@ TEST_F(BackendCassandraTest, CacheIntegration)
     ctx.run();
     ASSERT_EQ(done, true);
 }
+
+TEST_F(BackendCassandraTest, WriterLease)
+{
+    using namespace std::chrono_literals;
+
+    EXPECT_TRUE(backend->tryAcquireWriterLease("first", 60s));
+    EXPECT_TRUE(backend->tryAcquireWriterLease("first", 60s));
+    EXPECT_FALSE(backend->tryAcquireWriterLease("second", 60s));
+
+    // only the owner can release the lease
+    backend->releaseWriterLease("second");
+    EXPECT_FALSE(backend->tryAcquireWriterLease("second", 60s));
+
+    backend->releaseWriterLease("first");
+    EXPECT_TRUE(backend->tryAcquireWriterLease("second", 60s));
+    EXPECT_FALSE(backend->tryAcquireWriterLease("first", 60s));
+}
+
+TEST_F(BackendCassandraTest, WriterLeaseCanBeTakenOverOnceExpired)
+{
+    using namespace std::chrono_literals;
+
+    EXPECT_TRUE(backend->tryAcquireWriterLease("first", 1ms));
+    std::this_thread::sleep_for(10ms);
+    EXPECT_TRUE(backend->tryAcquireWriterLease("second", 60s));
+    EXPECT_FALSE(backend->tryAcquireWriterLease("first", 60s));
+}
+
+class BackendCassandraBucketedTxTest : public BackendCassandraTest {
+protected:
+    static constexpr auto BUCKET_SIZE = 3u;
+
+    Config bucketedCfg{json::parse(fmt::format(
+        R"JSON({{
+            "contact_points": "{}",
+            "keyspace": "{}",
+            "replication_factor": 1,
+            "tx_bucket_size": {}
+        }})JSON",
+        TestGlobals::instance().backendHost,
+        TestGlobals::instance().backendKeyspace,
+        BUCKET_SIZE
+    ))};
+
+    void
+    SetUp() override
+    {
+        BackendCassandraTest::SetUp();
+        backend = std::make_unique<CassandraBackend>(SettingsProvider{bucketedCfg}, false);
+    }
+};
+
+TEST_F(BackendCassandraBucketedTxTest, PaginationWalksBuckets)
+{
+    static constexpr auto FIRST_SEQ = 10u;
+    static constexpr auto NUM_LEDGERS = 10u;
+    static constexpr auto TXNS_PER_LEDGER = 2u;
+
+    std::atomic_bool done = false;
+    std::optional<boost::asio::io_context::work> work;
+    work.emplace(ctx);
+
+    boost::asio::spawn(ctx, [this, &done, &work](boost::asio::yield_context yield) {
+        auto const account = GetAccountIDWithString("rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun");
+        ripple::uint256 tokenID;
+        EXPECT_TRUE(tokenID.parseHex("000800006203F49C21D5D6E022CB16DE3538F248662FC73CEF7FF5C60000002C"));
+
+        // expected order is ascending by (ledger sequence, transaction index)
+        std::vector<std::string> expectedTxns;
+
+        for (auto seq = FIRST_SEQ; seq < FIRST_SEQ + NUM_LEDGERS; ++seq) {
+            auto const lgrInfo = CreateLedgerHeader(fmt::format("{:064X}", seq), seq);
+            backend->writeLedger(lgrInfo, ledgerHeaderToBinaryString(lgrInfo));
+
+            std::vector<AccountTransactionsData> accountTxData;
+            std::vector<NFTTransactionsData> nftTxData;
+            for (auto idx = 0u; idx < TXNS_PER_LEDGER; ++idx) {
+                ripple::uint256 const hash{seq * TXNS_PER_LEDGER + idx};
+                auto txn = fmt::format("txn_{}_{}", seq, idx);
+                expectedTxns.push_back(txn);
+
+                backend->writeTransaction(uint256ToString(hash), seq, idx, 0, std::move(txn), "meta");
+
+                AccountTransactionsData accountTx;
+                accountTx.accounts.insert(account);
+                accountTx.ledgerSequence = seq;
+                accountTx.transactionIndex = idx;
+                accountTx.txHash = hash;
+                accountTxData.push_back(std::move(accountTx));
+
+                nftTxData.emplace_back(tokenID, seq, idx, hash);
+            }
+
+            backend->writeAccountTransactions(std::move(accountTxData));
+            backend->writeNFTTransactions(nftTxData);
+            ASSERT_TRUE(backend->finishWrites(seq));
+        }
+
+        auto const toStrings = [](std::vector<data::TransactionAndMetadata> const& txns) {
+            std::vector<std::string> result;
+            for (auto const& txn : txns)
+                result.emplace_back(txn.transaction.begin(), txn.transaction.end());
+            return result;
+        };
+
+        auto const collect = [&](auto&& fetch, bool forward) {
+            static constexpr auto LIMIT = 3u;  // does not align with bucket or ledger boundaries on purpose
+
+            std::vector<std::string> result;
+            std::optional<data::TransactionsCursor> cursor;
+            do {
+                auto [txns, retCursor] = fetch(LIMIT, forward, cursor);
+                if (retCursor)
+                    EXPECT_EQ(txns.size(), LIMIT);
+
+                auto const page = toStrings(txns);
+                result.insert(result.end(), page.begin(), page.end());
+                cursor = retCursor;
+            } while (cursor);
+
+            return result;
+        };
+
+        auto const fetchAccountTx = [&](auto limit, bool forward, auto const& cursor) {
+            return backend->fetchAccountTransactions(account, limit, forward, cursor, yield);
+        };
+        auto const fetchNFTTx = [&](auto limit, bool forward, auto const& cursor) {
+            return backend->fetchNFTTransactions(tokenID, limit, forward, cursor, yield);
+        };
+
+        auto const reversed = std::vector<std::string>(expectedTxns.rbegin(), expectedTxns.rend());
+
+        EXPECT_EQ(collect(fetchAccountTx, true), expectedTxns);
+        EXPECT_EQ(collect(fetchAccountTx, false), reversed);
+        EXPECT_EQ(collect(fetchNFTTx, true), expectedTxns);
+        EXPECT_EQ(collect(fetchNFTTx, false), reversed);
+
+        auto const accounts = backend->fetchAccountRoots(1, 10, FIRST_SEQ + NUM_LEDGERS - 1, yield);
+        EXPECT_TRUE(accounts.empty());  // no account root objects were written
+
+        done = true;
+        work.reset();
+    });
+
+    ctx.run();
+    ASSERT_EQ(done, true);
+}
+
+TEST_F(BackendCassandraBucketedTxTest, RefusesToDisableBucketingOnPopulatedDatabase)
+{
+    AccountTransactionsData accountTx;
+    accountTx.accounts.insert(GetAccountIDWithString("rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun"));
+    accountTx.ledgerSequence = 1;
+    accountTx.transactionIndex = 0;
+    accountTx.txHash = ripple::uint256{1};
+
+    // the bucketed backend from SetUp writes into account_tx_bucketed
+    backend->writeAccountTransactions({accountTx});
+    backend->waitForWritesToFinish();
+
+    EXPECT_THROW(CassandraBackend(settingsProvider, false), std::runtime_error);
+    EXPECT_NO_THROW(CassandraBackend(SettingsProvider{bucketedCfg}, false));
+}
+
+TEST_F(BackendCassandraTest, RefusesToEnableBucketingOnPopulatedDatabase)
+{
+    AccountTransactionsData accountTx;
+    accountTx.accounts.insert(GetAccountIDWithString("rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun"));
+    accountTx.ledgerSequence = 1;
+    accountTx.transactionIndex = 0;
+    accountTx.txHash = ripple::uint256{1};
+
+    backend->writeAccountTransactions({accountTx});
+    backend->waitForWritesToFinish();
+
+    Config const bucketedCfg{json::parse(fmt::format(
+        R"JSON({{
+            "contact_points": "{}",
+            "keyspace": "{}",
+            "replication_factor": 1,
+            "tx_bucket_size": 1000
+        }})JSON",
+        TestGlobals::instance().backendHost,
+        TestGlobals::instance().backendKeyspace
+    ))};
+
+    EXPECT_THROW(CassandraBackend(SettingsProvider{bucketedCfg}, false), std::runtime_error);
+    EXPECT_NO_THROW(CassandraBackend(settingsProvider, false));
+}
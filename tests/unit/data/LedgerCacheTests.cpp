@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/LedgerCache.hpp"
+#include "data/Types.hpp"
+#include "util/MockPrometheus.hpp"
+
+#include <gtest/gtest.h>
+#include <xrpl/basics/base_uint.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace data;
+
+namespace {
+
+constexpr auto KEY = "1B8590C01B0006EDFA9ED60296DD052DC5E90F99659B25014D08E1BC983515BC";
+constexpr uint32_t SEQ = 30;
+
+struct LedgerCacheTests : util::prometheus::WithPrometheus {
+    LedgerCache cache;
+    ripple::uint256 const key{KEY};
+    Blob const blob{1, 2, 3};
+};
+
+}  // namespace
+
+TEST_F(LedgerCacheTests, UpdateCopiesObjects)
+{
+    std::vector<LedgerObject> const objects{{key, blob}};
+    cache.update(objects, SEQ);
+
+    EXPECT_EQ(cache.get(key, SEQ), blob);
+    EXPECT_EQ(objects.front().blob, blob);
+}
+
+TEST_F(LedgerCacheTests, UpdateByMoveTakesOverBlobs)
+{
+    std::vector<LedgerObject> objects{{key, blob}};
+    cache.update(std::move(objects), SEQ);
+
+    EXPECT_EQ(cache.get(key, SEQ), blob);
+}
+
+TEST_F(LedgerCacheTests, UpdateByMoveAppliesDeletesAndNewerSequences)
+{
+    cache.update(std::vector<LedgerObject>{{key, blob}}, SEQ);
+    cache.update(std::vector<LedgerObject>{{key, Blob{4, 5}}}, SEQ + 1);
+    EXPECT_EQ(cache.get(key, SEQ + 1), (Blob{4, 5}));
+
+    cache.update(std::vector<LedgerObject>{{key, {}}}, SEQ + 2);
+    EXPECT_FALSE(cache.get(key, SEQ + 2).has_value());
+}
+
+TEST_F(LedgerCacheTests, GetNeighborsRequiresFullCacheAndLatestSequence)
+{
+    cache.update(std::vector<LedgerObject>{{key, blob}}, SEQ);
+    EXPECT_FALSE(cache.getNeighbors({key}, SEQ).has_value());
+
+    cache.setFull();
+    EXPECT_FALSE(cache.getNeighbors({key}, SEQ - 1).has_value());
+    EXPECT_TRUE(cache.getNeighbors({key}, SEQ).has_value());
+}
+
+TEST_F(LedgerCacheTests, GetNeighborsMatchesPredecessorAndSuccessor)
+{
+    std::vector<LedgerObject> objects;
+    for (auto i = 1u; i <= 100; ++i)
+        objects.push_back({ripple::uint256{i * 10}, blob});
+    cache.update(std::move(objects), SEQ);
+    cache.setFull();
+
+    // present and absent keys, close together and far apart, below the first and above the last
+    std::vector<ripple::uint256> const keys{
+        ripple::uint256{5},
+        ripple::uint256{10},
+        ripple::uint256{11},
+        ripple::uint256{20},
+        ripple::uint256{500},
+        ripple::uint256{501},
+        ripple::uint256{1000},
+        ripple::uint256{5000}
+    };
+
+    auto const neighbors = cache.getNeighbors(keys, SEQ);
+    ASSERT_TRUE(neighbors.has_value());
+    ASSERT_EQ(neighbors->size(), keys.size());
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto const predecessor = cache.getPredecessor(keys[i], SEQ);
+        auto const successor = cache.getSuccessor(keys[i], SEQ);
+
+        EXPECT_EQ((*neighbors)[i].predecessor.has_value(), predecessor.has_value()) << i;
+        if (predecessor)
+            EXPECT_EQ((*neighbors)[i].predecessor, predecessor->key) << i;
+
+        EXPECT_EQ((*neighbors)[i].successor.has_value(), successor.has_value()) << i;
+        if (successor)
+            EXPECT_EQ((*neighbors)[i].successor, successor->key) << i;
+    }
+}
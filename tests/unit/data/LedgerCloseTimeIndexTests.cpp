@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/LedgerCloseTimeIndex.hpp"
+#include "data/Types.hpp"
+#include "util/TimeUtils.hpp"
+
+#include <gtest/gtest.h>
+#include <xrpl/basics/chrono.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+using namespace data;
+
+namespace {
+
+// ledger N closes at N * 10 seconds after the ripple epoch
+LedgerCloseTime
+ledgerAt(std::uint32_t seq)
+{
+    return {.sequence = seq, .closeTime = ripple::NetClock::time_point{ripple::NetClock::duration{seq * 10}}};
+}
+
+std::chrono::system_clock::time_point
+timeOf(std::uint32_t seq, std::chrono::seconds offset = std::chrono::seconds{0})
+{
+    return util::SystemTpFromLedgerCloseTime(ledgerAt(seq).closeTime) + offset;
+}
+
+}  // namespace
+
+struct LedgerCloseTimeIndexTest : ::testing::Test {
+    LedgerCloseTimeIndexTest()
+    {
+        index.setSampleInterval(1);
+    }
+
+    LedgerCloseTimeIndex index;
+};
+
+TEST_F(LedgerCloseTimeIndexTest, SampledByDefault)
+{
+    LedgerCloseTimeIndex sampled;
+    EXPECT_EQ(sampled.sampleInterval(), LedgerCloseTimeIndex::DEFAULT_SAMPLE_INTERVAL);
+
+    for (std::uint32_t seq = 1; seq <= 2 * LedgerCloseTimeIndex::DEFAULT_SAMPLE_INTERVAL; ++seq)
+        sampled.add(ledgerAt(seq));
+
+    EXPECT_EQ(sampled.size(), 2);
+}
+
+TEST_F(LedgerCloseTimeIndexTest, EmptyIndexReturnsEmptyWindow)
+{
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.lookup(timeOf(10)), LedgerCloseTimeIndex::Window{});
+}
+
+TEST_F(LedgerCloseTimeIndexTest, LookupFindsSurroundingLedgers)
+{
+    for (std::uint32_t seq = 10; seq <= 20; ++seq)
+        index.add(ledgerAt(seq));
+
+    EXPECT_EQ(index.size(), 11);
+    EXPECT_EQ(index.lookup(timeOf(15)), (LedgerCloseTimeIndex::Window{15, 16}));
+    EXPECT_EQ(index.lookup(timeOf(15, std::chrono::seconds{5})), (LedgerCloseTimeIndex::Window{15, 16}));
+    EXPECT_EQ(index.lookup(timeOf(10, std::chrono::seconds{-1})), (LedgerCloseTimeIndex::Window{std::nullopt, 10}));
+    EXPECT_EQ(index.lookup(timeOf(20, std::chrono::seconds{1})), (LedgerCloseTimeIndex::Window{20, std::nullopt}));
+}
+
+TEST_F(LedgerCloseTimeIndexTest, OnlySampledLedgersAreIndexed)
+{
+    index.setSampleInterval(4);
+    for (std::uint32_t seq = 10; seq <= 20; ++seq)
+        index.add(ledgerAt(seq));
+
+    EXPECT_EQ(index.size(), 3);  // 12, 16, 20
+    EXPECT_EQ(index.lookup(timeOf(14)), (LedgerCloseTimeIndex::Window{12, 16}));
+}
+
+TEST_F(LedgerCloseTimeIndexTest, BulkAddMergesWithExistingEntries)
+{
+    index.add(ledgerAt(30));
+    index.add(ledgerAt(31));
+
+    std::vector<LedgerCloseTime> older;
+    for (std::uint32_t seq = 20; seq <= 30; ++seq)
+        older.push_back(ledgerAt(seq));
+    index.add(older);
+
+    EXPECT_EQ(index.size(), 12);
+    EXPECT_EQ(index.lookup(timeOf(25)), (LedgerCloseTimeIndex::Window{25, 26}));
+    EXPECT_EQ(index.lookup(timeOf(30)), (LedgerCloseTimeIndex::Window{30, 31}));
+}
+
+TEST_F(LedgerCloseTimeIndexTest, RemoveBelow)
+{
+    for (std::uint32_t seq = 10; seq <= 20; ++seq)
+        index.add(ledgerAt(seq));
+
+    index.removeBelow(15);
+
+    EXPECT_EQ(index.size(), 6);
+    EXPECT_EQ(index.lookup(timeOf(12)), (LedgerCloseTimeIndex::Window{std::nullopt, 15}));
+}
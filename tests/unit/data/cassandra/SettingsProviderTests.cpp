@@ -29,6 +29,7 @@
 
 #include <chrono>
 #include <optional>
+#include <stdexcept>
 #include <thread>
 #include <variant>
 
@@ -67,6 +68,7 @@ TEST_F(SettingsProviderTest, Defaults)
     EXPECT_EQ(provider.getKeyspace(), "clio");
     EXPECT_EQ(provider.getReplicationFactor(), 3);
     EXPECT_EQ(provider.getTablePrefix(), std::nullopt);
+    EXPECT_EQ(provider.getTxBucketSize(), std::nullopt);
 }
 
 TEST_F(SettingsProviderTest, SimpleConfig)
@@ -77,7 +79,8 @@ TEST_F(SettingsProviderTest, SimpleConfig)
         "keyspace": "test",
         "replication_factor": 42,
         "table_prefix": "prefix",
-        "threads": 24
+        "threads": 24,
+        "tx_bucket_size": 1000
     })")};
     SettingsProvider const provider{cfg};
 
@@ -92,6 +95,16 @@ TEST_F(SettingsProviderTest, SimpleConfig)
     EXPECT_EQ(provider.getKeyspace(), "test");
     EXPECT_EQ(provider.getReplicationFactor(), 42);
     EXPECT_EQ(provider.getTablePrefix(), "prefix");
+    EXPECT_EQ(provider.getTxBucketSize(), 1000);
+}
+
+TEST_F(SettingsProviderTest, ZeroTxBucketSizeThrows)
+{
+    Config const cfg{json::parse(R"({
+        "contact_points": "127.0.0.1",
+        "tx_bucket_size": 0
+    })")};
+    EXPECT_THROW(SettingsProvider{cfg}, std::runtime_error);
 }
 
 TEST_F(SettingsProviderTest, DriverOptionalOptionsSpecified)
@@ -0,0 +1,222 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/Types.hpp"
+#include "etl/BackfillSettings.hpp"
+#include "etl/SystemState.hpp"
+#include "etl/impl/Backfiller.hpp"
+#include "util/FakeFetchResponse.hpp"
+#include "util/MockBackendTestFixture.hpp"
+#include "util/MockLedgerLoader.hpp"
+#include "util/MockLoadBalancer.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/StringUtils.hpp"
+#include "util/config/Config.hpp"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace json = boost::json;
+using namespace etl;
+using namespace data;
+using namespace testing;
+
+namespace {
+
+// taken from BackendTests
+constexpr auto RAW_HEADER =
+    "03C3141A01633CD656F91B4EBB5EB89B791BD34DBC8A04BB6F407C5335BC54351E"
+    "DD733898497E809E04074D14D271E4832D7888754F9230800761563A292FA2315A"
+    "6DB6FE30CC5909B285080FCD6773CC883F9FE0EE4D439340AC592AADB973ED3CF5"
+    "3E2232B33EF57CECAC2816E3122816E31A0A00F8377CD95DFA484CFAE282656A58"
+    "CE5AA29652EFFD80AC59CD91416E4E13DBBE";
+
+}  // namespace
+
+struct BackfillSettingsTest : Test {};
+
+TEST_F(BackfillSettingsTest, DefaultSettingsParsedCorrectly)
+{
+    auto const cfg = util::Config{json::parse(R"({})")};
+    auto const settings = make_BackfillSettings(cfg);
+
+    EXPECT_EQ(settings, BackfillSettings{});
+    EXPECT_FALSE(settings.isEnabled());
+}
+
+TEST_F(BackfillSettingsTest, ValuesCorrectlyPropagatedThroughConfig)
+{
+    auto const cfg = util::Config{json::parse(R"({
+        "backfill": {
+            "start_sequence": 32570,
+            "workers": 16,
+            "batch_size": 100
+        }
+    })")};
+    auto const settings = make_BackfillSettings(cfg);
+
+    EXPECT_TRUE(settings.isEnabled());
+    EXPECT_EQ(settings.startSequence, 32570);
+    EXPECT_EQ(settings.numWorkers, 16);
+    EXPECT_EQ(settings.batchSize, 100);
+}
+
+TEST_F(BackfillSettingsTest, ZeroWorkersThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"backfill": {"start_sequence": 1, "workers": 0}})")};
+    EXPECT_THROW(make_BackfillSettings(cfg), std::runtime_error);
+}
+
+TEST_F(BackfillSettingsTest, ZeroBatchSizeThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"backfill": {"start_sequence": 1, "batch_size": 0}})")};
+    EXPECT_THROW(make_BackfillSettings(cfg), std::runtime_error);
+}
+
+struct BackfillerTest : util::prometheus::WithPrometheus, MockBackendTest {
+    using BackfillerType = etl::impl::Backfiller<MockLoadBalancer, MockLedgerLoader>;
+
+    std::string const header = hexStringToBinaryString(RAW_HEADER);
+    std::shared_ptr<StrictMock<MockLoadBalancer>> balancer = std::make_shared<StrictMock<MockLoadBalancer>>();
+    StrictMock<MockLedgerLoader> loader;
+    SystemState state;
+
+    BackfillerType
+    makeBackfiller(BackfillSettings settings)
+    {
+        return BackfillerType{settings, backend, balancer, loader, state};
+    }
+
+    auto
+    fetchLedgerWithNeighbors()
+    {
+        return [this](std::uint32_t seq, bool, bool) {
+            return std::make_optional<FakeFetchResponse>(header, seq, true);
+        };
+    }
+};
+
+TEST_F(BackfillerTest, NothingToBackfill)
+{
+    auto backfiller = makeBackfiller(BackfillSettings{.startSequence = 10});
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 10, .maxSequence = 50}));
+    EXPECT_CALL(*backend, advanceMinSequence).Times(0);
+
+    EXPECT_EQ(backfiller.backfill(), 0);
+}
+
+TEST_F(BackfillerTest, DisabledBackfillDoesNothing)
+{
+    auto backfiller = makeBackfiller(BackfillSettings{});
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).Times(0);
+    EXPECT_EQ(backfiller.backfill(), 0);
+}
+
+TEST_F(BackfillerTest, MovesMinSequenceAfterEachBatch)
+{
+    auto backfiller = makeBackfiller(BackfillSettings{.startSequence = 13, .numWorkers = 2, .batchSize = 4});
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 20, .maxSequence = 50}));
+    EXPECT_CALL(*balancer, loadLedgerState(16));
+    EXPECT_CALL(*balancer, loadLedgerState(13));
+    for (std::uint32_t seq = 13; seq < 20; ++seq)
+        EXPECT_CALL(*balancer, fetchLedger(seq, true, true)).WillOnce(fetchLedgerWithNeighbors());
+
+    EXPECT_CALL(*backend, writeLedger).Times(7);
+    EXPECT_CALL(loader, insertTransactions).Times(7);
+    EXPECT_CALL(*backend, writeAccountTransactions).Times(7);
+    EXPECT_CALL(*backend, writeNFTs).Times(7);
+    EXPECT_CALL(*backend, writeNFTTransactions).Times(7);
+
+    Sequence const s;
+    EXPECT_CALL(*backend, waitForWritesToFinish).InSequence(s);
+    EXPECT_CALL(*backend, advanceMinSequence(20, 16)).InSequence(s).WillOnce(Return(true));
+    EXPECT_CALL(*backend, waitForWritesToFinish).InSequence(s);
+    EXPECT_CALL(*backend, advanceMinSequence(16, 13)).InSequence(s).WillOnce(Return(true));
+
+    EXPECT_EQ(backfiller.backfill(), 7);
+}
+
+TEST_F(BackfillerTest, LoadsStateOfFirstLedgerBeforeWritingBatch)
+{
+    auto backfiller = makeBackfiller(BackfillSettings{.startSequence = 18, .numWorkers = 1, .batchSize = 2});
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 20, .maxSequence = 50}));
+    EXPECT_CALL(loader, insertTransactions).Times(2);
+
+    Sequence const s;
+    EXPECT_CALL(*balancer, loadLedgerState(18)).InSequence(s);
+    EXPECT_CALL(*balancer, fetchLedger(18, true, true)).InSequence(s).WillOnce(fetchLedgerWithNeighbors());
+    EXPECT_CALL(*balancer, fetchLedger(19, true, true)).InSequence(s).WillOnce(fetchLedgerWithNeighbors());
+    EXPECT_CALL(*backend, waitForWritesToFinish).InSequence(s);
+    EXPECT_CALL(*backend, advanceMinSequence(20, 18)).InSequence(s).WillOnce(Return(true));
+
+    EXPECT_EQ(backfiller.backfill(), 2);
+}
+
+TEST_F(BackfillerTest, KeepsCheckpointIfLedgerCanNotBeFetched)
+{
+    auto backfiller = makeBackfiller(BackfillSettings{.startSequence = 18, .numWorkers = 1, .batchSize = 2});
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 20, .maxSequence = 50}));
+    EXPECT_CALL(*balancer, loadLedgerState(18));
+    EXPECT_CALL(*balancer, fetchLedger(18, true, true)).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*balancer, fetchLedger(19, true, true)).Times(0);
+    EXPECT_CALL(*backend, waitForWritesToFinish).Times(0);
+    EXPECT_CALL(*backend, advanceMinSequence).Times(0);
+
+    EXPECT_EQ(backfiller.backfill(), 0);
+}
+
+TEST_F(BackfillerTest, StopsIfObjectNeighborsAreNotIncluded)
+{
+    auto backfiller = makeBackfiller(BackfillSettings{.startSequence = 19, .numWorkers = 1, .batchSize = 1});
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 20, .maxSequence = 50}));
+    EXPECT_CALL(*balancer, loadLedgerState(19));
+    EXPECT_CALL(*balancer, fetchLedger(19, true, true))
+        .WillOnce(Return(std::make_optional<FakeFetchResponse>(header, 19, false)));
+    EXPECT_CALL(*backend, writeLedger).Times(0);
+    EXPECT_CALL(*backend, advanceMinSequence).Times(0);
+
+    EXPECT_EQ(backfiller.backfill(), 0);
+}
+
+TEST_F(BackfillerTest, StopsIfMinSequenceWasMovedByAnotherProcess)
+{
+    auto backfiller = makeBackfiller(BackfillSettings{.startSequence = 10, .numWorkers = 1, .batchSize = 1});
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 20, .maxSequence = 50}));
+    EXPECT_CALL(*balancer, loadLedgerState(19));
+    EXPECT_CALL(*balancer, fetchLedger(19, true, true)).WillOnce(fetchLedgerWithNeighbors());
+    EXPECT_CALL(loader, insertTransactions);
+    EXPECT_CALL(*backend, advanceMinSequence(20, 19)).WillOnce(Return(false));
+
+    EXPECT_EQ(backfiller.backfill(), 0);
+}
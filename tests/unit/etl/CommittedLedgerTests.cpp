@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/Types.hpp"
+#include "etl/impl/CommittedLedger.hpp"
+#include "util/TestObject.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <xrpl/basics/Slice.h>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/protocol/Fees.h>
+#include <xrpl/protocol/XRPAmount.h>
+
+#include <string>
+
+using namespace etl::impl;
+
+namespace {
+
+constexpr auto LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+constexpr auto SEQ = 30;
+
+}  // namespace
+
+struct CommittedLedgerTests : public ::testing::Test {
+    CommittedLedger
+    makeLedger() const
+    {
+        ripple::Fees fees;
+        fees.base = ripple::XRPAmount{10};
+        fees.reserve = ripple::XRPAmount{20};
+        fees.increment = ripple::XRPAmount{5};
+
+        return CommittedLedger{
+            .header = CreateLedgerHeader(LEDGERHASH, SEQ),
+            .transactions = {{{1, 2}, {3, 4, 5}, SEQ, 123}, {{6}, {7}, SEQ, 123}},
+            .diff = {{ripple::uint256{1}, {8, 9}}, {ripple::uint256{2}, {}}},
+            .fees = fees,
+            .minSequence = SEQ - 10
+        };
+    }
+};
+
+TEST_F(CommittedLedgerTests, RoundTrip)
+{
+    auto const ledger = makeLedger();
+    auto const serialized = ledger.serialize();
+
+    auto const result = CommittedLedger::deserialize(ripple::makeSlice(serialized));
+    ASSERT_TRUE(result);
+
+    EXPECT_EQ(result->header.seq, ledger.header.seq);
+    EXPECT_EQ(result->header.hash, ledger.header.hash);
+    EXPECT_EQ(result->header.parentHash, ledger.header.parentHash);
+    EXPECT_EQ(result->header.closeTime, ledger.header.closeTime);
+    EXPECT_EQ(result->transactions, ledger.transactions);
+    EXPECT_EQ(result->diff, ledger.diff);
+    ASSERT_TRUE(result->fees);
+    EXPECT_EQ(result->fees->base, ledger.fees->base);
+    EXPECT_EQ(result->fees->reserve, ledger.fees->reserve);
+    EXPECT_EQ(result->fees->increment, ledger.fees->increment);
+    EXPECT_EQ(result->minSequence, ledger.minSequence);
+}
+
+TEST_F(CommittedLedgerTests, RoundTripWithoutFees)
+{
+    auto ledger = makeLedger();
+    ledger.fees.reset();
+
+    auto const result = CommittedLedger::deserialize(ripple::makeSlice(ledger.serialize()));
+    ASSERT_TRUE(result);
+    EXPECT_FALSE(result->fees);
+    EXPECT_EQ(result->diff, ledger.diff);
+}
+
+TEST_F(CommittedLedgerTests, TruncatedDataIsRejected)
+{
+    auto const serialized = makeLedger().serialize();
+
+    EXPECT_FALSE(CommittedLedger::deserialize(ripple::makeSlice(serialized.substr(0, serialized.size() - 1))));
+    EXPECT_FALSE(CommittedLedger::deserialize(ripple::makeSlice(std::string{})));
+}
+
+TEST_F(CommittedLedgerTests, TrailingDataIsRejected)
+{
+    auto const serialized = makeLedger().serialize() + "x";
+    EXPECT_FALSE(CommittedLedger::deserialize(ripple::makeSlice(serialized)));
+}
+
+TEST_F(CommittedLedgerTests, OtherVersionIsRejected)
+{
+    auto serialized = makeLedger().serialize();
+    serialized[3] = static_cast<char>(serialized[3] + 1);  // version is the first 4 bytes, big-endian
+
+    EXPECT_FALSE(CommittedLedger::deserialize(ripple::makeSlice(serialized)));
+}
@@ -19,6 +19,9 @@
 
 #include "etl/impl/ExtractionDataPipe.hpp"
 #include "util/LoggerFixtures.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
 
 #include <gtest/gtest.h>
 
@@ -26,14 +29,25 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <thread>
 
 constexpr static auto STRIDE = 4;
 constexpr static auto START_SEQ = 1234;
 
-class ETLExtractionDataPipeTest : public NoLoggerFixture {
+class ETLExtractionDataPipeTest : public util::prometheus::WithPrometheus, public NoLoggerFixture {
 protected:
     etl::impl::ExtractionDataPipe<uint32_t> pipe_{STRIDE, START_SEQ};
+
+    static std::int64_t
+    queueSize(std::size_t extractor)
+    {
+        return PrometheusService::gaugeInt(
+                   "etl_extraction_queue_size",
+                   util::prometheus::Labels({util::prometheus::Label{"extractor", std::to_string(extractor)}})
+        )
+            .value();
+    }
 };
 
 TEST_F(ETLExtractionDataPipeTest, StrideMatchesInput)
@@ -67,7 +81,7 @@ TEST_F(ETLExtractionDataPipeTest, CallingCleanupUnblocksOtherThread)
 {
     std::atomic_bool unblocked = false;
     auto bgThread = std::thread([this, &unblocked] {
-        for (std::size_t i = 0; i < 252; ++i)
+        for (std::size_t i = 0; i < 251; ++i)
             pipe_.push(START_SEQ, 1234);  // 251st element will block this thread here
         unblocked = true;
     });
@@ -81,3 +95,40 @@ TEST_F(ETLExtractionDataPipeTest, CallingCleanupUnblocksOtherThread)
     bgThread.join();
     EXPECT_TRUE(unblocked);
 }
+
+TEST_F(ETLExtractionDataPipeTest, QueueSizeIsReportedPerExtractor)
+{
+    pipe_.push(START_SEQ, START_SEQ);
+    pipe_.push(START_SEQ + STRIDE, START_SEQ + STRIDE);
+    pipe_.push(START_SEQ + 1, START_SEQ + 1);
+
+    EXPECT_EQ(queueSize(0), 2);
+    EXPECT_EQ(queueSize(1), 1);
+    EXPECT_EQ(queueSize(2), 0);
+
+    pipe_.popNext(START_SEQ);
+    pipe_.popNext(START_SEQ + 1);
+
+    EXPECT_EQ(queueSize(0), 1);
+    EXPECT_EQ(queueSize(1), 0);
+}
+
+TEST_F(ETLExtractionDataPipeTest, DataIsHandedOverInOrderAcrossThreads)
+{
+    static constexpr auto TOTAL = 10'000u;
+
+    auto producer = std::thread([this] {
+        for (uint32_t seq = START_SEQ; seq < START_SEQ + TOTAL; seq += STRIDE)
+            pipe_.push(seq, seq);
+        pipe_.finish(START_SEQ + TOTAL);
+    });
+
+    for (uint32_t seq = START_SEQ; seq < START_SEQ + TOTAL; seq += STRIDE) {
+        auto const data = pipe_.popNext(seq);
+        ASSERT_TRUE(data.has_value());
+        EXPECT_EQ(*data, seq);
+    }
+    EXPECT_FALSE(pipe_.popNext(START_SEQ + TOTAL).has_value());
+
+    producer.join();
+}
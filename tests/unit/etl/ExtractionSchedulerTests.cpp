@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/ExtractionScheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+using namespace etl::impl;
+
+namespace {
+
+constexpr uint32_t START_SEQ = 1234;
+
+}  // namespace
+
+TEST(ExtractionSchedulerTests, UnlimitedBudgetNeverBlocks)
+{
+    ExtractionScheduler scheduler{START_SEQ, ExtractionScheduler::UNLIMITED};
+    scheduler.onExtracted(1'000'000);
+
+    EXPECT_EQ(scheduler.window(), ExtractionScheduler::UNLIMITED);
+    EXPECT_TRUE(scheduler.waitForTurn(START_SEQ + 10'000));
+}
+
+TEST(ExtractionSchedulerTests, UnknownSizeDoesNotBlock)
+{
+    ExtractionScheduler scheduler{START_SEQ, 100};
+
+    EXPECT_EQ(scheduler.window(), ExtractionScheduler::UNLIMITED);
+    EXPECT_TRUE(scheduler.waitForTurn(START_SEQ + 10));
+}
+
+TEST(ExtractionSchedulerTests, WindowFollowsAverageSize)
+{
+    ExtractionScheduler scheduler{START_SEQ, 1000};
+
+    scheduler.onExtracted(100);
+    EXPECT_EQ(scheduler.window(), 10);
+
+    scheduler.onExtracted(1100);  // the average is now 200
+    EXPECT_EQ(scheduler.window(), 5);
+}
+
+TEST(ExtractionSchedulerTests, NextLedgerIsAlwaysAllowed)
+{
+    ExtractionScheduler scheduler{START_SEQ, 100};
+    scheduler.onExtracted(1000);
+
+    EXPECT_EQ(scheduler.window(), 1);
+    EXPECT_TRUE(scheduler.waitForTurn(START_SEQ));
+    EXPECT_TRUE(scheduler.waitForTurn(START_SEQ - 1));
+}
+
+TEST(ExtractionSchedulerTests, WaitsUntilTransformerTakesLedger)
+{
+    ExtractionScheduler scheduler{START_SEQ, 100};
+    scheduler.onExtracted(100);
+
+    std::atomic_bool allowed = false;
+    auto extractor = std::thread([&] { allowed = scheduler.waitForTurn(START_SEQ + 1); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_FALSE(allowed);
+
+    scheduler.onTransformStarted(START_SEQ);
+    extractor.join();
+    EXPECT_TRUE(allowed);
+}
+
+TEST(ExtractionSchedulerTests, StopUnblocksWaitingExtractors)
+{
+    ExtractionScheduler scheduler{START_SEQ, 100};
+    scheduler.onExtracted(100);
+
+    std::atomic_bool allowed = true;
+    auto extractor = std::thread([&] { allowed = scheduler.waitForTurn(START_SEQ + 5); });
+
+    scheduler.stop();
+    extractor.join();
+    EXPECT_FALSE(allowed);
+    EXPECT_FALSE(scheduler.waitForTurn(START_SEQ));
+}
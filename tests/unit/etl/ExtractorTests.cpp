@@ -50,6 +50,8 @@ struct ETLExtractorTest : util::prometheus::WithPrometheus, NoLoggerFixture {
         state_.writeConflict = false;
         state_.isReadOnly = false;
         state_.isWriting = false;
+
+        ON_CALL(dataPipe_, waitForTurn).WillByDefault(Return(true));
     }
 };
 
@@ -107,6 +109,16 @@ TEST_F(ETLExtractorTest, StopsIfWaitingUntilValidatedByNetworkTimesOut)
     ExtractorType{dataPipe_, networkValidatedLedgers_, ledgerFetcher_, 0, 64, state_};
 }
 
+TEST_F(ETLExtractorTest, StopsIfPipeIsCleanedUpWhileWaitingForTurn)
+{
+    EXPECT_CALL(*networkValidatedLedgers_, waitUntilValidatedByNetwork).WillOnce(Return(true));
+    EXPECT_CALL(dataPipe_, waitForTurn(0)).WillOnce(Return(false));
+    EXPECT_CALL(ledgerFetcher_, fetchDataAndDiff).Times(0);
+    EXPECT_CALL(dataPipe_, finish(0));
+
+    ExtractorType{dataPipe_, networkValidatedLedgers_, ledgerFetcher_, 0, 64, state_};
+}
+
 TEST_F(ETLExtractorTest, SendsCorrectResponseToDataPipe)
 {
     EXPECT_CALL(*networkValidatedLedgers_, waitUntilValidatedByNetwork).WillOnce(Return(true));
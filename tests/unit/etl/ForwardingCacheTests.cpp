@@ -18,14 +18,18 @@
 //==============================================================================
 
 #include "etl/impl/ForwardingCache.hpp"
+#include "util/MockPrometheus.hpp"
 
+#include <boost/json/array.hpp>
 #include <boost/json/object.hpp>
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <chrono>
 #include <thread>
 
 using namespace etl::impl;
+using util::prometheus::CounterInt;
 
 struct CacheEntryTests : public ::testing::Test {
     CacheEntry entry_;
@@ -71,20 +75,30 @@ TEST_F(CacheEntryTests, Invalidate)
     EXPECT_FALSE(entry_.get());
 }
 
-TEST(ForwardingCacheTests, ShouldCache)
+struct ForwardingCacheTests : util::prometheus::WithPrometheus {};
+
+TEST_F(ForwardingCacheTests, ShouldCache)
 {
+    ForwardingCache const cache{std::chrono::seconds{100}};
     for (auto const& command : ForwardingCache::CACHEABLE_COMMANDS) {
         auto const request = boost::json::object{{"command", command}};
-        EXPECT_TRUE(ForwardingCache::shouldCache(request));
+        EXPECT_TRUE(cache.shouldCache(request));
     }
     auto const request = boost::json::object{{"command", "tx"}};
-    EXPECT_FALSE(ForwardingCache::shouldCache(request));
+    EXPECT_FALSE(cache.shouldCache(request));
 
     auto const requestWithoutCommand = boost::json::object{{"key", "value"}};
-    EXPECT_FALSE(ForwardingCache::shouldCache(requestWithoutCommand));
+    EXPECT_FALSE(cache.shouldCache(requestWithoutCommand));
+}
+
+TEST_F(ForwardingCacheTests, ShouldCacheCustomCommands)
+{
+    ForwardingCache const cache{std::chrono::seconds{100}, {"book_offers"}};
+    EXPECT_TRUE(cache.shouldCache(boost::json::object{{"command", "book_offers"}}));
+    EXPECT_FALSE(cache.shouldCache(boost::json::object{{"command", "server_info"}}));
 }
 
-TEST(ForwardingCacheTests, Get)
+TEST_F(ForwardingCacheTests, Get)
 {
     ForwardingCache cache{std::chrono::seconds{100}};
     auto const request = boost::json::object{{"command", "server_info"}};
@@ -97,7 +111,7 @@ TEST(ForwardingCacheTests, Get)
     EXPECT_EQ(*result, response);
 }
 
-TEST(ForwardingCacheTests, GetExpired)
+TEST_F(ForwardingCacheTests, GetExpired)
 {
     ForwardingCache cache{std::chrono::milliseconds{1}};
     auto const request = boost::json::object{{"command", "server_info"}};
@@ -110,7 +124,7 @@ TEST(ForwardingCacheTests, GetExpired)
     EXPECT_FALSE(result);
 }
 
-TEST(ForwardingCacheTests, GetAndPutNotCommand)
+TEST_F(ForwardingCacheTests, GetAndPutNotCommand)
 {
     ForwardingCache cache{std::chrono::seconds{100}};
     auto const request = boost::json::object{{"key", "value"}};
@@ -120,7 +134,7 @@ TEST(ForwardingCacheTests, GetAndPutNotCommand)
     EXPECT_FALSE(result);
 }
 
-TEST(ForwardingCache, Invalidate)
+TEST_F(ForwardingCacheTests, Invalidate)
 {
     ForwardingCache cache{std::chrono::seconds{100}};
     auto const request = boost::json::object{{"command", "server_info"}};
@@ -131,3 +145,53 @@ TEST(ForwardingCache, Invalidate)
 
     EXPECT_FALSE(cache.get(request));
 }
+
+TEST_F(ForwardingCacheTests, RequestsWithDifferentParametersAreCachedSeparately)
+{
+    ForwardingCache cache{std::chrono::seconds{100}};
+    auto const request = boost::json::object{{"command", "fee"}, {"api_version", 1}};
+    auto const otherRequest = boost::json::object{{"command", "fee"}, {"api_version", 2}};
+    auto const response = boost::json::object{{"key", "value"}};
+
+    cache.put(request, response);
+
+    EXPECT_EQ(cache.get(request), response);
+    EXPECT_FALSE(cache.get(otherRequest));
+}
+
+TEST_F(ForwardingCacheTests, IdAndOrderOfFieldsAreIgnored)
+{
+    ForwardingCache cache{std::chrono::seconds{100}};
+    auto const request = boost::json::object{{"id", 1}, {"command", "fee"}, {"api_version", 1}};
+    auto const sameRequest = boost::json::object{{"api_version", 1}, {"command", "fee"}, {"id", 2}};
+    auto const response = boost::json::object{{"key", "value"}};
+
+    cache.put(request, response);
+    EXPECT_EQ(cache.get(sameRequest), response);
+}
+
+TEST_F(ForwardingCacheTests, MakeKey)
+{
+    auto const request = boost::json::object{
+        {"id", 1}, {"command", "fee"}, {"params", boost::json::object{{"b", 1}, {"a", boost::json::array{2, 3}}}}
+    };
+    EXPECT_EQ(ForwardingCache::makeKey(request), R"({"command":"fee","params":{"a":[2,3],"b":1}})");
+}
+
+struct ForwardingCacheMockPrometheusTests : util::prometheus::WithMockPrometheus {};
+
+TEST_F(ForwardingCacheMockPrometheusTests, HitsAndMissesAreCounted)
+{
+    auto& hitMock = makeMock<CounterInt>("forwarding_cache_hit_total_number", "{command=\"fee\"}");
+    auto& missMock = makeMock<CounterInt>("forwarding_cache_miss_total_number", "{command=\"fee\"}");
+
+    ForwardingCache cache{std::chrono::seconds{100}};
+    auto const request = boost::json::object{{"command", "fee"}};
+
+    EXPECT_CALL(missMock, add(1));
+    EXPECT_FALSE(cache.get(request));
+
+    cache.put(request, boost::json::object{{"key", "value"}});
+    EXPECT_CALL(hitMock, add(1));
+    EXPECT_TRUE(cache.get(request));
+}
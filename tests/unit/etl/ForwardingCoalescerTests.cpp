@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/ForwardingCoalescer.hpp"
+#include "rpc/Errors.hpp"
+#include "util/AsioContextTestFixture.hpp"
+#include "util/MockPrometheus.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/json/object.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <expected>
+
+using namespace etl::impl;
+using testing::MockFunction;
+
+struct ForwardingCoalescerTests : util::prometheus::WithPrometheus, SyncAsioContextTest {
+    ForwardingCoalescer coalescer_;
+    boost::json::object const response_{{"key", "value"}};
+
+    // forwards after a delay so that other requests can arrive while this one is in flight
+    ForwardingCoalescer::Response
+    forwardSlowly(ForwardingCoalescer::Response response, boost::asio::yield_context yield)
+    {
+        boost::asio::steady_timer timer{yield.get_executor(), std::chrono::milliseconds{10}};
+        timer.async_wait(yield);
+        return response;
+    }
+};
+
+TEST_F(ForwardingCoalescerTests, IdenticalRequestsInFlightAreForwardedOnce)
+{
+    MockFunction<void()> forwardCalled;
+    EXPECT_CALL(forwardCalled, Call()).Times(1);
+
+    for (auto i = 0; i < 3; ++i) {
+        boost::asio::spawn(ctx, [&](boost::asio::yield_context yield) {
+            auto const response = coalescer_.forward(
+                "fee",
+                "key",
+                [&]() {
+                    forwardCalled.Call();
+                    return forwardSlowly(response_, yield);
+                },
+                yield
+            );
+            ASSERT_TRUE(response);
+            EXPECT_EQ(*response, response_);
+        });
+    }
+
+    runContext();
+}
+
+TEST_F(ForwardingCoalescerTests, ErrorIsSharedWithWaitingRequests)
+{
+    for (auto i = 0; i < 2; ++i) {
+        boost::asio::spawn(ctx, [&](boost::asio::yield_context yield) {
+            auto const response = coalescer_.forward(
+                "fee",
+                "key",
+                [&]() { return forwardSlowly(std::unexpected{rpc::ClioError::etlREQUEST_TIMEOUT}, yield); },
+                yield
+            );
+            ASSERT_FALSE(response);
+            EXPECT_EQ(response.error(), rpc::ClioError::etlREQUEST_TIMEOUT);
+        });
+    }
+
+    runContext();
+}
+
+TEST_F(ForwardingCoalescerTests, DifferentRequestsAreForwardedSeparately)
+{
+    MockFunction<void()> forwardCalled;
+    EXPECT_CALL(forwardCalled, Call()).Times(2);
+
+    for (auto const* key : {"key1", "key2"}) {
+        boost::asio::spawn(ctx, [&, key](boost::asio::yield_context yield) {
+            auto const response = coalescer_.forward(
+                "fee",
+                key,
+                [&]() {
+                    forwardCalled.Call();
+                    return forwardSlowly(response_, yield);
+                },
+                yield
+            );
+            EXPECT_TRUE(response);
+        });
+    }
+
+    runContext();
+}
+
+TEST_F(ForwardingCoalescerTests, SequentialRequestsAreForwardedSeparately)
+{
+    MockFunction<void()> forwardCalled;
+    EXPECT_CALL(forwardCalled, Call()).Times(2);
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        for (auto i = 0; i < 2; ++i) {
+            auto const response = coalescer_.forward(
+                "fee",
+                "key",
+                [&]() {
+                    forwardCalled.Call();
+                    return ForwardingCoalescer::Response{response_};
+                },
+                yield
+            );
+            EXPECT_TRUE(response);
+        }
+    });
+}
@@ -191,3 +191,86 @@ TEST_F(ForwardingSourceOperationsTests, Success)
         EXPECT_EQ(*result, expectedReply) << *result;
     });
 }
+
+TEST_F(ForwardingSourceOperationsTests, ConnectionIsReused)
+{
+    boost::asio::spawn(ctx, [&](boost::asio::yield_context yield) {
+        auto connection = serverConnection(yield);
+
+        for (auto i = 0; i < 2; ++i) {
+            auto receivedMessage = connection.receive(yield);
+            [&]() { ASSERT_TRUE(receivedMessage); }();
+            EXPECT_EQ(boost::json::parse(*receivedMessage), boost::json::parse(message_)) << *receivedMessage;
+
+            auto sendError = connection.send(boost::json::serialize(reply_), yield);
+            [&]() { ASSERT_FALSE(sendError) << *sendError; }();
+        }
+    });
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        auto expectedReply = reply_;
+        expectedReply["forwarded"] = true;
+
+        for (auto i = 0; i < 2; ++i) {
+            auto result =
+                forwardingSource.forwardToRippled(boost::json::parse(message_).as_object(), "some_ip", {}, yield);
+            [&]() { ASSERT_TRUE(result); }();
+            EXPECT_EQ(*result, expectedReply) << *result;
+        }
+    });
+}
+
+TEST_F(ForwardingSourceOperationsTests, ReconnectsWhenReusedConnectionIsClosed)
+{
+    boost::asio::spawn(ctx, [&](boost::asio::yield_context yield) {
+        for (auto i = 0; i < 2; ++i) {
+            auto connection = serverConnection(yield);
+
+            auto receivedMessage = connection.receive(yield);
+            [&]() { ASSERT_TRUE(receivedMessage); }();
+
+            auto sendError = connection.send(boost::json::serialize(reply_), yield);
+            [&]() { ASSERT_FALSE(sendError) << *sendError; }();
+
+            connection.close(yield);
+        }
+    });
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        for (auto i = 0; i < 2; ++i) {
+            auto result =
+                forwardingSource.forwardToRippled(boost::json::parse(message_).as_object(), "some_ip", {}, yield);
+            ASSERT_TRUE(result);
+        }
+    });
+}
+
+TEST_F(ForwardingSourceOperationsTests, DoesNotResendSubmitWhenReusedConnectionFailsAfterWrite)
+{
+    boost::json::object const submit = {{"command", "submit"}, {"tx_blob", "some_blob"}};
+
+    boost::asio::spawn(ctx, [&](boost::asio::yield_context yield) {
+        auto connection = serverConnection(yield);
+
+        auto receivedMessage = connection.receive(yield);
+        [&]() { ASSERT_TRUE(receivedMessage); }();
+        auto sendError = connection.send(boost::json::serialize(reply_), yield);
+        [&]() { ASSERT_FALSE(sendError) << *sendError; }();
+
+        // rippled receives the submission but the connection breaks before the response is sent
+        receivedMessage = connection.receive(yield);
+        [&]() { ASSERT_TRUE(receivedMessage); }();
+        EXPECT_EQ(boost::json::parse(*receivedMessage), submit) << *receivedMessage;
+        connection.close(yield);
+    });
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        auto result = forwardingSource.forwardToRippled(submit, "some_ip", {}, yield);
+        ASSERT_TRUE(result);
+
+        // a new connection would fail as no further connection is accepted
+        result = forwardingSource.forwardToRippled(submit, "some_ip", {}, yield);
+        ASSERT_FALSE(result);
+        EXPECT_EQ(result.error(), rpc::ClioError::etlREQUEST_ERROR);
+    });
+}
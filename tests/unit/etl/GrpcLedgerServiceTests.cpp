@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/Types.hpp"
+#include "etl/impl/GrpcLedgerService.hpp"
+#include "util/LedgerUtils.hpp"
+#include "util/MockBackendTestFixture.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/TestObject.hpp"
+
+#include <gmock/gmock.h>
+#include <grpcpp/support/status.h>
+#include <gtest/gtest.h>
+#include <org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <org/xrpl/rpc/v1/get_ledger_data.pb.h>
+#include <org/xrpl/rpc/v1/ledger.pb.h>
+#include <xrpl/basics/Slice.h>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/basics/strHex.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace etl::impl;
+using namespace testing;
+
+namespace {
+
+constexpr auto LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+constexpr auto SEQ = 30;
+
+std::string
+toString(ripple::uint256 const& key)
+{
+    return {reinterpret_cast<char const*>(key.data()), ripple::uint256::size()};
+}
+
+}  // namespace
+
+struct GrpcLedgerServiceTests : util::prometheus::WithPrometheus, MockBackendTest {
+    GrpcLedgerServiceTests()
+    {
+        backend->setRange(SEQ - 10, SEQ);
+    }
+
+    GrpcLedgerService service{backend};
+};
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerOutsideOfRange)
+{
+    org::xrpl::rpc::v1::GetLedgerRequest request;
+    request.mutable_ledger()->set_sequence(SEQ + 1);
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ + 1, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ + 1)));
+
+    auto const status = service.GetLedger(nullptr, &request, &response);
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::NOT_FOUND);
+}
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerWithTransactionsAndObjects)
+{
+    org::xrpl::rpc::v1::GetLedgerRequest request;
+    request.mutable_ledger()->set_sequence(SEQ);
+    request.set_transactions(true);
+    request.set_expand(true);
+    request.set_get_objects(true);
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+
+    auto const deleted = ripple::uint256{1};
+    auto const created = ripple::uint256{2};
+    auto const modified = ripple::uint256{3};
+
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ)));
+    EXPECT_CALL(*backend, fetchAllTransactionsInLedger(SEQ, _))
+        .WillOnce(Return(std::vector<data::TransactionAndMetadata>{{{1, 2}, {3}, SEQ, 0}}));
+    EXPECT_CALL(*backend, fetchLedgerDiff(SEQ, _))
+        .WillOnce(Return(std::vector<data::LedgerObject>{{deleted, {}}, {created, {4}}, {modified, {5}}}));
+    EXPECT_CALL(*backend, doFetchLedgerObjects(std::vector<ripple::uint256>{deleted, created, modified}, SEQ - 1, _))
+        .WillOnce(Return(std::vector<data::Blob>{{7}, {}, {6}}));
+
+    auto const status = service.GetLedger(nullptr, &request, &response);
+    ASSERT_TRUE(status.ok());
+
+    auto const header = util::deserializeHeader(ripple::makeSlice(response.ledger_header()));
+    EXPECT_EQ(header.seq, SEQ);
+    EXPECT_EQ(ripple::strHex(header.hash), LEDGERHASH);
+    EXPECT_TRUE(response.validated());
+    EXPECT_TRUE(response.is_unlimited());
+    EXPECT_FALSE(response.object_neighbors_included());
+
+    ASSERT_EQ(response.transactions_list().transactions_size(), 1);
+    EXPECT_EQ(response.transactions_list().transactions(0).transaction_blob(), std::string("\x01\x02"));
+    EXPECT_EQ(response.transactions_list().transactions(0).metadata_blob(), std::string("\x03"));
+
+    auto const& objects = response.ledger_objects().objects();
+    ASSERT_EQ(objects.size(), 3);
+    EXPECT_EQ(objects[0].key(), toString(deleted));
+    EXPECT_EQ(objects[0].mod_type(), org::xrpl::rpc::v1::RawLedgerObject::DELETED);
+    EXPECT_TRUE(objects[0].data().empty());
+    EXPECT_EQ(objects[1].key(), toString(created));
+    EXPECT_EQ(objects[1].mod_type(), org::xrpl::rpc::v1::RawLedgerObject::CREATED);
+    EXPECT_EQ(objects[1].data(), std::string("\x04"));
+    EXPECT_EQ(objects[2].key(), toString(modified));
+    EXPECT_EQ(objects[2].mod_type(), org::xrpl::rpc::v1::RawLedgerObject::MODIFIED);
+}
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerWithObjectNeighbors)
+{
+    org::xrpl::rpc::v1::GetLedgerRequest request;
+    request.mutable_ledger()->set_sequence(SEQ);
+    request.set_get_objects(true);
+    request.set_get_object_neighbors(true);
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+
+    auto const first = ripple::uint256{"1000000000000000000000000000000000000000000000000000000000000000"};
+    auto const deleted = ripple::uint256{"2000000000000000000000000000000000000000000000000000000000000000"};
+    auto const bookBase = ripple::uint256{"3000000000000000000000000000000000000000000000000000000000000000"};
+    auto const createdDir = ripple::uint256{"3000000000000000000000000000000000000000000000000000000000000001"};
+    auto const modified = ripple::uint256{"4000000000000000000000000000000000000000000000000000000000000000"};
+    auto const dirBlob = CreateOwnerDirLedgerObject({}, LEDGERHASH).getSerializer().peekData();
+
+    std::vector<data::LedgerObject> const cached{{first, {1, 2, 3}}, {createdDir, dirBlob}, {modified, {4, 5, 6}}};
+    backend->cache().update(cached, SEQ);
+    backend->cache().setFull();
+
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ)));
+    EXPECT_CALL(*backend, fetchLedgerDiff(SEQ, _))
+        .WillOnce(Return(std::vector<data::LedgerObject>{
+            {modified, {4, 5, 6}}, {createdDir, dirBlob}, {deleted, {}}
+        }));
+    EXPECT_CALL(*backend, doFetchLedgerObjects(std::vector<ripple::uint256>{modified, createdDir, deleted}, SEQ - 1, _))
+        .WillOnce(Return(std::vector<data::Blob>{{7, 8, 9}, {}, {7, 8, 9}}));
+
+    auto const status = service.GetLedger(nullptr, &request, &response);
+    ASSERT_TRUE(status.ok());
+    EXPECT_TRUE(response.object_neighbors_included());
+
+    auto const& objects = response.ledger_objects().objects();
+    ASSERT_EQ(objects.size(), 3);
+    EXPECT_EQ(objects[0].key(), toString(modified));
+    EXPECT_TRUE(objects[0].predecessor().empty());
+    EXPECT_TRUE(objects[0].successor().empty());
+    EXPECT_EQ(objects[1].key(), toString(createdDir));
+    EXPECT_EQ(objects[1].predecessor(), toString(first));
+    EXPECT_EQ(objects[1].successor(), toString(modified));
+    EXPECT_EQ(objects[2].key(), toString(deleted));
+    EXPECT_EQ(objects[2].predecessor(), toString(first));
+    EXPECT_EQ(objects[2].successor(), toString(createdDir));
+
+    ASSERT_EQ(response.book_successors_size(), 1);
+    EXPECT_EQ(response.book_successors(0).book_base(), toString(bookBase));
+    EXPECT_EQ(response.book_successors(0).first_book(), toString(createdDir));
+}
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerWithObjectNeighborsFailsIfCacheIsNotFull)
+{
+    org::xrpl::rpc::v1::GetLedgerRequest request;
+    request.mutable_ledger()->set_sequence(SEQ);
+    request.set_get_objects(true);
+    request.set_get_object_neighbors(true);
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+
+    auto const created = ripple::uint256{2};
+
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ)));
+    EXPECT_CALL(*backend, fetchLedgerDiff(SEQ, _))
+        .WillOnce(Return(std::vector<data::LedgerObject>{{created, {4, 5, 6}}}));
+    EXPECT_CALL(*backend, doFetchLedgerObjects(std::vector<ripple::uint256>{created}, SEQ - 1, _))
+        .WillOnce(Return(std::vector<data::Blob>{{}}));
+
+    auto const status = service.GetLedger(nullptr, &request, &response);
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::FAILED_PRECONDITION);
+}
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerWithTransactionHashes)
+{
+    org::xrpl::rpc::v1::GetLedgerRequest request;
+    request.mutable_ledger()->set_sequence(SEQ);
+    request.set_transactions(true);
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ)));
+    EXPECT_CALL(*backend, fetchAllTransactionHashesInLedger(SEQ, _))
+        .WillOnce(Return(std::vector<ripple::uint256>{ripple::uint256{7}}));
+    EXPECT_CALL(*backend, fetchLedgerDiff).Times(0);
+
+    ASSERT_TRUE(service.GetLedger(nullptr, &request, &response).ok());
+    ASSERT_EQ(response.hashes_list().hashes_size(), 1);
+    EXPECT_EQ(response.hashes_list().hashes(0), toString(ripple::uint256{7}));
+    EXPECT_EQ(response.ledger_objects().objects_size(), 0);
+}
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerData)
+{
+    auto const marker = ripple::uint256{1};
+    auto const key1 = ripple::uint256{2};
+    auto const key2 = ripple::uint256{3};
+
+    org::xrpl::rpc::v1::GetLedgerDataRequest request;
+    request.mutable_ledger()->set_sequence(SEQ);
+    request.set_marker(marker.data(), ripple::uint256::size());
+    org::xrpl::rpc::v1::GetLedgerDataResponse response;
+
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ)));
+    EXPECT_CALL(*backend, doFetchSuccessorKey(marker, SEQ, _)).WillOnce(Return(key1));
+    EXPECT_CALL(*backend, doFetchSuccessorKey(key1, SEQ, _)).WillOnce(Return(key2));
+    EXPECT_CALL(*backend, doFetchSuccessorKey(key2, SEQ, _)).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*backend, doFetchLedgerObjects(std::vector<ripple::uint256>{key1, key2}, SEQ, _))
+        .WillOnce(Return(std::vector<data::Blob>{{1}, {2}}));
+
+    ASSERT_TRUE(service.GetLedgerData(nullptr, &request, &response).ok());
+    EXPECT_EQ(response.ledger_index(), SEQ);
+    EXPECT_EQ(response.ledger_hash(), toString(ripple::uint256{LEDGERHASH}));
+    ASSERT_EQ(response.ledger_objects().objects_size(), 2);
+    EXPECT_EQ(response.ledger_objects().objects(0).key(), toString(key1));
+    EXPECT_EQ(response.ledger_objects().objects(1).data(), std::string("\x02"));
+    EXPECT_TRUE(response.marker().empty());
+}
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerDataStopsAtEndMarker)
+{
+    auto const key1 = ripple::uint256{2};
+    auto const key2 = ripple::uint256{3};
+
+    org::xrpl::rpc::v1::GetLedgerDataRequest request;
+    request.mutable_ledger()->set_sequence(SEQ);
+    request.set_end_marker(key1.data(), ripple::uint256::size());
+    org::xrpl::rpc::v1::GetLedgerDataResponse response;
+
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ)));
+    EXPECT_CALL(*backend, doFetchSuccessorKey(data::firstKey, SEQ, _)).WillOnce(Return(key1));
+    EXPECT_CALL(*backend, doFetchSuccessorKey(key1, SEQ, _)).WillOnce(Return(key2));
+    EXPECT_CALL(*backend, doFetchSuccessorKey(key2, SEQ, _)).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*backend, doFetchLedgerObjects).WillOnce(Return(std::vector<data::Blob>{{1}, {2}}));
+
+    ASSERT_TRUE(service.GetLedgerData(nullptr, &request, &response).ok());
+    ASSERT_EQ(response.ledger_objects().objects_size(), 1);
+    EXPECT_EQ(response.ledger_objects().objects(0).key(), toString(key1));
+    EXPECT_TRUE(response.marker().empty());
+}
+
+TEST_F(GrpcLedgerServiceTests, GetLedgerDataMalformedMarker)
+{
+    org::xrpl::rpc::v1::GetLedgerDataRequest request;
+    request.mutable_ledger()->set_sequence(SEQ);
+    request.set_marker("abc");
+    org::xrpl::rpc::v1::GetLedgerDataResponse response;
+
+    EXPECT_EQ(service.GetLedgerData(nullptr, &request, &response).error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+}
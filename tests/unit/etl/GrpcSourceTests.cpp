@@ -17,6 +17,8 @@
 */
 //==============================================================================
 
+#include "data/DBHelpers.hpp"
+#include "data/Types.hpp"
 #include "etl/impl/GrpcSource.hpp"
 #include "util/LoggerFixtures.hpp"
 #include "util/MockBackend.hpp"
@@ -24,6 +26,8 @@
 #include "util/MockXrpLedgerAPIService.hpp"
 #include "util/TestObject.hpp"
 #include "util/config/Config.hpp"
+#include "util/prometheus/Label.hpp"
+#include "util/prometheus/Prometheus.hpp"
 
 #include <gmock/gmock.h>
 #include <grpcpp/server_context.h>
@@ -149,3 +153,91 @@ TEST_F(GrpcSourceLoadInitialLedgerTests, worksFine)
     EXPECT_TRUE(success);
     EXPECT_EQ(data, std::vector<std::string>(4, keyStr));
 }
+
+TEST_F(GrpcSourceLoadInitialLedgerTests, reportsObjectsLoadedPerMarker)
+{
+    auto const object = CreateTicketLedgerObject("rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn", sequence_);
+    auto const objectData = object.getSerializer().peekData();
+
+    EXPECT_CALL(mockXrpLedgerAPIService, GetLedgerData)
+        .Times(numMarkers_)
+        .WillRepeatedly([&](grpc::ServerContext* /*context*/,
+                            org::xrpl::rpc::v1::GetLedgerDataRequest const* request,
+                            org::xrpl::rpc::v1::GetLedgerDataResponse* response) {
+            // two objects at the start of each marker range
+            auto const prefix = request->marker().empty() ? '\0' : request->marker()[0];
+            for (unsigned char i = 1; i <= 2; ++i) {
+                auto key = ripple::uint256{i};
+                key.data()[0] = prefix;
+
+                auto newObject = response->mutable_ledger_objects()->add_objects();
+                newObject->set_key(key.data(), ripple::uint256::size());
+                newObject->set_data(objectData.data(), objectData.size());
+            }
+
+            return grpc::Status{};
+        });
+
+    EXPECT_CALL(*mockBackend_, writeNFTs).Times(numMarkers_);
+    EXPECT_CALL(*mockBackend_, writeLedgerObject).Times(numMarkers_ * 2);
+    EXPECT_CALL(*mockBackend_, writeSuccessor).Times(numMarkers_);
+
+    auto const [data, success] = grpcSource_.loadInitialLedger(sequence_, numMarkers_, cacheOnly_);
+    EXPECT_TRUE(success);
+    EXPECT_EQ(data.size(), numMarkers_);
+
+    for (auto const* marker : {"00", "40", "80", "C0"}) {
+        auto const& counter = PrometheusService::counterInt(
+            "etl_initial_load_objects_total_number",
+            util::prometheus::Labels({util::prometheus::Label{"marker", marker}})
+        );
+        EXPECT_EQ(counter.value(), 2) << marker;
+    }
+}
+
+TEST_F(GrpcSourceLoadInitialLedgerTests, loadLedgerStateWritesObjectsAndLinksMarkersInDatabaseOnly)
+{
+    auto const object = CreateTicketLedgerObject("rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn", sequence_);
+    auto const objectData = object.getSerializer().peekData();
+    auto const makeKey = [](unsigned char prefix, unsigned char i) {
+        auto key = ripple::uint256{i};
+        key.data()[0] = prefix;
+        return uint256ToString(key);
+    };
+
+    EXPECT_CALL(mockXrpLedgerAPIService, GetLedgerData)
+        .Times(numMarkers_)
+        .WillRepeatedly([&](grpc::ServerContext* /*context*/,
+                            org::xrpl::rpc::v1::GetLedgerDataRequest const* request,
+                            org::xrpl::rpc::v1::GetLedgerDataResponse* response) {
+            auto const prefix = request->marker().empty() ? '\0' : request->marker()[0];
+            for (unsigned char i = 1; i <= 2; ++i) {
+                auto const key = makeKey(prefix, i);
+                auto newObject = response->mutable_ledger_objects()->add_objects();
+                newObject->set_key(key);
+                newObject->set_data(objectData.data(), objectData.size());
+            }
+
+            return grpc::Status{};
+        });
+
+    EXPECT_CALL(*mockBackend_, writeNFTs).Times(numMarkers_);
+    EXPECT_CALL(*mockBackend_, writeLedgerStateObject(testing::_, sequence_, testing::_)).Times(numMarkers_ * 2);
+
+    auto prev = uint256ToString(data::firstKey);
+    for (unsigned char const prefix : {0x00, 0x40, 0x80, 0xC0}) {
+        EXPECT_CALL(*mockBackend_, writeSuccessor(makeKey(prefix, 1), sequence_, makeKey(prefix, 2)));
+        EXPECT_CALL(*mockBackend_, writeSuccessor(std::string{prev}, sequence_, makeKey(prefix, 1)));
+        prev = makeKey(prefix, 2);
+    }
+    EXPECT_CALL(*mockBackend_, writeSuccessor(std::string{prev}, sequence_, uint256ToString(data::lastKey)));
+
+    EXPECT_TRUE(grpcSource_.loadLedgerState(sequence_, numMarkers_));
+    EXPECT_EQ(mockBackend_->cache().size(), 0);
+}
+
+TEST_F(GrpcSourceTests, loadLedgerStateNoStub)
+{
+    testing::StrictMock<GrpcSource> wrongGrpcSource{"wrong", "wrong", mockBackend_};
+    EXPECT_FALSE(wrongGrpcSource.loadLedgerState(0, 0));
+}
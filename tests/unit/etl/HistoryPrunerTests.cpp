@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/DBHelpers.hpp"
+#include "data/Types.hpp"
+#include "etl/HistoryPruner.hpp"
+#include "etl/SystemState.hpp"
+#include "util/MockBackendTestFixture.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/TestObject.hpp"
+#include "util/config/Config.hpp"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <xrpl/basics/base_uint.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace json = boost::json;
+using namespace etl;
+using namespace data;
+using namespace testing;
+
+namespace {
+
+constexpr auto ACCOUNT = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+constexpr auto ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
+constexpr auto LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+constexpr auto KEY = "1B8590C01B0006EDFA9ED60296DD052DC5E90F99659B25014D08E1BC983515BC";
+
+}  // namespace
+
+struct HistoryPrunerSettingsTest : Test {};
+
+TEST_F(HistoryPrunerSettingsTest, DefaultSettingsParsedCorrectly)
+{
+    auto const cfg = util::Config{json::parse(R"({})")};
+    auto const settings = make_HistoryPrunerSettings(cfg);
+
+    EXPECT_EQ(settings, HistoryPrunerSettings{});
+    EXPECT_FALSE(settings.isEnabled());
+}
+
+TEST_F(HistoryPrunerSettingsTest, ValuesCorrectlyPropagatedThroughConfig)
+{
+    auto const cfg = util::Config{json::parse(R"({
+        "online_delete": {
+            "min_sequence": 1000,
+            "retain_ledgers": 500,
+            "step": 42,
+            "max_ledgers_per_second": 7,
+            "interval": 30
+        }
+    })")};
+    auto const settings = make_HistoryPrunerSettings(cfg);
+
+    EXPECT_TRUE(settings.isEnabled());
+    EXPECT_EQ(settings.minSequence, 1000);
+    EXPECT_EQ(settings.retainLedgers, 500);
+    EXPECT_EQ(settings.step, 42);
+    EXPECT_EQ(settings.maxLedgersPerSecond, 7);
+    EXPECT_EQ(settings.intervalSeconds, 30);
+}
+
+TEST_F(HistoryPrunerSettingsTest, ZeroRetainLedgersThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"online_delete": {"retain_ledgers": 0}})")};
+    EXPECT_THROW(make_HistoryPrunerSettings(cfg), std::runtime_error);
+}
+
+TEST_F(HistoryPrunerSettingsTest, ZeroStepThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"online_delete": {"retain_ledgers": 10, "step": 0}})")};
+    EXPECT_THROW(make_HistoryPrunerSettings(cfg), std::runtime_error);
+}
+
+TEST_F(HistoryPrunerSettingsTest, TargetMinSequence)
+{
+    auto const retainOnly = HistoryPrunerSettings{.retainLedgers = 10};
+    EXPECT_EQ(retainOnly.targetMinSequence(100), 91);
+    EXPECT_EQ(retainOnly.targetMinSequence(5), std::nullopt);
+
+    auto const minOnly = HistoryPrunerSettings{.minSequence = 50};
+    EXPECT_EQ(minOnly.targetMinSequence(100), 50);
+    EXPECT_EQ(minOnly.targetMinSequence(20), 20);
+
+    auto const both = HistoryPrunerSettings{.minSequence = 50, .retainLedgers = 10};
+    EXPECT_EQ(both.targetMinSequence(100), 91);
+    EXPECT_EQ(both.targetMinSequence(55), 50);
+
+    EXPECT_EQ(HistoryPrunerSettings{}.targetMinSequence(100), std::nullopt);
+}
+
+struct HistoryPrunerTest : util::prometheus::WithPrometheus, MockBackendTest {
+    SystemState state;
+};
+
+TEST_F(HistoryPrunerTest, NothingToPrune)
+{
+    HistoryPruner pruner{HistoryPrunerSettings{.retainLedgers = 100, .maxLedgersPerSecond = 0}, backend, state};
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 10, .maxSequence = 50}));
+    EXPECT_CALL(*backend, advanceMinSequence).Times(0);
+    EXPECT_CALL(*backend, deleteLedgerHistory).Times(0);
+
+    EXPECT_EQ(pruner.prune(), 0);
+}
+
+TEST_F(HistoryPrunerTest, AdvancesMinBeforeDeletingEachStep)
+{
+    HistoryPruner pruner{
+        HistoryPrunerSettings{.retainLedgers = 5, .step = 3, .maxLedgersPerSecond = 0}, backend, state
+    };
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 10, .maxSequence = 20}));
+
+    Sequence const s;
+    EXPECT_CALL(*backend, advanceMinSequence(10, 13)).InSequence(s).WillOnce(Return(true));
+    for (std::uint32_t seq = 10; seq < 13; ++seq)
+        EXPECT_CALL(*backend, deleteLedgerHistory(Field(&LedgerHistoryData::ledgerSequence, seq), 13, _)).InSequence(s);
+    EXPECT_CALL(*backend, advanceMinSequence(13, 16)).InSequence(s).WillOnce(Return(true));
+    for (std::uint32_t seq = 13; seq < 16; ++seq)
+        EXPECT_CALL(*backend, deleteLedgerHistory(Field(&LedgerHistoryData::ledgerSequence, seq), 16, _)).InSequence(s);
+
+    EXPECT_EQ(pruner.prune(), 6);
+}
+
+TEST_F(HistoryPrunerTest, DeletionIsRateLimited)
+{
+    static constexpr auto RATE = 50u;
+    static constexpr auto NUM_LEDGERS = 6u;
+    HistoryPruner pruner{
+        HistoryPrunerSettings{.minSequence = 10 + NUM_LEDGERS, .maxLedgersPerSecond = RATE}, backend, state
+    };
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 10, .maxSequence = 30}));
+    EXPECT_CALL(*backend, advanceMinSequence).WillOnce(Return(true));
+    EXPECT_CALL(*backend, deleteLedgerHistory).Times(NUM_LEDGERS);
+
+    auto const start = std::chrono::steady_clock::now();
+    EXPECT_EQ(pruner.prune(), NUM_LEDGERS);
+
+    // the first ledger is deleted right away, each of the others one period after the previous one
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{1000} / RATE * (NUM_LEDGERS - 1));
+}
+
+TEST_F(HistoryPrunerTest, StopsWhenMinWasChangedByAnotherProcess)
+{
+    HistoryPruner pruner{HistoryPrunerSettings{.minSequence = 20, .maxLedgersPerSecond = 0}, backend, state};
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange).WillOnce(Return(LedgerRange{.minSequence = 10, .maxSequence = 30}));
+    EXPECT_CALL(*backend, advanceMinSequence(10, 20)).WillOnce(Return(false));
+    EXPECT_CALL(*backend, deleteLedgerHistory).Times(0);
+
+    EXPECT_EQ(pruner.prune(), 0);
+}
+
+TEST_F(HistoryPrunerTest, CollectsEverythingReferencingTheLedger)
+{
+    static constexpr std::uint32_t SEQ = 10;
+    HistoryPruner pruner{HistoryPrunerSettings{.minSequence = SEQ + 1, .maxLedgersPerSecond = 0}, backend, state};
+
+    EXPECT_CALL(*backend, hardFetchLedgerRange)
+        .WillOnce(Return(LedgerRange{.minSequence = SEQ, .maxSequence = SEQ + 5}));
+    EXPECT_CALL(*backend, advanceMinSequence(SEQ, SEQ + 1)).WillOnce(Return(true));
+    EXPECT_CALL(*backend, fetchLedgerBySequence(SEQ, _)).WillOnce(Return(CreateLedgerHeader(LEDGERHASH, SEQ)));
+
+    TransactionAndMetadata txn;
+    txn.transaction = CreatePaymentTransactionObject(ACCOUNT, ACCOUNT2, 100, 3, SEQ).getSerializer().peekData();
+    txn.metadata = CreatePaymentTransactionMetaObject(ACCOUNT, ACCOUNT2, 110, 30).getSerializer().peekData();
+    txn.ledgerSequence = SEQ;
+    EXPECT_CALL(*backend, fetchAllTransactionsInLedger(SEQ, _))
+        .WillOnce(Return(std::vector<TransactionAndMetadata>{txn}));
+    EXPECT_CALL(*backend, fetchLedgerDiff(SEQ, _))
+        .WillOnce(Return(std::vector<LedgerObject>{{.key = ripple::uint256{KEY}, .blob = Blob{'s'}}}));
+
+    LedgerHistoryData deleted;
+    EXPECT_CALL(*backend, deleteLedgerHistory(_, SEQ + 1, _)).WillOnce(SaveArg<0>(&deleted));
+
+    EXPECT_EQ(pruner.prune(), 1);
+    EXPECT_EQ(deleted.ledgerSequence, SEQ);
+    EXPECT_EQ(deleted.ledgerHash, ripple::uint256{LEDGERHASH});
+    EXPECT_EQ(deleted.txHashes.size(), 1);
+    EXPECT_EQ(deleted.accounts.size(), 2);
+    EXPECT_TRUE(deleted.nftIDs.empty());
+    EXPECT_EQ(deleted.objectKeys, std::vector<ripple::uint256>{ripple::uint256{KEY}});
+}
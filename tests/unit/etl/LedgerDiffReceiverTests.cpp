@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/LedgerDiffBroadcaster.hpp"
+#include "etl/impl/LedgerDiffReceiver.hpp"
+#include "etl/impl/LedgerStreamHandshake.hpp"
+#include "util/AsioContextTestFixture.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/TestObject.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/write.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <xrpl/basics/base_uint.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace etl::impl;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr auto LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+constexpr auto SEQ = 30;
+constexpr auto SECRET = "secret";
+
+CommittedLedger
+makeLedger(std::uint32_t seq)
+{
+    return CommittedLedger{.header = CreateLedgerHeader(LEDGERHASH, seq), .diff = {{ripple::uint256{1}, {1, 2}}}};
+}
+
+}  // namespace
+
+struct LedgerDiffReceiverTests : util::prometheus::WithPrometheus, AsyncAsioContextTest {
+    void
+    TearDown() override
+    {
+        receiver->stop();
+    }
+
+    std::shared_ptr<LedgerDiffReceiver> receiver =
+        std::make_shared<LedgerDiffReceiver>(ctx, std::vector<LedgerDiffReceiver::Peer>{}, SECRET);
+};
+
+TEST_F(LedgerDiffReceiverTests, ReturnsPushedLedger)
+{
+    receiver->push(makeLedger(SEQ));
+
+    auto const ledger = receiver->waitFor(SEQ, 0ms);
+    ASSERT_TRUE(ledger);
+    EXPECT_EQ(ledger->header.seq, SEQ);
+    EXPECT_EQ(ledger->diff.size(), 1);
+
+    // a ledger is handed out only once
+    EXPECT_FALSE(receiver->waitFor(SEQ, 0ms));
+}
+
+TEST_F(LedgerDiffReceiverTests, DoesNotWaitIfNothingWasReceived)
+{
+    auto const start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(receiver->waitFor(SEQ, 10s));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST_F(LedgerDiffReceiverTests, StopsWaitingIfNewerLedgerWasReceived)
+{
+    receiver->push(makeLedger(SEQ + 1));
+
+    auto const start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(receiver->waitFor(SEQ, 10s));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+
+    EXPECT_TRUE(receiver->waitFor(SEQ + 1, 0ms));
+}
+
+TEST_F(LedgerDiffReceiverTests, WaitsForLedger)
+{
+    receiver->push(makeLedger(SEQ - 1));
+
+    std::thread pusher{[this]() {
+        std::this_thread::sleep_for(10ms);
+        receiver->push(makeLedger(SEQ));
+    }};
+
+    auto const ledger = receiver->waitFor(SEQ, 10s);
+    pusher.join();
+
+    ASSERT_TRUE(ledger);
+    EXPECT_EQ(ledger->header.seq, SEQ);
+}
+
+TEST_F(LedgerDiffReceiverTests, ReceivesLedgerFromBroadcaster)
+{
+    auto broadcaster = std::make_shared<LedgerDiffBroadcaster>(ctx, "127.0.0.1", 0, SECRET, 16);
+    broadcaster->run();
+
+    receiver = std::make_shared<LedgerDiffReceiver>(
+        ctx,
+        std::vector<LedgerDiffReceiver::Peer>{{.ip = "127.0.0.1", .port = std::to_string(broadcaster->port())}},
+        SECRET
+    );
+    receiver->run();
+
+    // ledgers broadcast before the receiver is connected are not sent to it
+    std::optional<CommittedLedger> ledger;
+    for (auto i = 0; i < 500 and not ledger; ++i) {
+        broadcaster->broadcast(makeLedger(SEQ));
+        std::this_thread::sleep_for(10ms);
+        ledger = receiver->waitFor(SEQ, 0ms);
+    }
+
+    broadcaster->stop();
+
+    ASSERT_TRUE(ledger);
+    EXPECT_EQ(ledger->header.seq, SEQ);
+    EXPECT_EQ(ledger->diff, makeLedger(SEQ).diff);
+}
+
+TEST_F(LedgerDiffReceiverTests, DoesNotReceiveLedgersWithWrongSecret)
+{
+    auto broadcaster = std::make_shared<LedgerDiffBroadcaster>(ctx, "127.0.0.1", 0, SECRET, 16);
+    broadcaster->run();
+
+    receiver = std::make_shared<LedgerDiffReceiver>(
+        ctx,
+        std::vector<LedgerDiffReceiver::Peer>{{.ip = "127.0.0.1", .port = std::to_string(broadcaster->port())}},
+        "wrong secret"
+    );
+    receiver->run();
+
+    std::optional<CommittedLedger> ledger;
+    for (auto i = 0; i < 20 and not ledger; ++i) {
+        broadcaster->broadcast(makeLedger(SEQ));
+        std::this_thread::sleep_for(10ms);
+        ledger = receiver->waitFor(SEQ, 0ms);
+    }
+
+    broadcaster->stop();
+
+    EXPECT_FALSE(ledger);
+}
+
+TEST_F(LedgerDiffReceiverTests, DropsConnectionOnFrameWithInvalidMac)
+{
+    boost::asio::ip::tcp::acceptor acceptor{ctx, {boost::asio::ip::make_address("127.0.0.1"), 0}};
+
+    // a broadcaster that knows the secret for the handshake, but whose second frame is tampered with
+    boost::asio::spawn(ctx, [&](boost::asio::yield_context yield) {
+        auto socket = std::make_shared<boost::asio::ip::tcp::socket>(ctx);
+        acceptor.async_accept(*socket, yield);
+
+        auto session = LedgerStreamHandshake{SECRET}.accept(socket, yield);
+        ASSERT_TRUE(session);
+
+        for (auto const seq : {SEQ, SEQ + 1}) {
+            auto const payload = makeLedger(seq).serialize();
+            auto const size = static_cast<std::uint32_t>(payload.size());
+            std::array<unsigned char, 4> const sizeBuffer = {
+                static_cast<unsigned char>(size >> 24),
+                static_cast<unsigned char>(size >> 16),
+                static_cast<unsigned char>(size >> 8),
+                static_cast<unsigned char>(size)
+            };
+
+            auto mac = session->sign(payload);
+            if (seq != SEQ)
+                mac[0] ^= 1;
+
+            std::array const buffers = {
+                boost::asio::buffer(sizeBuffer), boost::asio::buffer(payload), boost::asio::buffer(mac)
+            };
+            boost::asio::async_write(*socket, buffers, yield);
+        }
+    });
+
+    receiver = std::make_shared<LedgerDiffReceiver>(
+        ctx,
+        std::vector<LedgerDiffReceiver::Peer>{
+            {.ip = "127.0.0.1", .port = std::to_string(acceptor.local_endpoint().port())}
+        },
+        SECRET
+    );
+    receiver->run();
+
+    std::optional<CommittedLedger> ledger;
+    for (auto i = 0; i < 500 and not ledger; ++i) {
+        std::this_thread::sleep_for(10ms);
+        ledger = receiver->waitFor(SEQ, 0ms);
+    }
+
+    ASSERT_TRUE(ledger);
+    EXPECT_FALSE(receiver->waitFor(SEQ + 1, 500ms));
+
+    boost::asio::post(ctx, [&acceptor]() { acceptor.close(); });
+}
+
+TEST(LedgerStreamSessionTests, VerifiesFramesInTheOrderTheyWereSigned)
+{
+    auto const key = ripple::uint256{42};
+    LedgerStreamSession sender{key};
+    LedgerStreamSession receiver{key};
+
+    auto const first = sender.sign("first");
+    auto const second = sender.sign("second");
+
+    EXPECT_TRUE(receiver.verify("first", first));
+    EXPECT_TRUE(receiver.verify("second", second));
+}
+
+TEST(LedgerStreamSessionTests, RejectsTamperedFrame)
+{
+    auto const key = ripple::uint256{42};
+    LedgerStreamSession sender{key};
+    LedgerStreamSession receiver{key};
+
+    EXPECT_FALSE(receiver.verify("tampered", sender.sign("frame")));
+}
+
+TEST(LedgerStreamSessionTests, RejectsReplayedFrame)
+{
+    auto const key = ripple::uint256{42};
+    LedgerStreamSession sender{key};
+    LedgerStreamSession receiver{key};
+
+    auto const mac = sender.sign("frame");
+    EXPECT_TRUE(receiver.verify("frame", mac));
+    EXPECT_FALSE(receiver.verify("frame", mac));
+}
+
+TEST(LedgerStreamSessionTests, RejectsFrameOfAnotherSession)
+{
+    LedgerStreamSession sender{ripple::uint256{42}};
+    LedgerStreamSession receiver{ripple::uint256{43}};
+
+    EXPECT_FALSE(receiver.verify("frame", sender.sign("frame")));
+}
@@ -20,6 +20,7 @@
 #include "data/DBHelpers.hpp"
 #include "data/Types.hpp"
 #include "etl/SystemState.hpp"
+#include "etl/impl/CommittedLedger.hpp"
 #include "etl/impl/LedgerPublisher.hpp"
 #include "util/AsioContextTestFixture.hpp"
 #include "util/MockBackendTestFixture.hpp"
@@ -34,6 +35,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <xrpl/basics/chrono.h>
+#include <xrpl/protocol/Fees.h>
 #include <xrpl/protocol/Indexes.h>
 #include <xrpl/protocol/LedgerHeader.h>
 
@@ -111,6 +113,24 @@ TEST_F(ETLLedgerPublisherTest, PublishLedgerHeaderIsWritingFalseAndCacheEnabled)
     EXPECT_EQ(backend->fetchLedgerRange().value().maxSequence, SEQ);
 }
 
+TEST_F(ETLLedgerPublisherTest, PublishCommittedLedgerIsWritingFalseUpdatesCacheFromDiff)
+{
+    SystemState dummyState;
+    dummyState.isWriting = false;
+    auto const dummyLedgerHeader = CreateLedgerHeader(LEDGERHASH, SEQ, AGE);
+    auto const diff = std::vector<LedgerObject>{{.key = ripple::uint256{1}, .blob = {1, 2, 3}}};
+
+    impl::LedgerPublisher publisher(ctx, backend, mockCache, mockSubscriptionManagerPtr, dummyState);
+    publisher.publish(impl::CommittedLedger{.header = dummyLedgerHeader, .diff = diff});
+    EXPECT_CALL(mockCache, isDisabled).WillOnce(Return(false));
+    EXPECT_CALL(*backend, fetchLedgerDiff).Times(0);
+    EXPECT_CALL(mockCache, updateImp(diff, SEQ, false));
+
+    ctx.run();
+    EXPECT_TRUE(backend->fetchLedgerRange());
+    EXPECT_EQ(backend->fetchLedgerRange().value().maxSequence, SEQ);
+}
+
 TEST_F(ETLLedgerPublisherTest, PublishLedgerHeaderIsWritingTrue)
 {
     SystemState dummyState;
@@ -206,6 +226,37 @@ TEST_F(ETLLedgerPublisherTest, PublishLedgerHeaderCloseTimeGreaterThanNow)
     EXPECT_TRUE(publisher.lastPublishAgeSeconds() <= 1);
 }
 
+TEST_F(ETLLedgerPublisherTest, PublishLedgerHeaderWithHandedOverDataDoesNotReadDB)
+{
+    SystemState dummyState;
+    dummyState.isWriting = true;
+
+    auto const dummyLedgerHeader = CreateLedgerHeader(LEDGERHASH, SEQ, 0);
+    backend->setRange(SEQ - 1, SEQ);
+
+    TransactionAndMetadata t1;
+    t1.transaction = CreatePaymentTransactionObject(ACCOUNT, ACCOUNT2, 100, 3, SEQ).getSerializer().peekData();
+    t1.metadata = CreatePaymentTransactionMetaObject(ACCOUNT, ACCOUNT2, 110, 30).getSerializer().peekData();
+    t1.ledgerSequence = SEQ;
+
+    ripple::Fees fees;
+    fees.base = ripple::XRPAmount{10};
+
+    impl::LedgerPublisher publisher(ctx, backend, mockCache, mockSubscriptionManagerPtr, dummyState);
+    publisher.publish(impl::CommittedLedger{.header = dummyLedgerHeader, .transactions = {t1}, .fees = fees});
+
+    // the strict backend fails the test if fees or transactions are fetched
+    EXPECT_CALL(
+        *mockSubscriptionManagerPtr,
+        pubLedger(_, Field(&ripple::Fees::base, fees.base), fmt::format("{}-{}", SEQ - 1, SEQ), 1)
+    );
+    EXPECT_CALL(*mockSubscriptionManagerPtr, pubBookChanges);
+    EXPECT_CALL(*mockSubscriptionManagerPtr, pubTransaction);
+
+    ctx.run();
+    EXPECT_TRUE(publisher.lastPublishAgeSeconds() <= 1);
+}
+
 TEST_F(ETLLedgerPublisherTest, PublishLedgerSeqStopIsTrue)
 {
     SystemState dummyState;
@@ -286,8 +337,8 @@ TEST_F(ETLLedgerPublisherTest, PublishMultipleTxInOrder)
     EXPECT_CALL(*mockSubscriptionManagerPtr, pubBookChanges);
     // should call pubTransaction t2 first (greater tx index)
     Sequence const s;
-    EXPECT_CALL(*mockSubscriptionManagerPtr, pubTransaction(t2, _)).InSequence(s);
-    EXPECT_CALL(*mockSubscriptionManagerPtr, pubTransaction(t1, _)).InSequence(s);
+    EXPECT_CALL(*mockSubscriptionManagerPtr, pubTransaction(t2, _, _)).InSequence(s);
+    EXPECT_CALL(*mockSubscriptionManagerPtr, pubTransaction(t1, _, _)).InSequence(s);
 
     ctx.run();
     // last publish time should be set
@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/LedgerRecording.hpp"
+#include "util/TestObject.hpp"
+#include "util/TmpFile.hpp"
+
+#include <gtest/gtest.h>
+#include <xrpl/proto/org/xrpl/rpc/v1/xrp_ledger.grpc.pb.h>
+#include <xrpl/protocol/LedgerHeader.h>
+#include <xrpl/protocol/Serializer.h>
+
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+
+using namespace etl::impl;
+
+namespace {
+
+constexpr auto LEDGERHASH = "4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652";
+constexpr uint32_t SEQ = 30;
+
+org::xrpl::rpc::v1::GetLedgerResponse
+makeLedger(uint32_t seq)
+{
+    ripple::Serializer serializer;
+    ripple::addRaw(CreateLedgerHeader(LEDGERHASH, seq), serializer, /* includeHash = */ true);
+
+    org::xrpl::rpc::v1::GetLedgerResponse response;
+    response.set_ledger_header(serializer.peekData().data(), serializer.peekData().size());
+    response.set_validated(true);
+    response.set_object_neighbors_included(true);
+
+    auto* object = response.mutable_ledger_objects()->add_objects();
+    object->set_key(std::string(32, static_cast<char>(seq)));
+    object->set_data("data");
+    object->set_mod_type(org::xrpl::rpc::v1::RawLedgerObject::CREATED);
+    return response;
+}
+
+}  // namespace
+
+struct LedgerRecordingTests : ::testing::Test {
+    TmpFile const file_{""};
+};
+
+TEST_F(LedgerRecordingTests, RecordAndReplay)
+{
+    {
+        LedgerRecorder recorder{file_.path};
+        recorder.record(makeLedger(SEQ));
+        recorder.record(makeLedger(SEQ + 1));
+        recorder.record(makeLedger(SEQ + 3));
+    }
+
+    LedgerReplay const replay{file_.path};
+    EXPECT_EQ(replay.size(), 3);
+    EXPECT_EQ(replay.firstSequence(), SEQ);
+    EXPECT_EQ(replay.lastSequence(), SEQ + 3);
+
+    auto const ledger = replay.fetchLedger(SEQ + 1, true, true);
+    ASSERT_TRUE(ledger.has_value());
+    EXPECT_EQ(ledger->SerializeAsString(), makeLedger(SEQ + 1).SerializeAsString());
+
+    EXPECT_FALSE(replay.fetchLedger(SEQ + 2, true, true).has_value());
+}
+
+TEST_F(LedgerRecordingTests, EmptyRecording)
+{
+    {
+        LedgerRecorder const recorder{file_.path};
+    }
+
+    LedgerReplay const replay{file_.path};
+    EXPECT_EQ(replay.size(), 0);
+    EXPECT_FALSE(replay.firstSequence().has_value());
+    EXPECT_FALSE(replay.lastSequence().has_value());
+}
+
+TEST_F(LedgerRecordingTests, ReplayFromMemory)
+{
+    LedgerReplay const replay{{makeLedger(SEQ + 1), makeLedger(SEQ)}};
+    EXPECT_EQ(replay.size(), 2);
+    EXPECT_EQ(replay.firstSequence(), SEQ);
+    EXPECT_EQ(replay.lastSequence(), SEQ + 1);
+    EXPECT_TRUE(replay.loadInitialLedger(SEQ).empty());
+}
+
+TEST_F(LedgerRecordingTests, NotARecording)
+{
+    TmpFile const file{"not a recording"};
+    EXPECT_THROW(LedgerReplay{file.path}, std::runtime_error);
+}
+
+TEST_F(LedgerRecordingTests, TruncatedRecording)
+{
+    {
+        LedgerRecorder recorder{file_.path};
+        recorder.record(makeLedger(SEQ));
+    }
+    {
+        std::ofstream file{file_.path, std::ios::binary | std::ios::app};
+        file << '\0' << '\0';
+    }
+
+    EXPECT_THROW(LedgerReplay{file_.path}, std::runtime_error);
+}
+
+TEST_F(LedgerRecordingTests, MissingFile)
+{
+    EXPECT_THROW(LedgerReplay{"/nonexistent/recording"}, std::runtime_error);
+    EXPECT_THROW(LedgerRecorder{"/nonexistent/recording"}, std::runtime_error);
+}
@@ -19,6 +19,7 @@
 
 #include "etl/LoadBalancer.hpp"
 #include "etl/Source.hpp"
+#include "etl/impl/LedgerRecording.hpp"
 #include "rpc/Errors.hpp"
 #include "util/AsioContextTestFixture.hpp"
 #include "util/MockBackendTestFixture.hpp"
@@ -28,10 +29,13 @@
 #include "util/MockSubscriptionManager.hpp"
 #include "util/NameGenerator.hpp"
 #include "util/Random.hpp"
+#include "util/TestObject.hpp"
+#include "util/TmpFile.hpp"
 #include "util/config/Config.hpp"
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/json/array.hpp>
 #include <boost/json/object.hpp>
 #include <boost/json/parse.hpp>
@@ -40,6 +44,8 @@
 #include <grpcpp/support/status.h>
 #include <gtest/gtest.h>
 #include <org/xrpl/rpc/v1/get_ledger.pb.h>
+#include <xrpl/protocol/LedgerHeader.h>
+#include <xrpl/protocol/Serializer.h>
 
 #include <chrono>
 #include <cstdint>
@@ -61,10 +67,10 @@ struct LoadBalancerConstructorTests : util::prometheus::WithPrometheus, MockBack
     boost::asio::io_context ioContext_;
     boost::json::value configJson_{{"etl_sources", {"source1", "source2"}}};
 
-    std::unique_ptr<LoadBalancer>
+    std::shared_ptr<LoadBalancer>
     makeLoadBalancer()
     {
-        return std::make_unique<LoadBalancer>(
+        return std::make_shared<LoadBalancer>(
             util::Config{configJson_},
             ioContext_,
             backend,
@@ -200,6 +206,13 @@ TEST_F(LoadBalancerConstructorDeathTest, numMarkersSpecifiedInConfigIsInvalid)
     EXPECT_DEATH({ makeLoadBalancer(); }, ".*");
 }
 
+TEST_F(LoadBalancerConstructorTests, idempotentCommandsMustBeReadOnly)
+{
+    configJson_.as_object()["forwarding"] =
+        boost::json::object{{"idempotent_commands", boost::json::array{"fee", "submit"}}};
+    EXPECT_THROW({ makeLoadBalancer(); }, std::runtime_error);
+}
+
 struct LoadBalancerOnConnectHookTests : LoadBalancerConstructorTests {
     LoadBalancerOnConnectHookTests()
     {
@@ -210,7 +223,7 @@ struct LoadBalancerOnConnectHookTests : LoadBalancerConstructorTests {
         EXPECT_CALL(sourceFactory_.sourceAt(1), run);
         loadBalancer_ = makeLoadBalancer();
     }
-    std::unique_ptr<LoadBalancer> loadBalancer_;
+    std::shared_ptr<LoadBalancer> loadBalancer_;
 };
 
 TEST_F(LoadBalancerOnConnectHookTests, sourcesConnect)
@@ -343,7 +356,7 @@ struct LoadBalancer3SourcesTests : LoadBalancerConstructorTests {
         EXPECT_CALL(sourceFactory_.sourceAt(2), run);
         loadBalancer_ = makeLoadBalancer();
     }
-    std::unique_ptr<LoadBalancer> loadBalancer_;
+    std::shared_ptr<LoadBalancer> loadBalancer_;
 };
 
 TEST_F(LoadBalancer3SourcesTests, forwardingUpdate)
@@ -423,6 +436,24 @@ TEST_F(LoadBalancerLoadInitialLedgerTests, load_source0ReturnsStatusFalse)
     EXPECT_EQ(loadBalancer_->loadInitialLedger(sequence_, cacheOnly_), response_.first);
 }
 
+TEST_F(LoadBalancerLoadInitialLedgerTests, loadLedgerState)
+{
+    EXPECT_CALL(sourceFactory_.sourceAt(0), hasLedger(sequence_)).WillOnce(Return(true));
+    EXPECT_CALL(sourceFactory_.sourceAt(0), loadLedgerState(sequence_, numMarkers_)).WillOnce(Return(true));
+
+    loadBalancer_->loadLedgerState(sequence_);
+}
+
+TEST_F(LoadBalancerLoadInitialLedgerTests, loadLedgerState_source0ReturnsStatusFalse)
+{
+    EXPECT_CALL(sourceFactory_.sourceAt(0), hasLedger(sequence_)).WillOnce(Return(true));
+    EXPECT_CALL(sourceFactory_.sourceAt(0), loadLedgerState(sequence_, numMarkers_)).WillOnce(Return(false));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), hasLedger(sequence_)).WillOnce(Return(true));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), loadLedgerState(sequence_, numMarkers_)).WillOnce(Return(true));
+
+    loadBalancer_->loadLedgerState(sequence_);
+}
+
 struct LoadBalancerLoadInitialLedgerCustomNumMarkersTests : LoadBalancerConstructorTests {
     uint32_t const numMarkers_ = 16;
     uint32_t const sequence_ = 123;
@@ -521,6 +552,75 @@ TEST_F(LoadBalancerFetchLegerTests, fetch_bothSourcesFail)
                     .has_value());
 }
 
+TEST_F(LoadBalancerFetchLegerTests, fetch_disconnectedSourceIsSkipped)
+{
+    EXPECT_CALL(sourceFactory_.sourceAt(0), isConnected()).WillOnce(Return(false));
+    EXPECT_CALL(sourceFactory_.sourceAt(0), setForwarding(false));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), isConnected()).WillOnce(Return(true));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), setForwarding(true));
+    sourceFactory_.callbacksAt(1).onConnect();
+
+    EXPECT_CALL(sourceFactory_.sourceAt(1), hasLedger(sequence_)).WillOnce(Return(true));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), fetchLedger(sequence_, getObjects_, getObjectNeighbors_))
+        .WillOnce(Return(response_));
+
+    EXPECT_TRUE(loadBalancer_->fetchLedger(sequence_, getObjects_, getObjectNeighbors_).has_value());
+}
+
+struct LoadBalancerFetchLedgerRecordingTests : LoadBalancerConstructorTests {
+    LoadBalancerFetchLedgerRecordingTests()
+    {
+        configJson_.as_object()["etl_recording_file"] = recording_.path;
+
+        EXPECT_CALL(sourceFactory_, makeSource).Times(2);
+        EXPECT_CALL(sourceFactory_.sourceAt(0), forwardToRippled).WillOnce(Return(boost::json::object{}));
+        EXPECT_CALL(sourceFactory_.sourceAt(0), run);
+        EXPECT_CALL(sourceFactory_.sourceAt(1), forwardToRippled).WillOnce(Return(boost::json::object{}));
+        EXPECT_CALL(sourceFactory_.sourceAt(1), run);
+        loadBalancer_ = makeLoadBalancer();
+
+        util::Random::setSeed(0);
+
+        ripple::Serializer serializer;
+        ripple::addRaw(
+            CreateLedgerHeader("4BC50C9B0D8515D3EAAE1E74B29A95804346C491EE1A95BF25E4AAB854A6A652", sequence_),
+            serializer,
+            /* includeHash = */ true
+        );
+        response_.second.set_ledger_header(serializer.peekData().data(), serializer.peekData().size());
+        response_.second.set_validated(true);
+    }
+
+    TmpFile const recording_{""};
+    uint32_t const sequence_ = 123;
+    std::pair<grpc::Status, org::xrpl::rpc::v1::GetLedgerResponse> response_ =
+        std::make_pair(grpc::Status::OK, org::xrpl::rpc::v1::GetLedgerResponse{});
+    std::shared_ptr<LoadBalancer> loadBalancer_;
+};
+
+TEST_F(LoadBalancerFetchLedgerRecordingTests, diffIsRecordedWithNeighbors)
+{
+    EXPECT_CALL(sourceFactory_.sourceAt(0), hasLedger(sequence_)).WillOnce(Return(true));
+    EXPECT_CALL(sourceFactory_.sourceAt(0), fetchLedger(sequence_, true, true)).WillOnce(Return(response_));
+
+    EXPECT_TRUE(loadBalancer_->fetchLedger(sequence_, true, false).has_value());
+
+    etl::impl::LedgerReplay const replay{recording_.path};
+    ASSERT_EQ(replay.size(), 1);
+    EXPECT_EQ(replay.fetchLedger(sequence_, true, true)->SerializeAsString(), response_.second.SerializeAsString());
+}
+
+TEST_F(LoadBalancerFetchLedgerRecordingTests, ledgerWithoutObjectsIsNotRecorded)
+{
+    EXPECT_CALL(sourceFactory_.sourceAt(0), hasLedger(sequence_)).WillOnce(Return(true));
+    EXPECT_CALL(sourceFactory_.sourceAt(0), fetchLedger(sequence_, false, false)).WillOnce(Return(response_));
+
+    EXPECT_TRUE(loadBalancer_->fetchLedger(sequence_, false, false).has_value());
+
+    etl::impl::LedgerReplay const replay{recording_.path};
+    EXPECT_EQ(replay.size(), 0);
+}
+
 struct LoadBalancerForwardToRippledTests : LoadBalancerConstructorTests, SyncAsioContextTest {
     LoadBalancerForwardToRippledTests()
     {
@@ -711,6 +811,146 @@ TEST_F(LoadBalancerForwardToRippledTests, onLedgerClosedHookInvalidatesCache)
     });
 }
 
+struct LoadBalancerForwardToRippledHedgingTests : LoadBalancerForwardToRippledTests {
+    LoadBalancerForwardToRippledHedgingTests()
+    {
+        configJson_.as_object()["forwarding"] =
+            boost::json::object{{"hedge_percentile", 0.9}, {"hedge_min_delay", 0.001}};
+    }
+
+    // replies after the hedge delay
+    auto
+    replySlowly(boost::json::object reply)
+    {
+        return [reply = std::move(reply)](auto&&, auto&&, auto&&, boost::asio::yield_context yield)
+                   -> std::expected<boost::json::object, rpc::ClioError> {
+            boost::asio::steady_timer timer{yield.get_executor(), std::chrono::milliseconds{50}};
+            timer.async_wait(yield);
+            return reply;
+        };
+    }
+
+    // the first source becomes the forwarding source; hedging only goes to connected sources
+    void
+    connectSources(bool connectSecond = true)
+    {
+        EXPECT_CALL(sourceFactory_.sourceAt(0), isConnected()).WillOnce(Return(true));
+        EXPECT_CALL(sourceFactory_.sourceAt(0), setForwarding(true));
+        EXPECT_CALL(sourceFactory_.sourceAt(1), setForwarding(false));
+        sourceFactory_.callbacksAt(0).onConnect();
+        if (connectSecond)
+            sourceFactory_.callbacksAt(1).onConnect();
+    }
+
+    boost::json::object const slowResponse_{{"response", "slow"}};
+};
+
+TEST_F(LoadBalancerForwardToRippledHedgingTests, slowIdempotentRequestIsHedged)
+{
+    EXPECT_CALL(sourceFactory_, makeSource).Times(2);
+    auto loadBalancer = makeLoadBalancer();
+    connectSources();
+
+    auto const request = boost::json::object{{"command", "fee"}};
+    EXPECT_CALL(sourceFactory_.sourceAt(0), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(replySlowly(slowResponse_));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(Return(response_));
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        EXPECT_EQ(loadBalancer->forwardToRippled(request, clientIP_, false, yield), response_);
+    });
+}
+
+TEST_F(LoadBalancerForwardToRippledHedgingTests, losingRequestKeepsLoadBalancerAlive)
+{
+    EXPECT_CALL(sourceFactory_, makeSource).Times(2);
+    auto loadBalancer = makeLoadBalancer();
+    connectSources();
+    std::weak_ptr<LoadBalancer> const weakLoadBalancer = loadBalancer;
+
+    auto const request = boost::json::object{{"command", "fee"}};
+    EXPECT_CALL(sourceFactory_.sourceAt(0), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(replySlowly(slowResponse_));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(Return(response_));
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        EXPECT_EQ(loadBalancer->forwardToRippled(request, clientIP_, false, yield), response_);
+
+        // the slow request to the first source is still running
+        loadBalancer.reset();
+        EXPECT_FALSE(weakLoadBalancer.expired());
+    });
+
+    EXPECT_TRUE(weakLoadBalancer.expired());
+}
+
+TEST_F(LoadBalancerForwardToRippledHedgingTests, failedIdempotentRequestIsHedgedImmediately)
+{
+    EXPECT_CALL(sourceFactory_, makeSource).Times(2);
+    auto loadBalancer = makeLoadBalancer();
+    connectSources();
+
+    auto const request = boost::json::object{{"command", "fee"}};
+    EXPECT_CALL(sourceFactory_.sourceAt(0), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(Return(std::unexpected{rpc::ClioError::etlCONNECTION_ERROR}));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(Return(response_));
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        EXPECT_EQ(loadBalancer->forwardToRippled(request, clientIP_, false, yield), response_);
+    });
+}
+
+TEST_F(LoadBalancerForwardToRippledHedgingTests, requestIsNotHedgedToDisconnectedSource)
+{
+    EXPECT_CALL(sourceFactory_, makeSource).Times(2);
+    auto loadBalancer = makeLoadBalancer();
+    connectSources(false);
+
+    auto const request = boost::json::object{{"command", "fee"}};
+    EXPECT_CALL(sourceFactory_.sourceAt(0), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(replySlowly(slowResponse_));
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        EXPECT_EQ(loadBalancer->forwardToRippled(request, clientIP_, false, yield), slowResponse_);
+    });
+}
+
+TEST_F(LoadBalancerForwardToRippledHedgingTests, failedHedgedRequestIsNotSentToTheSameSourcesAgain)
+{
+    EXPECT_CALL(sourceFactory_, makeSource).Times(2);
+    auto loadBalancer = makeLoadBalancer();
+    connectSources();
+
+    auto const request = boost::json::object{{"command", "fee"}};
+    EXPECT_CALL(sourceFactory_.sourceAt(0), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(Return(std::unexpected{rpc::ClioError::etlCONNECTION_ERROR}));
+    EXPECT_CALL(sourceFactory_.sourceAt(1), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(Return(std::unexpected{rpc::ClioError::etlREQUEST_TIMEOUT}));
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        auto const response = loadBalancer->forwardToRippled(request, clientIP_, false, yield);
+        ASSERT_FALSE(response);
+        EXPECT_EQ(response.error(), rpc::ClioError::etlREQUEST_TIMEOUT);
+    });
+}
+
+TEST_F(LoadBalancerForwardToRippledHedgingTests, otherRequestsAreNotHedged)
+{
+    EXPECT_CALL(sourceFactory_, makeSource).Times(2);
+    auto loadBalancer = makeLoadBalancer();
+
+    auto const request = boost::json::object{{"command", "submit"}};
+    EXPECT_CALL(sourceFactory_.sourceAt(0), forwardToRippled(request, clientIP_, testing::_, testing::_))
+        .WillOnce(replySlowly(slowResponse_));
+
+    runSpawn([&](boost::asio::yield_context yield) {
+        EXPECT_EQ(loadBalancer->forwardToRippled(request, clientIP_, false, yield), slowResponse_);
+    });
+}
+
 struct LoadBalancerToJsonTests : LoadBalancerOnConnectHookTests {};
 
 TEST_F(LoadBalancerToJsonTests, toJson)
@@ -718,7 +958,16 @@ TEST_F(LoadBalancerToJsonTests, toJson)
     EXPECT_CALL(sourceFactory_.sourceAt(0), toJson).WillOnce(Return(boost::json::object{{"source1", "value1"}}));
     EXPECT_CALL(sourceFactory_.sourceAt(1), toJson).WillOnce(Return(boost::json::object{{"source2", "value2"}}));
 
-    auto const expectedJson =
-        boost::json::array({boost::json::object{{"source1", "value1"}}, boost::json::object{{"source2", "value2"}}});
-    EXPECT_EQ(loadBalancer_->toJson(), expectedJson);
+    auto const json = loadBalancer_->toJson().as_array();
+    ASSERT_EQ(json.size(), 2);
+    EXPECT_EQ(json.at(0).at("source1"), "value1");
+    EXPECT_EQ(json.at(1).at("source2"), "value2");
+    for (auto const& source : json) {
+        auto const& stats = source.at("stats").as_object();
+        for (auto const* op : {"forward", "fetch_ledger", "load_initial_ledger"}) {
+            EXPECT_EQ(stats.at(op).at("latency_ms").as_double(), 0.);
+            EXPECT_EQ(stats.at(op).at("error_rate").as_double(), 0.);
+            EXPECT_EQ(stats.at(op).at("in_flight").as_uint64(), 0);
+        }
+    }
 }
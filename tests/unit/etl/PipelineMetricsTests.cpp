@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/DBHelpers.hpp"
+#include "etl/impl/PipelineMetrics.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/prometheus/Histogram.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <xrpl/basics/chrono.h>
+#include <xrpl/protocol/LedgerHeader.h>
+
+#include <chrono>
+
+using namespace etl::impl;
+using namespace util::prometheus;
+
+namespace {
+
+ripple::LedgerHeader
+makeHeader(std::chrono::seconds closedAgo)
+{
+    auto const now =
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+
+    ripple::LedgerHeader header;
+    header.closeTime = ripple::NetClock::time_point{now - std::chrono::seconds{rippleEpochStart} - closedAgo};
+    return header;
+}
+
+}  // namespace
+
+struct PipelineMetricsTests : WithMockPrometheus {
+    PipelineMetrics metrics_;
+};
+
+TEST_F(PipelineMetricsTests, Observe)
+{
+    auto& histogram = makeMock<HistogramInt>("etl_stage_duration_milliseconds_histogram", "{stage=\"update_cache\"}");
+    EXPECT_CALL(histogram, observe(12));
+    metrics_.observe(PipelineMetrics::Stage::UpdateCache, std::chrono::milliseconds{12});
+}
+
+TEST_F(PipelineMetricsTests, ObserveFractionalSeconds)
+{
+    auto& histogram = makeMock<HistogramInt>("etl_stage_duration_milliseconds_histogram", "{stage=\"extract\"}");
+    EXPECT_CALL(histogram, observe(1500));
+    metrics_.observe(PipelineMetrics::Stage::Extract, std::chrono::duration<double>{1.5});
+}
+
+TEST_F(PipelineMetricsTests, Measure)
+{
+    auto& histogram =
+        makeMock<HistogramInt>("etl_stage_duration_milliseconds_histogram", "{stage=\"insert_transactions\"}");
+    EXPECT_CALL(histogram, observe(testing::Ge(0)));
+    EXPECT_EQ(metrics_.measure(PipelineMetrics::Stage::InsertTransactions, []() { return 42; }), 42);
+}
+
+TEST_F(PipelineMetricsTests, ObservePublished)
+{
+    auto& histogram = makeMock<HistogramInt>("etl_publish_lag_milliseconds_histogram", "");
+    EXPECT_CALL(histogram, observe(testing::AllOf(testing::Ge(3000), testing::Lt(5000))));
+    metrics_.observePublished(makeHeader(std::chrono::seconds{3}));
+}
+
+TEST_F(PipelineMetricsTests, ObservePublishedCloseTimeInFuture)
+{
+    auto& histogram = makeMock<HistogramInt>("etl_publish_lag_milliseconds_histogram", "");
+    EXPECT_CALL(histogram, observe(0));
+    metrics_.observePublished(makeHeader(std::chrono::seconds{-10}));
+}
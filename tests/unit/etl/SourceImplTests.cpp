@@ -49,6 +49,7 @@ struct GrpcSourceMock {
 
     using LoadLedgerReturnType = std::pair<std::vector<std::string>, bool>;
     MOCK_METHOD(LoadLedgerReturnType, loadInitialLedger, (uint32_t, uint32_t, bool));
+    MOCK_METHOD(bool, loadLedgerState, (uint32_t, uint32_t));
 };
 
 struct SubscriptionSourceMock {
@@ -173,6 +174,15 @@ TEST_F(SourceImplTest, loadInitialLedger)
     EXPECT_TRUE(actualSuccess);
 }
 
+TEST_F(SourceImplTest, loadLedgerState)
+{
+    uint32_t const ledgerSeq = 123;
+    uint32_t const numMarkers = 3;
+
+    EXPECT_CALL(grpcSourceMock_, loadLedgerState(ledgerSeq, numMarkers)).WillOnce(Return(true));
+    EXPECT_TRUE(source_.loadLedgerState(ledgerSeq, numMarkers));
+}
+
 TEST_F(SourceImplTest, forwardToRippled)
 {
     boost::json::object const request = {{"some_key", "some_value"}};
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "etl/impl/SourceStats.hpp"
+#include "util/MockPrometheus.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace etl::impl;
+using namespace std::chrono_literals;
+
+struct SourceStatsTests : util::prometheus::WithPrometheus {
+    static constexpr auto OP = SourceStats::Operation::Forward;
+    SourceStats stats_{"0"};
+};
+
+TEST_F(SourceStatsTests, UnmeasuredSourceHasLowestScore)
+{
+    auto const initialScore = stats_.score(OP);
+    stats_.finish(OP, stats_.start(OP) - 100ms, true);
+    EXPECT_GT(stats_.score(OP), initialScore);
+}
+
+TEST_F(SourceStatsTests, SlowerSourceHasHigherScore)
+{
+    SourceStats slowStats{"1"};
+    stats_.finish(OP, stats_.start(OP) - 10ms, true);
+    slowStats.finish(OP, slowStats.start(OP) - 500ms, true);
+    EXPECT_LT(stats_.score(OP), slowStats.score(OP));
+}
+
+TEST_F(SourceStatsTests, ErrorsIncreaseScore)
+{
+    stats_.finish(OP, stats_.start(OP) - 10ms, true);
+    auto const scoreBeforeError = stats_.score(OP);
+
+    stats_.finish(OP, stats_.start(OP), false);
+    EXPECT_GT(stats_.score(OP), scoreBeforeError);
+}
+
+TEST_F(SourceStatsTests, FailingSourceLosesToHealthySource)
+{
+    SourceStats healthyStats{"1"};
+    healthyStats.finish(OP, healthyStats.start(OP) - 50ms, true);
+
+    stats_.finish(OP, stats_.start(OP), false);
+    EXPECT_LT(healthyStats.score(OP), stats_.score(OP));
+}
+
+TEST_F(SourceStatsTests, TimedOutRequestsCountTowardsLatency)
+{
+    SourceStats fastStats{"1"};
+    fastStats.finish(OP, fastStats.start(OP) - 50ms, true);
+
+    stats_.finish(OP, stats_.start(OP) - 10ms, true);
+    stats_.finish(OP, stats_.start(OP) - 10s, false);
+    EXPECT_GE(stats_.toJson().at("forward").at("latency_ms").as_double(), 2000.);
+    EXPECT_LT(fastStats.score(OP), stats_.score(OP));
+}
+
+TEST_F(SourceStatsTests, Connected)
+{
+    EXPECT_FALSE(stats_.isConnected());
+    stats_.setConnected(true);
+    EXPECT_TRUE(stats_.isConnected());
+    stats_.setConnected(false);
+    EXPECT_FALSE(stats_.isConnected());
+}
+
+TEST_F(SourceStatsTests, RequestsInFlightIncreaseScore)
+{
+    auto const idleScore = stats_.score(OP);
+    auto const start = stats_.start(OP);
+    EXPECT_GT(stats_.score(OP), idleScore);
+
+    stats_.finish(OP, start, true);
+    EXPECT_DOUBLE_EQ(stats_.score(OP), idleScore);
+}
+
+TEST_F(SourceStatsTests, OperationsAreTrackedSeparately)
+{
+    stats_.finish(OP, stats_.start(OP) - 500ms, true);
+    EXPECT_LT(stats_.score(SourceStats::Operation::FetchLedger), stats_.score(SourceStats::Operation::Forward));
+}
+
+TEST_F(SourceStatsTests, ToJson)
+{
+    stats_.finish(OP, stats_.start(OP) - 100ms, false);
+    auto const json = stats_.toJson();
+
+    EXPECT_EQ(json.at("forward").at("error_rate").as_double(), 0.2);
+    EXPECT_GE(json.at("forward").at("latency_ms").as_double(), 100.);
+    EXPECT_EQ(json.at("forward").at("in_flight").as_uint64(), 0);
+    EXPECT_EQ(json.at("fetch_ledger").at("error_rate").as_double(), 0.);
+    EXPECT_TRUE(json.contains("load_initial_ledger"));
+}
+
+TEST_F(SourceStatsTests, LatencyPercentile)
+{
+    EXPECT_FALSE(stats_.latencyPercentile(OP, 0.9));
+
+    for (auto i = 1; i <= 20; ++i)
+        stats_.finish(OP, stats_.start(OP) - std::chrono::milliseconds{i * 10}, true);
+    stats_.finish(OP, stats_.start(OP) - 10s, false);  // failed requests are not counted
+
+    auto const percentile = stats_.latencyPercentile(OP, 0.9);
+    ASSERT_TRUE(percentile);
+    EXPECT_GE(*percentile, 180ms);
+    EXPECT_LT(*percentile, 200ms);
+}
@@ -18,6 +18,8 @@
 //==============================================================================
 
 #include "etl/SystemState.hpp"
+#include "etl/impl/CommittedLedger.hpp"
+#include "etl/impl/LedgerLoader.hpp"
 #include "etl/impl/Transformer.hpp"
 #include "util/FakeFetchResponse.hpp"
 #include "util/MockAmendmentBlockHandler.hpp"
@@ -30,10 +32,13 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <xrpl/basics/base_uint.h>
 
 #include <chrono>
 #include <memory>
 #include <optional>
+#include <stdexcept>
+#include <string>
 #include <thread>
 
 using namespace testing;
@@ -85,7 +90,7 @@ TEST_F(ETLTransformerTest, StopsOnWriteConflict)
     state_.writeConflict = true;
 
     EXPECT_CALL(dataPipe_, popNext).Times(0);
-    EXPECT_CALL(ledgerPublisher_, publish(_)).Times(0);
+    EXPECT_CALL(ledgerPublisher_, publish(A<etl::impl::CommittedLedger>())).Times(0);
 
     transformer_ = std::make_unique<TransformerType>(
         dataPipe_, backend, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
@@ -117,7 +122,7 @@ TEST_F(ETLTransformerTest, StopsOnEmptyFetchResponse)
     EXPECT_CALL(*backend, writeNFTs).Times(AtLeast(1));
     EXPECT_CALL(*backend, writeNFTTransactions).Times(AtLeast(1));
     EXPECT_CALL(*backend, doFinishWrites).Times(AtLeast(1));
-    EXPECT_CALL(ledgerPublisher_, publish(_)).Times(AtLeast(1));
+    EXPECT_CALL(ledgerPublisher_, publish(A<etl::impl::CommittedLedger>())).Times(AtLeast(1));
 
     transformer_ = std::make_unique<TransformerType>(
         dataPipe_, backend, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
@@ -150,11 +155,120 @@ TEST_F(ETLTransformerTest, DoesNotPublishIfCanNotBuildNextLedger)
     EXPECT_CALL(*backend, doFinishWrites).Times(AtLeast(1));
 
     // should not call publish
-    EXPECT_CALL(ledgerPublisher_, publish(_)).Times(0);
+    EXPECT_CALL(ledgerPublisher_, publish(A<etl::impl::CommittedLedger>())).Times(0);
 
     transformer_ = std::make_unique<TransformerType>(
         dataPipe_, backend, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
     );
 }
 
-// TODO: implement tests for amendment block. requires more refactoring
+TEST_F(ETLTransformerTest, AmendmentBlockedIfTransactionsCanNotBeInserted)
+{
+    backend->cache().setFull();  // to avoid throwing exception in updateCache
+
+    auto const blob = hexStringToBinaryString(RAW_HEADER);
+    auto const response = std::make_optional<FakeFetchResponse>(blob);
+
+    ON_CALL(dataPipe_, popNext).WillByDefault(Return(response));
+
+    EXPECT_CALL(*backend, startWrites);
+    EXPECT_CALL(*backend, writeLedger(_, _));
+    EXPECT_CALL(ledgerLoader_, insertTransactions).WillOnce(Throw(std::runtime_error{"Unknown transaction type"}));
+    EXPECT_CALL(amendmentBlockHandler_, onAmendmentBlock);
+
+    // the failure is reported as a write conflict so nothing must be written or published
+    EXPECT_CALL(*backend, writeAccountTransactions).Times(0);
+    EXPECT_CALL(*backend, doFinishWrites).Times(0);
+    EXPECT_CALL(ledgerPublisher_, publish(A<etl::impl::CommittedLedger>())).Times(0);
+
+    transformer_ = std::make_unique<TransformerType>(
+        dataPipe_, backend, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
+    );
+    transformer_->waitTillFinished();
+
+    EXPECT_TRUE(state_.writeConflict);
+}
+
+TEST_F(ETLTransformerTest, AmendmentBlockedIfSuccessorsCanNotBeWritten)
+{
+    auto const blob = hexStringToBinaryString(RAW_HEADER);
+    auto response = std::make_optional<FakeFetchResponse>(blob, 0, true);
+
+    auto& deleted = response->mutable_ledger_objects()->mutable_objects()->emplace_back();
+    *deleted.mutable_key() = std::string(ripple::uint256::size(), 'k');
+    deleted.set_mod_type(FakeLedgerObject::DELETED);
+
+    EXPECT_CALL(dataPipe_, popNext).WillOnce(Return(response)).WillRepeatedly(Return(std::nullopt));
+    EXPECT_CALL(*backend, writeSuccessor).WillOnce(Throw(std::runtime_error{"Could not write successor"}));
+    EXPECT_CALL(amendmentBlockHandler_, onAmendmentBlock);
+
+    EXPECT_CALL(*backend, writeAccountTransactions).Times(0);
+    EXPECT_CALL(*backend, doFinishWrites).Times(0);
+    EXPECT_CALL(ledgerPublisher_, publish(A<etl::impl::CommittedLedger>())).Times(0);
+
+    transformer_ = std::make_unique<TransformerType>(
+        dataPipe_, backend, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
+    );
+    transformer_->waitTillFinished();
+
+    EXPECT_TRUE(state_.writeConflict);
+}
+
+TEST_F(ETLTransformerTest, HandsTransactionsOverToPublisher)
+{
+    backend->cache().setFull();  // to avoid throwing exception in updateCache
+
+    auto const blob = hexStringToBinaryString(RAW_HEADER);
+    auto const response = std::make_optional<FakeFetchResponse>(blob);
+
+    FormattedTransactionsData insertTxResult;
+    insertTxResult.transactions.resize(2);
+
+    EXPECT_CALL(dataPipe_, popNext).WillOnce(Return(response)).WillRepeatedly(Return(std::nullopt));
+    EXPECT_CALL(ledgerLoader_, insertTransactions).WillOnce(Return(insertTxResult));
+    EXPECT_CALL(*backend, doFinishWrites).WillOnce(Return(true));
+    EXPECT_CALL(*backend, fetchAllTransactionsInLedger).Times(0);
+    EXPECT_CALL(
+        ledgerPublisher_,
+        publish(Matcher<etl::impl::CommittedLedger>(Field(&etl::impl::CommittedLedger::transactions, SizeIs(2))))
+    );
+
+    transformer_ = std::make_unique<TransformerType>(
+        dataPipe_, backend, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
+    );
+    transformer_->waitTillFinished();
+}
+
+struct ETLTransformerDiffTest : ETLTransformerTest, WithParamInterface<bool> {};
+
+TEST_P(ETLTransformerDiffTest, DiffIsOnlyKeptForBroadcast)
+{
+    auto const broadcast = GetParam();
+    auto const blob = hexStringToBinaryString(RAW_HEADER);
+    auto response = std::make_optional<FakeFetchResponse>(blob, 0, true);
+
+    auto& modified = response->mutable_ledger_objects()->mutable_objects()->emplace_back();
+    *modified.mutable_key() = std::string(ripple::uint256::size(), 'k');
+    *modified.mutable_data() = "data";
+    modified.set_mod_type(FakeLedgerObject::MODIFIED);
+
+    EXPECT_CALL(dataPipe_, popNext).WillOnce(Return(response)).WillRepeatedly(Return(std::nullopt));
+    EXPECT_CALL(*backend, doFinishWrites).WillOnce(Return(true));
+    EXPECT_CALL(ledgerPublisher_, broadcastsLedgers).WillOnce(Return(broadcast));
+    auto const diffSize = broadcast ? 1u : 0u;
+    EXPECT_CALL(
+        ledgerPublisher_,
+        publish(Matcher<etl::impl::CommittedLedger>(Field(&etl::impl::CommittedLedger::diff, SizeIs(diffSize))))
+    );
+
+    transformer_ = std::make_unique<TransformerType>(
+        dataPipe_, backend, ledgerLoader_, ledgerPublisher_, amendmentBlockHandler_, 0, state_
+    );
+    transformer_->waitTillFinished();
+
+    EXPECT_EQ(backend->cache().size(), 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(ETLTransformerDiffTestGroup, ETLTransformerDiffTest, Values(true, false));
+
+// TODO: implement more tests for amendment block. requires more refactoring
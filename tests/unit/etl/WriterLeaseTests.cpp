@@ -0,0 +1,219 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/BackendInterface.hpp"
+#include "etl/SystemState.hpp"
+#include "etl/WriterLease.hpp"
+#include "util/MockBackendTestFixture.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/config/Config.hpp"
+
+#include <boost/json/parse.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+
+namespace json = boost::json;
+using namespace etl;
+using namespace testing;
+
+namespace {
+
+constexpr std::uint32_t DURATION_MS = 30;
+constexpr auto DURATION = std::chrono::milliseconds{DURATION_MS};
+
+WriterLeaseSettings const SETTINGS{.durationMs = DURATION_MS, .renewIntervalMs = 1};
+
+}  // namespace
+
+struct WriterLeaseSettingsTest : Test {};
+
+TEST_F(WriterLeaseSettingsTest, DefaultSettingsParsedCorrectly)
+{
+    auto const cfg = util::Config{json::parse(R"({})")};
+    auto const settings = make_WriterLeaseSettings(cfg);
+
+    EXPECT_EQ(settings, WriterLeaseSettings{});
+    EXPECT_FALSE(settings.isEnabled());
+}
+
+TEST_F(WriterLeaseSettingsTest, ValuesCorrectlyPropagatedThroughConfig)
+{
+    auto const cfg = util::Config{json::parse(R"({"writer_lease": {"duration_ms": 3000, "renew_interval_ms": 500}})")};
+    auto const settings = make_WriterLeaseSettings(cfg);
+
+    EXPECT_TRUE(settings.isEnabled());
+    EXPECT_EQ(settings.durationMs, 3000);
+    EXPECT_EQ(settings.renewIntervalMs, 500);
+}
+
+TEST_F(WriterLeaseSettingsTest, RenewIntervalDefaultsToAThirdOfTheDuration)
+{
+    auto const cfg = util::Config{json::parse(R"({"writer_lease": {"duration_ms": 3000}})")};
+    EXPECT_EQ(make_WriterLeaseSettings(cfg).renewIntervalMs, 1000);
+}
+
+TEST_F(WriterLeaseSettingsTest, ZeroDurationThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"writer_lease": {"duration_ms": 0}})")};
+    EXPECT_THROW(make_WriterLeaseSettings(cfg), std::runtime_error);
+}
+
+TEST_F(WriterLeaseSettingsTest, RenewIntervalNotShorterThanDurationThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"writer_lease": {"duration_ms": 100, "renew_interval_ms": 100}})")};
+    EXPECT_THROW(make_WriterLeaseSettings(cfg), std::runtime_error);
+}
+
+struct WriterLeaseTest : util::prometheus::WithPrometheus, MockBackendTest {
+    SystemState state;
+};
+
+TEST_F(WriterLeaseTest, DoesNotTryLeaseIfLedgerWasPublished)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    EXPECT_CALL(*backend, tryAcquireWriterLease).Times(0);
+
+    EXPECT_FALSE(lease.waitForLease([]() { return true; }));
+    EXPECT_FALSE(lease.isOwner());
+}
+
+TEST_F(WriterLeaseTest, KeepsPublishingUntilLeaseIsAcquired)
+{
+    WriterLease lease{SETTINGS, backend, state};
+
+    EXPECT_CALL(*backend, tryAcquireWriterLease(lease.owner(), DURATION))
+        .WillOnce(Return(false))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*backend, releaseWriterLease(lease.owner()));
+
+    MockFunction<bool()> publish;
+    EXPECT_CALL(publish, Call).Times(3).WillRepeatedly(Return(false));
+
+    EXPECT_TRUE(lease.waitForLease(publish.AsStdFunction()));
+    EXPECT_TRUE(lease.isOwner());
+}
+
+TEST_F(WriterLeaseTest, RetriesLeaseAfterDatabaseTimeout)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    EXPECT_CALL(*backend, tryAcquireWriterLease).WillOnce(Throw(data::DatabaseTimeout{})).WillOnce(Return(true));
+
+    MockFunction<bool()> publish;
+    EXPECT_CALL(publish, Call).Times(2).WillRepeatedly(Return(false));
+
+    EXPECT_TRUE(lease.waitForLease(publish.AsStdFunction()));
+    EXPECT_TRUE(lease.isOwner());
+}
+
+TEST_F(WriterLeaseTest, StopsWaitingIfAnotherWriterPublished)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    EXPECT_CALL(*backend, tryAcquireWriterLease).WillOnce(Return(false));
+
+    MockFunction<bool()> publish;
+    EXPECT_CALL(publish, Call).WillOnce(Return(false)).WillOnce(Return(true));
+
+    EXPECT_FALSE(lease.waitForLease(publish.AsStdFunction()));
+    EXPECT_FALSE(lease.isOwner());
+}
+
+TEST_F(WriterLeaseTest, StopsWaitingWhenStopping)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    state.isStopping = true;
+
+    EXPECT_FALSE(lease.waitForLease([]() { return false; }));
+}
+
+TEST_F(WriterLeaseTest, ReportsLostLeaseOnce)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    EXPECT_CALL(*backend, tryAcquireWriterLease)
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*backend, releaseWriterLease).Times(0);
+    ASSERT_TRUE(lease.waitForLease([]() { return false; }));
+
+    std::promise<void> lost;
+    lease.keepAlive([&lost]() { lost.set_value(); });
+
+    ASSERT_EQ(lost.get_future().wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    lease.release();
+    EXPECT_FALSE(lease.isOwner());
+}
+
+TEST_F(WriterLeaseTest, ReleaseStopsRenewingAndGivesUpTheLease)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    EXPECT_CALL(*backend, tryAcquireWriterLease).WillRepeatedly(Return(true));
+    ASSERT_TRUE(lease.waitForLease([]() { return false; }));
+
+    MockFunction<void()> onLost;
+    EXPECT_CALL(onLost, Call).Times(0);
+    EXPECT_CALL(*backend, releaseWriterLease(lease.owner()));
+
+    lease.keepAlive(onLost.AsStdFunction());
+    lease.release();
+    EXPECT_FALSE(lease.isOwner());
+}
+
+TEST_F(WriterLeaseTest, KeepsLeaseIfRenewalTimesOutWhileItIsValid)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    std::promise<void> renewed;
+    EXPECT_CALL(*backend, tryAcquireWriterLease)
+        .WillOnce(Return(true))
+        .WillOnce(Throw(data::DatabaseTimeout{}))
+        .WillOnce(DoAll(InvokeWithoutArgs([&renewed]() { renewed.set_value(); }), Return(true)))
+        .WillRepeatedly(Return(true));
+    ASSERT_TRUE(lease.waitForLease([]() { return false; }));
+
+    MockFunction<void()> onLost;
+    EXPECT_CALL(onLost, Call).Times(0);
+    lease.keepAlive(onLost.AsStdFunction());
+
+    ASSERT_EQ(renewed.get_future().wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_TRUE(lease.isOwner());
+    lease.release();
+}
+
+TEST_F(WriterLeaseTest, ReportsLostLeaseIfRenewalTimesOutUntilItExpires)
+{
+    WriterLease lease{SETTINGS, backend, state};
+    EXPECT_CALL(*backend, tryAcquireWriterLease)
+        .WillOnce(Return(true))
+        .WillRepeatedly(Throw(data::DatabaseTimeout{}));
+    EXPECT_CALL(*backend, releaseWriterLease).Times(0);
+    ASSERT_TRUE(lease.waitForLease([]() { return false; }));
+
+    std::promise<void> lost;
+    lease.keepAlive([&lost]() { lost.set_value(); });
+
+    ASSERT_EQ(lost.get_future().wait_for(std::chrono::seconds{1}), std::future_status::ready);
+    EXPECT_FALSE(lease.isOwner());
+    lease.release();
+}
@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "data/Types.hpp"
+#include "feed/OwnerFunds.hpp"
+#include "util/MockBackendTestFixture.hpp"
+#include "util/MockPrometheus.hpp"
+#include "util/TestObject.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <xrpl/basics/base_uint.h>
+#include <xrpl/protocol/Indexes.h>
+#include <xrpl/protocol/LedgerFormats.h>
+#include <xrpl/protocol/SField.h>
+#include <xrpl/protocol/STAmount.h>
+#include <xrpl/protocol/STObject.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using namespace feed;
+using namespace testing;
+
+namespace {
+
+constexpr auto ACCOUNT1 = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
+constexpr auto ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
+constexpr auto CURRENCY = "0158415500000000C1F76FF6ECB0BAC600000000";
+constexpr auto ISSUER = "rK9DrarGKnVEo2nYp5MfVRXRYf5yRX3mwD";
+constexpr auto TXNID = "E6DBAFC99223B42257915A63DFC6B0C032D4070F9A574B255AD97466726FC321";
+constexpr auto SEQ = 33;
+
+}  // namespace
+
+struct FeedOwnerFundsTest : util::prometheus::WithPrometheus, MockBackendTest {
+protected:
+    void
+    SetUp() override
+    {
+        ripple::STObject line(ripple::sfIndexes);
+        line.setFieldU16(ripple::sfLedgerEntryType, ripple::ltRIPPLE_STATE);
+        line.setFieldAmount(ripple::sfLowLimit, ripple::STAmount(10, false));
+        line.setFieldAmount(ripple::sfHighLimit, ripple::STAmount(100, false));
+        line.setFieldH256(ripple::sfPreviousTxnID, ripple::uint256{TXNID});
+        line.setFieldU32(ripple::sfPreviousTxnLgrSeq, 3);
+        line.setFieldU32(ripple::sfFlags, 0);
+        line.setFieldAmount(ripple::sfBalance, ripple::STAmount(GetIssue(CURRENCY, ISSUER), 100));
+        line_ = line.getSerializer().peekData();
+
+        ON_CALL(*backend, doFetchLedgerObjects).WillByDefault(WithArg<0>([this](auto const& keys) {
+            return objects(keys);
+        }));
+
+        // fee object 2*2+3->7
+        ON_CALL(*backend, doFetchLedgerObject(ripple::keylet::fees().key, _, _))
+            .WillByDefault(Return(CreateLegacyFeeSettingBlob(1, 2, 3, 4, 0)));
+    }
+
+    // every object but the account roots of the issuer and of ACCOUNT1 is the trust line
+    std::vector<data::Blob>
+    objects(std::vector<ripple::uint256> const& keys) const
+    {
+        auto const issuerRoot = CreateAccountRootObject(ISSUER, 0, 1, 10, 2, TXNID, 3);
+        auto const ownerRoot = CreateAccountRootObject(ACCOUNT1, 0, 1, 200, 2, TXNID, 3);
+
+        std::vector<data::Blob> blobs;
+        for (auto const& key : keys) {
+            if (key == ripple::keylet::account(GetAccountIDWithString(ISSUER)).key) {
+                blobs.push_back(issuerRoot.getSerializer().peekData());
+            } else if (key == ripple::keylet::account(GetAccountIDWithString(ACCOUNT1)).key) {
+                blobs.push_back(ownerRoot.getSerializer().peekData());
+            } else {
+                blobs.push_back(line_);
+            }
+        }
+        return blobs;
+    }
+
+    static data::TransactionAndMetadata
+    makeTransaction(ripple::STObject const& tx)
+    {
+        data::TransactionAndMetadata txAndMeta;
+        txAndMeta.transaction = tx.getSerializer().peekData();
+        txAndMeta.ledgerSequence = SEQ;
+        return txAndMeta;
+    }
+
+private:
+    data::Blob line_;
+};
+
+TEST_F(FeedOwnerFundsTest, OffersOfSameOwnerAndIssueShareLookup)
+{
+    auto const offer1 = CreateCreateOfferTransactionObject(ACCOUNT1, 1, 32, CURRENCY, ISSUER, 1, 3);
+    auto const offer2 = CreateCreateOfferTransactionObject(ACCOUNT1, 1, 33, CURRENCY, ISSUER, 2, 5);
+    auto const payment = CreatePaymentTransactionObject(ACCOUNT1, ACCOUNT2, 1, 1, 34);
+    std::vector const transactions{makeTransaction(offer1), makeTransaction(payment), makeTransaction(offer2)};
+
+    // trust line and issuer's account root, once for both offers
+    EXPECT_CALL(*backend, doFetchLedgerObjects(SizeIs(2), _, _));
+    OwnerFunds ownerFunds{backend, SEQ, transactions};
+
+    auto const funds1 = ownerFunds.get(offer1);
+    ASSERT_TRUE(funds1.has_value());
+    EXPECT_EQ(funds1->getText(), "100");
+
+    auto const funds2 = ownerFunds.get(offer2);
+    ASSERT_TRUE(funds2.has_value());
+    EXPECT_EQ(funds2->getText(), "100");
+
+    EXPECT_FALSE(ownerFunds.get(payment).has_value());
+}
+
+TEST_F(FeedOwnerFundsTest, OffersOfDifferentOwnersAreFetchedInOneBatch)
+{
+    auto const offer1 = CreateCreateOfferTransactionObject(ACCOUNT1, 1, 32, CURRENCY, ISSUER, 1, 3);
+    auto const offer2 = CreateCreateOfferTransactionObject(ACCOUNT2, 1, 33, CURRENCY, ISSUER, 2, 5);
+    auto const offer3 = CreateCreateOfferTransactionObject(ACCOUNT1, 1, 34, CURRENCY, ISSUER, 300, 200, true);
+    std::vector const transactions{makeTransaction(offer1), makeTransaction(offer2), makeTransaction(offer3)};
+
+    // both trust lines, the issuer's account root and the XRP owner's account root, then the fees
+    EXPECT_CALL(*backend, doFetchLedgerObjects(SizeIs(4), _, _));
+    EXPECT_CALL(*backend, doFetchLedgerObject(ripple::keylet::fees().key, _, _));
+    OwnerFunds ownerFunds{backend, SEQ, transactions};
+
+    EXPECT_TRUE(ownerFunds.get(offer1).has_value());
+    EXPECT_TRUE(ownerFunds.get(offer2).has_value());
+
+    // balance 200 - reserve 7
+    auto const funds3 = ownerFunds.get(offer3);
+    ASSERT_TRUE(funds3.has_value());
+    EXPECT_EQ(funds3->getText(), "193");
+}
+
+TEST_F(FeedOwnerFundsTest, NoFundsWhenOwnerIssuesTakerGets)
+{
+    auto const offer = CreateCreateOfferTransactionObject(ISSUER, 1, 32, CURRENCY, ISSUER, 1, 3);
+    auto const transaction = makeTransaction(offer);
+
+    EXPECT_CALL(*backend, doFetchLedgerObjects).Times(0);
+    OwnerFunds ownerFunds{backend, SEQ, std::span{&transaction, 1}};
+
+    EXPECT_FALSE(ownerFunds.get(offer).has_value());
+}
+
+TEST_F(FeedOwnerFundsTest, TransactionsAreNotParsedUntilFundsAreNeeded)
+{
+    data::TransactionAndMetadata notATransaction;
+    notATransaction.transaction = {0xFF, 0xFF, 0xFF};
+    auto const payment = CreatePaymentTransactionObject(ACCOUNT1, ACCOUNT2, 1, 1, 34);
+
+    EXPECT_CALL(*backend, doFetchLedgerObjects).Times(0);
+    OwnerFunds ownerFunds{backend, SEQ, std::span{&notATransaction, 1}};
+
+    EXPECT_FALSE(ownerFunds.get(payment).has_value());
+}
+
+TEST_F(FeedOwnerFundsTest, OfferNotGatheredUpfrontIsResolvedOnDemand)
+{
+    auto const offer = CreateCreateOfferTransactionObject(ACCOUNT1, 1, 32, CURRENCY, ISSUER, 1, 3);
+
+    EXPECT_CALL(*backend, doFetchLedgerObjects(SizeIs(2), _, _));
+    OwnerFunds ownerFunds{backend, SEQ, {}};
+
+    auto const funds = ownerFunds.get(offer);
+    ASSERT_TRUE(funds.has_value());
+    EXPECT_EQ(funds->getText(), "100");
+}
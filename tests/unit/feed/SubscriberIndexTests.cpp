@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include "feed/Types.hpp"
+#include "feed/impl/SubscriberIndex.hpp"
+#include "util/MockWsBase.hpp"
+#include "web/interface/ConnectionBase.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace testing;
+using namespace feed::impl;
+
+struct FeedSubscriberIndexTests : Test {
+protected:
+    std::shared_ptr<web::ConnectionBase> sessionPtr = std::make_shared<MockSession>();
+    SubscriberIds ids;
+
+    template <typename IndexType, typename... KeyType>
+    static std::vector<feed::SubscriberPtr>
+    collect(IndexType const& index, KeyType const&... key)
+    {
+        std::vector<feed::SubscriberPtr> subscribers;
+        index.forEach(key..., [&](SubscriberId, feed::SubscriberSharedPtr const& subscriber) {
+            subscribers.push_back(subscriber.get());
+        });
+        return subscribers;
+    }
+};
+
+TEST_F(FeedSubscriberIndexTests, SetAddRemove)
+{
+    SubscriberSet set{ids};
+    EXPECT_TRUE(set.add(sessionPtr));
+    EXPECT_FALSE(set.add(sessionPtr));
+
+    EXPECT_EQ(set.count(), 1);
+    EXPECT_EQ(collect(set), std::vector<feed::SubscriberPtr>{sessionPtr.get()});
+
+    EXPECT_TRUE(set.remove(sessionPtr.get()));
+    EXPECT_EQ(set.count(), 0);
+    EXPECT_FALSE(set.remove(sessionPtr.get()));
+    EXPECT_TRUE(collect(set).empty());
+}
+
+TEST_F(FeedSubscriberIndexTests, SetSkipsDestroyedSubscriber)
+{
+    SubscriberSet set{ids};
+    EXPECT_TRUE(set.add(sessionPtr));
+
+    sessionPtr.reset();
+    // the subscriber is destroyed but nothing removed it
+    EXPECT_EQ(set.count(), 1);
+    EXPECT_TRUE(collect(set).empty());
+}
+
+TEST_F(FeedSubscriberIndexTests, SetRemoveKeepsOtherSubscribers)
+{
+    SubscriberSet set{ids};
+    std::vector<std::shared_ptr<web::ConnectionBase>> sessions;
+    for (auto i = 0; i < 4; ++i) {
+        sessions.push_back(std::make_shared<MockSession>());
+        EXPECT_TRUE(set.add(sessions.back()));
+    }
+
+    EXPECT_TRUE(set.remove(sessions[1].get()));
+    EXPECT_TRUE(set.remove(sessions[3].get()));
+    EXPECT_THAT(collect(set), UnorderedElementsAre(sessions[0].get(), sessions[2].get()));
+}
+
+TEST_F(FeedSubscriberIndexTests, SnapshotIsNotAffectedByChanges)
+{
+    SubscriberSet set{ids};
+    auto const other = std::make_shared<MockSession>();
+    EXPECT_TRUE(set.add(sessionPtr));
+
+    std::vector<feed::SubscriberPtr> notified;
+    set.forEach([&](SubscriberId, feed::SubscriberSharedPtr const& subscriber) {
+        // changing the set while publishing neither deadlocks nor changes the subscribers being notified
+        EXPECT_TRUE(set.add(other));
+        EXPECT_TRUE(set.remove(sessionPtr.get()));
+        notified.push_back(subscriber.get());
+    });
+
+    EXPECT_EQ(notified, std::vector<feed::SubscriberPtr>{sessionPtr.get()});
+    EXPECT_EQ(collect(set), std::vector<feed::SubscriberPtr>{other.get()});
+}
+
+TEST_F(FeedSubscriberIndexTests, MapAddRemove)
+{
+    SubscriberMap<std::string> map{ids};
+    EXPECT_TRUE(map.add("test", sessionPtr));
+    EXPECT_TRUE(map.add("test1", sessionPtr));
+    EXPECT_FALSE(map.add("test", sessionPtr));
+
+    EXPECT_EQ(map.count("test"), 1);
+    EXPECT_EQ(collect(map, std::string{"test"}), std::vector<feed::SubscriberPtr>{sessionPtr.get()});
+    EXPECT_TRUE(collect(map, std::string{"test2"}).empty());
+
+    EXPECT_TRUE(map.remove("test", sessionPtr.get()));
+    EXPECT_FALSE(map.remove("test", sessionPtr.get()));
+    EXPECT_FALSE(map.remove("test2", sessionPtr.get()));
+
+    EXPECT_EQ(map.count("test"), 0);
+    EXPECT_TRUE(collect(map, std::string{"test"}).empty());
+    EXPECT_EQ(collect(map, std::string{"test1"}), std::vector<feed::SubscriberPtr>{sessionPtr.get()});
+}
+
+TEST_F(FeedSubscriberIndexTests, MapSkipsDestroyedSubscriber)
+{
+    SubscriberMap<std::string> map{ids};
+    EXPECT_TRUE(map.add("test", sessionPtr));
+    EXPECT_TRUE(map.add("test1", sessionPtr));
+
+    sessionPtr.reset();
+
+    EXPECT_TRUE(collect(map, std::string{"test"}).empty());
+    EXPECT_TRUE(collect(map, std::string{"test1"}).empty());
+}
+
+TEST_F(FeedSubscriberIndexTests, IdsAreSharedAndReused)
+{
+    SubscriberSet set{ids};
+    SubscriberMap<std::string> map{ids};
+    auto const other = std::make_shared<MockSession>();
+
+    EXPECT_TRUE(set.add(sessionPtr));
+    EXPECT_TRUE(map.add("test", sessionPtr));
+    EXPECT_TRUE(map.add("test", other));
+
+    auto const id = ids.find(sessionPtr.get());
+    ASSERT_TRUE(id.has_value());
+    EXPECT_NE(ids.find(other.get()), id);
+
+    // the id is kept while the subscriber has any subscription left
+    EXPECT_TRUE(set.remove(sessionPtr.get()));
+    EXPECT_EQ(ids.find(sessionPtr.get()), id);
+
+    EXPECT_TRUE(map.remove("test", sessionPtr.get()));
+    EXPECT_FALSE(ids.find(sessionPtr.get()).has_value());
+
+    auto const newcomer = std::make_shared<MockSession>();
+    EXPECT_TRUE(set.add(newcomer));
+    EXPECT_EQ(ids.find(newcomer.get()), id);
+}
+
+TEST_F(FeedSubscriberIndexTests, NotifiedSet)
+{
+    NotifiedSet notified;
+    EXPECT_TRUE(notified.insert(0));
+    EXPECT_TRUE(notified.insert(42));
+    EXPECT_FALSE(notified.insert(0));
+    EXPECT_FALSE(notified.insert(42));
+
+    notified.clear();
+    EXPECT_TRUE(notified.insert(42));
+    EXPECT_TRUE(notified.insert(7));
+    EXPECT_FALSE(notified.insert(7));
+}
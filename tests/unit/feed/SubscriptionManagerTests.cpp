@@ -19,6 +19,7 @@
 
 #include "data/Types.hpp"
 #include "feed/FeedTestUtil.hpp"
+#include "feed/OwnerFunds.hpp"
 #include "feed/SubscriptionManager.hpp"
 #include "util/AsioContextTestFixture.hpp"
 #include "util/MockBackendTestFixture.hpp"
@@ -40,6 +41,7 @@
 #include <xrpl/protocol/STObject.h>
 
 #include <memory>
+#include <span>
 #include <string>
 #include <thread>
 #include <vector>
@@ -354,7 +356,8 @@ TEST_F(SubscriptionManagerTest, TransactionTest)
 
     auto const metaObj = CreateMetaDataForBookChange(CURRENCY, ISSUER, 22, 3, 1, 1, 3);
     trans1.metadata = metaObj.getSerializer().peekData();
-    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader);
+    OwnerFunds ownerFunds{backend, ledgerHeader.seq, std::span{&trans1, 1}};
+    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader, ownerFunds);
 
     constexpr static auto OrderbookPublish =
         R"({
@@ -515,7 +518,8 @@ TEST_F(SubscriptionManagerTest, ProposedTransactionTest)
 
     auto const metaObj = CreateMetaDataForBookChange(CURRENCY, ACCOUNT1, 22, 3, 1, 1, 3);
     trans1.metadata = metaObj.getSerializer().peekData();
-    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader);
+    OwnerFunds ownerFunds{backend, ledgerHeader.seq, std::span{&trans1, 1}};
+    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader, ownerFunds);
     ctx.run();
 
     // unsub account1
@@ -542,7 +546,8 @@ TEST_F(SubscriptionManagerTest, DuplicateResponseSubTxAndProposedTx)
 
     auto const metaObj = CreateMetaDataForBookChange(CURRENCY, ACCOUNT1, 22, 3, 1, 1, 3);
     trans1.metadata = metaObj.getSerializer().peekData();
-    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader);
+    OwnerFunds ownerFunds{backend, ledgerHeader.seq, std::span{&trans1, 1}};
+    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader, ownerFunds);
     ctx.run();
 
     SubscriptionManagerPtr->unsubTransactions(session);
@@ -569,7 +574,8 @@ TEST_F(SubscriptionManagerTest, NoDuplicateResponseSubAccountAndProposedAccount)
 
     auto const metaObj = CreateMetaDataForBookChange(CURRENCY, ACCOUNT1, 22, 3, 1, 1, 3);
     trans1.metadata = metaObj.getSerializer().peekData();
-    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader);
+    OwnerFunds ownerFunds{backend, ledgerHeader.seq, std::span{&trans1, 1}};
+    SubscriptionManagerPtr->pubTransaction(trans1, ledgerHeader, ownerFunds);
     ctx.run();
 
     // unsub account1
@@ -41,6 +41,8 @@
 #include <xrpl/protocol/TER.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 constexpr static auto ACCOUNT1 = "rf1BiGeXwwQoi8Z2ueFYTEXSwuJYfV2Jpn";
 constexpr static auto ACCOUNT2 = "rLEsXccBGNR3UPuPu2hUXPjziKC3qKSBun";
@@ -49,6 +51,18 @@ constexpr static auto CURRENCY = "0158415500000000C1F76FF6ECB0BAC600000000";
 constexpr static auto ISSUER = "rK9DrarGKnVEo2nYp5MfVRXRYf5yRX3mwD";
 constexpr static auto TXNID = "E6DBAFC99223B42257915A63DFC6B0C032D4070F9A574B255AD97466726FC321";
 
+// the objects fetched for the owner funds of an offer: the issuer's account root, otherwise the trust line
+static std::vector<data::Blob>
+ownerFundsObjects(std::vector<ripple::uint256> const& keys, data::Blob const& line, data::Blob const& issuerRoot)
+{
+    auto const issuerRootKey = ripple::keylet::account(GetAccountIDWithString(ISSUER)).key;
+
+    std::vector<data::Blob> blobs;
+    for (auto const& key : keys)
+        blobs.push_back(key == issuerRootKey ? issuerRoot : line);
+    return blobs;
+}
+
 constexpr static auto TRAN_V1 =
     R"({
         "transaction":
@@ -811,14 +825,10 @@ TEST_F(FeedTransactionTest, PubTransactionWithOwnerFund)
     auto const issue2 = GetIssue(CURRENCY, ISSUER);
     line.setFieldAmount(ripple::sfBalance, ripple::STAmount(issue2, 100));
 
-    EXPECT_CALL(*backend, doFetchLedgerObject).Times(3);
-    auto const issueAccount = GetAccountIDWithString(ISSUER);
-    auto const kk = ripple::keylet::account(issueAccount).key;
-    ON_CALL(*backend, doFetchLedgerObject(testing::_, testing::_, testing::_))
-        .WillByDefault(testing::Return(line.getSerializer().peekData()));
     ripple::STObject const accountRoot = CreateAccountRootObject(ISSUER, 0, 1, 10, 2, TXNID, 3);
-    ON_CALL(*backend, doFetchLedgerObject(kk, testing::_, testing::_))
-        .WillByDefault(testing::Return(accountRoot.getSerializer().peekData()));
+    EXPECT_CALL(*backend, doFetchLedgerObjects).WillOnce(testing::WithArg<0>([&](auto const& keys) {
+        return ownerFundsObjects(keys, line.getSerializer().peekData(), accountRoot.getSerializer().peekData());
+    }));
 
     testFeedPtr->pub(trans1, ledgerHeader, backend);
     constexpr static auto TransactionForOwnerFund =
@@ -923,14 +933,10 @@ TEST_F(FeedTransactionTest, PubTransactionOfferCreationFrozenLine)
     line.setFieldU32(ripple::sfFlags, ripple::lsfHighFreeze);
     line.setFieldAmount(ripple::sfBalance, ripple::STAmount(GetIssue(CURRENCY, ISSUER), 100));
 
-    EXPECT_CALL(*backend, doFetchLedgerObject).Times(3);
-    auto const issueAccount = GetAccountIDWithString(ISSUER);
-    auto const kk = ripple::keylet::account(issueAccount).key;
-    ON_CALL(*backend, doFetchLedgerObject(testing::_, testing::_, testing::_))
-        .WillByDefault(testing::Return(line.getSerializer().peekData()));
     ripple::STObject const accountRoot = CreateAccountRootObject(ISSUER, 0, 1, 10, 2, TXNID, 3);
-    ON_CALL(*backend, doFetchLedgerObject(kk, testing::_, testing::_))
-        .WillByDefault(testing::Return(accountRoot.getSerializer().peekData()));
+    EXPECT_CALL(*backend, doFetchLedgerObjects).WillOnce(testing::WithArg<0>([&](auto const& keys) {
+        return ownerFundsObjects(keys, line.getSerializer().peekData(), accountRoot.getSerializer().peekData());
+    }));
     testFeedPtr->pub(trans1, ledgerHeader, backend);
     EXPECT_CALL(*mockSessionPtr, send(SharedStringJsonEq(TRAN_FROZEN))).Times(1);
     ctx.run();
@@ -959,22 +965,78 @@ TEST_F(FeedTransactionTest, SubTransactionOfferCreationGlobalFrozen)
     line.setFieldH256(ripple::sfPreviousTxnID, ripple::uint256{TXNID});
     line.setFieldU32(ripple::sfPreviousTxnLgrSeq, 3);
     line.setFieldU32(ripple::sfFlags, ripple::lsfHighFreeze);
-    auto const issueAccount = GetAccountIDWithString(ISSUER);
     line.setFieldAmount(ripple::sfBalance, ripple::STAmount(GetIssue(CURRENCY, ISSUER), 100));
 
-    EXPECT_CALL(*backend, doFetchLedgerObject).Times(2);
-    auto const kk = ripple::keylet::account(issueAccount).key;
-    ON_CALL(*backend, doFetchLedgerObject(testing::_, testing::_, testing::_))
-        .WillByDefault(testing::Return(line.getSerializer().peekData()));
     ripple::STObject const accountRoot = CreateAccountRootObject(ISSUER, ripple::lsfGlobalFreeze, 1, 10, 2, TXNID, 3);
-    ON_CALL(*backend, doFetchLedgerObject(kk, testing::_, testing::_))
-        .WillByDefault(testing::Return(accountRoot.getSerializer().peekData()));
+    EXPECT_CALL(*backend, doFetchLedgerObjects).WillOnce(testing::WithArg<0>([&](auto const& keys) {
+        return ownerFundsObjects(keys, line.getSerializer().peekData(), accountRoot.getSerializer().peekData());
+    }));
     testFeedPtr->pub(trans1, ledgerHeader, backend);
 
     EXPECT_CALL(*mockSessionPtr, send(SharedStringJsonEq(TRAN_FROZEN))).Times(1);
     ctx.run();
 }
 
+TEST_F(FeedTransactionTest, PubOfferCreateWithoutSubscribers)
+{
+    auto const ledgerHeader = CreateLedgerHeader(LEDGERHASH, 33);
+    auto trans1 = TransactionAndMetadata();
+    ripple::STObject const obj = CreateCreateOfferTransactionObject(ACCOUNT1, 1, 32, CURRENCY, ISSUER, 1, 3);
+    trans1.transaction = obj.getSerializer().peekData();
+    trans1.ledgerSequence = 32;
+    ripple::STArray const metaArray{0};
+    ripple::STObject metaObj(ripple::sfTransactionMetaData);
+    metaObj.setFieldArray(ripple::sfAffectedNodes, metaArray);
+    metaObj.setFieldU8(ripple::sfTransactionResult, ripple::tesSUCCESS);
+    metaObj.setFieldU32(ripple::sfTransactionIndex, 22);
+    trans1.metadata = metaObj.getSerializer().peekData();
+
+    // nobody would receive the transaction, so the owner funds are not fetched
+    EXPECT_CALL(*backend, doFetchLedgerObjects).Times(0);
+    testFeedPtr->pub(trans1, ledgerHeader, backend);
+
+    auto const account2 = GetAccountIDWithString(ACCOUNT2);
+    testFeedPtr->sub(account2, sessionPtr);
+    testFeedPtr->pub(trans1, ledgerHeader, backend);
+
+    auto const issue1 = GetIssue(CURRENCY, ISSUER);
+    testFeedPtr->sub(ripple::Book{ripple::xrpIssue(), issue1}, sessionPtr);
+    testFeedPtr->pub(trans1, ledgerHeader, backend);
+
+    EXPECT_CALL(*mockSessionPtr, send(testing::_)).Times(0);
+    ctx.run();
+}
+
+TEST_F(FeedTransactionTest, SubTransactionWithBothVersions)
+{
+    auto const session2 = std::make_shared<MockSession>();
+    session2->apiSubVersion = 2;
+    auto const session3 = std::make_shared<MockSession>();
+    session3->apiSubVersion = 2;
+
+    testFeedPtr->sub(sessionPtr);
+    testFeedPtr->sub(session2);
+    testFeedPtr->sub(GetAccountIDWithString(ACCOUNT2), session3);
+
+    auto const ledgerHeader = CreateLedgerHeader(LEDGERHASH, 33);
+    auto trans1 = TransactionAndMetadata();
+    ripple::STObject const obj = CreatePaymentTransactionObject(ACCOUNT1, ACCOUNT2, 1, 1, 32);
+    trans1.transaction = obj.getSerializer().peekData();
+    trans1.ledgerSequence = 32;
+    trans1.metadata = CreatePaymentTransactionMetaObject(ACCOUNT1, ACCOUNT2, 110, 30, 22).getSerializer().peekData();
+    testFeedPtr->pub(trans1, ledgerHeader, backend);
+
+    std::shared_ptr<std::string> sentV2;
+    std::shared_ptr<std::string> sentV2ToAccount;
+    EXPECT_CALL(*mockSessionPtr, send(SharedStringJsonEq(TRAN_V1))).Times(1);
+    EXPECT_CALL(*session2, send(SharedStringJsonEq(TRAN_V2))).WillOnce(testing::SaveArg<0>(&sentV2));
+    EXPECT_CALL(*session3, send(SharedStringJsonEq(TRAN_V2))).WillOnce(testing::SaveArg<0>(&sentV2ToAccount));
+    ctx.run();
+
+    // a version is rendered once and shared by all the subscribers
+    EXPECT_EQ(sentV2, sentV2ToAccount);
+}
+
 TEST_F(FeedTransactionTest, SubBothProposedAndValidatedAccount)
 {
     auto const account = GetAccountIDWithString(ACCOUNT1);
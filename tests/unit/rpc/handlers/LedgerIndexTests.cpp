@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include "data/Types.hpp"
 #include "rpc/Errors.hpp"
 #include "rpc/common/AnyHandler.hpp"
 #include "rpc/common/Types.hpp"
@@ -166,3 +167,28 @@ TEST_P(LedgerIndexTests, SearchFromLedgerRange)
         EXPECT_EQ(output.result->at("closed").as_string(), testBundle.closeTimeIso);
     });
 }
+
+TEST_F(RPCLedgerIndexTest, SearchUsingCloseTimeIndex)
+{
+    backend->setRange(RANGEMIN, RANGEMAX);
+    backend->closeTimeIndex().setSampleInterval(1);
+
+    // ledgers close every 2 seconds starting from 2024-06-25T12:23:10Z
+    for (uint32_t i = RANGEMIN; i <= RANGEMAX; i++) {
+        auto const ledgerHeader = CreateLedgerHeaderWithUnixTime(LEDGERHASH, i, 1719318190 + 2 * (i - RANGEMIN));
+        backend->closeTimeIndex().add(data::LedgerCloseTime{.sequence = i, .closeTime = ledgerHeader.closeTime});
+    }
+
+    // only the resulting ledger is read from the DB
+    auto const ledgerHeader = CreateLedgerHeaderWithUnixTime(LEDGERHASH, 19, 1719318190 + 2 * (19 - RANGEMIN));
+    EXPECT_CALL(*backend, fetchLedgerBySequence(19, _)).WillOnce(Return(ledgerHeader));
+
+    auto const handler = AnyHandler{LedgerIndexHandler{backend}};
+    auto const req = json::parse(R"({"date": "2024-06-25T12:23:29Z"})");
+    runSpawn([&](auto yield) {
+        auto const output = handler.process(req, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(output.result->at("ledger_index").as_uint64(), 19);
+        EXPECT_EQ(output.result->at("closed").as_string(), "2024-06-25T12:23:28Z");
+    });
+}
@@ -1099,3 +1099,62 @@ TEST_F(RPCTxTest, ViaLowercaseCTID)
         EXPECT_EQ(output.result->at("ctid").as_string(), CTID);
     });
 }
+
+TEST_F(RPCTxTest, ViaCTIDUsingTransactionIndex)
+{
+    TransactionAndMetadata tx;
+    tx.metadata = CreateMetaDataForCreateOffer(CURRENCY, ACCOUNT, 1, 200, 300).getSerializer().peekData();
+    tx.transaction =
+        CreateCreateOfferTransactionObject(ACCOUNT, 2, 100, CURRENCY, ACCOUNT2, 200, 300).getSerializer().peekData();
+    tx.date = 123456;
+    tx.ledgerSequence = SEQ_FROM_CTID;
+
+    EXPECT_CALL(*backend, fetchTransactionByIndex(SEQ_FROM_CTID, 1, _)).WillOnce(Return(tx));
+    EXPECT_CALL(*backend, fetchAllTransactionsInLedger).Times(0);
+
+    auto const rawETLPtr = dynamic_cast<MockETLService*>(mockETLServicePtr.get());
+    ASSERT_NE(rawETLPtr, nullptr);
+    EXPECT_CALL(*rawETLPtr, getETLState).WillOnce(Return(etl::ETLState{.networkID = 2}));
+
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestTxHandler{backend, mockETLServicePtr}};
+        auto const req = json::parse(fmt::format(
+            R"({{
+                "command": "tx",
+                "ctid": "{}"
+            }})",
+            CTID
+        ));
+        auto const output = handler.process(req, Context{yield});
+        ASSERT_TRUE(output);
+        EXPECT_EQ(output.result->at("ctid").as_string(), CTID);
+        EXPECT_EQ(output.result->at("ledger_index").as_uint64(), SEQ_FROM_CTID);
+    });
+}
+
+TEST_F(RPCTxTest, ViaCTIDNotInIndexedLedgerDoesNotScanLedger)
+{
+    EXPECT_CALL(*backend, fetchTransactionByIndex(SEQ_FROM_CTID, 1, _)).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(*backend, fetchFirstIndexedTransactionSequence).WillOnce(Return(SEQ_FROM_CTID));
+    EXPECT_CALL(*backend, fetchAllTransactionsInLedger).Times(0);
+
+    auto const rawETLPtr = dynamic_cast<MockETLService*>(mockETLServicePtr.get());
+    ASSERT_NE(rawETLPtr, nullptr);
+    EXPECT_CALL(*rawETLPtr, getETLState).WillOnce(Return(etl::ETLState{.networkID = 2}));
+
+    runSpawn([this](auto yield) {
+        auto const handler = AnyHandler{TestTxHandler{backend, mockETLServicePtr}};
+        auto const req = json::parse(fmt::format(
+            R"({{
+                "command": "tx",
+                "ctid": "{}"
+            }})",
+            CTID
+        ));
+        auto const output = handler.process(req, Context{yield});
+        ASSERT_FALSE(output);
+
+        auto const err = rpc::makeError(output.result.error());
+        EXPECT_EQ(err.at("error").as_string(), "txnNotFound");
+    });
+}
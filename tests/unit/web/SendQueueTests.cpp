@@ -0,0 +1,264 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of clio: https://github.com/XRPLF/clio
+    Copyright (c) 2024, the clio developers.
+
+    Permission to use, copy, modify, and distribute this software for any
+    purpose with or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL,  DIRECT,  INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include "util/MockPrometheus.hpp"
+#include "util/config/Config.hpp"
+#include "web/impl/SendQueue.hpp"
+
+#include <boost/json/parse.hpp>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace json = boost::json;
+using namespace web;
+using namespace web::impl;
+
+namespace {
+
+std::shared_ptr<std::string>
+makeMessage(std::string text)
+{
+    return std::make_shared<std::string>(std::move(text));
+}
+
+}  // namespace
+
+struct SendQueueSettingsTest : testing::Test {};
+
+TEST_F(SendQueueSettingsTest, DefaultSettingsParsedCorrectly)
+{
+    auto const cfg = util::Config{json::parse(R"({"server": {"ip": "0.0.0.0", "port": 51233}})")};
+    auto const settings = make_SendQueueSettings(cfg);
+
+    EXPECT_EQ(settings, SendQueueSettings{});
+    EXPECT_FALSE(settings.isEnabled());
+}
+
+TEST_F(SendQueueSettingsTest, ValuesCorrectlyPropagatedThroughConfig)
+{
+    auto const cfg = util::Config{json::parse(R"({
+        "server": {
+            "ws_send_queue": {
+                "max_bytes": 1000,
+                "max_messages": 10,
+                "total_max_bytes": 100000,
+                "policy": "gap_notice"
+            }
+        }
+    })")};
+    auto const settings = make_SendQueueSettings(cfg);
+
+    EXPECT_TRUE(settings.isEnabled());
+    EXPECT_EQ(settings.maxBytes, 1000);
+    EXPECT_EQ(settings.maxMessages, 10);
+    EXPECT_EQ(settings.totalMaxBytes, 100000);
+    EXPECT_EQ(settings.policy, SlowConsumerPolicy::GapNotice);
+}
+
+TEST_F(SendQueueSettingsTest, ZeroLimitThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"server": {"ws_send_queue": {"max_messages": 0}}})")};
+    EXPECT_THROW(make_SendQueueSettings(cfg), std::runtime_error);
+}
+
+TEST_F(SendQueueSettingsTest, UnknownPolicyThrows)
+{
+    auto const cfg = util::Config{json::parse(R"({"server": {"ws_send_queue": {"policy": "block"}}})")};
+    EXPECT_THROW(make_SendQueueSettings(cfg), std::runtime_error);
+}
+
+struct SendQueueTest : util::prometheus::WithPrometheus {
+    static std::shared_ptr<SendQueueBudget>
+    makeBudget(SendQueueSettings settings)
+    {
+        return std::make_shared<SendQueueBudget>(settings);
+    }
+};
+
+TEST_F(SendQueueTest, QueuesInOrderWithoutLimits)
+{
+    SendQueue queue{nullptr};
+    for (auto i = 0; i < 100; ++i)
+        EXPECT_EQ(queue.push(makeMessage(std::to_string(i))), SendQueue::PushResult::Queued);
+
+    EXPECT_EQ(queue.size(), 100);
+    for (auto i = 0; i < 100; ++i) {
+        EXPECT_EQ(*queue.front(), std::to_string(i));
+        queue.pop();
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.bytes(), 0);
+}
+
+TEST_F(SendQueueTest, DropsOldestWaitingMessages)
+{
+    SendQueue queue{makeBudget({.maxMessages = 3, .policy = SlowConsumerPolicy::DropOldest})};
+    for (auto const* text : {"sending", "a", "b", "c", "d"})
+        EXPECT_EQ(queue.push(makeMessage(text)), SendQueue::PushResult::Queued);
+
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.bytes(), 9);
+    EXPECT_EQ(queue.numDropped(), 2);
+
+    EXPECT_EQ(*queue.front(), "sending");
+    queue.pop();
+    EXPECT_EQ(*queue.front(), "c");
+    queue.pop();
+    EXPECT_EQ(*queue.front(), "d");
+}
+
+TEST_F(SendQueueTest, DropsUntilBytesFit)
+{
+    SendQueue queue{makeBudget({.maxBytes = 10, .policy = SlowConsumerPolicy::DropOldest})};
+    queue.push(makeMessage("12345"));
+    queue.push(makeMessage("123"));
+    queue.push(makeMessage("12"));
+    EXPECT_EQ(queue.size(), 3);
+
+    queue.push(makeMessage("1234"));
+    EXPECT_EQ(queue.size(), 2);
+    EXPECT_EQ(queue.bytes(), 9);
+    EXPECT_EQ(queue.numDropped(), 2);
+}
+
+TEST_F(SendQueueTest, SendsGapNoticeInPlaceOfDroppedMessages)
+{
+    SendQueue queue{makeBudget({.maxMessages = 2, .policy = SlowConsumerPolicy::GapNotice})};
+    for (auto const* text : {"sending", "a", "b", "c"})
+        queue.push(makeMessage(text));
+
+    EXPECT_EQ(*queue.front(), "sending");
+    queue.pop();
+    EXPECT_EQ(*queue.front(), R"({"type":"messagesDropped","count":2})");
+    queue.pop();
+    EXPECT_EQ(*queue.front(), "c");
+    queue.pop();
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(SendQueueTest, ReportsOverflowForDisconnectPolicy)
+{
+    SendQueue queue{makeBudget({.maxMessages = 2, .policy = SlowConsumerPolicy::Disconnect})};
+    EXPECT_EQ(queue.push(makeMessage("sending")), SendQueue::PushResult::Queued);
+    EXPECT_EQ(queue.push(makeMessage("a")), SendQueue::PushResult::Queued);
+    EXPECT_EQ(queue.push(makeMessage("b")), SendQueue::PushResult::Overflow);
+
+    queue.clear();
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(*queue.front(), "sending");
+}
+
+TEST_F(SendQueueTest, ResponsesAreNeverDropped)
+{
+    SendQueue queue{makeBudget({.maxMessages = 3, .policy = SlowConsumerPolicy::GapNotice})};
+    queue.push(makeMessage("sending"));
+    queue.push(makeMessage("response"), false);
+    queue.push(makeMessage("a"));
+    queue.push(makeMessage("b"));
+
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.numDropped(), 1);
+
+    EXPECT_EQ(*queue.front(), "sending");
+    queue.pop();
+    EXPECT_EQ(*queue.front(), R"({"type":"messagesDropped","count":1})");
+    queue.pop();
+    EXPECT_EQ(*queue.front(), "response");
+    queue.pop();
+    EXPECT_EQ(*queue.front(), "b");
+}
+
+TEST_F(SendQueueTest, ReportsOverflowIfOnlyResponsesAreWaiting)
+{
+    SendQueue queue{makeBudget({.maxMessages = 2, .policy = SlowConsumerPolicy::DropOldest})};
+    EXPECT_EQ(queue.push(makeMessage("sending")), SendQueue::PushResult::Queued);
+    EXPECT_EQ(queue.push(makeMessage("response"), false), SendQueue::PushResult::Queued);
+    EXPECT_EQ(queue.push(makeMessage("another response"), false), SendQueue::PushResult::Overflow);
+    EXPECT_EQ(queue.numDropped(), 0);
+}
+
+TEST_F(SendQueueTest, SingleLargeMessageIsAlwaysQueued)
+{
+    SendQueue queue{makeBudget({.maxBytes = 1, .policy = SlowConsumerPolicy::Disconnect})};
+    EXPECT_EQ(queue.push(makeMessage("too large")), SendQueue::PushResult::Queued);
+}
+
+TEST_F(SendQueueTest, OnlyLargestQueueDropsWhenTotalBudgetIsExceeded)
+{
+    auto const budget = makeBudget({.totalMaxBytes = 10, .policy = SlowConsumerPolicy::DropOldest});
+    SendQueue slow{budget};
+    SendQueue upToDate{budget};
+
+    for (auto const* text : {"12", "12", "12"})
+        slow.push(makeMessage(text));
+    EXPECT_EQ(slow.size(), 3);
+    EXPECT_FALSE(budget->isExceeded());
+
+    upToDate.push(makeMessage("1234"));
+    upToDate.push(makeMessage("1"));
+    EXPECT_TRUE(budget->isExceeded());
+    EXPECT_EQ(upToDate.size(), 2);
+
+    slow.push(makeMessage("12"));
+    EXPECT_EQ(slow.size(), 2);
+    EXPECT_EQ(slow.numDropped(), 2);
+    EXPECT_EQ(upToDate.numDropped(), 0);
+}
+
+TEST_F(SendQueueTest, SlowConnectionDoesNotGetFastConnectionDisconnectedWhenTotalBudgetIsExceeded)
+{
+    auto const budget = makeBudget({.totalMaxBytes = 20, .policy = SlowConsumerPolicy::Disconnect});
+    auto fast = std::make_unique<SendQueue>(budget);
+    auto slow = std::make_unique<SendQueue>(budget);
+
+    for (auto i = 0; i < 4; ++i)
+        EXPECT_EQ(slow->push(makeMessage("12345")), SendQueue::PushResult::Queued);
+    EXPECT_FALSE(budget->isExceeded());
+
+    // two responses are waiting for a client that is reading, while the budget is used up by the slow one
+    EXPECT_EQ(fast->push(makeMessage("r1"), false), SendQueue::PushResult::Queued);
+    EXPECT_EQ(fast->push(makeMessage("r2"), false), SendQueue::PushResult::Queued);
+    EXPECT_EQ(fast->push(makeMessage("r3"), false), SendQueue::PushResult::Queued);
+    EXPECT_TRUE(budget->isExceeded());
+
+    EXPECT_EQ(slow->push(makeMessage("12345")), SendQueue::PushResult::Overflow);
+
+    // the connection of the slow queue is closed
+    slow.reset();
+    EXPECT_FALSE(budget->isExceeded());
+    fast->pop();
+    EXPECT_EQ(fast->push(makeMessage("r4"), false), SendQueue::PushResult::Queued);
+    EXPECT_EQ(fast->numDropped(), 0);
+}
+
+TEST_F(SendQueueTest, DestroyedQueueReturnsItsBytesToTheBudget)
+{
+    auto const budget = makeBudget({.totalMaxBytes = 5});
+    {
+        SendQueue queue{budget};
+        queue.push(makeMessage("123456"));
+        EXPECT_TRUE(budget->isExceeded());
+    }
+    EXPECT_FALSE(budget->isExceeded());
+}